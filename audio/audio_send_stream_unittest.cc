@@ -56,9 +56,10 @@ const CodecInst kIsacCodec = {103, "isac", 16000, 320, 1, 32000};
 
 class MockLimitObserver : public BitrateAllocator::LimitObserver {
  public:
-  MOCK_METHOD2(OnAllocationLimitsChanged,
+  MOCK_METHOD3(OnAllocationLimitsChanged,
                void(uint32_t min_send_bitrate_bps,
-                    uint32_t max_padding_bitrate_bps));
+                    uint32_t max_padding_bitrate_bps,
+                    uint32_t max_bitrate_bps));
 };
 
 struct ConfigHelper {
@@ -86,10 +86,13 @@ int AudioFrameOperations::MonoToStereo(AudioFrame* frame) {
     return -1;
   }
 
-  int16_t data_copy[AudioFrame::kMaxDataSizeSamples];
-  memcpy(data_copy, frame->data_,
-         sizeof(int16_t) * frame->samples_per_channel_);
-  MonoToStereo(data_copy, frame->samples_per_channel_, frame->data_);
+  // Upmix in place, from the last sample, so that each sample is read before
+  // it is overwritten.
+  for (size_t i = frame->samples_per_channel_; i > 0; --i) {
+    const int16_t sample = frame->data_[i - 1];
+    frame->data_[2 * i - 2] = sample;
+    frame->data_[2 * i - 1] = sample;
+  }
   frame->num_channels_ = 2;
 
   return 0;
@@ -41,7 +41,7 @@ class AudioFrameOperations {
                            size_t samples_per_channel,
                            int16_t* dst_audio);
   // |frame.num_channels_| will be updated. This version checks for sufficient
-  // buffer size and that |num_channels_| is mono.
+  // buffer size and that |num_channels_| is mono, and upmixes in place.
   static int MonoToStereo(AudioFrame* frame);
 
   // Downmixes stereo |src_audio| to mono |dst_audio|. This is an in-place
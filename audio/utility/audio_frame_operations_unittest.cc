@@ -109,6 +109,19 @@ TEST_F(AudioFrameOperationsTest, MonoToStereoSucceeds) {
   VerifyFramesAreEqual(stereo_frame, frame_);
 }
 
+TEST_F(AudioFrameOperationsTest, MonoToStereoInPlaceKeepsSampleOrder) {
+  frame_.num_channels_ = 1;
+  for (size_t i = 0; i < frame_.samples_per_channel_; ++i)
+    frame_.data_[i] = static_cast<int16_t>(i);
+  EXPECT_EQ(0, AudioFrameOperations::MonoToStereo(&frame_));
+
+  EXPECT_EQ(2u, frame_.num_channels_);
+  for (size_t i = 0; i < frame_.samples_per_channel_; ++i) {
+    EXPECT_EQ(static_cast<int16_t>(i), frame_.data_[2 * i]);
+    EXPECT_EQ(static_cast<int16_t>(i), frame_.data_[2 * i + 1]);
+  }
+}
+
 TEST_F(AudioFrameOperationsTest, StereoToMonoFailsWithBadParameters) {
   frame_.num_channels_ = 1;
   EXPECT_EQ(-1, AudioFrameOperations::StereoToMono(&frame_));
@@ -12,7 +12,7 @@
 #include "webrtc/call/bitrate_allocator.h"
 
 #include <algorithm>
-#include <utility>
+#include <limits>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
@@ -48,10 +48,15 @@ double MediaRatio(uint32_t allocated_bitrate, uint32_t protection_bitrate) {
 BitrateAllocator::BitrateAllocator(LimitObserver* limit_observer)
     : limit_observer_(limit_observer),
       bitrate_observer_configs_(),
+      sum_min_bitrates_(0),
+      sum_max_bitrates_(0),
+      allocation_valid_(false),
+      allocation_bitrate_bps_(0),
       last_bitrate_bps_(0),
       last_non_zero_bitrate_bps_(kDefaultBitrateBps),
       last_fraction_loss_(0),
       last_rtt_(0),
+      last_probing_interval_ms_(0),
       num_pause_events_(0),
       clock_(Clock::GetRealTimeClock()),
       last_bwe_log_time_(0) {
@@ -68,6 +73,11 @@ void BitrateAllocator::OnNetworkChanged(uint32_t target_bitrate_bps,
                                         int64_t rtt,
                                         int64_t probing_interval_ms) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  // Everyone gets new network properties, otherwise observers may be skipped
+  // if their allocation didn't change, see SetMinAllocationChange().
+  const bool network_changed = fraction_loss != last_fraction_loss_ ||
+                               rtt != last_rtt_ ||
+                               probing_interval_ms != last_probing_interval_ms_;
   last_bitrate_bps_ = target_bitrate_bps;
   last_non_zero_bitrate_bps_ =
       target_bitrate_bps > 0 ? target_bitrate_bps : last_non_zero_bitrate_bps_;
@@ -82,10 +92,13 @@ void BitrateAllocator::OnNetworkChanged(uint32_t target_bitrate_bps,
     last_bwe_log_time_ = now;
   }
 
-  ObserverAllocation allocation = AllocateBitrates(target_bitrate_bps);
+  AllocateBitrates(target_bitrate_bps);
 
-  for (auto& config : bitrate_observer_configs_) {
-    uint32_t allocated_bitrate = allocation[config.observer];
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    ObserverConfig& config = bitrate_observer_configs_[i];
+    uint32_t allocated_bitrate = allocation_[i];
+    if (!network_changed && !AllocationChanged(config, allocated_bitrate))
+      continue;
     uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
         allocated_bitrate, last_fraction_loss_, last_rtt_,
         last_probing_interval_ms_);
@@ -110,10 +123,7 @@ void BitrateAllocator::OnNetworkChanged(uint32_t target_bitrate_bps,
                    << " and protection bitrate " << protection_bitrate;
     }
 
-    // Only update the media ratio if the observer got an allocation.
-    if (allocated_bitrate > 0)
-      config.media_ratio = MediaRatio(allocated_bitrate, protection_bitrate);
-    config.allocated_bitrate_bps = allocated_bitrate;
+    SetAllocatedBitrate(&config, allocated_bitrate, protection_bitrate);
   }
 }
 
@@ -136,25 +146,28 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
         ObserverConfig(observer, min_bitrate_bps, max_bitrate_bps,
                        pad_up_bitrate_bps, enforce_min_bitrate));
   }
+  OnObserverConfigsChanged();
 
-  ObserverAllocation allocation;
   if (last_bitrate_bps_ > 0) {
-    // Calculate a new allocation and update all observers.
-    allocation = AllocateBitrates(last_bitrate_bps_);
-    for (auto& config : bitrate_observer_configs_) {
-      uint32_t allocated_bitrate = allocation[config.observer];
+    // Calculate a new allocation and update the added observer, and the others
+    // whose allocation changed.
+    AllocateBitrates(last_bitrate_bps_);
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      ObserverConfig& config = bitrate_observer_configs_[i];
+      uint32_t allocated_bitrate = allocation_[i];
+      if (config.observer != observer &&
+          !AllocationChanged(config, allocated_bitrate)) {
+        continue;
+      }
       uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
           allocated_bitrate, last_fraction_loss_, last_rtt_,
           last_probing_interval_ms_);
-      config.allocated_bitrate_bps = allocated_bitrate;
-      if (allocated_bitrate > 0)
-        config.media_ratio = MediaRatio(allocated_bitrate, protection_bitrate);
+      SetAllocatedBitrate(&config, allocated_bitrate, protection_bitrate);
     }
   } else {
     // Currently, an encoder is not allowed to produce frames.
     // But we still have to return the initial config bitrate + let the
     // observer know that it can not produce frames.
-    allocation = AllocateBitrates(last_non_zero_bitrate_bps_);
     observer->OnBitrateUpdated(0, last_fraction_loss_, last_rtt_,
                                last_probing_interval_ms_);
   }
@@ -165,20 +178,29 @@ void BitrateAllocator::UpdateAllocationLimits() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   uint32_t total_requested_padding_bitrate = 0;
   uint32_t total_requested_min_bitrate = 0;
+  uint64_t total_max_bitrate = 0;
 
   for (const auto& config : bitrate_observer_configs_) {
     if (config.enforce_min_bitrate) {
       total_requested_min_bitrate += config.min_bitrate_bps;
     }
     total_requested_padding_bitrate += config.pad_up_bitrate_bps;
+    total_max_bitrate += config.max_bitrate_bps > 0
+                             ? config.max_bitrate_bps
+                             : std::numeric_limits<uint32_t>::max();
   }
+  const uint32_t total_max_bitrate_bps = static_cast<uint32_t>(
+      std::min<uint64_t>(total_max_bitrate,
+                         std::numeric_limits<uint32_t>::max()));
 
   LOG(LS_INFO) << "UpdateAllocationLimits : total_requested_min_bitrate: "
                << total_requested_min_bitrate
                << "bps, total_requested_padding_bitrate: "
-               << total_requested_padding_bitrate << "bps";
+               << total_requested_padding_bitrate
+               << "bps, total_max_bitrate: " << total_max_bitrate_bps << "bps";
   limit_observer_->OnAllocationLimitsChanged(total_requested_min_bitrate,
-                                             total_requested_padding_bitrate);
+                                             total_requested_padding_bitrate,
+                                             total_max_bitrate_bps);
 }
 
 void BitrateAllocator::RemoveObserver(BitrateAllocatorObserver* observer) {
@@ -186,6 +208,7 @@ void BitrateAllocator::RemoveObserver(BitrateAllocatorObserver* observer) {
   auto it = FindObserverConfig(observer);
   if (it != bitrate_observer_configs_.end()) {
     bitrate_observer_configs_.erase(it);
+    OnObserverConfigsChanged();
   }
 
   UpdateAllocationLimits();
@@ -208,6 +231,11 @@ int BitrateAllocator::GetStartBitrate(BitrateAllocatorObserver* observer) {
   }
 }
 
+void BitrateAllocator::SetMinAllocationChange(uint32_t bitrate_bps) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  min_allocation_change_bps_ = rtc::Optional<uint32_t>(bitrate_bps);
+}
+
 BitrateAllocator::ObserverConfigs::iterator
 BitrateAllocator::FindObserverConfig(const BitrateAllocatorObserver* observer) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
@@ -219,70 +247,93 @@ BitrateAllocator::FindObserverConfig(const BitrateAllocatorObserver* observer) {
   return bitrate_observer_configs_.end();
 }
 
-BitrateAllocator::ObserverAllocation BitrateAllocator::AllocateBitrates(
-    uint32_t bitrate) {
+void BitrateAllocator::OnObserverConfigsChanged() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  if (bitrate_observer_configs_.empty())
-    return ObserverAllocation();
+  sum_min_bitrates_ = 0;
+  sum_max_bitrates_ = 0;
+  observers_by_max_bitrate_.resize(bitrate_observer_configs_.size());
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    sum_min_bitrates_ += bitrate_observer_configs_[i].min_bitrate_bps;
+    sum_max_bitrates_ += bitrate_observer_configs_[i].max_bitrate_bps;
+    observers_by_max_bitrate_[i] = i;
+  }
+  std::stable_sort(observers_by_max_bitrate_.begin(),
+                   observers_by_max_bitrate_.end(),
+                   [this](size_t a, size_t b) {
+                     return bitrate_observer_configs_[a].max_bitrate_bps <
+                            bitrate_observer_configs_[b].max_bitrate_bps;
+                   });
+  allocation_valid_ = false;
+}
 
-  if (bitrate == 0)
-    return ZeroRateAllocation();
+void BitrateAllocator::AllocateBitrates(uint32_t bitrate) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  if (allocation_valid_ && allocation_bitrate_bps_ == bitrate)
+    return;
+  allocation_valid_ = true;
+  allocation_bitrate_bps_ = bitrate;
+
+  if (bitrate_observer_configs_.empty()) {
+    allocation_.clear();
+    return;
+  }
 
-  uint32_t sum_min_bitrates = 0;
-  uint32_t sum_max_bitrates = 0;
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    sum_min_bitrates += observer_config.min_bitrate_bps;
-    sum_max_bitrates += observer_config.max_bitrate_bps;
+  if (bitrate == 0) {
+    ZeroRateAllocation(&allocation_);
+    return;
   }
 
   // Not enough for all observers to get an allocation, allocate according to:
   // enforced min bitrate -> allocated bitrate previous round -> restart paused
   // streams.
-  if (!EnoughBitrateForAllObservers(bitrate, sum_min_bitrates))
-    return LowRateAllocation(bitrate);
+  if (!EnoughBitrateForAllObservers(bitrate, sum_min_bitrates_)) {
+    LowRateAllocation(bitrate, &allocation_);
+    return;
+  }
 
   // All observers will get their min bitrate plus an even share of the rest.
-  if (bitrate <= sum_max_bitrates)
-    return NormalRateAllocation(bitrate, sum_min_bitrates);
+  if (bitrate <= sum_max_bitrates_) {
+    NormalRateAllocation(bitrate, sum_min_bitrates_, &allocation_);
+    return;
+  }
 
   // All observers will get up to kTransmissionMaxBitrateMultiplier x max.
-  return MaxRateAllocation(bitrate, sum_max_bitrates);
+  MaxRateAllocation(bitrate, sum_max_bitrates_, &allocation_);
 }
 
-BitrateAllocator::ObserverAllocation BitrateAllocator::ZeroRateAllocation() {
+void BitrateAllocator::ZeroRateAllocation(ObserverAllocation* allocation) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
-  for (const auto& observer_config : bitrate_observer_configs_)
-    allocation[observer_config.observer] = 0;
-  return allocation;
+  allocation->assign(bitrate_observer_configs_.size(), 0);
 }
 
-BitrateAllocator::ObserverAllocation BitrateAllocator::LowRateAllocation(
-    uint32_t bitrate) {
+void BitrateAllocator::LowRateAllocation(uint32_t bitrate,
+                                         ObserverAllocation* allocation) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
+  allocation->resize(bitrate_observer_configs_.size());
   // Start by allocating bitrate to observers enforcing a min bitrate, hence
   // remaining_bitrate might turn negative.
   int64_t remaining_bitrate = bitrate;
-  for (const auto& observer_config : bitrate_observer_configs_) {
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    const ObserverConfig& observer_config = bitrate_observer_configs_[i];
     int32_t allocated_bitrate = 0;
     if (observer_config.enforce_min_bitrate)
       allocated_bitrate = observer_config.min_bitrate_bps;
 
-    allocation[observer_config.observer] = allocated_bitrate;
+    (*allocation)[i] = allocated_bitrate;
     remaining_bitrate -= allocated_bitrate;
   }
 
   // Allocate bitrate to all previously active streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : bitrate_observer_configs_) {
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      const ObserverConfig& observer_config = bitrate_observer_configs_[i];
       if (observer_config.enforce_min_bitrate ||
           LastAllocatedBitrate(observer_config) == 0)
         continue;
 
       uint32_t required_bitrate = MinBitrateWithHysteresis(observer_config);
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        (*allocation)[i] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -290,14 +341,15 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::LowRateAllocation(
 
   // Allocate bitrate to previously paused streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : bitrate_observer_configs_) {
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      const ObserverConfig& observer_config = bitrate_observer_configs_[i];
       if (LastAllocatedBitrate(observer_config) != 0)
         continue;
 
       // Add a hysteresis to avoid toggling.
       uint32_t required_bitrate = MinBitrateWithHysteresis(observer_config);
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        (*allocation)[i] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -305,40 +357,69 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::LowRateAllocation(
 
   // Split a possible remainder evenly on all streams with an allocation.
   if (remaining_bitrate > 0)
-    DistributeBitrateEvenly(remaining_bitrate, false, 1, &allocation);
-
-  RTC_DCHECK_EQ(allocation.size(), bitrate_observer_configs_.size());
-  return allocation;
+    DistributeBitrateEvenly(remaining_bitrate, false, 1, allocation);
 }
 
-BitrateAllocator::ObserverAllocation BitrateAllocator::NormalRateAllocation(
-    uint32_t bitrate,
-    uint32_t sum_min_bitrates) {
+void BitrateAllocator::NormalRateAllocation(uint32_t bitrate,
+                                            uint32_t sum_min_bitrates,
+                                            ObserverAllocation* allocation) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
-  for (const auto& observer_config : bitrate_observer_configs_)
-    allocation[observer_config.observer] = observer_config.min_bitrate_bps;
+  allocation->resize(bitrate_observer_configs_.size());
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i)
+    (*allocation)[i] = bitrate_observer_configs_[i].min_bitrate_bps;
 
   bitrate -= sum_min_bitrates;
   if (bitrate > 0)
-    DistributeBitrateEvenly(bitrate, true, 1, &allocation);
-
-  return allocation;
+    DistributeBitrateEvenly(bitrate, true, 1, allocation);
 }
 
-BitrateAllocator::ObserverAllocation BitrateAllocator::MaxRateAllocation(
-    uint32_t bitrate,
-    uint32_t sum_max_bitrates) {
+void BitrateAllocator::MaxRateAllocation(uint32_t bitrate,
+                                         uint32_t sum_max_bitrates,
+                                         ObserverAllocation* allocation) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
+  allocation->resize(bitrate_observer_configs_.size());
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i)
+    (*allocation)[i] = bitrate_observer_configs_[i].max_bitrate_bps;
 
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    allocation[observer_config.observer] = observer_config.max_bitrate_bps;
-    bitrate -= observer_config.max_bitrate_bps;
-  }
+  bitrate -= sum_max_bitrates;
   DistributeBitrateEvenly(bitrate, true, kTransmissionMaxBitrateMultiplier,
-                          &allocation);
-  return allocation;
+                          allocation);
+}
+
+bool BitrateAllocator::AllocationChanged(const ObserverConfig& observer_config,
+                                         uint32_t allocated_bitrate) const {
+  if (!min_allocation_change_bps_ ||
+      observer_config.allocated_bitrate_bps == -1) {
+    return true;
+  }
+  const uint32_t last_bitrate = observer_config.allocated_bitrate_bps;
+  // Pausing and resuming is never held back.
+  if ((last_bitrate == 0) != (allocated_bitrate == 0))
+    return true;
+  const uint32_t change = allocated_bitrate > last_bitrate
+                              ? allocated_bitrate - last_bitrate
+                              : last_bitrate - allocated_bitrate;
+  return change > *min_allocation_change_bps_;
+}
+
+void BitrateAllocator::SetAllocatedBitrate(ObserverConfig* observer_config,
+                                           uint32_t allocated_bitrate,
+                                           uint32_t protection_bitrate) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  // Only update the media ratio if the observer got an allocation.
+  const double media_ratio =
+      allocated_bitrate > 0 ? MediaRatio(allocated_bitrate, protection_bitrate)
+                            : observer_config->media_ratio;
+  // The hysteresis of the next allocation depends on whether the observer is
+  // paused and on its media ratio.
+  if (observer_config->allocated_bitrate_bps == -1 ||
+      (observer_config->allocated_bitrate_bps == 0) !=
+          (allocated_bitrate == 0) ||
+      observer_config->media_ratio != media_ratio) {
+    allocation_valid_ = false;
+  }
+  observer_config->media_ratio = media_ratio;
+  observer_config->allocated_bitrate_bps = allocated_bitrate;
 }
 
 uint32_t BitrateAllocator::LastAllocatedBitrate(
@@ -377,31 +458,33 @@ void BitrateAllocator::DistributeBitrateEvenly(uint32_t bitrate,
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   RTC_DCHECK_EQ(allocation->size(), bitrate_observer_configs_.size());
 
-  ObserverSortingMap list_max_bitrates;
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    if (include_zero_allocations ||
-        allocation->at(observer_config.observer) != 0) {
-      list_max_bitrates.insert(std::pair<uint32_t, const ObserverConfig*>(
-          observer_config.max_bitrate_bps, &observer_config));
-    }
+  size_t num_observers = 0;
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    if (include_zero_allocations || (*allocation)[i] != 0)
+      ++num_observers;
   }
-  auto it = list_max_bitrates.begin();
-  while (it != list_max_bitrates.end()) {
+  // Observers with a lower max bitrate first, so that what they can't fit is
+  // carried over to the ones that can.
+  for (size_t i : observers_by_max_bitrate_) {
+    if (num_observers == 0)
+      break;
+    if (!include_zero_allocations && (*allocation)[i] == 0)
+      continue;
+    const uint32_t max_bitrate = bitrate_observer_configs_[i].max_bitrate_bps;
     RTC_DCHECK_GT(bitrate, 0);
     uint32_t extra_allocation =
-        bitrate / static_cast<uint32_t>(list_max_bitrates.size());
-    uint32_t total_allocation =
-        extra_allocation + allocation->at(it->second->observer);
+        bitrate / static_cast<uint32_t>(num_observers);
+    uint32_t total_allocation = extra_allocation + (*allocation)[i];
     bitrate -= extra_allocation;
-    if (total_allocation > max_multiplier * it->first) {
+    if (total_allocation > max_multiplier * max_bitrate) {
       // There is more than we can fit for this observer, carry over to the
       // remaining observers.
-      bitrate += total_allocation - max_multiplier * it->first;
-      total_allocation = max_multiplier * it->first;
+      bitrate += total_allocation - max_multiplier * max_bitrate;
+      total_allocation = max_multiplier * max_bitrate;
     }
     // Finally, update the allocation for this observer.
-    allocation->at(it->second->observer) = total_allocation;
-    it = list_max_bitrates.erase(it);
+    (*allocation)[i] = total_allocation;
+    --num_observers;
   }
 }
 
@@ -13,10 +13,9 @@
 
 #include <stdint.h>
 
-#include <map>
-#include <utility>
 #include <vector>
 
+#include "webrtc/base/optional.h"
 #include "webrtc/base/sequenced_task_checker.h"
 
 namespace webrtc {
@@ -46,12 +45,13 @@ class BitrateAllocatorObserver {
 class BitrateAllocator {
  public:
   // Used to get notified when send stream limits such as the minimum send
-  // bitrate and max padding bitrate is changed.
+  // bitrate and max padding bitrate is changed. |max_bitrate_bps| is the sum
+  // of the observers' max bitrates, or the max uint32_t if any has none.
   class LimitObserver {
    public:
-    virtual void OnAllocationLimitsChanged(
-        uint32_t min_send_bitrate_bps,
-        uint32_t max_padding_bitrate_bps) = 0;
+    virtual void OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps,
+                                           uint32_t max_padding_bitrate_bps,
+                                           uint32_t max_bitrate_bps) = 0;
 
    protected:
     virtual ~LimitObserver() {}
@@ -92,6 +92,13 @@ class BitrateAllocator {
   // the list of added observers, a best guess is returned.
   int GetStartBitrate(BitrateAllocatorObserver* observer);
 
+  // By default all observers are notified on every network change. Once this
+  // is set, observers are only notified when their allocation changed by more
+  // than |bitrate_bps|, when they are paused or resumed, or when the fraction
+  // loss, rtt or probing interval changed. The protection bitrate reported by
+  // an observer is then only sampled when it is notified.
+  void SetMinAllocationChange(uint32_t bitrate_bps);
+
  private:
   // Note: All bitrates for member variables and methods are in bps.
   struct ObserverConfig {
@@ -117,25 +124,43 @@ class BitrateAllocator {
     double media_ratio;  // Part of the total bitrate used for media [0.0, 1.0].
   };
 
-  // Calculates the minimum requested send bitrate and max padding bitrate and
-  // calls LimitObserver::OnAllocationLimitsChanged.
+  // Calculates the minimum requested send bitrate, max padding bitrate and
+  // max bitrate and calls LimitObserver::OnAllocationLimitsChanged.
   void UpdateAllocationLimits();
 
   typedef std::vector<ObserverConfig> ObserverConfigs;
   ObserverConfigs::iterator FindObserverConfig(
       const BitrateAllocatorObserver* observer);
 
-  typedef std::multimap<uint32_t, const ObserverConfig*> ObserverSortingMap;
-  typedef std::map<BitrateAllocatorObserver*, int> ObserverAllocation;
-
-  ObserverAllocation AllocateBitrates(uint32_t bitrate);
-
-  ObserverAllocation ZeroRateAllocation();
-  ObserverAllocation LowRateAllocation(uint32_t bitrate);
-  ObserverAllocation NormalRateAllocation(uint32_t bitrate,
-                                          uint32_t sum_min_bitrates);
-  ObserverAllocation MaxRateAllocation(uint32_t bitrate,
-                                       uint32_t sum_max_bitrates);
+  // Bitrates indexed as |bitrate_observer_configs_|.
+  typedef std::vector<uint32_t> ObserverAllocation;
+
+  // Updates the observer order and bitrate sums after observers were added,
+  // removed or reconfigured.
+  void OnObserverConfigsChanged();
+
+  // Calculates the allocation of |bitrate| into |allocation_|, unless it
+  // already holds it.
+  void AllocateBitrates(uint32_t bitrate);
+
+  void ZeroRateAllocation(ObserverAllocation* allocation);
+  void LowRateAllocation(uint32_t bitrate, ObserverAllocation* allocation);
+  void NormalRateAllocation(uint32_t bitrate,
+                            uint32_t sum_min_bitrates,
+                            ObserverAllocation* allocation);
+  void MaxRateAllocation(uint32_t bitrate,
+                         uint32_t sum_max_bitrates,
+                         ObserverAllocation* allocation);
+
+  // Whether |observer_config| should be notified of |allocated_bitrate|, given
+  // the allocation it was last notified of.
+  bool AllocationChanged(const ObserverConfig& observer_config,
+                         uint32_t allocated_bitrate) const;
+  // Stores the allocation |observer_config| was notified of, and the
+  // protection it reported.
+  void SetAllocatedBitrate(ObserverConfig* observer_config,
+                           uint32_t allocated_bitrate,
+                           uint32_t protection_bitrate);
 
   uint32_t LastAllocatedBitrate(const ObserverConfig& observer_config);
   // The minimum bitrate required by this observer, including enable-hysteresis
@@ -156,6 +181,19 @@ class BitrateAllocator {
   LimitObserver* const limit_observer_ GUARDED_BY(&sequenced_checker_);
   // Stored in a list to keep track of the insertion order.
   ObserverConfigs bitrate_observer_configs_ GUARDED_BY(&sequenced_checker_);
+  // Indices into |bitrate_observer_configs_|, by increasing max bitrate and
+  // then insertion order.
+  std::vector<size_t> observers_by_max_bitrate_
+      GUARDED_BY(&sequenced_checker_);
+  uint32_t sum_min_bitrates_ GUARDED_BY(&sequenced_checker_);
+  uint32_t sum_max_bitrates_ GUARDED_BY(&sequenced_checker_);
+  // The last calculated allocation, valid for |allocation_bitrate_bps_| until
+  // the observers or their state change.
+  ObserverAllocation allocation_ GUARDED_BY(&sequenced_checker_);
+  bool allocation_valid_ GUARDED_BY(&sequenced_checker_);
+  uint32_t allocation_bitrate_bps_ GUARDED_BY(&sequenced_checker_);
+  rtc::Optional<uint32_t> min_allocation_change_bps_
+      GUARDED_BY(&sequenced_checker_);
   uint32_t last_bitrate_bps_ GUARDED_BY(&sequenced_checker_);
   uint32_t last_non_zero_bitrate_bps_ GUARDED_BY(&sequenced_checker_);
   uint8_t last_fraction_loss_ GUARDED_BY(&sequenced_checker_);
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/call/bitrate_allocator.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumObservers = 500;
+constexpr int kNumUpdates = 2000;
+constexpr int64_t kProbingIntervalMs = 3000;
+
+class NullLimitObserver : public BitrateAllocator::LimitObserver {
+ public:
+  void OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps,
+                                 uint32_t max_padding_bitrate_bps,
+                                 uint32_t max_bitrate_bps) override {}
+};
+
+class CountingObserver : public BitrateAllocatorObserver {
+ public:
+  uint32_t OnBitrateUpdated(uint32_t bitrate_bps,
+                            uint8_t fraction_loss,
+                            int64_t rtt,
+                            int64_t probing_interval_ms) override {
+    ++num_updates_;
+    return bitrate_bps / 10;
+  }
+
+  int num_updates() const { return num_updates_; }
+
+ private:
+  int num_updates_ = 0;
+};
+
+// The send streams of a bridge: one audio stream and two simulcast layers of
+// video per participant, updated with an estimate drifting around half the
+// sum of their max bitrates. There the audio streams and low layers are at
+// their max, and the high layers share the rest between their min and max.
+void RunBridgeSendStreams(const std::string& test_name,
+                          bool set_min_allocation_change) {
+  NullLimitObserver limit_observer;
+  BitrateAllocator allocator(&limit_observer);
+  if (set_min_allocation_change)
+    allocator.SetMinAllocationChange(10000);
+  std::vector<std::unique_ptr<CountingObserver>> observers;
+  uint32_t sum_max_bitrates = 0;
+  for (int i = 0; i < kNumObservers; ++i) {
+    observers.emplace_back(new CountingObserver());
+    uint32_t min_bitrate_bps;
+    uint32_t max_bitrate_bps;
+    switch (i % 3) {
+      case 0:
+        min_bitrate_bps = 6000;
+        max_bitrate_bps = 32000;
+        break;
+      case 1:
+        min_bitrate_bps = 30000;
+        max_bitrate_bps = 150000;
+        break;
+      default:
+        min_bitrate_bps = 150000;
+        max_bitrate_bps = 1200000;
+        break;
+    }
+    sum_max_bitrates += max_bitrate_bps;
+    allocator.AddObserver(observers.back().get(), min_bitrate_bps,
+                          max_bitrate_bps, 0, i % 3 == 0);
+  }
+
+  Random random(0x5e1d);
+  uint32_t target_bitrate_bps = sum_max_bitrates / 2;
+  int64_t rtt_ms = 50;
+  int num_updates_before = 0;
+  for (const auto& observer : observers)
+    num_updates_before += observer->num_updates();
+
+  const int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumUpdates; ++i) {
+    // The estimate changes on most updates, the rtt now and then.
+    if (random.Rand(0, 3) != 0) {
+      target_bitrate_bps += random.Rand(0, 200000);
+      target_bitrate_bps -= random.Rand(0, 200000);
+    }
+    if (random.Rand(0, 9) == 0)
+      rtt_ms = random.Rand(40, 60);
+    allocator.OnNetworkChanged(target_bitrate_bps, 0, rtt_ms,
+                               kProbingIntervalMs);
+  }
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+  int num_notifications = -num_updates_before;
+  for (const auto& observer : observers)
+    num_notifications += observer->num_updates();
+  for (const auto& observer : observers)
+    allocator.RemoveObserver(observer.get());
+
+  webrtc::test::PrintResult("bitrate_allocator", test_name,
+                            "network_changed", elapsed_ns / kNumUpdates / 1000,
+                            "us/update", true);
+  webrtc::test::PrintResult("bitrate_allocator", test_name, "notifications",
+                            num_notifications / kNumUpdates,
+                            "observers/update", false);
+}
+}  // namespace
+
+TEST(BitrateAllocatorPerfTest, NotifyAll500Observers) {
+  RunBridgeSendStreams("_notify_all_500_observers", false);
+}
+
+TEST(BitrateAllocatorPerfTest, NotifyChanged500Observers) {
+  RunBridgeSendStreams("_notify_changed_500_observers", true);
+}
+
+}  // namespace webrtc
@@ -9,6 +9,7 @@
  */
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -23,9 +24,10 @@ namespace webrtc {
 
 class MockLimitObserver : public BitrateAllocator::LimitObserver {
  public:
-  MOCK_METHOD2(OnAllocationLimitsChanged,
+  MOCK_METHOD3(OnAllocationLimitsChanged,
                void(uint32_t min_send_bitrate_bps,
-                    uint32_t max_padding_bitrate_bps));
+                    uint32_t max_padding_bitrate_bps,
+                    uint32_t max_bitrate_bps));
 };
 
 class TestBitrateObserver : public BitrateAllocatorObserver {
@@ -35,7 +37,8 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
         last_fraction_loss_(0),
         last_rtt_ms_(0),
         last_probing_interval_ms_(0),
-        protection_ratio_(0.0) {}
+        protection_ratio_(0.0),
+        num_updates_(0) {}
 
   void SetBitrateProtectionRatio(double protection_ratio) {
     protection_ratio_ = protection_ratio;
@@ -49,6 +52,7 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
     last_fraction_loss_ = fraction_loss;
     last_rtt_ms_ = rtt;
     last_probing_interval_ms_ = probing_interval_ms;
+    ++num_updates_;
     return bitrate_bps * protection_ratio_;
   }
   uint32_t last_bitrate_bps_;
@@ -56,6 +60,7 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
   int64_t last_rtt_ms_;
   int last_probing_interval_ms_;
   double protection_ratio_;
+  int num_updates_;
 };
 
 namespace {
@@ -78,8 +83,9 @@ TEST_F(BitrateAllocatorTest, UpdatingBitrateObserver) {
   const uint32_t kMinSendBitrateBps = 100000;
   const uint32_t kPadUpToBitrateBps = 50000;
 
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(kMinSendBitrateBps,
-                                                         kPadUpToBitrateBps));
+  EXPECT_CALL(limit_observer_,
+              OnAllocationLimitsChanged(kMinSendBitrateBps, kPadUpToBitrateBps,
+                                        1500000));
   allocator_->AddObserver(&bitrate_observer, kMinSendBitrateBps, 1500000,
                           kPadUpToBitrateBps, true);
   EXPECT_EQ(300000, allocator_->GetStartBitrate(&bitrate_observer));
@@ -93,13 +99,13 @@ TEST_F(BitrateAllocatorTest, UpdatingBitrateObserver) {
 
   // Expect |max_padding_bitrate_bps| to change to 0 if the observer is updated.
   EXPECT_CALL(limit_observer_,
-              OnAllocationLimitsChanged(kMinSendBitrateBps, 0));
+              OnAllocationLimitsChanged(kMinSendBitrateBps, 0, 4000000));
   allocator_->AddObserver(&bitrate_observer, kMinSendBitrateBps, 4000000, 0,
                           true);
   EXPECT_EQ(4000000, allocator_->GetStartBitrate(&bitrate_observer));
 
   EXPECT_CALL(limit_observer_,
-              OnAllocationLimitsChanged(kMinSendBitrateBps, 0));
+              OnAllocationLimitsChanged(kMinSendBitrateBps, 0, 1500000));
   allocator_->AddObserver(&bitrate_observer, kMinSendBitrateBps, 1500000, 0,
                           true);
   EXPECT_EQ(3000000, allocator_->GetStartBitrate(&bitrate_observer));
@@ -111,11 +117,11 @@ TEST_F(BitrateAllocatorTest, UpdatingBitrateObserver) {
 TEST_F(BitrateAllocatorTest, TwoBitrateObserversOneRtcpObserver) {
   TestBitrateObserver bitrate_observer_1;
   TestBitrateObserver bitrate_observer_2;
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(100000, 0));
+  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(100000, 0, 300000));
   allocator_->AddObserver(&bitrate_observer_1, 100000, 300000, 0, true);
   EXPECT_EQ(300000, allocator_->GetStartBitrate(&bitrate_observer_1));
   EXPECT_CALL(limit_observer_,
-              OnAllocationLimitsChanged(100000 + 200000, 0));
+              OnAllocationLimitsChanged(100000 + 200000, 0, 600000));
   allocator_->AddObserver(&bitrate_observer_2, 200000, 300000, 0, true);
   EXPECT_EQ(200000, allocator_->GetStartBitrate(&bitrate_observer_2));
 
@@ -157,14 +163,27 @@ TEST_F(BitrateAllocatorTest, RemoveObserverTriggersLimitObserver) {
   const uint32_t kMinSendBitrateBps = 100000;
   const uint32_t kPadUpToBitrateBps = 50000;
 
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(kMinSendBitrateBps,
-                                                         kPadUpToBitrateBps));
+  EXPECT_CALL(limit_observer_,
+              OnAllocationLimitsChanged(kMinSendBitrateBps, kPadUpToBitrateBps,
+                                        1500000));
   allocator_->AddObserver(&bitrate_observer, kMinSendBitrateBps, 1500000,
                           kPadUpToBitrateBps, true);
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0));
+  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0, 0));
   allocator_->RemoveObserver(&bitrate_observer);
 }
 
+TEST_F(BitrateAllocatorTest, ReportsSumOfMaxBitrates) {
+  TestBitrateObserver bitrate_observer_1;
+  TestBitrateObserver bitrate_observer_2;
+  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(100000, 0, 300000));
+  allocator_->AddObserver(&bitrate_observer_1, 100000, 300000, 0, true);
+  // A max bitrate of 0 is no max, so neither is there one for the sum.
+  EXPECT_CALL(limit_observer_,
+              OnAllocationLimitsChanged(200000, 0,
+                                        std::numeric_limits<uint32_t>::max()));
+  allocator_->AddObserver(&bitrate_observer_2, 100000, 0, 0, true);
+}
+
 class BitrateAllocatorTestNoEnforceMin : public ::testing::Test {
  protected:
   BitrateAllocatorTestNoEnforceMin()
@@ -183,7 +202,7 @@ TEST_F(BitrateAllocatorTestNoEnforceMin, OneBitrateObserver) {
   TestBitrateObserver bitrate_observer_1;
   // Expect OnAllocationLimitsChanged with |min_send_bitrate_bps| = 0 since
   // AddObserver is called with |enforce_min_bitrate| = false.
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0));
+  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0, 400000));
   allocator_->AddObserver(&bitrate_observer_1, 100000, 400000, 0, false);
   EXPECT_EQ(300000, allocator_->GetStartBitrate(&bitrate_observer_1));
 
@@ -195,7 +214,7 @@ TEST_F(BitrateAllocatorTestNoEnforceMin, OneBitrateObserver) {
   allocator_->OnNetworkChanged(10000, 0, 0, kDefaultProbingIntervalMs);
   EXPECT_EQ(0u, bitrate_observer_1.last_bitrate_bps_);
 
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0));
+  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0, 0));
   allocator_->RemoveObserver(&bitrate_observer_1);
 }
 
@@ -264,7 +283,7 @@ TEST_F(BitrateAllocatorTestNoEnforceMin, OneBitrateObserverWithPacketLoss) {
   TestBitrateObserver bitrate_observer;
   // Expect OnAllocationLimitsChanged with |min_send_bitrate_bps| = 0 since
   // AddObserver is called with |enforce_min_bitrate| = false.
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0));
+  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0, 400000));
   allocator_->AddObserver(
       &bitrate_observer, 100000, 400000, 0, false);
   EXPECT_EQ(300000, allocator_->GetStartBitrate(&bitrate_observer));
@@ -304,7 +323,7 @@ TEST_F(BitrateAllocatorTestNoEnforceMin, OneBitrateObserverWithPacketLoss) {
   allocator_->OnNetworkChanged(139000, 0, 0, kDefaultProbingIntervalMs);
   EXPECT_EQ(139000u, bitrate_observer.last_bitrate_bps_);
 
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0));
+  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(0, 0, 0));
   allocator_->RemoveObserver(&bitrate_observer);
 }
 
@@ -389,7 +408,7 @@ TEST_F(BitrateAllocatorTest, ThreeBitrateObserversLowBweEnforceMin) {
 
 TEST_F(BitrateAllocatorTest, AddObserverWhileNetworkDown) {
   TestBitrateObserver bitrate_observer_1;
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(50000, 0));
+  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(50000, 0, 400000));
 
   allocator_->AddObserver(&bitrate_observer_1, 50000, 400000, 0, true);
   EXPECT_EQ(300000, allocator_->GetStartBitrate(&bitrate_observer_1));
@@ -401,7 +420,8 @@ TEST_F(BitrateAllocatorTest, AddObserverWhileNetworkDown) {
 
   TestBitrateObserver bitrate_observer_2;
   // Adding an observer while the network is down should not affect the limits.
-  EXPECT_CALL(limit_observer_, OnAllocationLimitsChanged(50000 + 50000, 0));
+  EXPECT_CALL(limit_observer_,
+              OnAllocationLimitsChanged(50000 + 50000, 0, 800000));
   allocator_->AddObserver(&bitrate_observer_2, 50000, 400000, 0, true);
 
   // Expect the start_bitrate to be set as if the network was still up but that
@@ -521,4 +541,56 @@ TEST_F(BitrateAllocatorTest, PassProbingInterval) {
   allocator_->RemoveObserver(&observer);
 }
 
+TEST_F(BitrateAllocatorTest, NotifiesOnlyChangedAllocations) {
+  TestBitrateObserver observer1;
+  TestBitrateObserver observer2;
+  allocator_->SetMinAllocationChange(0);
+  allocator_->AddObserver(&observer1, 100000, 150000, 0, true);
+  allocator_->AddObserver(&observer2, 100000, 1000000, 0, true);
+  allocator_->OnNetworkChanged(300000, 0, 50, kDefaultProbingIntervalMs);
+  EXPECT_EQ(150000u, observer1.last_bitrate_bps_);
+  EXPECT_EQ(150000u, observer2.last_bitrate_bps_);
+  const int updates1 = observer1.num_updates_;
+  const int updates2 = observer2.num_updates_;
+
+  // Same estimate and network properties, no one is notified.
+  allocator_->OnNetworkChanged(300000, 0, 50, kDefaultProbingIntervalMs);
+  EXPECT_EQ(updates1, observer1.num_updates_);
+  EXPECT_EQ(updates2, observer2.num_updates_);
+
+  // |observer1| is already at its max, only |observer2| gets more.
+  allocator_->OnNetworkChanged(400000, 0, 50, kDefaultProbingIntervalMs);
+  EXPECT_EQ(updates1, observer1.num_updates_);
+  EXPECT_EQ(updates2 + 1, observer2.num_updates_);
+  EXPECT_EQ(250000u, observer2.last_bitrate_bps_);
+
+  // A change of rtt reaches everyone.
+  allocator_->OnNetworkChanged(400000, 0, 100, kDefaultProbingIntervalMs);
+  EXPECT_EQ(updates1 + 1, observer1.num_updates_);
+  EXPECT_EQ(updates2 + 2, observer2.num_updates_);
+  EXPECT_EQ(100, observer1.last_rtt_ms_);
+
+  allocator_->RemoveObserver(&observer1);
+  allocator_->RemoveObserver(&observer2);
+}
+
+TEST_F(BitrateAllocatorTest, HoldsBackSmallAllocationChanges) {
+  TestBitrateObserver observer;
+  allocator_->SetMinAllocationChange(10000);
+  allocator_->AddObserver(&observer, 100000, 1000000, 0, false);
+  allocator_->OnNetworkChanged(300000, 0, 50, kDefaultProbingIntervalMs);
+  EXPECT_EQ(300000u, observer.last_bitrate_bps_);
+
+  allocator_->OnNetworkChanged(305000, 0, 50, kDefaultProbingIntervalMs);
+  EXPECT_EQ(300000u, observer.last_bitrate_bps_);
+  allocator_->OnNetworkChanged(310001, 0, 50, kDefaultProbingIntervalMs);
+  EXPECT_EQ(310001u, observer.last_bitrate_bps_);
+
+  // Pausing is never held back.
+  allocator_->OnNetworkChanged(0, 0, 50, kDefaultProbingIntervalMs);
+  EXPECT_EQ(0u, observer.last_bitrate_bps_);
+
+  allocator_->RemoveObserver(&observer);
+}
+
 }  // namespace webrtc
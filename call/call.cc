@@ -20,11 +20,15 @@
 #include "webrtc/audio/audio_send_stream.h"
 #include "webrtc/audio/audio_state.h"
 #include "webrtc/audio/scoped_voe_interface.h"
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/optional.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/task_queue.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/base/thread_checker.h"
@@ -32,12 +36,14 @@
 #include "webrtc/call/bitrate_allocator.h"
 #include "webrtc/call/call.h"
 #include "webrtc/call/flexfec_receive_stream_impl.h"
+#include "webrtc/call/shared_transport_controller.h"
 #include "webrtc/config.h"
 #include "webrtc/logging/rtc_event_log/rtc_event_log.h"
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
 #include "webrtc/modules/congestion_controller/include/congestion_controller.h"
 #include "webrtc/modules/pacing/paced_sender.h"
 #include "webrtc/modules/rtp_rtcp/include/flexfec_receiver.h"
+#include "webrtc/modules/rtp_rtcp/include/rtcp_aggregator.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extension.h"
@@ -63,6 +69,17 @@ const int Call::Config::kDefaultStartBitrateBps = 300000;
 
 namespace internal {
 
+// An RTCP packet posted to the receive queues. Only the first queue on which a
+// stream accepts it logs it, unless a stream delivered to synchronously
+// already has.
+struct QueuedRtcpPacket {
+  QueuedRtcpPacket(const uint8_t* data, size_t length, bool logged)
+      : packet(data, length), logged(logged ? 1 : 0) {}
+
+  const rtc::CopyOnWriteBuffer packet;
+  volatile int logged;
+};
+
 class Call : public webrtc::Call,
              public PacketReceiver,
              public RecoveredPacketReceiver,
@@ -138,7 +155,8 @@ class Call : public webrtc::Call,
 
   // Implements BitrateAllocator::LimitObserver.
   void OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps,
-                                 uint32_t max_padding_bitrate_bps) override;
+                                 uint32_t max_padding_bitrate_bps,
+                                 uint32_t max_bitrate_bps) override;
 
  private:
   DeliveryStatus DeliverRtcp(MediaType media_type, const uint8_t* packet,
@@ -147,9 +165,52 @@ class Call : public webrtc::Call,
                             const uint8_t* packet,
                             size_t length,
                             const PacketTime& packet_time);
+  DeliveryStatus DeliverVideoRtp(VideoReceiveStream* receive_stream,
+                                 MediaType media_type,
+                                 const uint8_t* packet,
+                                 size_t length,
+                                 const PacketTime& packet_time)
+      SHARED_LOCKS_REQUIRED(receive_crit_);
+  DeliveryStatus DeliverFlexfecRtp(FlexfecReceiveStreamImpl* receive_stream,
+                                   MediaType media_type,
+                                   const uint8_t* packet,
+                                   size_t length,
+                                   const PacketTime& packet_time)
+      SHARED_LOCKS_REQUIRED(receive_crit_);
+
+  // Returns the queue packets of the video stream with media SSRC |ssrc| are
+  // processed on, or null if packets are processed synchronously.
+  rtc::TaskQueue* ReceiveQueueForSsrc(uint32_t ssrc) const;
+  void PostRtpToReceiveQueue(rtc::TaskQueue* queue,
+                             MediaType media_type,
+                             const uint8_t* packet,
+                             size_t length,
+                             const PacketTime& packet_time);
+  // Runs on |queue|. The streams are looked up again, since they may have
+  // been destroyed after the packet was posted.
+  void DeliverRtpOnReceiveQueue(MediaType media_type,
+                                const rtc::CopyOnWriteBuffer& packet,
+                                const PacketTime& packet_time);
+  // Posts |packet| to every queue with a video receive stream on it. Returns
+  // false if there is none.
+  bool PostRtcpToReceiveQueues(MediaType media_type,
+                               const uint8_t* packet,
+                               size_t length,
+                               bool logged);
+  void DeliverRtcpOnReceiveQueue(
+      rtc::TaskQueue* queue,
+      MediaType media_type,
+      const rtc::scoped_refptr<rtc::RefCountedObject<QueuedRtcpPacket>>&
+          rtcp);
+
   void ConfigureSync(const std::string& sync_group)
       EXCLUSIVE_LOCKS_REQUIRED(receive_crit_);
 
+  // Returns the aggregator for the RTCP sent on |transport|, creating it for
+  // the first stream, and releases it after the last stream is destroyed.
+  Transport* AddRtcpAggregatorStream(Transport* transport);
+  void RemoveRtcpAggregatorStream(Transport* aggregator);
+
   VoiceEngine* voice_engine() {
     internal::AudioState* audio_state =
         static_cast<internal::AudioState*>(config_.audio_state.get());
@@ -172,8 +233,11 @@ class Call : public webrtc::Call,
   Clock* const clock_;
 
   const int num_cpu_cores_;
-  const std::unique_ptr<ProcessThread> module_process_thread_;
+  SharedTransportController* const shared_transport_controller_;
+  // Only created when there is no |shared_transport_controller_|.
+  const std::unique_ptr<ProcessThread> owned_module_process_thread_;
   const std::unique_ptr<ProcessThread> pacer_thread_;
+  ProcessThread* const module_process_thread_;
   const std::unique_ptr<CallStats> call_stats_;
   const std::unique_ptr<BitrateAllocator> bitrate_allocator_;
   Call::Config config_;
@@ -182,6 +246,11 @@ class Call : public webrtc::Call,
   NetworkState audio_network_state_;
   NetworkState video_network_state_;
 
+  // Queues video receive streams are pinned to, if |num_receive_queues| is
+  // set in the config. Created at construction and never modified after, so
+  // they can be used without holding |receive_crit_|.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> receive_queues_;
+
   std::unique_ptr<RWLockWrapper> receive_crit_;
   // Audio, Video, and FlexFEC receive streams are owned by the client that
   // creates them.
@@ -210,6 +279,15 @@ class Call : public webrtc::Call,
   std::map<uint32_t, RtpHeaderExtensionMap> received_rtp_header_extensions_
       GUARDED_BY(receive_crit_);
 
+  // The aggregators combining the RTCP of the video receive streams sending
+  // on each transport, if |rtcp_aggregation_interval_ms| is set in the config.
+  // Only used on the configuration thread.
+  struct RtcpAggregatorRef {
+    std::unique_ptr<RtcpAggregator> aggregator;
+    int num_streams = 0;
+  };
+  std::map<Transport*, RtcpAggregatorRef> rtcp_aggregators_;
+
   std::unique_ptr<RWLockWrapper> send_crit_;
   // Audio and Video send streams are owned by the client that creates them.
   std::map<uint32_t, AudioSendStream*> audio_send_ssrcs_ GUARDED_BY(send_crit_);
@@ -233,16 +311,21 @@ class Call : public webrtc::Call,
   rtc::CriticalSection bitrate_crit_;
   uint32_t min_allocated_send_bitrate_bps_ GUARDED_BY(&bitrate_crit_);
   uint32_t configured_max_padding_bitrate_bps_ GUARDED_BY(&bitrate_crit_);
+  // The last estimate handed to |bitrate_allocator_|; the share of this Call
+  // with a |shared_transport_controller_|.
+  uint32_t last_target_bitrate_bps_ GUARDED_BY(&bitrate_crit_);
   AvgCounter estimated_send_bitrate_kbps_counter_ GUARDED_BY(&bitrate_crit_);
   AvgCounter pacer_bitrate_kbps_counter_ GUARDED_BY(&bitrate_crit_);
 
   std::map<std::string, rtc::NetworkRoute> network_routes_;
 
-  VieRemb remb_;
-  PacketRouter packet_router_;
-  // TODO(nisse): Could be a direct member, except for constness
-  // issues with GetRemoteBitrateEstimator (and maybe others).
-  const std::unique_ptr<CongestionController> congestion_controller_;
+  // Only created when there is no |shared_transport_controller_|.
+  const std::unique_ptr<VieRemb> owned_remb_;
+  const std::unique_ptr<PacketRouter> owned_packet_router_;
+  const std::unique_ptr<CongestionController> owned_congestion_controller_;
+  VieRemb* const remb_;
+  PacketRouter* const packet_router_;
+  CongestionController* const congestion_controller_;
   const std::unique_ptr<SendDelayStats> video_send_delay_stats_;
   const int64_t start_ms_;
   // TODO(perkj): |worker_queue_| is supposed to replace
@@ -276,8 +359,18 @@ namespace internal {
 Call::Call(const Call::Config& config)
     : clock_(Clock::GetRealTimeClock()),
       num_cpu_cores_(CpuInfo::DetectNumberOfCores()),
-      module_process_thread_(ProcessThread::Create("ModuleProcessThread")),
-      pacer_thread_(ProcessThread::Create("PacerThread")),
+      shared_transport_controller_(config.shared_transport_controller),
+      owned_module_process_thread_(
+          shared_transport_controller_
+              ? nullptr
+              : ProcessThread::Create("ModuleProcessThread")),
+      pacer_thread_(shared_transport_controller_
+                        ? nullptr
+                        : ProcessThread::Create("PacerThread")),
+      module_process_thread_(
+          shared_transport_controller_
+              ? shared_transport_controller_->module_process_thread()
+              : owned_module_process_thread_.get()),
       call_stats_(new CallStats(clock_)),
       bitrate_allocator_(new BitrateAllocator(this)),
       config_(config),
@@ -293,19 +386,35 @@ Call::Call(const Call::Config& config)
       received_rtcp_bytes_per_second_counter_(clock_, nullptr, true),
       min_allocated_send_bitrate_bps_(0),
       configured_max_padding_bitrate_bps_(0),
+      last_target_bitrate_bps_(0),
       estimated_send_bitrate_kbps_counter_(clock_, nullptr, true),
       pacer_bitrate_kbps_counter_(clock_, nullptr, true),
-      remb_(clock_),
-      congestion_controller_(new CongestionController(clock_,
-                                                      this,
-                                                      &remb_,
-                                                      event_log_,
-                                                      &packet_router_)),
+      owned_remb_(shared_transport_controller_ ? nullptr : new VieRemb(clock_)),
+      owned_packet_router_(shared_transport_controller_ ? nullptr
+                                                        : new PacketRouter()),
+      owned_congestion_controller_(
+          shared_transport_controller_
+              ? nullptr
+              : new CongestionController(clock_,
+                                         this,
+                                         owned_remb_.get(),
+                                         event_log_,
+                                         owned_packet_router_.get())),
+      remb_(shared_transport_controller_ ? shared_transport_controller_->remb()
+                                         : owned_remb_.get()),
+      packet_router_(shared_transport_controller_
+                         ? shared_transport_controller_->packet_router()
+                         : owned_packet_router_.get()),
+      congestion_controller_(
+          shared_transport_controller_
+              ? shared_transport_controller_->congestion_controller()
+              : owned_congestion_controller_.get()),
       video_send_delay_stats_(new SendDelayStats(clock_)),
       start_ms_(clock_->TimeInMilliseconds()),
       worker_queue_("call_worker_queue") {
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   RTC_DCHECK(config.event_log != nullptr);
+  RTC_DCHECK_GE(config.num_receive_queues, 0);
   RTC_DCHECK_GE(config.bitrate_config.min_bitrate_bps, 0);
   RTC_DCHECK_GE(config.bitrate_config.start_bitrate_bps,
                 config.bitrate_config.min_bitrate_bps);
@@ -314,7 +423,18 @@ Call::Call(const Call::Config& config)
                   config.bitrate_config.start_bitrate_bps);
   }
   Trace::CreateTrace();
-  call_stats_->RegisterStatsObserver(congestion_controller_.get());
+  for (int i = 0; i < config.num_receive_queues; ++i) {
+    receive_queues_.push_back(std::unique_ptr<rtc::TaskQueue>(
+        new rtc::TaskQueue("call_receive_queue")));
+  }
+  call_stats_->RegisterStatsObserver(congestion_controller_);
+
+  if (shared_transport_controller_) {
+    // The shared controller runs its own threads and bitrate configuration.
+    shared_transport_controller_->AddObserver(this);
+    module_process_thread_->RegisterModule(call_stats_.get());
+    return;
+  }
 
   congestion_controller_->SignalNetworkState(kNetworkDown);
   congestion_controller_->SetBweBitrates(
@@ -324,7 +444,7 @@ Call::Call(const Call::Config& config)
 
   module_process_thread_->Start();
   module_process_thread_->RegisterModule(call_stats_.get());
-  module_process_thread_->RegisterModule(congestion_controller_.get());
+  module_process_thread_->RegisterModule(congestion_controller_);
   pacer_thread_->RegisterModule(congestion_controller_->pacer());
   pacer_thread_->RegisterModule(
       congestion_controller_->GetRemoteBitrateEstimator(true));
@@ -332,7 +452,7 @@ Call::Call(const Call::Config& config)
 }
 
 Call::~Call() {
-  RTC_DCHECK(!remb_.InUse());
+  RTC_DCHECK(shared_transport_controller_ || !remb_->InUse());
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
 
   RTC_CHECK(audio_send_ssrcs_.empty());
@@ -342,14 +462,23 @@ Call::~Call() {
   RTC_CHECK(video_receive_ssrcs_.empty());
   RTC_CHECK(video_receive_streams_.empty());
 
-  pacer_thread_->Stop();
-  pacer_thread_->DeRegisterModule(congestion_controller_->pacer());
-  pacer_thread_->DeRegisterModule(
-      congestion_controller_->GetRemoteBitrateEstimator(true));
-  module_process_thread_->DeRegisterModule(congestion_controller_.get());
-  module_process_thread_->DeRegisterModule(call_stats_.get());
-  module_process_thread_->Stop();
-  call_stats_->DeregisterStatsObserver(congestion_controller_.get());
+  // Stop the receive queues before anything their pending tasks may touch is
+  // destroyed. With all streams gone, the tasks have nothing left to deliver.
+  receive_queues_.clear();
+
+  if (shared_transport_controller_) {
+    module_process_thread_->DeRegisterModule(call_stats_.get());
+    shared_transport_controller_->RemoveObserver(this);
+  } else {
+    pacer_thread_->Stop();
+    pacer_thread_->DeRegisterModule(congestion_controller_->pacer());
+    pacer_thread_->DeRegisterModule(
+        congestion_controller_->GetRemoteBitrateEstimator(true));
+    module_process_thread_->DeRegisterModule(congestion_controller_);
+    module_process_thread_->DeRegisterModule(call_stats_.get());
+    module_process_thread_->Stop();
+  }
+  call_stats_->DeregisterStatsObserver(congestion_controller_);
 
   // Only update histograms after process threads have been shut down, so that
   // they won't try to concurrently update stats.
@@ -467,8 +596,8 @@ webrtc::AudioSendStream* Call::CreateAudioSendStream(
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   event_log_->LogAudioSendStreamConfig(config);
   AudioSendStream* send_stream = new AudioSendStream(
-      config, config_.audio_state, &worker_queue_, &packet_router_,
-      congestion_controller_.get(), bitrate_allocator_.get(), event_log_,
+      config, config_.audio_state, &worker_queue_, packet_router_,
+      congestion_controller_, bitrate_allocator_.get(), event_log_,
       call_stats_->rtcp_rtt_stats());
   {
     WriteLockScoped write_lock(*send_crit_);
@@ -522,7 +651,7 @@ webrtc::AudioReceiveStream* Call::CreateAudioReceiveStream(
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   event_log_->LogAudioReceiveStreamConfig(config);
   AudioReceiveStream* receive_stream = new AudioReceiveStream(
-      &packet_router_,
+      packet_router_,
       // TODO(nisse): Used only when UseSendSideBwe(config) is true.
       congestion_controller_->GetRemoteBitrateEstimator(true), config,
       config_.audio_state, event_log_);
@@ -583,9 +712,9 @@ webrtc::VideoSendStream* Call::CreateVideoSendStream(
   // Copy ssrcs from |config| since |config| is moved.
   std::vector<uint32_t> ssrcs = config.rtp.ssrcs;
   VideoSendStream* send_stream = new VideoSendStream(
-      num_cpu_cores_, module_process_thread_.get(), &worker_queue_,
-      call_stats_.get(), congestion_controller_.get(), &packet_router_,
-      bitrate_allocator_.get(), video_send_delay_stats_.get(), &remb_,
+      num_cpu_cores_, module_process_thread_, &worker_queue_,
+      call_stats_.get(), congestion_controller_, packet_router_,
+      bitrate_allocator_.get(), video_send_delay_stats_.get(), remb_,
       event_log_, std::move(config), std::move(encoder_config),
       suspended_video_send_ssrcs_);
 
@@ -642,10 +771,15 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
     webrtc::VideoReceiveStream::Config configuration) {
   TRACE_EVENT0("webrtc", "Call::CreateVideoReceiveStream");
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
+  if (config_.rtcp_aggregation_interval_ms > 0 &&
+      configuration.rtcp_send_transport) {
+    configuration.rtcp_send_transport =
+        AddRtcpAggregatorStream(configuration.rtcp_send_transport);
+  }
   VideoReceiveStream* receive_stream = new VideoReceiveStream(
-      num_cpu_cores_, congestion_controller_.get(), &packet_router_,
-      std::move(configuration), voice_engine(), module_process_thread_.get(),
-      call_stats_.get(), &remb_);
+      num_cpu_cores_, congestion_controller_, packet_router_,
+      std::move(configuration), voice_engine(), module_process_thread_,
+      call_stats_.get(), remb_);
 
   const webrtc::VideoReceiveStream::Config& config = receive_stream->config();
   {
@@ -653,11 +787,16 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
     RTC_DCHECK(video_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
                video_receive_ssrcs_.end());
     video_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
+    RtpHeaderExtensionMap rtp_header_extensions(config.rtp.extensions);
+    received_rtp_header_extensions_[config.rtp.remote_ssrc] =
+        rtp_header_extensions;
     // TODO(pbos): Configure different RTX payloads per receive payload.
     VideoReceiveStream::Config::Rtp::RtxMap::const_iterator it =
         config.rtp.rtx.begin();
-    if (it != config.rtp.rtx.end())
+    if (it != config.rtp.rtx.end()) {
       video_receive_ssrcs_[it->second.ssrc] = receive_stream;
+      received_rtp_header_extensions_[it->second.ssrc] = rtp_header_extensions;
+    }
     video_receive_streams_.insert(receive_stream);
     ConfigureSync(config.sync_group);
   }
@@ -683,6 +822,7 @@ void Call::DestroyVideoReceiveStream(
         if (receive_stream_impl != nullptr)
           RTC_DCHECK(receive_stream_impl == it->second);
         receive_stream_impl = it->second;
+        received_rtp_header_extensions_.erase(it->first);
         video_receive_ssrcs_.erase(it++);
       } else {
         ++it;
@@ -693,7 +833,11 @@ void Call::DestroyVideoReceiveStream(
     ConfigureSync(receive_stream_impl->config().sync_group);
   }
   UpdateAggregateNetworkState();
+  Transport* const rtcp_send_transport =
+      receive_stream_impl->config().rtcp_send_transport;
   delete receive_stream_impl;
+  if (config_.rtcp_aggregation_interval_ms > 0 && rtcp_send_transport)
+    RemoveRtcpAggregatorStream(rtcp_send_transport);
 }
 
 FlexfecReceiveStream* Call::CreateFlexfecReceiveStream(
@@ -704,7 +848,7 @@ FlexfecReceiveStream* Call::CreateFlexfecReceiveStream(
   RecoveredPacketReceiver* recovered_packet_receiver = this;
   FlexfecReceiveStreamImpl* receive_stream = new FlexfecReceiveStreamImpl(
       config, recovered_packet_receiver, call_stats_->rtcp_rtt_stats(),
-      module_process_thread_.get());
+      module_process_thread_);
 
   {
     WriteLockScoped write_lock(*receive_crit_);
@@ -789,6 +933,10 @@ Call::Stats Call::GetStats() const {
   {
     rtc::CritScope cs(&bitrate_crit_);
     stats.max_padding_bitrate_bps = configured_max_padding_bitrate_bps_;
+    // The shared estimate is split between the Calls; report what this one
+    // may send.
+    if (shared_transport_controller_)
+      stats.send_bandwidth_bps = last_target_bitrate_bps_;
   }
   return stats;
 }
@@ -816,6 +964,11 @@ void Call::SetBitrateConfig(
   if (bitrate_config.start_bitrate_bps > 0)
     config_.bitrate_config.start_bitrate_bps = bitrate_config.start_bitrate_bps;
   config_.bitrate_config.max_bitrate_bps = bitrate_config.max_bitrate_bps;
+  if (shared_transport_controller_) {
+    LOG(LS_WARNING) << "Ignoring the bitrate config of a Call with a shared "
+                       "transport controller, whose bitrates apply instead.";
+    return;
+  }
   congestion_controller_->SetBweBitrates(bitrate_config.min_bitrate_bps,
                                          bitrate_config.start_bitrate_bps,
                                          bitrate_config.max_bitrate_bps);
@@ -904,6 +1057,13 @@ void Call::OnNetworkRouteChanged(const std::string& transport_name,
   }
   if (kv->second != network_route) {
     kv->second = network_route;
+    // The shared controller serves other Calls too, which keep their routes.
+    if (shared_transport_controller_) {
+      LOG(LS_WARNING) << "Network route changed on transport "
+                      << transport_name
+                      << ", not resetting the shared bandwidth estimate.";
+      return;
+    }
     LOG(LS_INFO) << "Network route changed on transport " << transport_name
                  << ": new local network id " << network_route.local_network_id
                  << " new remote network id " << network_route.remote_network_id
@@ -919,6 +1079,35 @@ void Call::OnNetworkRouteChanged(const std::string& transport_name,
   }
 }
 
+Transport* Call::AddRtcpAggregatorStream(Transport* transport) {
+  RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
+  RtcpAggregatorRef& ref = rtcp_aggregators_[transport];
+  if (!ref.aggregator) {
+    ref.aggregator.reset(new RtcpAggregator(
+        clock_, transport,
+        webrtc::VideoSendStream::Config::kDefaultMaxPacketSize,
+        config_.rtcp_aggregation_interval_ms));
+    module_process_thread_->RegisterModule(ref.aggregator.get());
+  }
+  ++ref.num_streams;
+  return ref.aggregator.get();
+}
+
+void Call::RemoveRtcpAggregatorStream(Transport* aggregator) {
+  RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
+  auto it = rtcp_aggregators_.begin();
+  while (it != rtcp_aggregators_.end() &&
+         it->second.aggregator.get() != aggregator) {
+    ++it;
+  }
+  RTC_DCHECK(it != rtcp_aggregators_.end());
+  if (it == rtcp_aggregators_.end() || --it->second.num_streams > 0)
+    return;
+  module_process_thread_->DeRegisterModule(it->second.aggregator.get());
+  // Sends the reports still pending.
+  rtcp_aggregators_.erase(it);
+}
+
 void Call::UpdateAggregateNetworkState() {
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
 
@@ -948,6 +1137,10 @@ void Call::UpdateAggregateNetworkState() {
   LOG(LS_INFO) << "UpdateAggregateNetworkState: aggregate_state="
                << (aggregate_state == kNetworkUp ? "up" : "down");
 
+  if (shared_transport_controller_) {
+    shared_transport_controller_->SignalNetworkState(this, aggregate_state);
+    return;
+  }
   congestion_controller_->SignalNetworkState(aggregate_state);
 }
 
@@ -976,6 +1169,10 @@ void Call::OnNetworkChanged(uint32_t target_bitrate_bps,
   RTC_DCHECK_RUN_ON(&worker_queue_);
   bitrate_allocator_->OnNetworkChanged(target_bitrate_bps, fraction_loss,
                                        rtt_ms, probing_interval_ms);
+  {
+    rtc::CritScope lock(&bitrate_crit_);
+    last_target_bitrate_bps_ = target_bitrate_bps;
+  }
 
   // Ignore updates if bitrate is zero (the aggregate network state is down).
   if (target_bitrate_bps == 0) {
@@ -1006,9 +1203,17 @@ void Call::OnNetworkChanged(uint32_t target_bitrate_bps,
 }
 
 void Call::OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps,
-                                     uint32_t max_padding_bitrate_bps) {
-  congestion_controller_->SetAllocatedSendBitrateLimits(
-      min_send_bitrate_bps, max_padding_bitrate_bps);
+                                     uint32_t max_padding_bitrate_bps,
+                                     uint32_t max_bitrate_bps) {
+  if (shared_transport_controller_) {
+    // The new share is handed out on the controller's task queue, and only
+    // reaches |bitrate_allocator_| by a task on |worker_queue_|.
+    shared_transport_controller_->SetAllocatedSendBitrateLimits(
+        this, min_send_bitrate_bps, max_padding_bitrate_bps, max_bitrate_bps);
+  } else {
+    congestion_controller_->SetAllocatedSendBitrateLimits(
+        min_send_bitrate_bps, max_padding_bitrate_bps);
+  }
   rtc::CritScope lock(&bitrate_crit_);
   min_allocated_send_bitrate_bps_ = min_send_bitrate_bps;
   configured_max_padding_bitrate_bps_ = max_padding_bitrate_bps;
@@ -1075,7 +1280,8 @@ PacketReceiver::DeliveryStatus Call::DeliverRtcp(MediaType media_type,
     received_rtcp_bytes_per_second_counter_.Add(static_cast<int>(length));
   }
   bool rtcp_delivered = false;
-  if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
+  if ((media_type == MediaType::ANY || media_type == MediaType::VIDEO) &&
+      receive_queues_.empty()) {
     ReadLockScoped read_lock(*receive_crit_);
     for (VideoReceiveStream* stream : video_receive_streams_) {
       if (stream->DeliverRtcp(packet, length))
@@ -1107,7 +1313,16 @@ PacketReceiver::DeliveryStatus Call::DeliverRtcp(MediaType media_type,
   if (rtcp_delivered)
     event_log_->LogRtcpPacket(kIncomingPacket, media_type, packet, length);
 
-  return rtcp_delivered ? DELIVERY_OK : DELIVERY_PACKET_ERROR;
+  // Video receive streams on the queues get the packet after this returns, so
+  // it is only logged there, once one of them has accepted it.
+  bool rtcp_posted = false;
+  if ((media_type == MediaType::ANY || media_type == MediaType::VIDEO) &&
+      !receive_queues_.empty()) {
+    rtcp_posted =
+        PostRtcpToReceiveQueues(media_type, packet, length, rtcp_delivered);
+  }
+
+  return rtcp_delivered || rtcp_posted ? DELIVERY_OK : DELIVERY_PACKET_ERROR;
 }
 
 PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
@@ -1139,45 +1354,188 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
     if (it != video_receive_ssrcs_.end()) {
       received_bytes_per_second_counter_.Add(static_cast<int>(length));
       received_video_bytes_per_second_counter_.Add(static_cast<int>(length));
-      // TODO(brandtr): Notify the BWE of received media packets here.
-      auto status = it->second->DeliverRtp(packet, length, packet_time)
-                        ? DELIVERY_OK
-                        : DELIVERY_PACKET_ERROR;
-      // Deliver media packets to FlexFEC subsystem. RTP header extensions need
-      // not be parsed, as FlexFEC is oblivious to the semantic meaning of the
-      // packet contents beyond the 12 byte RTP base header. The BWE is fed
-      // information about these media packets from the regular media pipeline.
-      rtc::Optional<RtpPacketReceived> parsed_packet =
-          ParseRtpPacket(packet, length, packet_time);
-      if (parsed_packet) {
-        auto it_bounds = flexfec_receive_ssrcs_media_.equal_range(ssrc);
-        for (auto it = it_bounds.first; it != it_bounds.second; ++it)
-          it->second->AddAndProcessReceivedPacket(*parsed_packet);
+      // RTX packets go to the queue of the media SSRC they retransmit.
+      rtc::TaskQueue* queue =
+          ReceiveQueueForSsrc(it->second->config().rtp.remote_ssrc);
+      if (queue) {
+        PostRtpToReceiveQueue(queue, media_type, packet, length, packet_time);
+        return DELIVERY_OK;
       }
-      if (status == DELIVERY_OK)
-        event_log_->LogRtpHeader(kIncomingPacket, media_type, packet, length);
-      return status;
+      return DeliverVideoRtp(it->second, media_type, packet, length,
+                             packet_time);
     }
   }
   if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
     auto it = flexfec_receive_ssrcs_protection_.find(ssrc);
     if (it != flexfec_receive_ssrcs_protection_.end()) {
-      rtc::Optional<RtpPacketReceived> parsed_packet =
-          ParseRtpPacket(packet, length, packet_time);
-      if (parsed_packet) {
-        NotifyBweOfReceivedPacket(*parsed_packet);
-        auto status = it->second->AddAndProcessReceivedPacket(*parsed_packet)
-                          ? DELIVERY_OK
-                          : DELIVERY_PACKET_ERROR;
-        if (status == DELIVERY_OK)
-          event_log_->LogRtpHeader(kIncomingPacket, media_type, packet, length);
-        return status;
+      // FlexFEC packets are processed with the media they protect, so that
+      // recovered packets reach the receive stream on its own queue.
+      const std::vector<uint32_t>& protected_ssrcs =
+          it->second->GetConfig().protected_media_ssrcs;
+      rtc::TaskQueue* queue = ReceiveQueueForSsrc(
+          protected_ssrcs.empty() ? ssrc : protected_ssrcs[0]);
+      if (queue) {
+        PostRtpToReceiveQueue(queue, media_type, packet, length, packet_time);
+        return DELIVERY_OK;
       }
+      return DeliverFlexfecRtp(it->second, media_type, packet, length,
+                               packet_time);
     }
   }
   return DELIVERY_UNKNOWN_SSRC;
 }
 
+PacketReceiver::DeliveryStatus Call::DeliverVideoRtp(
+    VideoReceiveStream* receive_stream,
+    MediaType media_type,
+    const uint8_t* packet,
+    size_t length,
+    const PacketTime& packet_time) {
+  // The packet is parsed once here, with the stream's header extensions
+  // identified, and the parsed packet is shared by the receive stream and
+  // FlexFEC instead of each of them parsing the raw bytes again.
+  rtc::Optional<RtpPacketReceived> parsed_packet =
+      ParseRtpPacket(packet, length, packet_time);
+  if (!parsed_packet) {
+    // rtp::Packet is stricter than the stream's own header parser, e.g. about
+    // a padding bit with no padding, so leave the decision to the stream.
+    auto status = receive_stream->DeliverRtp(packet, length, packet_time)
+                      ? DELIVERY_OK
+                      : DELIVERY_PACKET_ERROR;
+    if (status == DELIVERY_OK)
+      event_log_->LogRtpHeader(kIncomingPacket, media_type, packet, length);
+    return status;
+  }
+  // TODO(brandtr): Notify the BWE of received media packets here.
+  auto status = receive_stream->OnRtpPacket(*parsed_packet)
+                    ? DELIVERY_OK
+                    : DELIVERY_PACKET_ERROR;
+  // Deliver media packets to FlexFEC subsystem. FlexFEC is oblivious to
+  // the semantic meaning of the packet contents beyond the 12 byte RTP
+  // base header. The BWE is fed information about these media packets
+  // from the regular media pipeline.
+  auto it_bounds = flexfec_receive_ssrcs_media_.equal_range(
+      parsed_packet->Ssrc());
+  for (auto it = it_bounds.first; it != it_bounds.second; ++it)
+    it->second->AddAndProcessReceivedPacket(*parsed_packet);
+  if (status == DELIVERY_OK)
+    event_log_->LogRtpHeader(kIncomingPacket, media_type, packet, length);
+  return status;
+}
+
+PacketReceiver::DeliveryStatus Call::DeliverFlexfecRtp(
+    FlexfecReceiveStreamImpl* receive_stream,
+    MediaType media_type,
+    const uint8_t* packet,
+    size_t length,
+    const PacketTime& packet_time) {
+  rtc::Optional<RtpPacketReceived> parsed_packet =
+      ParseRtpPacket(packet, length, packet_time);
+  if (!parsed_packet)
+    return DELIVERY_UNKNOWN_SSRC;
+  NotifyBweOfReceivedPacket(*parsed_packet);
+  auto status = receive_stream->AddAndProcessReceivedPacket(*parsed_packet)
+                    ? DELIVERY_OK
+                    : DELIVERY_PACKET_ERROR;
+  if (status == DELIVERY_OK)
+    event_log_->LogRtpHeader(kIncomingPacket, media_type, packet, length);
+  return status;
+}
+
+rtc::TaskQueue* Call::ReceiveQueueForSsrc(uint32_t ssrc) const {
+  if (receive_queues_.empty())
+    return nullptr;
+  // SSRCs picked by the same sender are often consecutive; multiplicative
+  // hashing spreads them over the queues.
+  const uint32_t hash = ssrc * 0x9E3779B1u;
+  return receive_queues_[hash % receive_queues_.size()].get();
+}
+
+void Call::PostRtpToReceiveQueue(rtc::TaskQueue* queue,
+                                 MediaType media_type,
+                                 const uint8_t* packet,
+                                 size_t length,
+                                 const PacketTime& packet_time) {
+  rtc::CopyOnWriteBuffer buffer(packet, length);
+  queue->PostTask([this, media_type, buffer, packet_time]() {
+    DeliverRtpOnReceiveQueue(media_type, buffer, packet_time);
+  });
+}
+
+void Call::DeliverRtpOnReceiveQueue(MediaType media_type,
+                                    const rtc::CopyOnWriteBuffer& packet,
+                                    const PacketTime& packet_time) {
+  uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(&packet.cdata()[8]);
+  ReadLockScoped read_lock(*receive_crit_);
+  auto video_it = video_receive_ssrcs_.find(ssrc);
+  if (video_it != video_receive_ssrcs_.end()) {
+    DeliverVideoRtp(video_it->second, media_type, packet.cdata(),
+                    packet.size(), packet_time);
+    return;
+  }
+  auto flexfec_it = flexfec_receive_ssrcs_protection_.find(ssrc);
+  if (flexfec_it != flexfec_receive_ssrcs_protection_.end()) {
+    DeliverFlexfecRtp(flexfec_it->second, media_type, packet.cdata(),
+                      packet.size(), packet_time);
+  }
+}
+
+bool Call::PostRtcpToReceiveQueues(MediaType media_type,
+                                   const uint8_t* packet,
+                                   size_t length,
+                                   bool logged) {
+  // Compound packets can carry reports for any of the streams, so the packet
+  // goes to every queue that has a video receive stream on it, in order with
+  // the RTP packets already posted there.
+  std::vector<bool> has_streams(receive_queues_.size(), false);
+  {
+    ReadLockScoped read_lock(*receive_crit_);
+    for (VideoReceiveStream* stream : video_receive_streams_) {
+      rtc::TaskQueue* queue =
+          ReceiveQueueForSsrc(stream->config().rtp.remote_ssrc);
+      for (size_t i = 0; i < receive_queues_.size(); ++i) {
+        if (receive_queues_[i].get() == queue)
+          has_streams[i] = true;
+      }
+    }
+  }
+  rtc::scoped_refptr<rtc::RefCountedObject<QueuedRtcpPacket>> rtcp(
+      new rtc::RefCountedObject<QueuedRtcpPacket>(packet, length, logged));
+  bool posted = false;
+  for (size_t i = 0; i < receive_queues_.size(); ++i) {
+    if (!has_streams[i])
+      continue;
+    rtc::TaskQueue* queue = receive_queues_[i].get();
+    queue->PostTask([this, queue, media_type, rtcp]() {
+      DeliverRtcpOnReceiveQueue(queue, media_type, rtcp);
+    });
+    posted = true;
+  }
+  return posted;
+}
+
+void Call::DeliverRtcpOnReceiveQueue(
+    rtc::TaskQueue* queue,
+    MediaType media_type,
+    const rtc::scoped_refptr<rtc::RefCountedObject<QueuedRtcpPacket>>& rtcp) {
+  RTC_DCHECK(queue->IsCurrent());
+  bool rtcp_delivered = false;
+  {
+    ReadLockScoped read_lock(*receive_crit_);
+    for (VideoReceiveStream* stream : video_receive_streams_) {
+      if (ReceiveQueueForSsrc(stream->config().rtp.remote_ssrc) == queue &&
+          stream->DeliverRtcp(rtcp->packet.cdata(), rtcp->packet.size())) {
+        rtcp_delivered = true;
+      }
+    }
+  }
+  if (rtcp_delivered &&
+      rtc::AtomicOps::CompareAndSwap(&rtcp->logged, 0, 1) == 0) {
+    event_log_->LogRtcpPacket(kIncomingPacket, media_type,
+                              rtcp->packet.cdata(), rtcp->packet.size());
+  }
+}
+
 PacketReceiver::DeliveryStatus Call::DeliverPacket(
     MediaType media_type,
     const uint8_t* packet,
@@ -28,6 +28,7 @@ namespace webrtc {
 
 class AudioProcessing;
 class RtcEventLog;
+class SharedTransportController;
 
 const char* Version();
 
@@ -86,6 +87,28 @@ class Call {
     // RtcEventLog to use for this call. Required.
     // Use webrtc::RtcEventLog::CreateNull() for a null implementation.
     RtcEventLog* event_log = nullptr;
+
+    // Number of task queues incoming video RTP and RTCP is processed on. With
+    // the default of 0, packets are processed on the thread that calls
+    // DeliverPacket(). Otherwise each video receive stream, together with the
+    // FlexFEC streams protecting it, is pinned to one of the queues by its
+    // SSRC, so packets of a stream stay in order while different streams are
+    // processed in parallel. DeliverPacket() then returns DELIVERY_OK for
+    // video RTP packets with a known SSRC, and for RTCP packets posted to a
+    // queue with video receive streams, before they have been processed.
+    // Such packets are written to the event log once a stream accepts them.
+    int num_receive_queues = 0;
+
+    // Congestion control shared with other Calls to the same peer, see
+    // SharedTransportController. If null, the Call has its own pacer and
+    // bandwidth estimation.
+    SharedTransportController* shared_transport_controller = nullptr;
+
+    // If positive, the RTCP of the video receive streams sharing an
+    // |rtcp_send_transport|, as on a bundled transport, is combined by an
+    // RtcpAggregator. Their periodic reports then wait up to this long to be
+    // sent together, while feedback such as NACK and PLI is sent right away.
+    int rtcp_aggregation_interval_ms = 0;
   };
 
   struct Stats {
@@ -9,13 +9,30 @@
  */
 
 #include <list>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
+#include "webrtc/base/arraysize.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/call/audio_state.h"
 #include "webrtc/call/call.h"
+#include "webrtc/call/shared_transport_controller.h"
+#include "webrtc/logging/rtc_event_log/mock/mock_rtc_event_log.h"
 #include "webrtc/logging/rtc_event_log/rtc_event_log.h"
 #include "webrtc/modules/audio_coding/codecs/mock/mock_audio_decoder_factory.h"
 #include "webrtc/modules/audio_mixer/audio_mixer_impl.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/test/fake_decoder.h"
+#include "webrtc/test/fake_videorenderer.h"
+#include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
 #include "webrtc/test/mock_transport.h"
 #include "webrtc/test/mock_voice_engine.h"
@@ -294,4 +311,313 @@ TEST(CallTest, MultipleFlexfecReceiveStreamsProtectingSingleVideoStream) {
   }
 }
 
+namespace {
+constexpr int kNumReceiveQueues = 4;
+constexpr uint8_t kVideoPayloadType = 100;
+constexpr int64_t kQueuedDeliveryTimeoutMs = 10000;
+
+// Creates started video receive streams on a Call with receive queues, and
+// records the packets it logs, which it does once a stream has accepted them.
+class QueuedReceiveCallTest : public ::testing::Test {
+ protected:
+  QueuedReceiveCallTest() {
+    ON_CALL(event_log_, LogRtpHeader(testing::_, testing::_, testing::_,
+                                     testing::_))
+        .WillByDefault(
+            testing::Invoke(this, &QueuedReceiveCallTest::OnRtpLogged));
+    ON_CALL(event_log_, LogRtcpPacket(testing::_, testing::_, testing::_,
+                                      testing::_))
+        .WillByDefault(
+            testing::Invoke(this, &QueuedReceiveCallTest::OnRtcpLogged));
+    Call::Config config(&event_log_);
+    config.num_receive_queues = kNumReceiveQueues;
+    call_.reset(Call::Create(config));
+  }
+
+  ~QueuedReceiveCallTest() override {
+    for (const auto& kv : streams_)
+      DestroyStream(kv.second);
+  }
+
+  VideoReceiveStream* CreateStream(uint32_t remote_ssrc) {
+    decoders_.emplace_back(new test::FakeDecoder());
+    VideoReceiveStream::Decoder decoder;
+    decoder.decoder = decoders_.back().get();
+    decoder.payload_type = kVideoPayloadType;
+    decoder.payload_name = "FAKE";
+    VideoReceiveStream::Config config(&rtcp_send_transport_);
+    config.rtp.remote_ssrc = remote_ssrc;
+    config.rtp.local_ssrc = 1;
+    config.renderer = &renderer_;
+    config.decoders.push_back(decoder);
+    VideoReceiveStream* stream =
+        call_->CreateVideoReceiveStream(std::move(config));
+    stream->Start();
+    streams_[remote_ssrc] = stream;
+    return stream;
+  }
+
+  void DestroyStream(VideoReceiveStream* stream) {
+    stream->Stop();
+    call_->DestroyVideoReceiveStream(stream);
+  }
+
+  // A generic video packet, which is a key frame of its own.
+  PacketReceiver::DeliveryStatus DeliverRtp(uint32_t ssrc, uint16_t seq) {
+    uint8_t packet[14] = {0x80, kVideoPayloadType};
+    ByteWriter<uint16_t>::WriteBigEndian(&packet[2], seq);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet[4], seq * 3000u);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet[8], ssrc);
+    packet[12] = 0x03;  // Key frame, first packet.
+    packet[13] = static_cast<uint8_t>(seq);
+    return call_->Receiver()->DeliverPacket(MediaType::VIDEO, packet,
+                                            sizeof(packet), PacketTime());
+  }
+
+  // Waits until |done| returns true, which it is called for under the lock
+  // the logged packets are recorded with.
+  template <typename Predicate>
+  bool WaitUntil(Predicate done) {
+    const int64_t deadline_ms = rtc::TimeMillis() + kQueuedDeliveryTimeoutMs;
+    while (rtc::TimeMillis() < deadline_ms) {
+      {
+        rtc::CritScope lock(&crit_);
+        if (done())
+          return true;
+      }
+      SleepMs(5);
+    }
+    return false;
+  }
+
+  void OnRtpLogged(PacketDirection direction,
+                   MediaType media_type,
+                   const uint8_t* header,
+                   size_t packet_length) {
+    rtc::CritScope lock(&crit_);
+    logged_seqs_[ByteReader<uint32_t>::ReadBigEndian(&header[8])].push_back(
+        ByteReader<uint16_t>::ReadBigEndian(&header[2]));
+    ++num_logged_rtp_;
+  }
+
+  void OnRtcpLogged(PacketDirection direction,
+                    MediaType media_type,
+                    const uint8_t* packet,
+                    size_t length) {
+    rtc::CritScope lock(&crit_);
+    ++num_logged_rtcp_;
+  }
+
+  testing::NiceMock<MockRtcEventLog> event_log_;
+  testing::NiceMock<MockTransport> rtcp_send_transport_;
+  test::FakeVideoRenderer renderer_;
+  std::vector<std::unique_ptr<test::FakeDecoder>> decoders_;
+  std::unique_ptr<Call> call_;
+  std::map<uint32_t, VideoReceiveStream*> streams_;
+
+  rtc::CriticalSection crit_;
+  // The sequence numbers of the RTP packets logged for each SSRC.
+  std::map<uint32_t, std::vector<uint16_t>> logged_seqs_ GUARDED_BY(crit_);
+  size_t num_logged_rtp_ GUARDED_BY(crit_) = 0;
+  int num_logged_rtcp_ GUARDED_BY(crit_) = 0;
+};
+
+const uint32_t kQueuedSsrcs[] = {1001, 1002, 1003, 1004, 1005, 1006, 1007,
+                                 1008};
+}  // namespace
+
+TEST_F(QueuedReceiveCallTest, KeepsPacketsOfEachStreamInOrder) {
+  constexpr uint16_t kNumPackets = 500;
+  for (uint32_t ssrc : kQueuedSsrcs)
+    CreateStream(ssrc);
+
+  // Interleaved, as from a bundled transport, so that streams on the same
+  // queue have their packets posted alternately.
+  for (uint16_t seq = 0; seq < kNumPackets; ++seq) {
+    for (uint32_t ssrc : kQueuedSsrcs)
+      EXPECT_EQ(PacketReceiver::DELIVERY_OK, DeliverRtp(ssrc, seq));
+  }
+  const size_t kNumStreams = arraysize(kQueuedSsrcs);
+  ASSERT_TRUE(WaitUntil([this, kNumStreams]() {
+    return num_logged_rtp_ == kNumStreams * kNumPackets;
+  }));
+
+  rtc::CritScope lock(&crit_);
+  for (uint32_t ssrc : kQueuedSsrcs) {
+    const std::vector<uint16_t>& seqs = logged_seqs_[ssrc];
+    ASSERT_EQ(kNumPackets, seqs.size()) << "SSRC " << ssrc;
+    for (uint16_t seq = 0; seq < kNumPackets; ++seq)
+      ASSERT_EQ(seq, seqs[seq]) << "SSRC " << ssrc;
+  }
+}
+
+TEST_F(QueuedReceiveCallTest, RtcpReachesStreamsOnEveryQueue) {
+  rtcp::Sdes sdes;
+  for (uint32_t ssrc : kQueuedSsrcs) {
+    CreateStream(ssrc);
+    sdes.AddCName(ssrc, "cname" + std::to_string(ssrc));
+  }
+  rtc::Buffer packet = sdes.Build();
+
+  EXPECT_EQ(PacketReceiver::DELIVERY_OK,
+            call_->Receiver()->DeliverPacket(MediaType::VIDEO, packet.data(),
+                                             packet.size(), PacketTime()));
+  // Each stream only takes the CNAME of its own remote SSRC, so every one of
+  // them has to get the packet, whichever queue it is on.
+  for (uint32_t ssrc : kQueuedSsrcs) {
+    const std::string cname = "cname" + std::to_string(ssrc);
+    VideoReceiveStream* stream = streams_[ssrc];
+    EXPECT_TRUE(WaitUntil(
+        [stream, &cname]() { return stream->GetStats().c_name == cname; }))
+        << "SSRC " << ssrc;
+  }
+
+  // Stopping the queues completes the tasks delivering the packet. The
+  // packet is logged once, although it went to several queues.
+  for (const auto& kv : streams_)
+    DestroyStream(kv.second);
+  streams_.clear();
+  call_.reset();
+  rtc::CritScope lock(&crit_);
+  EXPECT_EQ(1, num_logged_rtcp_);
+}
+
+TEST_F(QueuedReceiveCallTest, RtcpIsNotLoggedUnlessAStreamAcceptsIt) {
+  VideoReceiveStream* stream = CreateStream(kQueuedSsrcs[0]);
+  // A stopped stream rejects RTCP, after DeliverPacket() has returned.
+  stream->Stop();
+  rtcp::Sdes sdes;
+  sdes.AddCName(kQueuedSsrcs[0], "cname");
+  rtc::Buffer packet = sdes.Build();
+  EXPECT_EQ(PacketReceiver::DELIVERY_OK,
+            call_->Receiver()->DeliverPacket(MediaType::VIDEO, packet.data(),
+                                             packet.size(), PacketTime()));
+
+  DestroyStream(stream);
+  streams_.clear();
+  call_.reset();
+  rtc::CritScope lock(&crit_);
+  EXPECT_EQ(0, num_logged_rtcp_);
+}
+
+TEST_F(QueuedReceiveCallTest, DestroysStreamWithPacketsPending) {
+  constexpr uint16_t kNumPackets = 1000;
+  const uint32_t kDestroyedSsrc = kQueuedSsrcs[0];
+  const uint32_t kRemainingSsrc = kQueuedSsrcs[1];
+  VideoReceiveStream* destroyed = CreateStream(kDestroyedSsrc);
+  CreateStream(kRemainingSsrc);
+  for (uint16_t seq = 0; seq < kNumPackets; ++seq) {
+    EXPECT_EQ(PacketReceiver::DELIVERY_OK, DeliverRtp(kDestroyedSsrc, seq));
+    EXPECT_EQ(PacketReceiver::DELIVERY_OK, DeliverRtp(kRemainingSsrc, seq));
+  }
+
+  // The tasks still queued for the destroyed stream find it gone and drop
+  // their packets.
+  DestroyStream(destroyed);
+  streams_.erase(kDestroyedSsrc);
+  EXPECT_EQ(PacketReceiver::DELIVERY_UNKNOWN_SSRC,
+            DeliverRtp(kDestroyedSsrc, kNumPackets));
+
+  ASSERT_TRUE(WaitUntil([this, kRemainingSsrc]() {
+    return logged_seqs_[kRemainingSsrc].size() == kNumPackets;
+  }));
+  rtc::CritScope lock(&crit_);
+  const std::vector<uint16_t>& seqs = logged_seqs_[kDestroyedSsrc];
+  EXPECT_LE(seqs.size(), kNumPackets);
+  for (size_t i = 0; i < seqs.size(); ++i)
+    EXPECT_EQ(i, seqs[i]);
+}
+
+// The receiver reports of video receive streams sharing a transport wait in
+// one RtcpAggregator, which sends them once the last stream is destroyed.
+TEST(CallTest, VideoReceiveStreamsOnOneTransportShareRtcpAggregator) {
+  RtcEventLogNullImpl event_log;
+  Call::Config call_config(&event_log);
+  // Longer than the test, so that nothing is sent until the end.
+  call_config.rtcp_aggregation_interval_ms = 60000;
+  std::unique_ptr<Call> call(Call::Create(call_config));
+  call->SignalChannelNetworkState(MediaType::VIDEO, kNetworkUp);
+
+  rtc::CriticalSection crit;
+  std::vector<std::vector<uint8_t>> sent;
+  testing::NiceMock<MockTransport> transport;
+  ON_CALL(transport, SendRtcp(testing::_, testing::_))
+      .WillByDefault(testing::Invoke([&](const uint8_t* data, size_t length) {
+        rtc::CritScope lock(&crit);
+        sent.emplace_back(data, data + length);
+        return true;
+      }));
+
+  test::FakeDecoder fake_decoder;
+  const uint32_t kLocalSsrcs[] = {1111, 2222};
+  std::vector<VideoReceiveStream*> streams;
+  for (uint32_t local_ssrc : kLocalSsrcs) {
+    VideoReceiveStream::Decoder decoder;
+    decoder.decoder = &fake_decoder;
+    decoder.payload_type = kVideoPayloadType;
+    decoder.payload_name = "FAKE";
+    VideoReceiveStream::Config config(&transport);
+    config.rtp.remote_ssrc = local_ssrc + 1;
+    config.rtp.local_ssrc = local_ssrc;
+    config.decoders.push_back(decoder);
+    streams.push_back(call->CreateVideoReceiveStream(std::move(config)));
+  }
+
+  // Each stream sends its first receiver report after 500 ms.
+  SleepMs(1000);
+  call->DestroyVideoReceiveStream(streams[0]);
+  {
+    rtc::CritScope lock(&crit);
+    EXPECT_TRUE(sent.empty());
+  }
+  call->DestroyVideoReceiveStream(streams[1]);
+
+  rtc::CritScope lock(&crit);
+  ASSERT_EQ(1u, sent.size());
+  std::set<uint32_t> reporting_ssrcs;
+  const uint8_t* next = sent[0].data();
+  const uint8_t* const end = sent[0].data() + sent[0].size();
+  while (next != end) {
+    rtcp::CommonHeader header;
+    ASSERT_TRUE(header.Parse(next, end - next));
+    rtcp::ReceiverReport rr;
+    if (header.type() == rtcp::ReceiverReport::kPacketType &&
+        rr.Parse(header)) {
+      reporting_ssrcs.insert(rr.sender_ssrc());
+    }
+    next = header.NextPacket();
+  }
+  EXPECT_EQ(std::set<uint32_t>(std::begin(kLocalSsrcs), std::end(kLocalSsrcs)),
+            reporting_ssrcs);
+}
+
+// Two Calls sharing a transport controller each get, and report, their share
+// of the shared estimate.
+TEST(CallTest, CallsSplitSharedEstimate) {
+  constexpr int kEstimateBps = 600000;
+  RtcEventLogNullImpl event_log;
+  SharedTransportController controller(&event_log,
+                                       Call::Config::BitrateConfig());
+  Call::Config config(&event_log);
+  config.shared_transport_controller = &controller;
+  std::unique_ptr<Call> call1(Call::Create(config));
+  std::unique_ptr<Call> call2(Call::Create(config));
+
+  // Per-Call bitrate configs don't apply to the shared estimate.
+  Call::Config::BitrateConfig bitrate_config;
+  bitrate_config.max_bitrate_bps = kEstimateBps / 10;
+  call1->SetBitrateConfig(bitrate_config);
+
+  // Without streams, neither Call has a max to cap its share at.
+  controller.OnNetworkChanged(kEstimateBps, 0, 50, 3000);
+  const int64_t deadline_ms = rtc::TimeMillis() + kQueuedDeliveryTimeoutMs;
+  while (rtc::TimeMillis() < deadline_ms &&
+         (call1->GetStats().send_bandwidth_bps != kEstimateBps / 2 ||
+          call2->GetStats().send_bandwidth_bps != kEstimateBps / 2)) {
+    SleepMs(5);
+  }
+  EXPECT_EQ(kEstimateBps / 2, call1->GetStats().send_bandwidth_bps);
+  EXPECT_EQ(kEstimateBps / 2, call2->GetStats().send_bandwidth_bps);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/timeutils.h"
+#include "webrtc/call/call.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log.h"
+#include "webrtc/media/base/videosinkinterface.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/test/fake_decoder.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/null_transport.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr uint32_t kFirstRemoteSsrc = 0x10000;
+constexpr uint32_t kLocalSsrc = 0x1;
+constexpr int kPayloadType = 96;
+constexpr size_t kPayloadSize = 1000;
+constexpr int kPacketsPerStream = 2000;
+constexpr int kTimeoutMs = 60000;
+
+class NullRenderer : public rtc::VideoSinkInterface<VideoFrame> {
+ public:
+  void OnFrame(const VideoFrame& frame) override {}
+};
+
+// Builds single packet key frames with the generic payload format, so that the
+// whole receive pipeline, up to the frame buffer, handles every packet.
+std::vector<uint8_t> BuildPacket(uint32_t ssrc, uint16_t seq_num) {
+  std::vector<uint8_t> packet(12 + 1 + kPayloadSize, 0);
+  packet[0] = 0x80;
+  packet[1] = 0x80 | kPayloadType;
+  ByteWriter<uint16_t>::WriteBigEndian(&packet[2], seq_num);
+  ByteWriter<uint32_t>::WriteBigEndian(&packet[4], seq_num * 3000u);
+  ByteWriter<uint32_t>::WriteBigEndian(&packet[8], ssrc);
+  // Generic header: key frame, first packet.
+  packet[12] = 0x01 | 0x02;
+  return packet;
+}
+
+int64_t ReceivedPackets(const std::vector<VideoReceiveStream*>& streams) {
+  int64_t packets = 0;
+  for (VideoReceiveStream* stream : streams)
+    packets += stream->GetStats().rtp_stats.transmitted.packets;
+  return packets;
+}
+
+void RunReceiveBenchmark(int num_streams, int num_receive_queues) {
+  RtcEventLogNullImpl event_log;
+  Call::Config call_config(&event_log);
+  call_config.num_receive_queues = num_receive_queues;
+  std::unique_ptr<Call> call(Call::Create(call_config));
+  call->SignalChannelNetworkState(MediaType::VIDEO, kNetworkUp);
+
+  test::NullTransport transport;
+  NullRenderer renderer;
+  std::vector<std::unique_ptr<test::FakeDecoder>> decoders;
+  std::vector<VideoReceiveStream*> streams;
+  for (int i = 0; i < num_streams; ++i) {
+    decoders.emplace_back(new test::FakeDecoder());
+    VideoReceiveStream::Config config(&transport);
+    config.rtp.remote_ssrc = kFirstRemoteSsrc + i;
+    config.rtp.local_ssrc = kLocalSsrc;
+    config.renderer = &renderer;
+    VideoReceiveStream::Decoder decoder;
+    decoder.decoder = decoders.back().get();
+    decoder.payload_type = kPayloadType;
+    decoder.payload_name = "FAKE";
+    config.decoders.push_back(decoder);
+    streams.push_back(call->CreateVideoReceiveStream(std::move(config)));
+    streams.back()->Start();
+  }
+
+  // Packets are prepared up front and delivered round robin over the streams,
+  // the way a bundled transport interleaves them.
+  std::vector<std::vector<uint8_t>> packets;
+  for (int seq_num = 0; seq_num < kPacketsPerStream; ++seq_num) {
+    for (int i = 0; i < num_streams; ++i)
+      packets.push_back(BuildPacket(kFirstRemoteSsrc + i, seq_num));
+  }
+
+  PacketReceiver* receiver = call->Receiver();
+  const int64_t start_ns = rtc::TimeNanos();
+  for (const auto& packet : packets) {
+    receiver->DeliverPacket(MediaType::VIDEO, packet.data(), packet.size(),
+                            PacketTime());
+  }
+  const int64_t timeout_ms = rtc::TimeMillis() + kTimeoutMs;
+  while (ReceivedPackets(streams) < static_cast<int64_t>(packets.size()) &&
+         rtc::TimeMillis() < timeout_ms) {
+    SleepMs(1);
+  }
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  EXPECT_EQ(static_cast<int64_t>(packets.size()), ReceivedPackets(streams));
+
+  for (VideoReceiveStream* stream : streams) {
+    stream->Stop();
+    call->DestroyVideoReceiveStream(stream);
+  }
+
+  const std::string trace = std::to_string(num_streams) + "_streams";
+  webrtc::test::PrintResult(
+      "call_receive_pipeline",
+      num_receive_queues == 0 ? "_sync"
+                              : "_" + std::to_string(num_receive_queues) +
+                                    "_queues",
+      trace, packets.size() * rtc::kNumNanosecsPerSec / elapsed_ns,
+      "packets/s", true);
+}
+
+class ReceivePipelinePerfTest : public ::testing::TestWithParam<int> {};
+}  // namespace
+
+TEST_P(ReceivePipelinePerfTest, Synchronous) {
+  RunReceiveBenchmark(GetParam(), 0);
+}
+
+TEST_P(ReceivePipelinePerfTest, QueuePerCore) {
+  RunReceiveBenchmark(GetParam(), CpuInfo::DetectNumberOfCores());
+}
+
+INSTANTIATE_TEST_CASE_P(StreamCount,
+                        ReceivePipelinePerfTest,
+                        ::testing::Values(8, 64, 256));
+
+}  // namespace webrtc
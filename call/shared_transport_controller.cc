@@ -0,0 +1,226 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/call/shared_transport_controller.h"
+
+#include <algorithm>
+#include <map>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/modules/utility/include/process_thread.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/video/vie_remb.h"
+
+namespace webrtc {
+
+SharedTransportController::SharedTransportController(
+    RtcEventLog* event_log,
+    const Call::Config::BitrateConfig& bitrate_config)
+    : clock_(Clock::GetRealTimeClock()),
+      remb_(new VieRemb(clock_)),
+      congestion_controller_(clock_,
+                             this,
+                             remb_.get(),
+                             event_log,
+                             &packet_router_),
+      module_process_thread_(
+          ProcessThread::Create("SharedModuleProcessThread")),
+      pacer_thread_(ProcessThread::Create("SharedPacerThread")),
+      last_bitrate_bps_(0),
+      last_fraction_loss_(0),
+      last_rtt_ms_(0),
+      last_probing_interval_ms_(0),
+      task_queue_("SharedTransportController") {
+  RTC_DCHECK(event_log);
+  congestion_controller_.SignalNetworkState(kNetworkDown);
+  congestion_controller_.SetBweBitrates(bitrate_config.min_bitrate_bps,
+                                        bitrate_config.start_bitrate_bps,
+                                        bitrate_config.max_bitrate_bps);
+
+  module_process_thread_->Start();
+  module_process_thread_->RegisterModule(&congestion_controller_);
+  pacer_thread_->RegisterModule(congestion_controller_.pacer());
+  pacer_thread_->RegisterModule(
+      congestion_controller_.GetRemoteBitrateEstimator(true));
+  pacer_thread_->Start();
+}
+
+SharedTransportController::~SharedTransportController() {
+  RTC_DCHECK(!remb_->InUse());
+  pacer_thread_->Stop();
+  pacer_thread_->DeRegisterModule(congestion_controller_.pacer());
+  pacer_thread_->DeRegisterModule(
+      congestion_controller_.GetRemoteBitrateEstimator(true));
+  module_process_thread_->DeRegisterModule(&congestion_controller_);
+  module_process_thread_->Stop();
+}
+
+void SharedTransportController::AddObserver(
+    CongestionController::Observer* observer) {
+  task_queue_.PostTask([this, observer] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    RTC_DCHECK(FindObserver(observer) == observers_.end());
+    observers_.push_back(ObserverInfo(observer));
+    DistributeBitrate();
+  });
+}
+
+void SharedTransportController::RemoveObserver(
+    CongestionController::Observer* observer) {
+  RTC_DCHECK(!task_queue_.IsCurrent());
+  // Observers are only called on |task_queue_|, so once this task has run,
+  // |observer| won't be called again.
+  rtc::Event removed(false, false);
+  task_queue_.PostTask([this, observer, &removed] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    auto it = FindObserver(observer);
+    RTC_DCHECK(it != observers_.end());
+    observers_.erase(it);
+    UpdateCongestionController();
+    DistributeBitrate();
+    removed.Set();
+  });
+  removed.Wait(rtc::Event::kForever);
+}
+
+void SharedTransportController::SetAllocatedSendBitrateLimits(
+    CongestionController::Observer* observer,
+    uint32_t min_send_bitrate_bps,
+    uint32_t max_padding_bitrate_bps,
+    uint32_t max_bitrate_bps) {
+  task_queue_.PostTask([this, observer, min_send_bitrate_bps,
+                        max_padding_bitrate_bps, max_bitrate_bps] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    auto it = FindObserver(observer);
+    // Calls report their limits asynchronously, possibly after being removed.
+    if (it == observers_.end())
+      return;
+    it->min_send_bitrate_bps = min_send_bitrate_bps;
+    it->max_padding_bitrate_bps = max_padding_bitrate_bps;
+    it->max_bitrate_bps = max_bitrate_bps;
+    UpdateCongestionController();
+    DistributeBitrate();
+  });
+}
+
+void SharedTransportController::SignalNetworkState(
+    CongestionController::Observer* observer,
+    NetworkState state) {
+  task_queue_.PostTask([this, observer, state] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    auto it = FindObserver(observer);
+    RTC_DCHECK(it != observers_.end());
+    it->network_state = state;
+    UpdateCongestionController();
+  });
+}
+
+void SharedTransportController::OnNetworkChanged(uint32_t bitrate_bps,
+                                                 uint8_t fraction_loss,
+                                                 int64_t rtt_ms,
+                                                 int64_t probing_interval_ms) {
+  task_queue_.PostTask(
+      [this, bitrate_bps, fraction_loss, rtt_ms, probing_interval_ms] {
+        RTC_DCHECK_RUN_ON(&task_queue_);
+        last_bitrate_bps_ = bitrate_bps;
+        last_fraction_loss_ = fraction_loss;
+        last_rtt_ms_ = rtt_ms;
+        last_probing_interval_ms_ = probing_interval_ms;
+        DistributeBitrate();
+      });
+}
+
+std::vector<SharedTransportController::ObserverInfo>::iterator
+SharedTransportController::FindObserver(
+    CongestionController::Observer* observer) {
+  for (auto it = observers_.begin(); it != observers_.end(); ++it) {
+    if (it->observer == observer)
+      return it;
+  }
+  return observers_.end();
+}
+
+void SharedTransportController::UpdateCongestionController() {
+  uint32_t min_send_bitrate_bps = 0;
+  uint32_t max_padding_bitrate_bps = 0;
+  NetworkState network_state = kNetworkDown;
+  for (const ObserverInfo& info : observers_) {
+    min_send_bitrate_bps += info.min_send_bitrate_bps;
+    max_padding_bitrate_bps += info.max_padding_bitrate_bps;
+    if (info.network_state == kNetworkUp)
+      network_state = kNetworkUp;
+  }
+  congestion_controller_.SetAllocatedSendBitrateLimits(
+      min_send_bitrate_bps, max_padding_bitrate_bps);
+  // May call OnNetworkChanged(), which posts the new estimate.
+  congestion_controller_.SignalNetworkState(network_state);
+}
+
+void SharedTransportController::DistributeBitrate() {
+  if (observers_.empty())
+    return;
+  uint64_t sum_min_bitrates = 0;
+  uint64_t sum_max_bitrates = 0;
+  for (const ObserverInfo& info : observers_) {
+    sum_min_bitrates += info.min_send_bitrate_bps;
+    sum_max_bitrates +=
+        std::max(info.min_send_bitrate_bps, info.max_bitrate_bps);
+  }
+
+  std::vector<uint32_t> allocation(observers_.size());
+  if (last_bitrate_bps_ < sum_min_bitrates) {
+    // Everyone gets the same fraction of their minimum.
+    for (size_t i = 0; i < observers_.size(); ++i) {
+      allocation[i] = static_cast<uint32_t>(
+          static_cast<uint64_t>(observers_[i].min_send_bitrate_bps) *
+          last_bitrate_bps_ / sum_min_bitrates);
+    }
+  } else {
+    // Everyone gets their minimum and an even part of the rest up to their
+    // max. Observers with the least room are capped first, and what they
+    // can't use is split between those with more, as in BitrateAllocator.
+    std::multimap<uint32_t, size_t> observers_by_room;
+    for (size_t i = 0; i < observers_.size(); ++i) {
+      const ObserverInfo& info = observers_[i];
+      allocation[i] = info.min_send_bitrate_bps;
+      observers_by_room.insert(std::make_pair(
+          std::max(info.min_send_bitrate_bps, info.max_bitrate_bps) -
+              info.min_send_bitrate_bps,
+          i));
+    }
+    uint64_t remaining_bitrate = last_bitrate_bps_ - sum_min_bitrates;
+    size_t num_remaining = observers_by_room.size();
+    for (const auto& room_and_index : observers_by_room) {
+      const uint32_t extra_bitrate_bps = static_cast<uint32_t>(
+          std::min<uint64_t>(room_and_index.first,
+                             remaining_bitrate / num_remaining));
+      allocation[room_and_index.second] += extra_bitrate_bps;
+      remaining_bitrate -= extra_bitrate_bps;
+      --num_remaining;
+    }
+    // Above the sum of the max bitrates, the rest is split evenly.
+    if (last_bitrate_bps_ > sum_max_bitrates) {
+      for (uint32_t& bitrate_bps : allocation)
+        bitrate_bps += remaining_bitrate / observers_.size();
+    }
+  }
+
+  // Observers can't change |observers_| while they run, since that is done by
+  // tasks on |task_queue_|.
+  for (size_t i = 0; i < observers_.size(); ++i) {
+    observers_[i].observer->OnNetworkChanged(
+        allocation[i], last_fraction_loss_, last_rtt_ms_,
+        last_probing_interval_ms_);
+  }
+}
+
+}  // namespace webrtc
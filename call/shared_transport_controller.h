@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_CALL_SHARED_TRANSPORT_CONTROLLER_H_
+#define WEBRTC_CALL_SHARED_TRANSPORT_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/task_queue.h"
+#include "webrtc/base/thread_checker.h"
+#include "webrtc/call/call.h"
+#include "webrtc/modules/congestion_controller/include/congestion_controller.h"
+#include "webrtc/modules/pacing/packet_router.h"
+
+namespace webrtc {
+
+class Clock;
+class ProcessThread;
+class RtcEventLog;
+class VieRemb;
+
+// Congestion control shared by several Calls that send to the same peer over
+// one uplink: one pacer queue, one bandwidth estimate, and the process and
+// pacer threads, instead of one of each per Call. The estimate is split
+// between the attached Calls like BitrateAllocator splits it between streams:
+// each Call gets the min send bitrate its streams require and an even share of
+// the rest, capped at the sum of its streams' max bitrates, with what a capped
+// Call can't use going to the others. Above the sum of the max bitrates, the
+// rest is split evenly. Each Call then allocates its share to its own streams.
+//
+// The attached Calls share one transport-wide sequence number space and one
+// receive-side estimate, so they must all be connected to the same remote
+// peer. Per-Call bitrate configurations and network route changes are
+// ignored, with a warning; the bitrates given here apply to all.
+//
+// Observers are notified on a task queue of the controller, in order and
+// without holding a lock, so they may call back into the controller.
+// Pass to Call::Config::shared_transport_controller. Must outlive the Calls
+// attached to it.
+class SharedTransportController : public CongestionController::Observer {
+ public:
+  SharedTransportController(
+      RtcEventLog* event_log,
+      const Call::Config::BitrateConfig& bitrate_config);
+  ~SharedTransportController() override;
+
+  // The following are used by the attached Calls.
+  CongestionController* congestion_controller() {
+    return &congestion_controller_;
+  }
+  PacketRouter* packet_router() { return &packet_router_; }
+  VieRemb* remb() { return remb_.get(); }
+  ProcessThread* module_process_thread() {
+    return module_process_thread_.get();
+  }
+
+  // |observer| gets its share of the estimate until removed. Once
+  // RemoveObserver() returns, |observer| is not called again. It must not be
+  // called from an observer.
+  void AddObserver(CongestionController::Observer* observer);
+  void RemoveObserver(CongestionController::Observer* observer);
+  // Sets what the streams of |observer| require and can use; see
+  // CongestionController::SetAllocatedSendBitrateLimits. The share of
+  // |observer| is capped at |max_bitrate_bps| while others can use the rest.
+  void SetAllocatedSendBitrateLimits(CongestionController::Observer* observer,
+                                     uint32_t min_send_bitrate_bps,
+                                     uint32_t max_padding_bitrate_bps,
+                                     uint32_t max_bitrate_bps);
+  // The network is up while it is up for any of the observers.
+  void SignalNetworkState(CongestionController::Observer* observer,
+                          NetworkState state);
+
+  // Implements CongestionController::Observer.
+  void OnNetworkChanged(uint32_t bitrate_bps,
+                        uint8_t fraction_loss,
+                        int64_t rtt_ms,
+                        int64_t probing_interval_ms) override;
+
+ private:
+  struct ObserverInfo {
+    explicit ObserverInfo(CongestionController::Observer* observer)
+        : observer(observer) {}
+
+    CongestionController::Observer* observer;
+    uint32_t min_send_bitrate_bps = 0;
+    uint32_t max_padding_bitrate_bps = 0;
+    uint32_t max_bitrate_bps = 0;
+    NetworkState network_state = kNetworkDown;
+  };
+
+  std::vector<ObserverInfo>::iterator FindObserver(
+      CongestionController::Observer* observer) RUN_ON(&task_queue_);
+  // Applies the summed limits and network state of the observers.
+  void UpdateCongestionController() RUN_ON(&task_queue_);
+  // Splits the last estimate between the observers and notifies them.
+  void DistributeBitrate() RUN_ON(&task_queue_);
+
+  Clock* const clock_;
+  const std::unique_ptr<VieRemb> remb_;
+  PacketRouter packet_router_;
+  CongestionController congestion_controller_;
+  const std::unique_ptr<ProcessThread> module_process_thread_;
+  const std::unique_ptr<ProcessThread> pacer_thread_;
+
+  std::vector<ObserverInfo> observers_ ACCESS_ON(&task_queue_);
+  uint32_t last_bitrate_bps_ ACCESS_ON(&task_queue_);
+  uint8_t last_fraction_loss_ ACCESS_ON(&task_queue_);
+  int64_t last_rtt_ms_ ACCESS_ON(&task_queue_);
+  int64_t last_probing_interval_ms_ ACCESS_ON(&task_queue_);
+
+  // Declared last, so that it is destroyed, with the tasks it still holds,
+  // before anything they use.
+  rtc::TaskQueue task_queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedTransportController);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_CALL_SHARED_TRANSPORT_CONTROLLER_H_
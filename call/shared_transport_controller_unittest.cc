@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/call/shared_transport_controller.h"
+
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/logging/rtc_event_log/rtc_event_log.h"
+#include "webrtc/test/gmock.h"
+#include "webrtc/test/gtest.h"
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::AtLeast;
+using ::testing::InvokeWithoutArgs;
+using ::testing::NiceMock;
+
+namespace webrtc {
+namespace {
+constexpr int64_t kRttMs = 50;
+constexpr int64_t kProbingIntervalMs = 3000;
+constexpr int kTimeoutMs = 5000;
+
+class MockObserver : public CongestionController::Observer {
+ public:
+  MOCK_METHOD4(OnNetworkChanged,
+               void(uint32_t bitrate_bps,
+                    uint8_t fraction_loss,
+                    int64_t rtt_ms,
+                    int64_t probing_interval_ms));
+};
+
+// Observers are notified on the controller's task queue, so the tests wait
+// for the shares they expect.
+class SharedTransportControllerTest : public ::testing::Test {
+ protected:
+  SharedTransportControllerTest()
+      : controller_(&event_log_, Call::Config::BitrateConfig()) {
+    // Each change is distributed, which is only checked where expected.
+    EXPECT_CALL(observer1_, OnNetworkChanged(_, _, _, _)).Times(AnyNumber());
+    EXPECT_CALL(observer2_, OnNetworkChanged(_, _, _, _)).Times(AnyNumber());
+    controller_.AddObserver(&observer1_);
+    controller_.AddObserver(&observer2_);
+  }
+  ~SharedTransportControllerTest() override {
+    controller_.RemoveObserver(&observer1_);
+    controller_.RemoveObserver(&observer2_);
+  }
+
+  // Sets |event| whenever |observer| gets |bitrate_bps| with |fraction_loss|.
+  void ExpectShare(MockObserver* observer,
+                   uint32_t bitrate_bps,
+                   uint8_t fraction_loss,
+                   rtc::Event* event) {
+    EXPECT_CALL(*observer, OnNetworkChanged(bitrate_bps, fraction_loss,
+                                            kRttMs, _))
+        .Times(AtLeast(1))
+        .WillRepeatedly(InvokeWithoutArgs([event] { event->Set(); }));
+  }
+
+  RtcEventLogNullImpl event_log_;
+  // Outlive the observers being removed, which may match expectations again.
+  rtc::Event done1_{false, false};
+  rtc::Event done2_{false, false};
+  NiceMock<MockObserver> observer1_;
+  NiceMock<MockObserver> observer2_;
+  SharedTransportController controller_;
+};
+}  // namespace
+
+TEST_F(SharedTransportControllerTest, SplitsEstimateAboveMinBitrates) {
+  controller_.SetAllocatedSendBitrateLimits(&observer1_, 100000, 0, 2000000);
+  controller_.SetAllocatedSendBitrateLimits(&observer2_, 300000, 0, 2000000);
+
+  ExpectShare(&observer1_, 350000, 10, &done1_);
+  ExpectShare(&observer2_, 550000, 10, &done2_);
+  controller_.OnNetworkChanged(900000, 10, kRttMs, kProbingIntervalMs);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+}
+
+TEST_F(SharedTransportControllerTest, ScalesMinBitratesBelowTheirSum) {
+  controller_.SetAllocatedSendBitrateLimits(&observer1_, 100000, 0, 2000000);
+  controller_.SetAllocatedSendBitrateLimits(&observer2_, 300000, 0, 2000000);
+
+  ExpectShare(&observer1_, 50000, 0, &done1_);
+  ExpectShare(&observer2_, 150000, 0, &done2_);
+  controller_.OnNetworkChanged(200000, 0, kRttMs, kProbingIntervalMs);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+}
+
+// What a Call can't use goes to the others, as BitrateAllocator does with
+// streams.
+TEST_F(SharedTransportControllerTest, CapsSharesAtMaxBitrates) {
+  controller_.SetAllocatedSendBitrateLimits(&observer1_, 100000, 0, 200000);
+  controller_.SetAllocatedSendBitrateLimits(&observer2_, 100000, 0, 2000000);
+
+  ExpectShare(&observer1_, 200000, 0, &done1_);
+  ExpectShare(&observer2_, 700000, 0, &done2_);
+  controller_.OnNetworkChanged(900000, 0, kRttMs, kProbingIntervalMs);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+}
+
+TEST_F(SharedTransportControllerTest, SplitsWhatIsLeftAboveMaxBitrates) {
+  controller_.SetAllocatedSendBitrateLimits(&observer1_, 100000, 0, 200000);
+  controller_.SetAllocatedSendBitrateLimits(&observer2_, 100000, 0, 300000);
+
+  ExpectShare(&observer1_, 400000, 0, &done1_);
+  ExpectShare(&observer2_, 500000, 0, &done2_);
+  controller_.OnNetworkChanged(900000, 0, kRttMs, kProbingIntervalMs);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+}
+
+TEST_F(SharedTransportControllerTest, RedistributesWhenObserverLeaves) {
+  ExpectShare(&observer1_, 300000, 0, &done1_);
+  ExpectShare(&observer2_, 300000, 0, &done2_);
+  controller_.OnNetworkChanged(600000, 0, kRttMs, kProbingIntervalMs);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+
+  NiceMock<MockObserver> observer3;
+  rtc::Event done3(false, false);
+  ExpectShare(&observer1_, 200000, 0, &done1_);
+  ExpectShare(&observer2_, 200000, 0, &done2_);
+  ExpectShare(&observer3, 200000, 0, &done3);
+  controller_.AddObserver(&observer3);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done3.Wait(kTimeoutMs));
+
+  ExpectShare(&observer1_, 300000, 0, &done1_);
+  ExpectShare(&observer2_, 300000, 0, &done2_);
+  controller_.RemoveObserver(&observer3);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+}
+
+TEST_F(SharedTransportControllerTest, ZeroEstimateReachesEveryone) {
+  controller_.SetAllocatedSendBitrateLimits(&observer1_, 100000, 0, 2000000);
+  controller_.SetAllocatedSendBitrateLimits(&observer2_, 100000, 0, 2000000);
+  ExpectShare(&observer1_, 300000, 0, &done1_);
+  ExpectShare(&observer2_, 300000, 0, &done2_);
+  controller_.OnNetworkChanged(600000, 0, kRttMs, kProbingIntervalMs);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+
+  ExpectShare(&observer1_, 0, 0, &done1_);
+  ExpectShare(&observer2_, 0, 0, &done2_);
+  controller_.OnNetworkChanged(0, 0, kRttMs, kProbingIntervalMs);
+  EXPECT_TRUE(done1_.Wait(kTimeoutMs));
+  EXPECT_TRUE(done2_.Wait(kTimeoutMs));
+}
+
+// Observers are not called with a lock held which other threads using the
+// controller need.
+TEST_F(SharedTransportControllerTest, OtherThreadsAreNotBlockedByObservers) {
+  struct Reporter {
+    static bool Run(void* obj) {
+      Reporter* reporter = static_cast<Reporter*>(obj);
+      reporter->start.Wait(rtc::Event::kForever);
+      reporter->controller->SetAllocatedSendBitrateLimits(
+          reporter->observer, 100000, 0, 2000000);
+      reporter->done.Set();
+      return false;
+    }
+    SharedTransportController* controller;
+    CongestionController::Observer* observer;
+    rtc::Event start{false, false};
+    rtc::Event done{false, false};
+  } reporter{&controller_, &observer2_};
+  rtc::PlatformThread thread(&Reporter::Run, &reporter, "Reporter");
+  thread.Start();
+
+  rtc::Event done(false, false);
+  EXPECT_CALL(observer1_, OnNetworkChanged(600000, 0, kRttMs, _))
+      .WillOnce(InvokeWithoutArgs([&] {
+        reporter.start.Set();
+        EXPECT_TRUE(reporter.done.Wait(kTimeoutMs));
+        done.Set();
+      }));
+  controller_.OnNetworkChanged(1200000, 0, kRttMs, kProbingIntervalMs);
+  EXPECT_TRUE(done.Wait(kTimeoutMs));
+  thread.Stop();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/resampler/multi_stream_sinc_resampler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/common_audio/include/audio_util.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+
+namespace {
+
+const size_t kKernelSize = SincResampler::kKernelSize;
+const size_t kKernelOffsetCount = SincResampler::kKernelOffsetCount;
+const size_t kAlignment = 32;
+
+inline float ReadSample(float sample) {
+  return sample;
+}
+
+inline float ReadSample(int16_t sample) {
+  return static_cast<float>(sample);
+}
+
+inline void WriteSample(float sample, float* destination) {
+  *destination = sample;
+}
+
+inline void WriteSample(float sample, int16_t* destination) {
+  *destination = FloatS16ToS16(sample);
+}
+
+float* AllocateFloats(size_t size) {
+  return static_cast<float*>(AlignedMalloc(sizeof(float) * size, kAlignment));
+}
+
+}  // namespace
+
+const size_t MultiStreamSincResampler::kLanes;
+
+MultiStreamSincResampler::MultiStreamSincResampler(size_t num_streams,
+                                                   size_t source_frames,
+                                                   size_t destination_frames)
+    : num_streams_(num_streams),
+      num_groups_((num_streams + kLanes - 1) / kLanes),
+      io_sample_rate_ratio_(source_frames * 1.0 / destination_frames),
+      request_frames_(source_frames),
+      destination_frames_(destination_frames),
+      input_buffer_size_(request_frames_ + kKernelSize),
+      kernel_storage_(AllocateFloats(SincResampler::kKernelStorageSize)),
+      input_buffers_(
+          AllocateFloats(num_groups_ * input_buffer_size_ * kLanes)),
+      output_buffer_(AllocateFloats(destination_frames_ * kLanes)),
+      convolve_proc_(Convolve_C),
+      first_pass_(true) {
+  RTC_DCHECK_GT(num_streams_, 0);
+  RTC_DCHECK_GT(request_frames_, 0);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2))
+    convolve_proc_ = Convolve_AVX2;
+  else if (WebRtc_GetCPUInfo(kSSE2))
+    convolve_proc_ = Convolve_SSE;
+#endif
+  std::unique_ptr<float[]> pre_sinc(
+      new float[SincResampler::kKernelStorageSize]);
+  std::unique_ptr<float[]> window(
+      new float[SincResampler::kKernelStorageSize]);
+  SincResampler::InitializeKernel(io_sample_rate_ratio_, kernel_storage_.get(),
+                                  pre_sinc.get(), window.get());
+  // At most the outputs of one block are convolved at once.
+  taps_.reserve(
+      static_cast<size_t>(ceil(input_buffer_size_ / io_sample_rate_ratio_)));
+  Flush();
+  RTC_DCHECK_GT(block_size_, kKernelSize);
+}
+
+MultiStreamSincResampler::~MultiStreamSincResampler() {}
+
+size_t MultiStreamSincResampler::Resample(const int16_t* const* sources,
+                                          size_t source_frames,
+                                          int16_t* const* destinations,
+                                          size_t destination_capacity) {
+  RTC_CHECK_EQ(source_frames, request_frames_);
+  RTC_CHECK_GE(destination_capacity, destination_frames_);
+  return ResampleStreams(sources, destinations);
+}
+
+size_t MultiStreamSincResampler::Resample(const float* const* sources,
+                                          size_t source_frames,
+                                          float* const* destinations,
+                                          size_t destination_capacity) {
+  RTC_CHECK_EQ(source_frames, request_frames_);
+  RTC_CHECK_GE(destination_capacity, destination_frames_);
+  return ResampleStreams(sources, destinations);
+}
+
+template <typename T>
+size_t MultiStreamSincResampler::ResampleStreams(const T* const* sources,
+                                                 T* const* destinations) {
+  // Like PushSincResampler, the first call consumes a block of zeros, so that
+  // the sources are read exactly once per call with half a kernel of delay.
+  // The outputs of that pass are discarded, so they aren't computed.
+  if (first_pass_) {
+    ResampleFrames<T>(static_cast<size_t>(block_size_ / io_sample_rate_ratio_),
+                      nullptr, nullptr);
+  }
+  ResampleFrames(destination_frames_, sources, destinations);
+  return destination_frames_;
+}
+
+template <typename T>
+void MultiStreamSincResampler::ResampleFrames(size_t frames,
+                                              const T* const* sources,
+                                              T* const* destinations) {
+  size_t remaining_frames = frames;
+  size_t offset = 0;
+  bool sources_read = false;
+
+  if (!buffer_primed_ && remaining_frames) {
+    ReadSources(sources);
+    sources_read = true;
+    buffer_primed_ = true;
+  }
+
+  while (remaining_frames) {
+    // The same positions as SincResampler::Resample() computes for each
+    // output, collected for all streams.
+    taps_.clear();
+    for (int i = static_cast<int>(
+             ceil((block_size_ - virtual_source_idx_) / io_sample_rate_ratio_));
+         i > 0 && remaining_frames; --i, --remaining_frames) {
+      RTC_DCHECK_LT(virtual_source_idx_, block_size_);
+      const size_t source_idx = static_cast<size_t>(virtual_source_idx_);
+      const double virtual_offset_idx =
+          (virtual_source_idx_ - source_idx) * kKernelOffsetCount;
+      const size_t offset_idx = static_cast<size_t>(virtual_offset_idx);
+      taps_.push_back({source_idx, offset_idx,
+                       virtual_offset_idx - offset_idx});
+      virtual_source_idx_ += io_sample_rate_ratio_;
+    }
+
+    if (destinations) {
+      ConvolveTaps(destinations, offset);
+      offset += taps_.size();
+    }
+    if (!remaining_frames)
+      return;
+
+    // Wrap back around to the start, copying r3 and r4 to r1 and r2 in every
+    // group.
+    virtual_source_idx_ -= block_size_;
+    for (size_t group = 0; group < num_groups_; ++group) {
+      memcpy(group_input(group), group_input(group) + (r3_ * kLanes),
+             sizeof(float) * kKernelSize * kLanes);
+    }
+    if (r0_ == kKernelSize / 2)
+      UpdateRegions(true);
+
+    // PushSincResampler only provides input once per call.
+    RTC_CHECK(!sources_read);
+    ReadSources(sources);
+    sources_read = true;
+  }
+}
+
+template <typename T>
+void MultiStreamSincResampler::ConvolveTaps(T* const* destinations,
+                                            size_t offset) {
+  float* const output = output_buffer_.get();
+  for (size_t group = 0; group < num_groups_; ++group) {
+    convolve_proc_(group_input(group), kernel_storage_.get(), taps_.data(),
+                   taps_.size(), output);
+    const size_t first_stream = group * kLanes;
+    const size_t num_lanes = std::min(kLanes, num_streams_ - first_stream);
+    for (size_t lane = 0; lane < num_lanes; ++lane) {
+      T* const destination = destinations[first_stream + lane] + offset;
+      for (size_t i = 0; i < taps_.size(); ++i)
+        WriteSample(output[i * kLanes + lane], &destination[i]);
+    }
+  }
+}
+
+template <typename T>
+void MultiStreamSincResampler::ReadSources(const T* const* sources) {
+  if (first_pass_) {
+    for (size_t group = 0; group < num_groups_; ++group) {
+      memset(group_input(group) + r0_ * kLanes, 0,
+             sizeof(float) * request_frames_ * kLanes);
+    }
+    first_pass_ = false;
+    return;
+  }
+
+  RTC_DCHECK(sources);
+  for (size_t stream = 0; stream < num_streams_; ++stream) {
+    float* const input =
+        group_input(stream / kLanes) + r0_ * kLanes + stream % kLanes;
+    const T* const source = sources[stream];
+    for (size_t i = 0; i < request_frames_; ++i)
+      input[i * kLanes] = ReadSample(source[i]);
+  }
+}
+
+void MultiStreamSincResampler::UpdateRegions(bool second_load) {
+  // See SincResampler::UpdateRegions().
+  r0_ = second_load ? kKernelSize : kKernelSize / 2;
+  r3_ = r0_ + request_frames_ - kKernelSize;
+  r4_ = r0_ + request_frames_ - kKernelSize / 2;
+  block_size_ = r4_ - kKernelSize / 2;
+  RTC_DCHECK_LT(kKernelSize / 2, r3_);
+}
+
+void MultiStreamSincResampler::Flush() {
+  virtual_source_idx_ = 0;
+  buffer_primed_ = false;
+  // The lanes past the last stream stay zero.
+  memset(input_buffers_.get(), 0,
+         sizeof(float) * num_groups_ * input_buffer_size_ * kLanes);
+  UpdateRegions(false);
+}
+
+void MultiStreamSincResampler::Convolve_C(const float* input,
+                                          const float* kernels,
+                                          const Tap* taps,
+                                          size_t num_taps,
+                                          float* output) {
+  for (size_t t = 0; t < num_taps; ++t) {
+    const float* input_ptr = input + taps[t].source_idx * kLanes;
+    const float* k1 = kernels + taps[t].offset_idx * kKernelSize;
+    const float* k2 = k1 + kKernelSize;
+    float sum1[kLanes] = {0};
+    float sum2[kLanes] = {0};
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      for (size_t lane = 0; lane < kLanes; ++lane) {
+        sum1[lane] += input_ptr[lane] * k1[i];
+        sum2[lane] += input_ptr[lane] * k2[i];
+      }
+      input_ptr += kLanes;
+    }
+    const double factor = taps[t].kernel_interpolation_factor;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      output[t * kLanes + lane] = static_cast<float>(
+          (1.0 - factor) * sum1[lane] + factor * sum2[lane]);
+    }
+  }
+}
+
+}  // namespace webrtc
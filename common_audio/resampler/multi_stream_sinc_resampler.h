@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_RESAMPLER_MULTI_STREAM_SINC_RESAMPLER_H_
+#define WEBRTC_COMMON_AUDIO_RESAMPLER_MULTI_STREAM_SINC_RESAMPLER_H_
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/gtest_prod_util.h"
+#include "webrtc/common_audio/resampler/sinc_resampler.h"
+#include "webrtc/system_wrappers/include/aligned_malloc.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Resamples any number of mono streams with the same source and destination
+// rates in one pass, with the same push interface and output as one
+// PushSincResampler per stream.
+//
+// All streams share one set of kernels, and the sub-sample positions of the
+// outputs, which only depend on the rates, are computed once per call. The
+// streams are kept in groups of kLanes interleaved sample by sample, so that
+// each output of a group is a convolution of whole vectors of kLanes streams
+// with a broadcast kernel tap. The sums are taken in the same order as
+// SincResampler::Convolve_C(), and are bit-exact with it on every platform.
+// With much fewer than kLanes streams most of each vector is padding, and a
+// PushSincResampler per stream is faster.
+class MultiStreamSincResampler {
+ public:
+  // Number of streams in a group.
+  static const size_t kLanes = 8;
+
+  // Provide the number of streams, and the size of the source and destination
+  // blocks in samples per stream. The blocks must correspond to the same time
+  // duration (typically 10 ms) as the sample ratio is inferred from them.
+  MultiStreamSincResampler(size_t num_streams,
+                           size_t source_frames,
+                           size_t destination_frames);
+  ~MultiStreamSincResampler();
+
+  // Resamples |source_frames| samples of each stream, |sources[i]| into
+  // |destinations[i]|. |source_frames| must always equal the |source_frames|
+  // provided at construction, and |destination_capacity| must be at least
+  // |destination_frames|. Returns the number of samples provided in each
+  // destination.
+  size_t Resample(const int16_t* const* sources,
+                  size_t source_frames,
+                  int16_t* const* destinations,
+                  size_t destination_capacity);
+  size_t Resample(const float* const* sources,
+                  size_t source_frames,
+                  float* const* destinations,
+                  size_t destination_capacity);
+
+  size_t num_streams() const { return num_streams_; }
+
+ private:
+  FRIEND_TEST_ALL_PREFIXES(MultiStreamSincResamplerTest, ConvolveMatchesC);
+
+  // One output of every stream of a group: the kernels and the position on
+  // the input buffer, which SincResampler::Resample() computes per output.
+  struct Tap {
+    // First input frame under the kernel.
+    size_t source_idx;
+    // The kernels |offset_idx| and |offset_idx| + 1 straddle the position.
+    size_t offset_idx;
+    double kernel_interpolation_factor;
+  };
+
+  // Writes the kLanes outputs of each of |num_taps| taps to |output|, from the
+  // interleaved |input| of one group. |input| and |output| are 32-byte
+  // aligned. On x86 the implementation is chosen at run time.
+  typedef void (*ConvolveProc)(const float* input,
+                               const float* kernels,
+                               const Tap* taps,
+                               size_t num_taps,
+                               float* output);
+  static void Convolve_C(const float* input,
+                         const float* kernels,
+                         const Tap* taps,
+                         size_t num_taps,
+                         float* output);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void Convolve_SSE(const float* input,
+                           const float* kernels,
+                           const Tap* taps,
+                           size_t num_taps,
+                           float* output);
+  static void Convolve_AVX2(const float* input,
+                            const float* kernels,
+                            const Tap* taps,
+                            size_t num_taps,
+                            float* output);
+#endif
+
+  template <typename T>
+  size_t ResampleStreams(const T* const* sources,
+                         T* const* destinations);
+  // Runs SincResampler::Resample() for |frames| outputs. Without
+  // |destinations| only the input is consumed, as for the priming pass.
+  template <typename T>
+  void ResampleFrames(size_t frames,
+                      const T* const* sources,
+                      T* const* destinations);
+  // Convolves all groups over |taps_| and writes the outputs from position
+  // |offset| of the destinations.
+  template <typename T>
+  void ConvolveTaps(T* const* destinations, size_t offset);
+  // Implements SincResamplerCallback::Run() of PushSincResampler: fills
+  // region r0 of every group with the sources, or with zeros on the first
+  // pass.
+  template <typename T>
+  void ReadSources(const T* const* sources);
+
+  void UpdateRegions(bool second_load);
+  void Flush();
+
+  float* group_input(size_t group) {
+    return input_buffers_.get() + group * input_buffer_size_ * kLanes;
+  }
+
+  const size_t num_streams_;
+  const size_t num_groups_;
+  const double io_sample_rate_ratio_;
+  const size_t request_frames_;
+  const size_t destination_frames_;
+  const size_t input_buffer_size_;
+
+  // As in SincResampler, kernel_storage_ holds kKernelOffsetCount + 1 kernels
+  // of kKernelSize taps.
+  std::unique_ptr<float[], AlignedFreeDeleter> kernel_storage_;
+  // |num_groups_| buffers of |input_buffer_size_| frames of kLanes samples.
+  std::unique_ptr<float[], AlignedFreeDeleter> input_buffers_;
+  // The outputs of one group, kLanes samples per frame.
+  std::unique_ptr<float[], AlignedFreeDeleter> output_buffer_;
+  // The taps of the outputs between two reads of the sources.
+  std::vector<Tap> taps_;
+
+  ConvolveProc convolve_proc_;
+
+  // The state of the SincResampler of each stream, see sinc_resampler.cc.
+  // The regions are offsets in frames from the start of the buffers; r1 is at
+  // 0 and r2 at kKernelSize / 2.
+  double virtual_source_idx_;
+  bool buffer_primed_;
+  size_t r0_;
+  size_t r3_;
+  size_t r4_;
+  size_t block_size_;
+
+  // True until the first call to Resample(), which primes the buffers with the
+  // same delay as PushSincResampler.
+  bool first_pass_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MultiStreamSincResampler);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_RESAMPLER_MULTI_STREAM_SINC_RESAMPLER_H_
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/resampler/multi_stream_sinc_resampler.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+namespace {
+
+const size_t kKernelSize = SincResampler::kKernelSize;
+
+// Stores (1 - factor) * sums1 + factor * sums2, computed in double precision
+// as SincResampler::Convolve_C() interpolates.
+inline void InterpolateAndStore(__m256 sums1,
+                                __m256 sums2,
+                                double factor,
+                                float* output) {
+  const __m256d weight1 = _mm256_set1_pd(1.0 - factor);
+  const __m256d weight2 = _mm256_set1_pd(factor);
+  const __m256d low = _mm256_add_pd(
+      _mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(sums1)), weight1),
+      _mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(sums2)), weight2));
+  const __m256d high = _mm256_add_pd(
+      _mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(sums1, 1)), weight1),
+      _mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(sums2, 1)),
+                    weight2));
+  _mm256_store_ps(output, _mm256_insertf128_ps(
+                              _mm256_castps128_ps256(_mm256_cvtpd_ps(low)),
+                              _mm256_cvtpd_ps(high), 1));
+}
+
+}  // namespace
+
+// The eight lanes are one vector. Products and sums are kept separate, without
+// FMA, to stay bit-exact with the C version. Since every sum is a chain of
+// kKernelSize dependent additions, four outputs are computed at once to hide
+// the latency of the additions.
+void MultiStreamSincResampler::Convolve_AVX2(const float* input,
+                                             const float* kernels,
+                                             const Tap* taps,
+                                             size_t num_taps,
+                                             float* output) {
+  static_assert(kLanes == 8, "One vector per frame");
+  size_t t = 0;
+  for (; t + 4 <= num_taps; t += 4) {
+    const float* input_ptr[4];
+    const float* k1[4];
+    __m256 sums1[4];
+    __m256 sums2[4];
+    for (int j = 0; j < 4; ++j) {
+      input_ptr[j] = input + taps[t + j].source_idx * kLanes;
+      k1[j] = kernels + taps[t + j].offset_idx * kKernelSize;
+      sums1[j] = _mm256_setzero_ps();
+      sums2[j] = _mm256_setzero_ps();
+    }
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        const __m256 samples = _mm256_load_ps(input_ptr[j] + i * kLanes);
+        sums1[j] = _mm256_add_ps(
+            sums1[j], _mm256_mul_ps(samples, _mm256_set1_ps(k1[j][i])));
+        sums2[j] = _mm256_add_ps(
+            sums2[j],
+            _mm256_mul_ps(samples, _mm256_set1_ps(k1[j][kKernelSize + i])));
+      }
+    }
+    for (int j = 0; j < 4; ++j) {
+      InterpolateAndStore(sums1[j], sums2[j],
+                          taps[t + j].kernel_interpolation_factor, output);
+      output += kLanes;
+    }
+  }
+
+  for (; t < num_taps; ++t) {
+    const float* input_ptr = input + taps[t].source_idx * kLanes;
+    const float* k1 = kernels + taps[t].offset_idx * kKernelSize;
+    const float* k2 = k1 + kKernelSize;
+    __m256 sums1 = _mm256_setzero_ps();
+    __m256 sums2 = _mm256_setzero_ps();
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      const __m256 samples = _mm256_load_ps(input_ptr + i * kLanes);
+      sums1 = _mm256_add_ps(sums1,
+                            _mm256_mul_ps(samples, _mm256_set1_ps(k1[i])));
+      sums2 = _mm256_add_ps(sums2,
+                            _mm256_mul_ps(samples, _mm256_set1_ps(k2[i])));
+    }
+    InterpolateAndStore(sums1, sums2, taps[t].kernel_interpolation_factor,
+                        output);
+    output += kLanes;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/common_audio/resampler/multi_stream_sinc_resampler.h"
+#include "webrtc/common_audio/resampler/push_sinc_resampler.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumChunks = 100;
+
+// Resamples 10 ms chunks of |num_streams| streams, with one PushSincResampler
+// per stream and with one MultiStreamSincResampler, and prints the time per
+// stream and chunk of each.
+void RunResampleBenchmark(int source_rate,
+                          int destination_rate,
+                          size_t num_streams) {
+  const size_t source_frames = source_rate / 100;
+  const size_t destination_frames = destination_rate / 100;
+  Random random(num_streams);
+  std::vector<std::vector<int16_t>> sources(
+      num_streams, std::vector<int16_t>(source_frames));
+  std::vector<std::vector<int16_t>> destinations(
+      num_streams, std::vector<int16_t>(destination_frames));
+  std::vector<const int16_t*> source_pointers;
+  std::vector<int16_t*> destination_pointers;
+  for (size_t i = 0; i < num_streams; ++i) {
+    for (int16_t& sample : sources[i])
+      sample = random.Rand<int16_t>();
+    source_pointers.push_back(sources[i].data());
+    destination_pointers.push_back(destinations[i].data());
+  }
+
+  std::vector<std::unique_ptr<PushSincResampler>> resamplers;
+  for (size_t i = 0; i < num_streams; ++i) {
+    resamplers.emplace_back(
+        new PushSincResampler(source_frames, destination_frames));
+  }
+  int64_t start_ns = rtc::TimeNanos();
+  for (int chunk = 0; chunk < kNumChunks; ++chunk) {
+    for (size_t i = 0; i < num_streams; ++i) {
+      resamplers[i]->Resample(source_pointers[i], source_frames,
+                              destination_pointers[i], destination_frames);
+    }
+  }
+  const int64_t per_stream_ns = rtc::TimeNanos() - start_ns;
+
+  MultiStreamSincResampler multi_stream_resampler(num_streams, source_frames,
+                                                  destination_frames);
+  start_ns = rtc::TimeNanos();
+  for (int chunk = 0; chunk < kNumChunks; ++chunk) {
+    multi_stream_resampler.Resample(source_pointers.data(), source_frames,
+                                    destination_pointers.data(),
+                                    destination_frames);
+  }
+  const int64_t multi_stream_ns = rtc::TimeNanos() - start_ns;
+
+  const std::string trace = "_" + std::to_string(source_rate / 1000) + "_to_" +
+                            std::to_string(destination_rate / 1000) + "khz_" +
+                            std::to_string(num_streams) + "_streams";
+  const double num_stream_chunks =
+      static_cast<double>(kNumChunks) * num_streams;
+  webrtc::test::PrintResult("resample_10ms", trace, "push_sinc_resampler",
+                            per_stream_ns / num_stream_chunks, "ns/stream",
+                            false);
+  webrtc::test::PrintResult("resample_10ms", trace,
+                            "multi_stream_sinc_resampler",
+                            multi_stream_ns / num_stream_chunks, "ns/stream",
+                            true);
+}
+}  // namespace
+
+TEST(MultiStreamSincResamplerPerformanceTest, Downsample48To16kHz) {
+  for (size_t num_streams : {1, 2, 8, 64, 256})
+    RunResampleBenchmark(48000, 16000, num_streams);
+}
+
+TEST(MultiStreamSincResamplerPerformanceTest, Upsample16To48kHz) {
+  for (size_t num_streams : {1, 8, 256})
+    RunResampleBenchmark(16000, 48000, num_streams);
+}
+
+TEST(MultiStreamSincResamplerPerformanceTest, Resample44To48kHz) {
+  for (size_t num_streams : {1, 8, 256})
+    RunResampleBenchmark(44100, 48000, num_streams);
+}
+
+}  // namespace webrtc
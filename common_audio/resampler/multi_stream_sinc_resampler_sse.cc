@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/resampler/multi_stream_sinc_resampler.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+
+namespace {
+
+// (1 - factor) * sums1 + factor * sums2 in double precision, as
+// SincResampler::Convolve_C() interpolates.
+inline __m128 Interpolate(__m128 sums1,
+                          __m128 sums2,
+                          __m128d weight1,
+                          __m128d weight2) {
+  const __m128d low = _mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(sums1), weight1),
+                                 _mm_mul_pd(_mm_cvtps_pd(sums2), weight2));
+  const __m128d high = _mm_add_pd(
+      _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(sums1, sums1)), weight1),
+      _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(sums2, sums2)), weight2));
+  return _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high));
+}
+
+}  // namespace
+
+// The eight lanes are two vectors; each tap of the kernels is broadcast over
+// them.
+void MultiStreamSincResampler::Convolve_SSE(const float* input,
+                                            const float* kernels,
+                                            const Tap* taps,
+                                            size_t num_taps,
+                                            float* output) {
+  static_assert(kLanes == 8, "Two vectors per frame");
+  for (size_t t = 0; t < num_taps; ++t) {
+    const float* input_ptr = input + taps[t].source_idx * kLanes;
+    const float* k1 = kernels + taps[t].offset_idx * SincResampler::kKernelSize;
+    const float* k2 = k1 + SincResampler::kKernelSize;
+    __m128 sums1_low = _mm_setzero_ps();
+    __m128 sums1_high = _mm_setzero_ps();
+    __m128 sums2_low = _mm_setzero_ps();
+    __m128 sums2_high = _mm_setzero_ps();
+    for (size_t i = 0; i < SincResampler::kKernelSize; ++i) {
+      const __m128 low = _mm_load_ps(input_ptr);
+      const __m128 high = _mm_load_ps(input_ptr + 4);
+      const __m128 tap1 = _mm_set1_ps(k1[i]);
+      const __m128 tap2 = _mm_set1_ps(k2[i]);
+      sums1_low = _mm_add_ps(sums1_low, _mm_mul_ps(low, tap1));
+      sums1_high = _mm_add_ps(sums1_high, _mm_mul_ps(high, tap1));
+      sums2_low = _mm_add_ps(sums2_low, _mm_mul_ps(low, tap2));
+      sums2_high = _mm_add_ps(sums2_high, _mm_mul_ps(high, tap2));
+      input_ptr += kLanes;
+    }
+    const double factor = taps[t].kernel_interpolation_factor;
+    const __m128d weight1 = _mm_set1_pd(1.0 - factor);
+    const __m128d weight2 = _mm_set1_pd(factor);
+    _mm_store_ps(output, Interpolate(sums1_low, sums2_low, weight1, weight2));
+    _mm_store_ps(output + 4,
+                 Interpolate(sums1_high, sums2_high, weight1, weight2));
+    output += kLanes;
+  }
+}
+
+}  // namespace webrtc
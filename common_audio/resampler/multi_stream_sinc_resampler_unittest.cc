@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/resampler/multi_stream_sinc_resampler.h"
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/common_audio/resampler/push_sinc_resampler.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/simd_kernels.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumChunks = 20;
+
+// Pointers to the channels of |streams|.
+template <typename T>
+std::vector<T*> Pointers(std::vector<std::vector<T>>* streams) {
+  std::vector<T*> pointers;
+  for (auto& stream : *streams)
+    pointers.push_back(stream.data());
+  return pointers;
+}
+
+// Resamples |num_streams| streams of noise, with different amplitudes, both
+// with a MultiStreamSincResampler and with one PushSincResampler per stream.
+// The two only differ by the order in which the SIMD versions of
+// SincResampler sum the products.
+template <typename T>
+void ResampleAndCompare(int source_rate,
+                        int destination_rate,
+                        size_t num_streams,
+                        float tolerance) {
+  const size_t source_frames = source_rate / 100;
+  const size_t destination_frames = destination_rate / 100;
+  MultiStreamSincResampler resampler(num_streams, source_frames,
+                                     destination_frames);
+  std::vector<std::unique_ptr<PushSincResampler>> references;
+  for (size_t i = 0; i < num_streams; ++i) {
+    references.emplace_back(
+        new PushSincResampler(source_frames, destination_frames));
+  }
+
+  Random random(source_rate + destination_rate + num_streams);
+  std::vector<std::vector<T>> sources(num_streams,
+                                      std::vector<T>(source_frames));
+  std::vector<std::vector<T>> destinations(num_streams,
+                                           std::vector<T>(destination_frames));
+  std::vector<T> expected(destination_frames);
+  for (int chunk = 0; chunk < kNumChunks; ++chunk) {
+    for (size_t i = 0; i < num_streams; ++i) {
+      const int amplitude = 32767 >> (i % 8);
+      for (T& sample : sources[i])
+        sample = static_cast<T>(random.Rand(-amplitude, amplitude));
+    }
+    const std::vector<T*> source_pointers = Pointers(&sources);
+    EXPECT_EQ(destination_frames,
+              resampler.Resample(source_pointers.data(), source_frames,
+                                 Pointers(&destinations).data(),
+                                 destination_frames));
+    for (size_t i = 0; i < num_streams; ++i) {
+      references[i]->Resample(sources[i].data(), source_frames,
+                              expected.data(), destination_frames);
+      for (size_t j = 0; j < destination_frames; ++j) {
+        ASSERT_NEAR(expected[j], destinations[i][j], tolerance)
+            << source_rate << " to " << destination_rate << " Hz, stream "
+            << i << " of " << num_streams << ", chunk " << chunk
+            << ", sample " << j;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(MultiStreamSincResamplerTest, FloatMatchesPushSincResampler) {
+  const int kRates[][2] = {{48000, 16000}, {16000, 48000}, {44100, 48000},
+                           {48000, 44100}, {32000, 16000}, {8000, 32000}};
+  for (const auto& rates : kRates) {
+    for (size_t num_streams : {1, 3, 8, 13}) {
+      ResampleAndCompare<float>(rates[0], rates[1], num_streams, 0.05f);
+    }
+  }
+}
+
+TEST(MultiStreamSincResamplerTest, Int16MatchesPushSincResampler) {
+  for (size_t num_streams : {1, 9, 24})
+    ResampleAndCompare<int16_t>(48000, 16000, num_streams, 1);
+}
+
+TEST(MultiStreamSincResamplerTest, ConvolveMatchesC) {
+  typedef MultiStreamSincResampler Resampler;
+  const size_t kInputFrames = 100;
+  // Not a multiple of the outputs some versions compute at once.
+  const size_t kNumTaps = 41;
+  std::unique_ptr<float[], AlignedFreeDeleter> input(static_cast<float*>(
+      AlignedMalloc(sizeof(float) * kInputFrames * Resampler::kLanes, 32)));
+  std::unique_ptr<float[], AlignedFreeDeleter> expected(static_cast<float*>(
+      AlignedMalloc(sizeof(float) * kNumTaps * Resampler::kLanes, 32)));
+  std::unique_ptr<float[], AlignedFreeDeleter> actual(static_cast<float*>(
+      AlignedMalloc(sizeof(float) * kNumTaps * Resampler::kLanes, 32)));
+  std::vector<float> kernels(SincResampler::kKernelStorageSize);
+  std::vector<float> pre_sinc(SincResampler::kKernelStorageSize);
+  std::vector<float> window(SincResampler::kKernelStorageSize);
+  SincResampler::InitializeKernel(48000.0 / 44100.0, kernels.data(),
+                                  pre_sinc.data(), window.data());
+
+  Random random(0xc0);
+  for (size_t i = 0; i < kInputFrames * Resampler::kLanes; ++i)
+    input[i] = random.Rand(-32768, 32767);
+  std::vector<Resampler::Tap> taps;
+  for (size_t i = 0; i < kNumTaps; ++i) {
+    taps.push_back(
+        {random.Rand(0u, static_cast<uint32_t>(kInputFrames -
+                                                SincResampler::kKernelSize)),
+         random.Rand(0u, static_cast<uint32_t>(
+                             SincResampler::kKernelOffsetCount - 1)),
+         random.Rand<double>()});
+  }
+  Resampler::Convolve_C(input.get(), kernels.data(), taps.data(), kNumTaps,
+                        expected.get());
+
+  for (const auto& simd : test::SupportedSimdKernels<Resampler::ConvolveProc>(
+           WEBRTC_X86_KERNEL(&Resampler::Convolve_SSE),
+           WEBRTC_X86_KERNEL(&Resampler::Convolve_AVX2), nullptr)) {
+    SCOPED_TRACE(simd.instruction_set);
+    simd.kernel(input.get(), kernels.data(), taps.data(), kNumTaps,
+                actual.get());
+    for (size_t i = 0; i < kNumTaps * Resampler::kLanes; ++i)
+      EXPECT_EQ(expected[i], actual[i]) << "output " << i;
+  }
+}
+
+}  // namespace webrtc
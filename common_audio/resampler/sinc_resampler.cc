@@ -202,6 +202,15 @@ void SincResampler::UpdateRegions(bool second_load) {
 }
 
 void SincResampler::InitializeKernel() {
+  InitializeKernel(io_sample_rate_ratio_, kernel_storage_.get(),
+                   kernel_pre_sinc_storage_.get(),
+                   kernel_window_storage_.get());
+}
+
+void SincResampler::InitializeKernel(double io_sample_rate_ratio,
+                                     float* kernel_storage,
+                                     float* kernel_pre_sinc_storage,
+                                     float* kernel_window_storage) {
   // Blackman window parameters.
   static const double kAlpha = 0.16;
   static const double kA0 = 0.5 * (1.0 - kAlpha);
@@ -210,7 +219,7 @@ void SincResampler::InitializeKernel() {
 
   // Generates a set of windowed sinc() kernels.
   // We generate a range of sub-sample offsets from 0.0 to 1.0.
-  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
+  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio);
   for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
     const float subsample_offset =
         static_cast<float>(offset_idx) / kKernelOffsetCount;
@@ -220,17 +229,17 @@ void SincResampler::InitializeKernel() {
       const float pre_sinc = static_cast<float>(M_PI *
           (static_cast<int>(i) - static_cast<int>(kKernelSize / 2) -
            subsample_offset));
-      kernel_pre_sinc_storage_[idx] = pre_sinc;
+      kernel_pre_sinc_storage[idx] = pre_sinc;
 
       // Compute Blackman window, matching the offset of the sinc().
       const float x = (i - subsample_offset) / kKernelSize;
       const float window = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
           kA2 * cos(4.0 * M_PI * x));
-      kernel_window_storage_[idx] = window;
+      kernel_window_storage[idx] = window;
 
       // Compute the sinc with offset, then window the sinc() function and store
       // at the correct offset.
-      kernel_storage_[idx] = static_cast<float>(window *
+      kernel_storage[idx] = static_cast<float>(window *
           ((pre_sinc == 0) ?
               sinc_scale_factor :
               (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
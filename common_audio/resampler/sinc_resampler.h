@@ -85,6 +85,15 @@ class SincResampler {
 
   float* get_kernel_for_testing() { return kernel_storage_.get(); }
 
+  // Fills the kKernelStorageSize values of |kernel_storage| with the windowed
+  // sinc kernels for |io_sample_rate_ratio|, and |kernel_pre_sinc_storage| and
+  // |kernel_window_storage| with the values SetRatio() reuses. Lets
+  // MultiStreamSincResampler use the same kernels.
+  static void InitializeKernel(double io_sample_rate_ratio,
+                               float* kernel_storage,
+                               float* kernel_pre_sinc_storage,
+                               float* kernel_window_storage);
+
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveBenchmark);
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <immintrin.h>
+
+enum { kMaxCoefficients = 32 };
+
+// Loads eight samples at |low| into the low lane and eight at |high| into the
+// high lane.
+static inline __m256i LoadLanes(const int16_t* low, const int16_t* high) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)low)),
+      _mm_loadu_si128((const __m128i*)high), 1);
+}
+
+// Same as the SSE2 version, with outputs n..n+3 in the low lanes and outputs
+// n+4..n+7 in the high lanes, so that eight outputs are stored at once.
+int WebRtcSpl_DownsampleFastAVX2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  int16_t reversed[kMaxCoefficients];
+  size_t padded_length = 0;
+  size_t i = 0;
+  size_t j = 0;
+  size_t n = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+  if (coefficients_length > kMaxCoefficients) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  padded_length = ((coefficients_length + 7) >> 3) << 3;
+  for (j = 0; j < padded_length; j++) {
+    reversed[j] = j < coefficients_length
+                      ? coefficients[coefficients_length - 1 - j] : 0;
+  }
+
+  i = delay;
+  for (; n + 8 <= data_out_length; n += 8, i += 8 * factor) {
+    const int16_t* in = data_in + i - (coefficients_length - 1);
+    const size_t high = 4 * factor;
+    __m256i sum0 = _mm256_setzero_si256();
+    __m256i sum1 = _mm256_setzero_si256();
+    __m256i sum2 = _mm256_setzero_si256();
+    __m256i sum3 = _mm256_setzero_si256();
+    __m256i out = _mm256_setzero_si256();
+    if (i + 7 * factor + padded_length - coefficients_length >=
+        data_in_length) {
+      break;
+    }
+    for (j = 0; j < padded_length; j += 8) {
+      const __m128i c = _mm_loadu_si128((const __m128i*)&reversed[j]);
+      const __m256i coeffs =
+          _mm256_inserti128_si256(_mm256_castsi128_si256(c), c, 1);
+      const int16_t* x = &in[j];
+      sum0 = _mm256_add_epi32(
+          sum0, _mm256_madd_epi16(LoadLanes(x, x + high), coeffs));
+      sum1 = _mm256_add_epi32(
+          sum1, _mm256_madd_epi16(LoadLanes(x + factor, x + factor + high),
+                                  coeffs));
+      sum2 = _mm256_add_epi32(
+          sum2, _mm256_madd_epi16(
+                    LoadLanes(x + 2 * factor, x + 2 * factor + high), coeffs));
+      sum3 = _mm256_add_epi32(
+          sum3, _mm256_madd_epi16(
+                    LoadLanes(x + 3 * factor, x + 3 * factor + high), coeffs));
+    }
+    {
+      // The unpacks work within each lane, leaving outputs n..n+3 and
+      // n+4..n+7 in order in the two lanes.
+      const __m256i s01 = _mm256_add_epi32(_mm256_unpacklo_epi32(sum0, sum1),
+                                           _mm256_unpackhi_epi32(sum0, sum1));
+      const __m256i s23 = _mm256_add_epi32(_mm256_unpacklo_epi32(sum2, sum3),
+                                           _mm256_unpackhi_epi32(sum2, sum3));
+      out = _mm256_add_epi32(_mm256_unpacklo_epi64(s01, s23),
+                             _mm256_unpackhi_epi64(s01, s23));
+    }
+    out = _mm256_srai_epi32(
+        _mm256_add_epi32(out, _mm256_set1_epi32(2048)), 12);
+    // packssdw also packs per lane; gather the two low quadwords.
+    out = _mm256_permute4x64_epi64(_mm256_packs_epi32(out, out),
+                                   _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128((__m128i*)&data_out[n], _mm256_castsi256_si128(out));
+  }
+
+  for (; n < data_out_length; n++, i += factor) {
+    int32_t out_s32 = 2048;  // Round value, 0.5 in Q12.
+    for (j = 0; j < coefficients_length; j++)
+      out_s32 += coefficients[j] * data_in[i - j];  // Q12.
+    data_out[n] = WebRtcSpl_SatW32ToW16(out_s32 >> 12);
+  }
+
+  return 0;
+}
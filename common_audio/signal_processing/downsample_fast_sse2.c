@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+// Longer filters are left to the C version. The filters of NetEq and iLBC
+// have at most 7 coefficients.
+enum { kMaxCoefficients = 32 };
+
+// Sums each of the four vectors, into the four lanes of the result.
+static inline __m128i HorizontalSum4(__m128i s0,
+                                     __m128i s1,
+                                     __m128i s2,
+                                     __m128i s3) {
+  const __m128i s01 = _mm_add_epi32(_mm_unpacklo_epi32(s0, s1),
+                                    _mm_unpackhi_epi32(s0, s1));
+  const __m128i s23 = _mm_add_epi32(_mm_unpacklo_epi32(s2, s3),
+                                    _mm_unpackhi_epi32(s2, s3));
+  return _mm_add_epi32(_mm_unpacklo_epi64(s01, s23),
+                       _mm_unpackhi_epi64(s01, s23));
+}
+
+// SSE2 version of WebRtcSpl_DownsampleFast() for x86 platforms. The
+// coefficients are reversed and padded with zeros to a multiple of eight, so
+// that each output is a sum of pmaddwd over contiguous input, and four
+// outputs are rounded, shifted and saturated at once.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  int16_t reversed[kMaxCoefficients];
+  size_t num_chunks = 0;
+  size_t padded_length = 0;
+  size_t i = 0;
+  size_t j = 0;
+  size_t n = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+  if (coefficients_length > kMaxCoefficients) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  num_chunks = (coefficients_length + 7) >> 3;
+  padded_length = num_chunks << 3;
+  for (j = 0; j < padded_length; j++) {
+    reversed[j] = j < coefficients_length
+                      ? coefficients[coefficients_length - 1 - j] : 0;
+  }
+
+  // Output |i| reads up to data_in[i + padded_length - coefficients_length],
+  // so the last outputs, whose padding would read past the end of |data_in|,
+  // are done one by one.
+  i = delay;
+  for (; n + 4 <= data_out_length; n += 4, i += 4 * factor) {
+    const int16_t* in = data_in + i - (coefficients_length - 1);
+    __m128i sum0 = _mm_setzero_si128();
+    __m128i sum1 = _mm_setzero_si128();
+    __m128i sum2 = _mm_setzero_si128();
+    __m128i sum3 = _mm_setzero_si128();
+    __m128i out = _mm_setzero_si128();
+    if (i + 3 * factor + padded_length - coefficients_length >=
+        data_in_length) {
+      break;
+    }
+    for (j = 0; j < padded_length; j += 8) {
+      const __m128i coeffs = _mm_loadu_si128((const __m128i*)&reversed[j]);
+      sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(
+          _mm_loadu_si128((const __m128i*)&in[j]), coeffs));
+      sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(
+          _mm_loadu_si128((const __m128i*)&in[j + factor]), coeffs));
+      sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(
+          _mm_loadu_si128((const __m128i*)&in[j + 2 * factor]), coeffs));
+      sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(
+          _mm_loadu_si128((const __m128i*)&in[j + 3 * factor]), coeffs));
+    }
+    // Round (0.5 in Q12), go to Q0 and saturate like WebRtcSpl_SatW32ToW16.
+    out = _mm_add_epi32(HorizontalSum4(sum0, sum1, sum2, sum3),
+                        _mm_set1_epi32(2048));
+    out = _mm_srai_epi32(out, 12);
+    _mm_storel_epi64((__m128i*)&data_out[n], _mm_packs_epi32(out, out));
+  }
+
+  for (; n < data_out_length; n++, i += factor) {
+    int32_t out_s32 = 2048;  // Round value, 0.5 in Q12.
+    for (j = 0; j < coefficients_length; j++)
+      out_s32 += coefficients[j] * data_in[i - j];  // Q12.
+    data_out[n] = WebRtcSpl_SatW32ToW16(out_s32 >> 12);
+  }
+
+  return 0;
+}
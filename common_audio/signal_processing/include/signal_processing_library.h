@@ -105,8 +105,9 @@ extern "C" {
 
 // Initialize SPL. Currently it contains only function pointer initialization.
 // If the underlying platform is known to be ARM-Neon (WEBRTC_HAS_NEON defined),
-// the pointers will be assigned to code optimized for Neon; otherwise, generic
-// C code will be assigned.
+// the pointers will be assigned to code optimized for Neon; on x86 they will be
+// assigned to the SSE2 or AVX2 code the CPU supports; otherwise, generic C code
+// will be assigned.
 // Note that this function MUST be called in any application that uses SPL
 // functions.
 void WebRtcSpl_Init();
@@ -156,6 +157,10 @@ int16_t WebRtcSpl_MaxAbsValueW16Neon(const int16_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxAbsValueW16_mips(const int16_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length);
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, size_t length);
+#endif
 
 // Returns the largest absolute value in a signed 32-bit vector.
 //
@@ -173,6 +178,10 @@ int32_t WebRtcSpl_MaxAbsValueW32Neon(const int32_t* vector, size_t length);
 #if defined(MIPS_DSP_R1_LE)
 int32_t WebRtcSpl_MaxAbsValueW32_mips(const int32_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MaxAbsValueW32SSE2(const int32_t* vector, size_t length);
+int32_t WebRtcSpl_MaxAbsValueW32AVX2(const int32_t* vector, size_t length);
+#endif
 
 // Returns the maximum value of a 16-bit vector.
 //
@@ -190,6 +199,10 @@ int16_t WebRtcSpl_MaxValueW16Neon(const int16_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxValueW16_mips(const int16_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, size_t length);
+int16_t WebRtcSpl_MaxValueW16AVX2(const int16_t* vector, size_t length);
+#endif
 
 // Returns the maximum value of a 32-bit vector.
 //
@@ -207,6 +220,10 @@ int32_t WebRtcSpl_MaxValueW32Neon(const int32_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int32_t WebRtcSpl_MaxValueW32_mips(const int32_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MaxValueW32SSE2(const int32_t* vector, size_t length);
+int32_t WebRtcSpl_MaxValueW32AVX2(const int32_t* vector, size_t length);
+#endif
 
 // Returns the minimum value of a 16-bit vector.
 //
@@ -224,6 +241,10 @@ int16_t WebRtcSpl_MinValueW16Neon(const int16_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MinValueW16_mips(const int16_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, size_t length);
+int16_t WebRtcSpl_MinValueW16AVX2(const int16_t* vector, size_t length);
+#endif
 
 // Returns the minimum value of a 32-bit vector.
 //
@@ -241,6 +262,10 @@ int32_t WebRtcSpl_MinValueW32Neon(const int32_t* vector, size_t length);
 #if defined(MIPS32_LE)
 int32_t WebRtcSpl_MinValueW32_mips(const int32_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int32_t WebRtcSpl_MinValueW32SSE2(const int32_t* vector, size_t length);
+int32_t WebRtcSpl_MinValueW32AVX2(const int32_t* vector, size_t length);
+#endif
 
 // Returns the vector index to the largest absolute value of a 16-bit vector.
 //
@@ -546,6 +571,22 @@ void WebRtcSpl_CrossCorrelation_mips(int32_t* cross_correlation,
                                      int right_shifts,
                                      int step_seq2);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2);
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2);
+#endif
 
 // Creates (the first half of) a Hanning window. Size must be at least 1 and
 // at most 512.
@@ -715,6 +756,24 @@ int WebRtcSpl_DownsampleFast_mips(const int16_t* data_in,
                                   int factor,
                                   size_t delay);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay);
+int WebRtcSpl_DownsampleFastAVX2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay);
+#endif
 
 // End: Filter operations.
 
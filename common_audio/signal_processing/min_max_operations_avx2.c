@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// Each reduction folds the high lane onto the low one, then halves the width
+// until the result is in element 0.
+static inline int16_t HorizontalMaxEpi16(__m256i v) {
+  __m128i m = _mm_max_epi16(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  m = _mm_max_epi16(m, _mm_srli_si128(m, 8));
+  m = _mm_max_epi16(m, _mm_srli_si128(m, 4));
+  m = _mm_max_epi16(m, _mm_srli_si128(m, 2));
+  return (int16_t)_mm_cvtsi128_si32(m);
+}
+
+static inline int16_t HorizontalMinEpi16(__m256i v) {
+  __m128i m = _mm_min_epi16(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  m = _mm_min_epi16(m, _mm_srli_si128(m, 8));
+  m = _mm_min_epi16(m, _mm_srli_si128(m, 4));
+  m = _mm_min_epi16(m, _mm_srli_si128(m, 2));
+  return (int16_t)_mm_cvtsi128_si32(m);
+}
+
+static inline int32_t HorizontalMaxEpi32(__m256i v) {
+  __m128i m = _mm_max_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  m = _mm_max_epi32(m, _mm_srli_si128(m, 8));
+  m = _mm_max_epi32(m, _mm_srli_si128(m, 4));
+  return _mm_cvtsi128_si32(m);
+}
+
+static inline int32_t HorizontalMinEpi32(__m256i v) {
+  __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  m = _mm_min_epi32(m, _mm_srli_si128(m, 8));
+  m = _mm_min_epi32(m, _mm_srli_si128(m, 4));
+  return _mm_cvtsi128_si32(m);
+}
+
+// Maximum absolute value of word16 vector. AVX2 version for x86 platforms.
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, size_t length) {
+  __m256i max_v = _mm256_setzero_si256();
+  int16_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 16 <= length; i += 16) {
+    const __m256i v = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    // vpabsw leaves -32768 as it is, so compare unsigned.
+    max_v = _mm256_max_epu16(max_v, _mm256_abs_epi16(v));
+  }
+  // Clamp abs(-32768) like the C version, then the lanes are all positive.
+  max_v = _mm256_min_epu16(max_v, _mm256_set1_epi16(WEBRTC_SPL_WORD16_MAX));
+  maximum = HorizontalMaxEpi16(max_v);
+
+  for (; i < length; i++) {
+    int absolute = abs((int)vector[i]);
+    if (absolute > maximum)
+      maximum = (int16_t)WEBRTC_SPL_MIN(absolute, WEBRTC_SPL_WORD16_MAX);
+  }
+  return maximum;
+}
+
+// Maximum absolute value of word32 vector. AVX2 version for x86 platforms.
+int32_t WebRtcSpl_MaxAbsValueW32AVX2(const int32_t* vector, size_t length) {
+  __m256i max_v = _mm256_setzero_si256();
+  uint32_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    const __m256i v = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    max_v = _mm256_max_epu32(max_v, _mm256_abs_epi32(v));
+  }
+  max_v = _mm256_min_epu32(max_v, _mm256_set1_epi32(WEBRTC_SPL_WORD32_MAX));
+  maximum = (uint32_t)HorizontalMaxEpi32(max_v);
+
+  for (; i < length; i++) {
+    uint32_t absolute = abs((int)vector[i]);
+    if (absolute > maximum)
+      maximum = absolute;
+  }
+  return (int32_t)WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+}
+
+// Maximum value of word16 vector. AVX2 version for x86 platforms.
+int16_t WebRtcSpl_MaxValueW16AVX2(const int16_t* vector, size_t length) {
+  __m256i max_v = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  int16_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 16 <= length; i += 16) {
+    max_v = _mm256_max_epi16(
+        max_v, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = HorizontalMaxEpi16(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Maximum value of word32 vector. AVX2 version for x86 platforms.
+int32_t WebRtcSpl_MaxValueW32AVX2(const int32_t* vector, size_t length) {
+  __m256i max_v = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  int32_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    max_v = _mm256_max_epi32(
+        max_v, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = HorizontalMaxEpi32(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Minimum value of word16 vector. AVX2 version for x86 platforms.
+int16_t WebRtcSpl_MinValueW16AVX2(const int16_t* vector, size_t length) {
+  __m256i min_v = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  int16_t minimum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 16 <= length; i += 16) {
+    min_v = _mm256_min_epi16(
+        min_v, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = HorizontalMinEpi16(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// Minimum value of word32 vector. AVX2 version for x86 platforms.
+int32_t WebRtcSpl_MinValueW32AVX2(const int32_t* vector, size_t length) {
+  __m256i min_v = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  int32_t minimum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    min_v = _mm256_min_epi32(
+        min_v, _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = HorizontalMinEpi32(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <stdlib.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// SSE2 has no 32-bit min and max, so select with a comparison.
+static inline __m128i MaxEpi32(__m128i a, __m128i b) {
+  const __m128i greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+}
+
+static inline __m128i MinEpi32(__m128i a, __m128i b) {
+  const __m128i greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+}
+
+// Maximum of the eight lanes, in lane 0.
+static inline int16_t HorizontalMaxEpi16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 2));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static inline int16_t HorizontalMinEpi16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 2));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static inline int32_t HorizontalMaxEpi32(__m128i v) {
+  v = MaxEpi32(v, _mm_srli_si128(v, 8));
+  v = MaxEpi32(v, _mm_srli_si128(v, 4));
+  return _mm_cvtsi128_si32(v);
+}
+
+static inline int32_t HorizontalMinEpi32(__m128i v) {
+  v = MinEpi32(v, _mm_srli_si128(v, 8));
+  v = MinEpi32(v, _mm_srli_si128(v, 4));
+  return _mm_cvtsi128_si32(v);
+}
+
+// Maximum absolute value of word16 vector. SSE2 version for x86 platforms.
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length) {
+  __m128i max_v = _mm_setzero_si128();
+  int16_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    // The saturating negation turns -32768 into 32767, which is also the
+    // value the C version clamps abs(-32768) to.
+    max_v = _mm_max_epi16(max_v, _mm_max_epi16(
+        v, _mm_subs_epi16(_mm_setzero_si128(), v)));
+  }
+  maximum = HorizontalMaxEpi16(max_v);
+
+  for (; i < length; i++) {
+    int absolute = abs((int)vector[i]);
+    if (absolute > maximum)
+      maximum = (int16_t)WEBRTC_SPL_MIN(absolute, WEBRTC_SPL_WORD16_MAX);
+  }
+  return maximum;
+}
+
+// Maximum absolute value of word32 vector. SSE2 version for x86 platforms.
+int32_t WebRtcSpl_MaxAbsValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i max_v = _mm_setzero_si128();
+  uint32_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    const __m128i sign = _mm_srai_epi32(v, 31);
+    __m128i absolute = _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+    // Only abs(0x80000000) is still negative; make it 0x7fffffff.
+    absolute = _mm_add_epi32(absolute, _mm_srai_epi32(absolute, 31));
+    max_v = MaxEpi32(max_v, absolute);
+  }
+  maximum = (uint32_t)HorizontalMaxEpi32(max_v);
+
+  for (; i < length; i++) {
+    uint32_t absolute = abs((int)vector[i]);
+    if (absolute > maximum)
+      maximum = absolute;
+  }
+  return (int32_t)WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+}
+
+// Maximum value of word16 vector. SSE2 version for x86 platforms.
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, size_t length) {
+  __m128i max_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  int16_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8)
+    max_v = _mm_max_epi16(max_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  maximum = HorizontalMaxEpi16(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Maximum value of word32 vector. SSE2 version for x86 platforms.
+int32_t WebRtcSpl_MaxValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i max_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  int32_t maximum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4)
+    max_v = MaxEpi32(max_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  maximum = HorizontalMaxEpi32(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Minimum value of word16 vector. SSE2 version for x86 platforms.
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, size_t length) {
+  __m128i min_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  int16_t minimum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8)
+    min_v = _mm_min_epi16(min_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  minimum = HorizontalMinEpi16(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// Minimum value of word32 vector. SSE2 version for x86 platforms.
+int32_t WebRtcSpl_MinValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i min_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  int32_t minimum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4)
+    min_v = MinEpi32(min_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  minimum = HorizontalMinEpi32(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
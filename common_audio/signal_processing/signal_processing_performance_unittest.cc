@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumCalls = 20000;
+
+// Sizes as NetEq uses them: 10 ms at 48 kHz, and the correlation of Expand
+// on the signal downsampled to 4 kHz.
+constexpr size_t kBlockLength = 480;
+constexpr size_t kDownsampledLength = 124;
+constexpr size_t kCorrelationLength = 60;
+constexpr size_t kNumLags = 54;
+constexpr size_t kFilterLength = 7;
+constexpr int kDownsamplingFactor = 12;
+
+// Calls |run| kNumCalls times and prints the mean time of a call, with the
+// version ("c", "sse2" or "avx2") in the trace name.
+template <typename Function>
+void Measure(const std::string& kernel,
+             const std::string& version,
+             const Function& run) {
+  // Once to warm up the caches.
+  run();
+  const int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumCalls; ++i)
+    run();
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  webrtc::test::PrintResult("spl_kernel", "_" + version, kernel,
+                            static_cast<double>(elapsed_ns) / kNumCalls,
+                            "ns/call", false);
+}
+
+std::vector<int16_t> RandomSamples(size_t length, Random* random) {
+  std::vector<int16_t> samples(length);
+  for (int16_t& sample : samples)
+    sample = random->Rand<int16_t>();
+  return samples;
+}
+
+// Runs |measure| with the C version, and with the SSE2 and AVX2 versions if
+// the CPU has them.
+template <typename Function>
+void ForEachVersion(
+    Function c,
+    Function sse2,
+    Function avx2,
+    const std::function<void(const std::string&, Function)>& measure) {
+  measure("c", c);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2))
+    measure("sse2", sse2);
+  if (WebRtc_GetCPUInfo(kAVX2))
+    measure("avx2", avx2);
+#endif
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#define X86_VERSIONS(name) WebRtcSpl_##name##SSE2, WebRtcSpl_##name##AVX2
+#else
+#define X86_VERSIONS(name) nullptr, nullptr
+#endif
+}  // namespace
+
+// The pitch lag search of Expand, which correlates backwards.
+TEST(SplPerformanceTest, CrossCorrelation) {
+  Random random(0x1234);
+  const std::vector<int16_t> seq1 = RandomSamples(kCorrelationLength, &random);
+  const std::vector<int16_t> seq2 =
+      RandomSamples(kCorrelationLength + kNumLags, &random);
+  ForEachVersion<CrossCorrelation>(
+      WebRtcSpl_CrossCorrelationC, X86_VERSIONS(CrossCorrelation),
+      [&](const std::string& version, CrossCorrelation function) {
+        int32_t correlation[kNumLags];
+        for (int right_shifts : {0, 2}) {
+          Measure("cross_correlation_shift" + std::to_string(right_shifts),
+                  version, [&] {
+                    function(correlation, seq1.data(), &seq2[kNumLags],
+                             kCorrelationLength, kNumLags, right_shifts, -1);
+                  });
+        }
+      });
+}
+
+// What DspHelper::DownsampleTo4kHz does with 10 ms at 48 kHz.
+TEST(SplPerformanceTest, DownsampleFast) {
+  // DspHelper::kDownsample48kHzTbl.
+  const int16_t kCoefficients[kFilterLength] = {1019, 390, 427, 440,
+                                                427,  390, 1019};
+  Random random(0x5678);
+  const std::vector<int16_t> input = RandomSamples(
+      kFilterLength + kDownsamplingFactor * kDownsampledLength, &random);
+  ForEachVersion<DownsampleFast>(
+      WebRtcSpl_DownsampleFastC, X86_VERSIONS(DownsampleFast),
+      [&](const std::string& version, DownsampleFast function) {
+        int16_t output[kDownsampledLength];
+        Measure("downsample_fast", version, [&] {
+          function(input.data(), input.size(), output, kDownsampledLength,
+                   kCoefficients, kFilterLength, kDownsamplingFactor,
+                   kFilterLength - 1);
+        });
+      });
+}
+
+TEST(SplPerformanceTest, MaxAbsValueW16) {
+  Random random(0x9abc);
+  const std::vector<int16_t> block = RandomSamples(kBlockLength, &random);
+  ForEachVersion<MaxAbsValueW16>(
+      WebRtcSpl_MaxAbsValueW16C, X86_VERSIONS(MaxAbsValueW16),
+      [&](const std::string& version, MaxAbsValueW16 function) {
+        Measure("max_abs_value_w16", version,
+                [&] { function(block.data(), block.size()); });
+      });
+}
+
+TEST(SplPerformanceTest, MinMaxValueW32) {
+  Random random(0xdef0);
+  std::vector<int32_t> block(kBlockLength);
+  for (int32_t& value : block)
+    value = random.Rand<int32_t>();
+  ForEachVersion<MaxValueW32>(
+      WebRtcSpl_MaxValueW32C, X86_VERSIONS(MaxValueW32),
+      [&](const std::string& version, MaxValueW32 function) {
+        Measure("max_value_w32", version,
+                [&] { function(block.data(), block.size()); });
+      });
+  ForEachVersion<MinValueW32>(
+      WebRtcSpl_MinValueW32C, X86_VERSIONS(MinValueW32),
+      [&](const std::string& version, MinValueW32 function) {
+        Measure("min_value_w32", version,
+                [&] { function(block.data(), block.size()); });
+      });
+}
+
+}  // namespace webrtc
@@ -9,10 +9,14 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
 #include <sstream>
+#include <vector>
 
+#include "webrtc/base/random.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/simd_kernels.h"
 
 static const size_t kVector16Size = 9;
 static const int16_t vector16[kVector16Size] = {1, -15511, 4323, 1963,
@@ -471,11 +475,11 @@ TEST_F(SplTest, CrossCorrelationTest) {
                              kCrossCorrelationDimension, kShift, kStep);
 
   // WebRtcSpl_CrossCorrelationC() and WebRtcSpl_CrossCorrelationNeon()
-  // are not bit-exact.
+  // are not bit-exact. The SSE2 and AVX2 versions are.
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
   if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
@@ -605,3 +609,175 @@ TEST_F(SplTest, Resample48WithSaturationTest) {
     EXPECT_EQ(kRefValue16kHz2, out_vector_w16[i]);
   }
 }
+
+namespace {
+
+struct SplKernels {
+  MaxAbsValueW16 max_abs_value_w16;
+  MaxAbsValueW32 max_abs_value_w32;
+  MaxValueW16 max_value_w16;
+  MaxValueW32 max_value_w32;
+  MinValueW16 min_value_w16;
+  MinValueW32 min_value_w32;
+  CrossCorrelation cross_correlation;
+  DownsampleFast downsample_fast;
+};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+const SplKernels kSse2Kernels = {
+    WebRtcSpl_MaxAbsValueW16SSE2, WebRtcSpl_MaxAbsValueW32SSE2,
+    WebRtcSpl_MaxValueW16SSE2,    WebRtcSpl_MaxValueW32SSE2,
+    WebRtcSpl_MinValueW16SSE2,    WebRtcSpl_MinValueW32SSE2,
+    WebRtcSpl_CrossCorrelationSSE2, WebRtcSpl_DownsampleFastSSE2};
+
+const SplKernels kAvx2Kernels = {
+    WebRtcSpl_MaxAbsValueW16AVX2, WebRtcSpl_MaxAbsValueW32AVX2,
+    WebRtcSpl_MaxValueW16AVX2,    WebRtcSpl_MaxValueW32AVX2,
+    WebRtcSpl_MinValueW16AVX2,    WebRtcSpl_MinValueW32AVX2,
+    WebRtcSpl_CrossCorrelationAVX2, WebRtcSpl_DownsampleFastAVX2};
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
+// Lengths around the 8 and 16 sample vector widths, so that the unrolled
+// loops and the scalar tails all run.
+const size_t kLengths[] = {1, 3, 7, 8, 9, 15, 16, 17, 31, 33, 60, 241};
+
+// WebRtcSpl_MaxAbsValueW32C() takes abs(WEBRTC_SPL_WORD32_MIN), which is
+// undefined and which optimizing compilers have it return as it is, so the
+// result it documents is computed without overflow here.
+int32_t ReferenceMaxAbsValueW32(const std::vector<int32_t>& vector) {
+  int64_t maximum = 0;
+  for (int32_t value : vector)
+    maximum = std::max(maximum, std::abs(static_cast<int64_t>(value)));
+  return static_cast<int32_t>(
+      std::min<int64_t>(maximum, WEBRTC_SPL_WORD32_MAX));
+}
+
+void ExpectMinMaxMatchesC(const SplKernels& kernels) {
+  webrtc::Random random(0x5b1);
+  for (size_t length : kLengths) {
+    for (int trial = 0; trial < 20; ++trial) {
+      std::vector<int16_t> v16(length);
+      std::vector<int32_t> v32(length);
+      for (size_t i = 0; i < length; ++i) {
+        v16[i] = random.Rand<int16_t>();
+        v32[i] = random.Rand<int32_t>();
+      }
+      // The values the C versions special-case, at a random position.
+      if (trial % 2 == 0) {
+        v16[random.Rand(0u, static_cast<uint32_t>(length - 1))] =
+            WEBRTC_SPL_WORD16_MIN;
+        v32[random.Rand(0u, static_cast<uint32_t>(length - 1))] =
+            WEBRTC_SPL_WORD32_MIN;
+      }
+      // Small magnitudes, where the maximum is in the scalar tail as often as
+      // not.
+      if (trial % 4 == 1) {
+        for (size_t i = 0; i < length; ++i) {
+          v16[i] >>= 12;
+          v32[i] >>= 28;
+        }
+      }
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(v16.data(), length),
+                kernels.max_abs_value_w16(v16.data(), length));
+      EXPECT_EQ(ReferenceMaxAbsValueW32(v32),
+                kernels.max_abs_value_w32(v32.data(), length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW16C(v16.data(), length),
+                kernels.max_value_w16(v16.data(), length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW32C(v32.data(), length),
+                kernels.max_value_w32(v32.data(), length));
+      EXPECT_EQ(WebRtcSpl_MinValueW16C(v16.data(), length),
+                kernels.min_value_w16(v16.data(), length));
+      EXPECT_EQ(WebRtcSpl_MinValueW32C(v32.data(), length),
+                kernels.min_value_w32(v32.data(), length));
+    }
+  }
+}
+
+void ExpectCrossCorrelationMatchesC(const SplKernels& kernels) {
+  const size_t kDimCrossCorrelation = 20;
+  webrtc::Random random(0xc055);
+  for (size_t length : kLengths) {
+    // |seq2| is walked backwards for negative steps, so start in the middle.
+    std::vector<int16_t> seq1(length);
+    std::vector<int16_t> seq2(length + 2 * kDimCrossCorrelation);
+    for (int16_t& sample : seq1)
+      sample = random.Rand<int16_t>();
+    for (int16_t& sample : seq2)
+      sample = random.Rand<int16_t>();
+    seq1[0] = WEBRTC_SPL_WORD16_MIN;
+    seq2[kDimCrossCorrelation] = WEBRTC_SPL_WORD16_MIN;
+    for (int right_shifts = 0; right_shifts <= 3; ++right_shifts) {
+      for (int step : {-1, 1}) {
+        int32_t expected[kDimCrossCorrelation];
+        int32_t actual[kDimCrossCorrelation];
+        WebRtcSpl_CrossCorrelationC(expected, seq1.data(),
+                                    &seq2[kDimCrossCorrelation], length,
+                                    kDimCrossCorrelation, right_shifts, step);
+        kernels.cross_correlation(actual, seq1.data(),
+                                  &seq2[kDimCrossCorrelation], length,
+                                  kDimCrossCorrelation, right_shifts, step);
+        for (size_t i = 0; i < kDimCrossCorrelation; ++i) {
+          EXPECT_EQ(expected[i], actual[i])
+              << "length " << length << ", shift " << right_shifts
+              << ", step " << step << ", lag " << i;
+        }
+      }
+    }
+  }
+}
+
+void ExpectDownsampleFastMatchesC(const SplKernels& kernels) {
+  webrtc::Random random(0xd0);
+  std::vector<int16_t> data_in(1000);
+  for (int16_t& sample : data_in)
+    sample = random.Rand<int16_t>();
+  for (size_t coefficients_length : {1, 3, 5, 7, 8, 11, 17, 33}) {
+    std::vector<int16_t> coefficients(coefficients_length);
+    for (int16_t& coefficient : coefficients)
+      coefficient = static_cast<int16_t>(random.Rand(-1024, 1024));
+    // Saturates for full scale input of the same sign.
+    coefficients[0] = 8191;
+    for (int factor : {2, 4, 8, 12}) {
+      for (size_t data_out_length : {1, 3, 4, 7, 8, 9, 20, 61}) {
+        const size_t delay = coefficients_length - 1;
+        // Exactly as long as needed, so that the last outputs cannot read
+        // past the input.
+        const size_t data_in_length =
+            delay + factor * (data_out_length - 1) + 1;
+        if (data_in_length > data_in.size())
+          continue;
+        std::vector<int16_t> expected(data_out_length);
+        std::vector<int16_t> actual(data_out_length);
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(
+                         data_in.data(), data_in_length, expected.data(),
+                         data_out_length, coefficients.data(),
+                         coefficients_length, factor, delay));
+        EXPECT_EQ(0, kernels.downsample_fast(
+                         data_in.data(), data_in_length, actual.data(),
+                         data_out_length, coefficients.data(),
+                         coefficients_length, factor, delay));
+        EXPECT_EQ(expected, actual)
+            << coefficients_length << " coefficients, factor " << factor
+            << ", " << data_out_length << " outputs";
+      }
+    }
+  }
+  // Too short input.
+  int16_t out[4];
+  EXPECT_EQ(-1, kernels.downsample_fast(data_in.data(), 10, out, 4,
+                                        data_in.data(), 3, 4, 2));
+}
+
+}  // namespace
+
+TEST_F(SplTest, SimdKernelsMatchC) {
+  for (const auto& simd :
+       webrtc::test::SupportedSimdKernels<const SplKernels*>(
+           WEBRTC_X86_KERNEL(&kSse2Kernels), WEBRTC_X86_KERNEL(&kAvx2Kernels),
+           nullptr)) {
+    SCOPED_TRACE(simd.instruction_set);
+    ExpectMinMaxMatchesC(*simd.kernel);
+    ExpectCrossCorrelationMatchesC(*simd.kernel);
+    ExpectDownsampleFastMatchesC(*simd.kernel);
+  }
+}
@@ -131,4 +131,27 @@ TEST(AudioDecoderFactoryTest, CreateOpus) {
   }
 }
 
+TEST(AudioDecoderFactoryTest, CreateOpusWithPooledStates) {
+  rtc::scoped_refptr<AudioDecoderFactory> adf =
+      CreateBuiltinAudioDecoderFactoryWithPooledStates();
+  ASSERT_TRUE(adf);
+  EXPECT_FALSE(adf->MakeAudioDecoder(SdpAudioFormat("opus", 48000, 2)));
+  EXPECT_FALSE(adf->MakeAudioDecoder(
+      SdpAudioFormat("opus", 48000, 1, {{"stereo", "0"}})));
+  for (int i = 0; i < 2; ++i) {
+    // The second time, the decoders get the states of the first ones.
+    std::unique_ptr<AudioDecoder> mono = adf->MakeAudioDecoder(
+        SdpAudioFormat("opus", 48000, 2, {{"stereo", "0"}}));
+    std::unique_ptr<AudioDecoder> stereo = adf->MakeAudioDecoder(
+        SdpAudioFormat("opus", 48000, 2, {{"stereo", "1"}}));
+    ASSERT_TRUE(mono);
+    ASSERT_TRUE(stereo);
+    EXPECT_EQ(1u, mono->Channels());
+    EXPECT_EQ(2u, stereo->Channels());
+    EXPECT_EQ(48000, stereo->SampleRateHz());
+  }
+  // Other decoders are made as without pooling.
+  EXPECT_TRUE(adf->MakeAudioDecoder(SdpAudioFormat("pcmu", 8000, 1)));
+}
+
 }  // namespace webrtc
@@ -47,6 +47,27 @@ std::unique_ptr<AudioDecoder> Unique(AudioDecoder* d) {
   return std::unique_ptr<AudioDecoder>(d);
 }
 
+#ifdef WEBRTC_CODEC_OPUS
+// The number of channels to decode |format| with, if it is a valid Opus
+// format.
+rtc::Optional<int> OpusDecoderChannels(const SdpAudioFormat& format) {
+  rtc::Optional<int> num_channels = [&] {
+    auto stereo = format.parameters.find("stereo");
+    if (stereo != format.parameters.end()) {
+      if (stereo->second == "0") {
+        return rtc::Optional<int>(1);
+      } else if (stereo->second == "1") {
+        return rtc::Optional<int>(2);
+      }
+    }
+    return rtc::Optional<int>();
+  }();
+  return format.clockrate_hz == 48000 && format.num_channels == 2
+             ? num_channels
+             : rtc::Optional<int>();
+}
+#endif
+
 // TODO(kwiberg): These factory functions should probably be moved to each
 // decoder.
 NamedDecoderConstructor decoder_constructors[] = {
@@ -108,27 +129,22 @@ NamedDecoderConstructor decoder_constructors[] = {
 #ifdef WEBRTC_CODEC_OPUS
     {"opus",
      [](const SdpAudioFormat& format) {
-       rtc::Optional<int> num_channels = [&] {
-         auto stereo = format.parameters.find("stereo");
-         if (stereo != format.parameters.end()) {
-           if (stereo->second == "0") {
-             return rtc::Optional<int>(1);
-           } else if (stereo->second == "1") {
-             return rtc::Optional<int>(2);
-           }
-         }
-         return rtc::Optional<int>();
-       }();
-       return format.clockrate_hz == 48000 && format.num_channels == 2 &&
-                      num_channels
-                  ? Unique(new AudioDecoderOpus(*num_channels))
-                  : nullptr;
+       const rtc::Optional<int> num_channels = OpusDecoderChannels(format);
+       return num_channels ? Unique(new AudioDecoderOpus(*num_channels))
+                           : nullptr;
      }},
 #endif
 };
 
 class BuiltinAudioDecoderFactory : public AudioDecoderFactory {
  public:
+  explicit BuiltinAudioDecoderFactory(bool pool_states) {
+#ifdef WEBRTC_CODEC_OPUS
+    if (pool_states)
+      opus_state_pool_ = new rtc::RefCountedObject<OpusDecoderStatePool>();
+#endif
+  }
+
   std::vector<AudioCodecSpec> GetSupportedDecoders() override {
     static std::vector<AudioCodecSpec> specs = {
 #ifdef WEBRTC_CODEC_OPUS
@@ -160,6 +176,14 @@ class BuiltinAudioDecoderFactory : public AudioDecoderFactory {
 
   std::unique_ptr<AudioDecoder> MakeAudioDecoder(
       const SdpAudioFormat& format) override {
+#ifdef WEBRTC_CODEC_OPUS
+    if (opus_state_pool_ && STR_CASE_CMP(format.name.c_str(), "opus") == 0) {
+      const rtc::Optional<int> num_channels = OpusDecoderChannels(format);
+      return num_channels ? Unique(new AudioDecoderOpus(*num_channels,
+                                                        opus_state_pool_))
+                          : nullptr;
+    }
+#endif
     for (const auto& dc : decoder_constructors) {
       if (STR_CASE_CMP(format.name.c_str(), dc.name) == 0) {
         std::unique_ptr<AudioDecoder> dec = dc.constructor(format);
@@ -175,13 +199,24 @@ class BuiltinAudioDecoderFactory : public AudioDecoderFactory {
     }
     return nullptr;
   }
+
+ private:
+#ifdef WEBRTC_CODEC_OPUS
+  rtc::scoped_refptr<OpusDecoderStatePool> opus_state_pool_;
+#endif
 };
 
 }  // namespace
 
 rtc::scoped_refptr<AudioDecoderFactory> CreateBuiltinAudioDecoderFactory() {
   return rtc::scoped_refptr<AudioDecoderFactory>(
-      new rtc::RefCountedObject<BuiltinAudioDecoderFactory>);
+      new rtc::RefCountedObject<BuiltinAudioDecoderFactory>(false));
+}
+
+rtc::scoped_refptr<AudioDecoderFactory>
+CreateBuiltinAudioDecoderFactoryWithPooledStates() {
+  return rtc::scoped_refptr<AudioDecoderFactory>(
+      new rtc::RefCountedObject<BuiltinAudioDecoderFactory>(true));
 }
 
 }  // namespace webrtc
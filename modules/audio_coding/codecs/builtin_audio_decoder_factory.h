@@ -22,6 +22,12 @@ namespace webrtc {
 // NOTE: This function is still under development and may change without notice.
 rtc::scoped_refptr<AudioDecoderFactory> CreateBuiltinAudioDecoderFactory();
 
+// Same as CreateBuiltinAudioDecoderFactory(), but the Opus decoders of the
+// factory reuse the codec states of destroyed ones instead of allocating
+// their own, for servers where many receive streams come and go.
+rtc::scoped_refptr<AudioDecoderFactory>
+CreateBuiltinAudioDecoderFactoryWithPooledStates();
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_MODULES_AUDIO_CODING_CODECS_BUILTIN_AUDIO_DECODER_FACTORY_H_
@@ -65,14 +65,26 @@ class OpusFrame : public AudioDecoder::EncodedAudioFrame {
 }  // namespace
 
 AudioDecoderOpus::AudioDecoderOpus(size_t num_channels)
-    : channels_(num_channels) {
+    : AudioDecoderOpus(num_channels, nullptr) {}
+
+AudioDecoderOpus::AudioDecoderOpus(
+    size_t num_channels,
+    rtc::scoped_refptr<OpusDecoderStatePool> state_pool)
+    : state_pool_(std::move(state_pool)), channels_(num_channels) {
   RTC_DCHECK(num_channels == 1 || num_channels == 2);
-  WebRtcOpus_DecoderCreate(&dec_state_, channels_);
-  WebRtcOpus_DecoderInit(dec_state_);
+  if (state_pool_) {
+    dec_state_ = state_pool_->Take(channels_);
+  } else {
+    WebRtcOpus_DecoderCreate(&dec_state_, channels_);
+    WebRtcOpus_DecoderInit(dec_state_);
+  }
 }
 
 AudioDecoderOpus::~AudioDecoderOpus() {
-  WebRtcOpus_DecoderFree(dec_state_);
+  if (!state_pool_)
+    WebRtcOpus_DecoderFree(dec_state_);
+  else if (dec_state_)
+    state_pool_->Return(dec_state_);
 }
 
 std::vector<AudioDecoder::ParseResult> AudioDecoderOpus::ParsePayload(
@@ -12,7 +12,9 @@
 #define WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_AUDIO_DECODER_OPUS_H_
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/modules/audio_coding/codecs/audio_decoder.h"
+#include "webrtc/modules/audio_coding/codecs/opus/opus_decoder_state_pool.h"
 #include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
 
 namespace webrtc {
@@ -20,6 +22,9 @@ namespace webrtc {
 class AudioDecoderOpus final : public AudioDecoder {
  public:
   explicit AudioDecoderOpus(size_t num_channels);
+  // Takes its state from |state_pool| and gives it back when destroyed.
+  AudioDecoderOpus(size_t num_channels,
+                   rtc::scoped_refptr<OpusDecoderStatePool> state_pool);
   ~AudioDecoderOpus() override;
 
   std::vector<ParseResult> ParsePayload(rtc::Buffer&& payload,
@@ -45,6 +50,7 @@ class AudioDecoderOpus final : public AudioDecoder {
                               SpeechType* speech_type) override;
 
  private:
+  const rtc::scoped_refptr<OpusDecoderStatePool> state_pool_;
   OpusDecInst* dec_state_;
   const size_t channels_;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioDecoderOpus);
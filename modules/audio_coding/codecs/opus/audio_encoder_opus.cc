@@ -434,16 +434,23 @@ size_t AudioEncoderOpus::SufficientOutputBufferSize() const {
 
 // If the given config is OK, recreate the Opus encoder instance with those
 // settings, save the config, and return true. Otherwise, do nothing and return
-// false.
+// false. The current instance is reset and reused if it has the same number
+// of channels and application.
 bool AudioEncoderOpus::RecreateEncoderInstance(const Config& config) {
   if (!config.IsOk())
     return false;
-  if (inst_)
-    RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
   input_buffer_.clear();
   input_buffer_.reserve(Num10msFramesPerPacket() * SamplesPer10msFrame());
-  RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
-                                           config.application));
+  if (inst_ && config.num_channels == config_.num_channels &&
+      config.application == config_.application) {
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderInit(inst_));
+    RTC_CHECK_EQ(0, WebRtcOpus_SetForceChannels(inst_, 0));
+  } else {
+    if (inst_)
+      RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
+                                             config.application));
+  }
   RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(inst_, config.GetBitrateBps()));
   if (config.fec_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableFec(inst_));
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/opus/opus_decoder_state_pool.h"
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+const size_t OpusDecoderStatePool::kDefaultMaxFreeStates;
+
+OpusDecoderStatePool::OpusDecoderStatePool()
+    : OpusDecoderStatePool(kDefaultMaxFreeStates) {}
+
+OpusDecoderStatePool::OpusDecoderStatePool(size_t max_free_states)
+    : max_free_states_(max_free_states), num_states_(0) {}
+
+OpusDecoderStatePool::~OpusDecoderStatePool() {
+  rtc::CritScope lock(&crit_);
+  for (auto& states : free_states_) {
+    for (OpusDecInst* state : states)
+      WebRtcOpus_DecoderFree(state);
+  }
+}
+
+OpusDecInst* OpusDecoderStatePool::Take(size_t num_channels) {
+  RTC_DCHECK(num_channels == 1 || num_channels == 2);
+  OpusDecInst* state = nullptr;
+  {
+    rtc::CritScope lock(&crit_);
+    std::vector<OpusDecInst*>& states = free_states_[num_channels - 1];
+    if (!states.empty()) {
+      state = states.back();
+      states.pop_back();
+    }
+  }
+  if (!state) {
+    if (WebRtcOpus_DecoderCreate(&state, num_channels) != 0)
+      return nullptr;
+    rtc::CritScope lock(&crit_);
+    ++num_states_;
+  }
+  WebRtcOpus_DecoderInit(state);
+  return state;
+}
+
+void OpusDecoderStatePool::Return(OpusDecInst* state) {
+  RTC_DCHECK(state);
+  const size_t num_channels = WebRtcOpus_DecoderChannels(state);
+  RTC_DCHECK(num_channels == 1 || num_channels == 2);
+  {
+    rtc::CritScope lock(&crit_);
+    std::vector<OpusDecInst*>& states = free_states_[num_channels - 1];
+    if (states.size() < max_free_states_) {
+      states.push_back(state);
+      return;
+    }
+    --num_states_;
+  }
+  WebRtcOpus_DecoderFree(state);
+}
+
+size_t OpusDecoderStatePool::num_states() const {
+  rtc::CritScope lock(&crit_);
+  return num_states_;
+}
+
+}  // namespace webrtc
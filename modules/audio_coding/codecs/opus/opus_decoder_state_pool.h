@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_DECODER_STATE_POOL_H_
+#define WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_DECODER_STATE_POOL_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
+
+namespace webrtc {
+
+// Keeps the states of destroyed Opus decoders for new ones, so that receive
+// streams coming and going in a large conference don't allocate and free a
+// libopus decoder each. Shared by the decoders of a factory, which hold a
+// reference to it; create with new rtc::RefCountedObject<...>.
+class OpusDecoderStatePool : public rtc::RefCountInterface {
+ public:
+  // The number of free states kept for each number of channels by default.
+  // A libopus state takes 18 kB for mono and 27 kB for stereo, so the free
+  // states take at most about 0.7 MB. States returned beyond the limit are
+  // freed.
+  static const size_t kDefaultMaxFreeStates = 16;
+
+  // Returns a state with |num_channels| channels, reset as if it had just
+  // been created, or null if a new one can't be created.
+  OpusDecInst* Take(size_t num_channels);
+
+  // Gives back a state from Take(), to be handed out again, or freed if
+  // enough states with its number of channels are free already.
+  void Return(OpusDecInst* state);
+
+  // The number of states which exist, whether taken or free.
+  size_t num_states() const;
+
+ protected:
+  OpusDecoderStatePool();
+  explicit OpusDecoderStatePool(size_t max_free_states);
+  ~OpusDecoderStatePool() override;
+
+ private:
+  const size_t max_free_states_;
+  rtc::CriticalSection crit_;
+  // Indexed by the number of channels minus one.
+  std::vector<OpusDecInst*> free_states_[2] GUARDED_BY(crit_);
+  size_t num_states_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(OpusDecoderStatePool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_DECODER_STATE_POOL_H_
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/modules/audio_coding/codecs/opus/opus_decoder_state_pool.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kFrameSamples = 960;  // 20 ms at 48 kHz.
+constexpr size_t kMaxBytes = 1000;
+
+// Encodes |num_packets| packets of 60 ms frames of a tone, so that the
+// decoder's PLC duration differs from that of a new decoder afterwards.
+std::vector<std::vector<uint8_t>> EncodeTone(int num_packets) {
+  OpusEncInst* encoder;
+  EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&encoder, 1, 0));
+  std::vector<int16_t> audio(3 * kFrameSamples);
+  std::vector<std::vector<uint8_t>> packets;
+  uint8_t packet[kMaxBytes];
+  for (int i = 0; i < num_packets; ++i) {
+    for (size_t n = 0; n < audio.size(); ++n) {
+      audio[n] = static_cast<int16_t>(
+          8000 * sin(2 * M_PI * 440 * (i * audio.size() + n) / 48000));
+    }
+    const int bytes = WebRtcOpus_Encode(encoder, audio.data(), audio.size(),
+                                        kMaxBytes, packet);
+    EXPECT_GT(bytes, 0);
+    packets.emplace_back(packet, packet + bytes);
+  }
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+  return packets;
+}
+
+std::vector<int16_t> Decode(OpusDecInst* decoder,
+                            const std::vector<uint8_t>& packet) {
+  std::vector<int16_t> audio(6 * kFrameSamples);
+  int16_t audio_type;
+  const int samples = WebRtcOpus_Decode(decoder, packet.data(), packet.size(),
+                                        audio.data(), &audio_type);
+  EXPECT_GT(samples, 0);
+  audio.resize(samples > 0 ? samples : 0);
+  return audio;
+}
+
+}  // namespace
+
+TEST(OpusDecoderStatePoolTest, ReusesReturnedStates) {
+  rtc::scoped_refptr<OpusDecoderStatePool> pool(
+      new rtc::RefCountedObject<OpusDecoderStatePool>());
+  OpusDecInst* mono = pool->Take(1);
+  ASSERT_TRUE(mono);
+  EXPECT_EQ(1u, WebRtcOpus_DecoderChannels(mono));
+  pool->Return(mono);
+  EXPECT_EQ(mono, pool->Take(1));
+  EXPECT_EQ(1u, pool->num_states());
+
+  // States are only reused for the same number of channels.
+  OpusDecInst* stereo = pool->Take(2);
+  ASSERT_TRUE(stereo);
+  EXPECT_NE(mono, stereo);
+  EXPECT_EQ(2u, WebRtcOpus_DecoderChannels(stereo));
+  EXPECT_EQ(2u, pool->num_states());
+
+  pool->Return(mono);
+  pool->Return(stereo);
+}
+
+TEST(OpusDecoderStatePoolTest, FreesStatesBeyondTheMaxFreeStates) {
+  constexpr size_t kMaxFreeStates = 2;
+  rtc::scoped_refptr<OpusDecoderStatePool> pool(
+      new rtc::RefCountedObject<OpusDecoderStatePool>(kMaxFreeStates));
+  std::vector<OpusDecInst*> states;
+  for (size_t i = 0; i < kMaxFreeStates + 2; ++i) {
+    states.push_back(pool->Take(1));
+    ASSERT_TRUE(states.back());
+  }
+  OpusDecInst* stereo = pool->Take(2);
+  ASSERT_TRUE(stereo);
+  EXPECT_EQ(kMaxFreeStates + 3, pool->num_states());
+
+  for (OpusDecInst* state : states)
+    pool->Return(state);
+  EXPECT_EQ(kMaxFreeStates + 1, pool->num_states());
+  // The cap is per number of channels.
+  pool->Return(stereo);
+  EXPECT_EQ(kMaxFreeStates + 1, pool->num_states());
+
+  // The states kept are handed out again before new ones are created.
+  const std::vector<OpusDecInst*> kept(states.begin(),
+                                       states.begin() + kMaxFreeStates);
+  for (size_t i = 0; i < kMaxFreeStates; ++i) {
+    states[i] = pool->Take(1);
+    EXPECT_NE(kept.end(), std::find(kept.begin(), kept.end(), states[i]));
+  }
+  EXPECT_EQ(kMaxFreeStates + 1, pool->num_states());
+  for (size_t i = 0; i < kMaxFreeStates; ++i)
+    pool->Return(states[i]);
+}
+
+TEST(OpusDecoderStatePoolTest, ReusedStateDecodesAsNewOne) {
+  const std::vector<std::vector<uint8_t>> packets = EncodeTone(5);
+  rtc::scoped_refptr<OpusDecoderStatePool> pool(
+      new rtc::RefCountedObject<OpusDecoderStatePool>());
+
+  // Another stream leaves a state with 60 ms frames behind.
+  OpusDecInst* state = pool->Take(1);
+  ASSERT_TRUE(state);
+  for (size_t i = packets.size() / 2; i < packets.size(); ++i)
+    Decode(state, packets[i]);
+  EXPECT_EQ(static_cast<int>(3 * kFrameSamples),
+            WebRtcOpus_PlcDuration(state));
+  pool->Return(state);
+
+  OpusDecInst* new_state;
+  ASSERT_EQ(0, WebRtcOpus_DecoderCreate(&new_state, 1));
+  WebRtcOpus_DecoderInit(new_state);
+  ASSERT_EQ(state, pool->Take(1));
+  EXPECT_EQ(WebRtcOpus_PlcDuration(new_state), WebRtcOpus_PlcDuration(state));
+  for (const auto& packet : packets)
+    EXPECT_EQ(Decode(new_state, packet), Decode(state, packet));
+
+  EXPECT_EQ(0, WebRtcOpus_DecoderFree(new_state));
+  pool->Return(state);
+}
+
+}  // namespace webrtc
@@ -79,6 +79,13 @@ int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   }
 }
 
+int16_t WebRtcOpus_EncoderInit(OpusEncInst* inst) {
+  if (!inst)
+    return -1;
+  inst->in_dtx_mode = 0;
+  return opus_encoder_ctl(inst->encoder, OPUS_RESET_STATE);
+}
+
 int WebRtcOpus_Encode(OpusEncInst* inst,
                       const int16_t* audio_in,
                       size_t samples,
@@ -270,6 +277,7 @@ size_t WebRtcOpus_DecoderChannels(OpusDecInst* inst) {
 void WebRtcOpus_DecoderInit(OpusDecInst* inst) {
   opus_decoder_ctl(inst->decoder, OPUS_RESET_STATE);
   inst->in_dtx_mode = 0;
+  inst->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
 }
 
 /* For decoder to determine if it is to output speech or comfort noise. */
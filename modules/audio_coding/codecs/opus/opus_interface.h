@@ -48,6 +48,20 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
 
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
+/****************************************************************************
+ * WebRtcOpus_EncoderInit(...)
+ *
+ * This function resets the coding state of the encoder, as if it had just
+ * been created. Its settings are kept.
+ *
+ * Input:
+ *      - inst               : Encoder context
+ *
+ * Return value              :  0 - Success
+ *                             -1 - Error
+ */
+int16_t WebRtcOpus_EncoderInit(OpusEncInst* inst);
+
 /****************************************************************************
  * WebRtcOpus_Encode(...)
  *
@@ -230,7 +244,7 @@ size_t WebRtcOpus_DecoderChannels(OpusDecInst* inst);
 /****************************************************************************
  * WebRtcOpus_DecoderInit(...)
  *
- * This function resets state of the decoder.
+ * This function resets state of the decoder, as if it had just been created.
  *
  * Input:
  *      - inst               : Decoder context
@@ -8,8 +8,18 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
+#include <vector>
+
+#include "webrtc/base/format_macros.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/audio_coding/codecs/opus/opus_decoder_state_pool.h"
 #include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
 #include "webrtc/modules/audio_coding/codecs/tools/audio_codec_speed_test.h"
+#include "webrtc/test/testsupport/fileutils.h"
 
 using ::std::string;
 
@@ -118,4 +128,91 @@ const coding_param param_set[] =
 INSTANTIATE_TEST_CASE_P(AllTest, OpusSpeedTest,
                         ::testing::ValuesIn(param_set));
 
+// Decodes the streams of a large conference, where every 20 ms each of the
+// streams decodes a packet, and participants keep joining and leaving. The
+// streams play the same recording, offset in time.
+TEST(OpusMultiStreamSpeedTest, HundredStreams) {
+  const size_t kNumStreams = 100;
+  const size_t kNumPackets = 250;  // 5 s.
+  const size_t kNumJoins = 1000;
+  const size_t kBlockSamples = kOpusBlockDurationMs * kOpusSamplingKhz;
+
+  // Encodes the packets of all streams.
+  const std::string file_name =
+      test::ResourcePath("audio_coding/speech_mono_32_48kHz", "pcm");
+  FILE* fp = fopen(file_name.c_str(), "rb");
+  ASSERT_TRUE(fp) << file_name;
+  std::vector<int16_t> audio(kNumPackets * kBlockSamples);
+  ASSERT_EQ(audio.size(), fread(audio.data(), sizeof(int16_t), audio.size(),
+                                fp));
+  fclose(fp);
+  WebRtcOpusEncInst* encoder;
+  ASSERT_EQ(0, WebRtcOpus_EncoderCreate(&encoder, 1, 0));
+  ASSERT_EQ(0, WebRtcOpus_SetBitRate(encoder, 32000));
+  std::vector<std::vector<uint8_t>> packets(kNumPackets);
+  uint8_t bit_stream[1000];
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    const int bytes =
+        WebRtcOpus_Encode(encoder, &audio[i * kBlockSamples], kBlockSamples,
+                          sizeof(bit_stream), bit_stream);
+    ASSERT_GT(bytes, 0);
+    packets[i].assign(bit_stream, bit_stream + bytes);
+  }
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+
+  rtc::scoped_refptr<OpusDecoderStatePool> pool(
+      new rtc::RefCountedObject<OpusDecoderStatePool>());
+  std::vector<WebRtcOpusDecInst*> decoders(kNumStreams);
+  for (auto& decoder : decoders) {
+    decoder = pool->Take(1);
+    ASSERT_TRUE(decoder);
+  }
+
+  std::vector<int16_t> decoded(kBlockSamples);
+  int16_t audio_type;
+  int64_t start_ns = rtc::TimeNanos();
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    for (size_t stream = 0; stream < kNumStreams; ++stream) {
+      const std::vector<uint8_t>& packet =
+          packets[(i + stream) % kNumPackets];
+      EXPECT_EQ(static_cast<int>(kBlockSamples),
+                WebRtcOpus_Decode(decoders[stream], packet.data(),
+                                  packet.size(), decoded.data(),
+                                  &audio_type));
+    }
+  }
+  const int64_t decode_ns = rtc::TimeNanos() - start_ns;
+
+  // A new participant takes the place of stream |i|, with a new state or one
+  // from the pool.
+  start_ns = rtc::TimeNanos();
+  for (size_t i = 0; i < kNumJoins; ++i) {
+    WebRtcOpusDecInst*& decoder = decoders[i % kNumStreams];
+    EXPECT_EQ(0, WebRtcOpus_DecoderFree(decoder));
+    EXPECT_EQ(0, WebRtcOpus_DecoderCreate(&decoder, 1));
+    WebRtcOpus_DecoderInit(decoder);
+  }
+  const int64_t create_ns = rtc::TimeNanos() - start_ns;
+  start_ns = rtc::TimeNanos();
+  for (size_t i = 0; i < kNumJoins; ++i) {
+    WebRtcOpusDecInst*& decoder = decoders[i % kNumStreams];
+    pool->Return(decoder);
+    decoder = pool->Take(1);
+  }
+  const int64_t pool_ns = rtc::TimeNanos() - start_ns;
+
+  printf("Decoding %" PRIuS " streams: %.2f us per packet, %.2f%% of a core\n",
+         kNumStreams,
+         decode_ns / 1000.0 / (kNumPackets * kNumStreams),
+         100.0 * decode_ns /
+             (kNumPackets * kOpusBlockDurationMs * rtc::kNumNanosecsPerMillisec));
+  printf("Joining: %.2f us with a new decoder state, %.2f us from the pool "
+         "(%" PRIuS " states for %" PRIuS " joins)\n",
+         create_ns / 1000.0 / kNumJoins, pool_ns / 1000.0 / kNumJoins,
+         pool->num_states(), kNumJoins);
+
+  for (WebRtcOpusDecInst* decoder : decoders)
+    pool->Return(decoder);
+}
+
 }  // namespace webrtc
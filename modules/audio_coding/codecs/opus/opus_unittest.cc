@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/modules/audio_coding/codecs/opus/opus_inst.h"
@@ -462,6 +463,45 @@ TEST_P(OpusTest, OpusDecodeInit) {
   EXPECT_EQ(0, WebRtcOpus_DecoderFree(opus_decoder_));
 }
 
+// Encode two frames, initialize the encoder and encode the first frame once
+// more, which gives the same packet as the first time.
+TEST_P(OpusTest, OpusEncodeInit) {
+  PrepareSpeechData(channels_, 20, 40);
+
+  // Test without creating encoder memory.
+  EXPECT_EQ(-1, WebRtcOpus_EncoderInit(opus_encoder_));
+
+  // Create encoder memory.
+  EXPECT_EQ(0, WebRtcOpus_EncoderCreate(&opus_encoder_,
+                                        channels_,
+                                        application_));
+
+  const rtc::ArrayView<const int16_t> first_block =
+      speech_data_.GetNextBlock();
+  const std::vector<int16_t> first_audio(first_block.begin(),
+                                         first_block.end());
+  int encoded_bytes_int =
+      WebRtcOpus_Encode(opus_encoder_, first_audio.data(),
+                        kOpus20msFrameSamples, kMaxBytes, bitstream_);
+  ASSERT_GT(encoded_bytes_int, 0);
+  const std::vector<uint8_t> first_packet(bitstream_,
+                                          bitstream_ + encoded_bytes_int);
+  EXPECT_GT(WebRtcOpus_Encode(opus_encoder_,
+                              speech_data_.GetNextBlock().data(),
+                              kOpus20msFrameSamples, kMaxBytes, bitstream_),
+            0);
+
+  EXPECT_EQ(0, WebRtcOpus_EncoderInit(opus_encoder_));
+  encoded_bytes_int =
+      WebRtcOpus_Encode(opus_encoder_, first_audio.data(),
+                        kOpus20msFrameSamples, kMaxBytes, bitstream_);
+  EXPECT_EQ(first_packet,
+            std::vector<uint8_t>(bitstream_, bitstream_ + encoded_bytes_int));
+
+  // Free memory.
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(opus_encoder_));
+}
+
 TEST_P(OpusTest, OpusEnableDisableFec) {
   // Test without creating encoder memory.
   EXPECT_EQ(-1, WebRtcOpus_EnableFec(opus_encoder_));
@@ -8,13 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-// This is the implementation of the PacketBuffer class. It is mostly based on
-// an STL list. The list is kept sorted at all times so that the next packet to
-// decode is at the beginning of the list.
+// This is the implementation of the PacketBuffer class. It is based on a ring
+// of packet slots, kept sorted at all times so that the next packet to decode
+// is at the beginning of the ring.
 
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 
-#include <algorithm>  // find_if()
+#include <algorithm>  // max()
 
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/audio_coding/codecs/audio_decoder.h"
@@ -23,21 +23,6 @@
 
 namespace webrtc {
 namespace {
-// Predicate used when inserting packets in the buffer list.
-// Operator() returns true when |packet| goes before |new_packet|.
-class NewTimestampIsLarger {
- public:
-  explicit NewTimestampIsLarger(const Packet& new_packet)
-      : new_packet_(new_packet) {
-  }
-  bool operator()(const Packet& packet) {
-    return (new_packet_ >= packet);
-  }
-
- private:
-  const Packet& new_packet_;
-};
-
 // Returns true if both payload types are known to the decoder database, and
 // have the same sample rate.
 bool EqualSampleRates(uint8_t pt1,
@@ -51,7 +36,13 @@ bool EqualSampleRates(uint8_t pt1,
 
 PacketBuffer::PacketBuffer(size_t max_number_of_packets,
                            const TickTimer* tick_timer)
-    : max_number_of_packets_(max_number_of_packets), tick_timer_(tick_timer) {}
+    : max_number_of_packets_(max_number_of_packets),
+      // A full buffer is flushed before inserting, so it never holds more
+      // than |max_number_of_packets| packets, or one if that is zero.
+      slots_(std::max<size_t>(max_number_of_packets, 1)),
+      first_slot_(0),
+      num_packets_(0),
+      tick_timer_(tick_timer) {}
 
 // Destructor. All packets in the buffer will be destroyed.
 PacketBuffer::~PacketBuffer() {
@@ -60,11 +51,13 @@ PacketBuffer::~PacketBuffer() {
 
 // Flush the buffer. All packets in the buffer will be destroyed.
 void PacketBuffer::Flush() {
-  buffer_.clear();
+  while (!Empty())
+    PopFront();
+  first_slot_ = 0;
 }
 
 bool PacketBuffer::Empty() const {
-  return buffer_.empty();
+  return num_packets_ == 0;
 }
 
 int PacketBuffer::InsertPacket(Packet&& packet) {
@@ -80,39 +73,71 @@ int PacketBuffer::InsertPacket(Packet&& packet) {
 
   packet.waiting_time = tick_timer_->GetNewStopwatch();
 
-  if (buffer_.size() >= max_number_of_packets_) {
+  if (num_packets_ >= max_number_of_packets_) {
     // Buffer is full. Flush it.
     Flush();
     LOG(LS_WARNING) << "Packet buffer flushed";
     return_val = kFlushed;
   }
 
-  // Get an iterator pointing to the place in the buffer where the new packet
-  // should be inserted. The list is searched from the back, since the most
-  // likely case is that the new packet should be near the end of the list.
-  PacketList::reverse_iterator rit = std::find_if(
-      buffer_.rbegin(), buffer_.rend(),
-      NewTimestampIsLarger(packet));
-
-  // The new packet is to be inserted to the right of |rit|. If it has the same
-  // timestamp as |rit|, which has a higher priority, do not insert the new
-  // packet to list.
-  if (rit != buffer_.rend() && packet.timestamp == rit->timestamp) {
+  // The new packet is to be inserted after |index| - 1. If it has the same
+  // timestamp as that packet, which has a higher priority, do not insert the
+  // new packet.
+  size_t index = InsertionIndex(packet);
+  if (index > 0 && packet.timestamp == PacketAt(index - 1).timestamp) {
     return return_val;
   }
 
-  // The new packet is to be inserted to the left of |it|. If it has the same
-  // timestamp as |it|, which has a lower priority, replace |it| with the new
-  // packet.
-  PacketList::iterator it = rit.base();
-  if (it != buffer_.end() && packet.timestamp == it->timestamp) {
-    it = buffer_.erase(it);
+  // The new packet is to be inserted before |index|. If it has the same
+  // timestamp as that packet, which has a lower priority, replace it with the
+  // new packet.
+  if (index < num_packets_ && packet.timestamp == PacketAt(index).timestamp) {
+    PacketAt(index) = std::move(packet);
+    return return_val;
+  }
+
+  // Make room by moving the packets on the shorter side of |index|.
+  RTC_DCHECK_LT(num_packets_, slots_.size());
+  if (index < num_packets_ / 2) {
+    first_slot_ = (first_slot_ + slots_.size() - 1) % slots_.size();
+    for (size_t i = 0; i < index; ++i)
+      PacketAt(i) = std::move(PacketAt(i + 1));
+  } else {
+    for (size_t i = num_packets_; i > index; --i)
+      PacketAt(i) = std::move(PacketAt(i - 1));
   }
-  buffer_.insert(it, std::move(packet));  // Insert the packet at that position.
+  PacketAt(index) = std::move(packet);
+  ++num_packets_;
 
   return return_val;
 }
 
+size_t PacketBuffer::InsertionIndex(const Packet& packet) const {
+  // The most likely case is that the new packet goes last.
+  if (num_packets_ == 0 || packet >= PacketAt(num_packets_ - 1))
+    return num_packets_;
+  // Binary search for the first packet newer than |packet|.
+  size_t low = 0;
+  size_t high = num_packets_ - 1;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (packet >= PacketAt(middle)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+void PacketBuffer::PopFront() {
+  RTC_DCHECK(!Empty());
+  // Destroys the packet, leaving an empty one in the slot.
+  PacketAt(0) = Packet();
+  first_slot_ = (first_slot_ + 1) % slots_.size();
+  --num_packets_;
+}
+
 int PacketBuffer::InsertPacketList(
     PacketList* packet_list,
     const DecoderDatabase& decoder_database,
@@ -165,7 +190,7 @@ int PacketBuffer::NextTimestamp(uint32_t* next_timestamp) const {
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  *next_timestamp = buffer_.front().timestamp;
+  *next_timestamp = PacketAt(0).timestamp;
   return kOK;
 }
 
@@ -177,11 +202,10 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  PacketList::const_iterator it;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    if (it->timestamp >= timestamp) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    if (PacketAt(i).timestamp >= timestamp) {
       // Found a packet matching the search.
-      *next_timestamp = it->timestamp;
+      *next_timestamp = PacketAt(i).timestamp;
       return kOK;
     }
   }
@@ -189,7 +213,7 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
 }
 
 const Packet* PacketBuffer::PeekNextPacket() const {
-  return buffer_.empty() ? nullptr : &buffer_.front();
+  return Empty() ? nullptr : &PacketAt(0);
 }
 
 rtc::Optional<Packet> PacketBuffer::GetNextPacket() {
@@ -198,10 +222,10 @@ rtc::Optional<Packet> PacketBuffer::GetNextPacket() {
     return rtc::Optional<Packet>();
   }
 
-  rtc::Optional<Packet> packet(std::move(buffer_.front()));
+  rtc::Optional<Packet> packet(std::move(PacketAt(0)));
   // Assert that the packet sanity checks in InsertPacket method works.
   RTC_DCHECK(!packet->empty());
-  buffer_.pop_front();
+  PopFront();
 
   return packet;
 }
@@ -211,15 +235,15 @@ int PacketBuffer::DiscardNextPacket() {
     return kBufferEmpty;
   }
   // Assert that the packet sanity checks in InsertPacket method works.
-  RTC_DCHECK(!buffer_.front().empty());
-  buffer_.pop_front();
+  RTC_DCHECK(!PacketAt(0).empty());
+  PopFront();
   return kOK;
 }
 
 int PacketBuffer::DiscardOldPackets(uint32_t timestamp_limit,
                                     uint32_t horizon_samples) {
-  while (!Empty() && timestamp_limit != buffer_.front().timestamp &&
-         IsObsoleteTimestamp(buffer_.front().timestamp, timestamp_limit,
+  while (!Empty() && timestamp_limit != PacketAt(0).timestamp &&
+         IsObsoleteTimestamp(PacketAt(0).timestamp, timestamp_limit,
                              horizon_samples)) {
     if (DiscardNextPacket() != kOK) {
       assert(false);  // Must be ok by design.
@@ -233,24 +257,29 @@ int PacketBuffer::DiscardAllOldPackets(uint32_t timestamp_limit) {
 }
 
 void PacketBuffer::DiscardPacketsWithPayloadType(uint8_t payload_type) {
-  for (auto it = buffer_.begin(); it != buffer_.end(); /* */) {
-    const Packet& packet = *it;
-    if (packet.payload_type == payload_type) {
-      it = buffer_.erase(it);
-    } else {
-      ++it;
-    }
+  // Moves the packets to keep towards the front.
+  size_t num_kept = 0;
+  for (size_t i = 0; i < num_packets_; ++i) {
+    if (PacketAt(i).payload_type == payload_type)
+      continue;
+    if (num_kept != i)
+      PacketAt(num_kept) = std::move(PacketAt(i));
+    ++num_kept;
   }
+  for (size_t i = num_kept; i < num_packets_; ++i)
+    PacketAt(i) = Packet();
+  num_packets_ = num_kept;
 }
 
 size_t PacketBuffer::NumPacketsInBuffer() const {
-  return buffer_.size();
+  return num_packets_;
 }
 
 size_t PacketBuffer::NumSamplesInBuffer(size_t last_decoded_length) const {
   size_t num_samples = 0;
   size_t last_duration = last_decoded_length;
-  for (const Packet& packet : buffer_) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    const Packet& packet = PacketAt(i);
     if (packet.frame) {
       // TODO(hlundin): Verify that it's fine to count all packets and remove
       // this check.
@@ -268,7 +297,7 @@ size_t PacketBuffer::NumSamplesInBuffer(size_t last_decoded_length) const {
 }
 
 void PacketBuffer::BufferStat(int* num_packets, int* max_num_packets) const {
-  *num_packets = static_cast<int>(buffer_.size());
+  *num_packets = static_cast<int>(num_packets_);
   *max_num_packets = static_cast<int>(max_number_of_packets_);
 }
 
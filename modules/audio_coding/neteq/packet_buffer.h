@@ -11,6 +11,8 @@
 #ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 #define WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 
+#include <vector>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/optional.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"
@@ -22,7 +24,9 @@ namespace webrtc {
 class DecoderDatabase;
 class TickTimer;
 
-// This is the actual buffer holding the packets before decoding.
+// This is the actual buffer holding the packets before decoding. The packets
+// are kept sorted in a ring of slots allocated up front, so that inserting and
+// extracting packets doesn't allocate.
 class PacketBuffer {
  public:
   enum BufferReturnCodes {
@@ -134,8 +138,25 @@ class PacketBuffer {
   }
 
  private:
+  // The |index|th packet in timestamp order.
+  Packet& PacketAt(size_t index) {
+    return slots_[(first_slot_ + index) % slots_.size()];
+  }
+  const Packet& PacketAt(size_t index) const {
+    return slots_[(first_slot_ + index) % slots_.size()];
+  }
+  // Returns the index at which |packet| goes, after all packets which are not
+  // newer.
+  size_t InsertionIndex(const Packet& packet) const;
+  // Destroys the first packet.
+  void PopFront();
+
   size_t max_number_of_packets_;
-  PacketList buffer_;
+  // Holds |num_packets_| packets from |first_slot_| on, wrapping around. Slots
+  // outside of that range hold empty packets.
+  std::vector<Packet> slots_;
+  size_t first_slot_;
+  size_t num_packets_;
   const TickTimer* tick_timer_;
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketBuffer);
 };
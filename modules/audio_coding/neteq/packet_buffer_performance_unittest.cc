@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
+#include "webrtc/modules/audio_coding/neteq/tick_timer.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumStreams = 50;
+constexpr size_t kMaxPackets = 50;
+constexpr int kNumRounds = 20000;
+constexpr uint32_t kSamplesPerPacket = 960;
+constexpr size_t kPayloadSize = 80;
+// Packets are delayed by up to this many packet times, so that they arrive
+// out of order.
+constexpr int kMaxJitterPackets = 4;
+// The number of packets kept buffered.
+constexpr int kTargetLevelPackets = 6;
+
+// The packets of one stream, generated ahead of time so that only the buffer
+// is measured.
+struct Stream {
+  std::vector<Packet> arrivals;
+  size_t next_arrival = 0;
+};
+
+Packet CreatePacket(int index, uint8_t payload_type) {
+  Packet packet;
+  packet.timestamp = index * kSamplesPerPacket;
+  packet.sequence_number = static_cast<uint16_t>(index);
+  packet.payload_type = payload_type;
+  packet.payload.SetSize(kPayloadSize);
+  return packet;
+}
+}  // namespace
+
+// The packet buffers of a process receiving 50 Opus streams, each getting and
+// playing out one packet per round, with jitter reordering the arrivals.
+TEST(PacketBufferPerformanceTest, FiftyStreams) {
+  Random random(0x5eed);
+  TickTimer tick_timer;
+  std::vector<std::unique_ptr<PacketBuffer>> buffers;
+  std::vector<Stream> streams(kNumStreams);
+  for (int i = 0; i < kNumStreams; ++i) {
+    buffers.emplace_back(new PacketBuffer(kMaxPackets, &tick_timer));
+    // Swaps packets with one up to kMaxJitterPackets later.
+    const int num_packets = kNumRounds + kTargetLevelPackets;
+    std::vector<int> order(num_packets);
+    for (int j = 0; j < num_packets; ++j)
+      order[j] = j;
+    for (int j = 0; j + kMaxJitterPackets < num_packets; ++j) {
+      if (random.Rand(0, 3) == 0)
+        std::swap(order[j], order[j + random.Rand(1, kMaxJitterPackets)]);
+    }
+    for (int index : order)
+      streams[i].arrivals.push_back(CreatePacket(index, i % 2));
+  }
+
+  int64_t insert_ns = 0;
+  int64_t extract_ns = 0;
+  size_t num_extracted = 0;
+  for (int round = 0; round < kNumRounds + kTargetLevelPackets; ++round) {
+    const int64_t insert_start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumStreams; ++i) {
+      Stream& stream = streams[i];
+      buffers[i]->InsertPacket(
+          std::move(stream.arrivals[stream.next_arrival++]));
+    }
+    const int64_t extract_start_ns = rtc::TimeNanos();
+    insert_ns += extract_start_ns - insert_start_ns;
+    if (round < kTargetLevelPackets)
+      continue;
+    for (auto& buffer : buffers) {
+      const uint32_t playout_timestamp =
+          (round - kTargetLevelPackets) * kSamplesPerPacket;
+      buffer->DiscardOldPackets(playout_timestamp, 0);
+      if (buffer->GetNextPacket())
+        ++num_extracted;
+    }
+    extract_ns += rtc::TimeNanos() - extract_start_ns;
+  }
+
+  const int num_inserted = kNumStreams * (kNumRounds + kTargetLevelPackets);
+  // Nearly all packets arrive before their playout time.
+  EXPECT_GT(num_extracted,
+            static_cast<size_t>(kNumStreams * kNumRounds * 9 / 10));
+  webrtc::test::PrintResult("packet_buffer", "_50_streams", "insert",
+                            insert_ns / num_inserted, "ns/packet", true);
+  webrtc::test::PrintResult("packet_buffer", "_50_streams", "extract",
+                            extract_ns / (kNumStreams * kNumRounds),
+                            "ns/packet", true);
+}
+
+}  // namespace webrtc
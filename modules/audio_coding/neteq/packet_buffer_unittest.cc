@@ -12,6 +12,10 @@
 
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 
+#include <algorithm>
+#include <list>
+
+#include "webrtc/base/random.h"
 #include "webrtc/modules/audio_coding/codecs/builtin_audio_decoder_factory.h"
 #include "webrtc/modules/audio_coding/neteq/mock/mock_decoder_database.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"
@@ -603,6 +607,159 @@ TEST(PacketBuffer, ComparePackets) {
   EXPECT_TRUE(d >= b);
 }
 
+namespace {
+// The list based packet buffer which PacketBuffer replaced, as a reference for
+// the behavior PacketBuffer must keep.
+class ListPacketBuffer {
+ public:
+  explicit ListPacketBuffer(size_t max_number_of_packets)
+      : max_number_of_packets_(max_number_of_packets) {}
+
+  int InsertPacket(Packet&& packet) {
+    int return_val = PacketBuffer::kOK;
+    if (buffer_.size() >= max_number_of_packets_) {
+      buffer_.clear();
+      return_val = PacketBuffer::kFlushed;
+    }
+    auto rit = std::find_if(
+        buffer_.rbegin(), buffer_.rend(),
+        [&packet](const Packet& other) { return packet >= other; });
+    if (rit != buffer_.rend() && packet.timestamp == rit->timestamp)
+      return return_val;
+    auto it = rit.base();
+    if (it != buffer_.end() && packet.timestamp == it->timestamp)
+      it = buffer_.erase(it);
+    buffer_.insert(it, std::move(packet));
+    return return_val;
+  }
+
+  rtc::Optional<Packet> GetNextPacket() {
+    if (buffer_.empty())
+      return rtc::Optional<Packet>();
+    rtc::Optional<Packet> packet(std::move(buffer_.front()));
+    buffer_.pop_front();
+    return packet;
+  }
+
+  void DiscardOldPackets(uint32_t timestamp_limit, uint32_t horizon_samples) {
+    while (!buffer_.empty() && timestamp_limit != buffer_.front().timestamp &&
+           PacketBuffer::IsObsoleteTimestamp(buffer_.front().timestamp,
+                                             timestamp_limit,
+                                             horizon_samples)) {
+      buffer_.pop_front();
+    }
+  }
+
+  void DiscardPacketsWithPayloadType(uint8_t payload_type) {
+    buffer_.remove_if([payload_type](const Packet& packet) {
+      return packet.payload_type == payload_type;
+    });
+  }
+
+  int NextHigherTimestamp(uint32_t timestamp, uint32_t* next_timestamp) const {
+    if (buffer_.empty())
+      return PacketBuffer::kBufferEmpty;
+    for (const Packet& packet : buffer_) {
+      if (packet.timestamp >= timestamp) {
+        *next_timestamp = packet.timestamp;
+        return PacketBuffer::kOK;
+      }
+    }
+    return PacketBuffer::kNotFound;
+  }
+
+  void Flush() { buffer_.clear(); }
+  const std::list<Packet>& packets() const { return buffer_; }
+
+ private:
+  const size_t max_number_of_packets_;
+  std::list<Packet> buffer_;
+};
+
+void ExpectSamePackets(const ListPacketBuffer& reference,
+                       PacketBuffer* buffer) {
+  ASSERT_EQ(reference.packets().size(), buffer->NumPacketsInBuffer());
+  if (reference.packets().empty()) {
+    EXPECT_TRUE(buffer->Empty());
+    return;
+  }
+  const Packet* next_packet = buffer->PeekNextPacket();
+  ASSERT_TRUE(next_packet);
+  EXPECT_EQ(reference.packets().front(), *next_packet);
+  EXPECT_EQ(reference.packets().front().payload_type,
+            next_packet->payload_type);
+  EXPECT_EQ(reference.packets().size() * 10, buffer->NumSamplesInBuffer(10));
+}
+}  // namespace
+
+// Runs random sequences of insertions, extractions and discards, with
+// reordering, duplicates, redundant packets and timestamp wrap-around, on
+// PacketBuffer and on the list based buffer it replaced, and checks that they
+// agree.
+TEST(PacketBuffer, BehavesAsListBasedBuffer) {
+  Random random(0x4711);
+  TickTimer tick_timer;
+  for (int run = 0; run < 50; ++run) {
+    const size_t max_packets = random.Rand(1, 20);
+    SCOPED_TRACE(max_packets);
+    PacketBuffer buffer(max_packets, &tick_timer);
+    ListPacketBuffer reference(max_packets);
+    // Start close to the wrap-around of both timestamps and sequence numbers.
+    uint32_t timestamp = 0xFFFFFFFF - 40 * 160;
+    uint16_t sequence_number = 0xFFFF - 40;
+    for (int i = 0; i < 500; ++i) {
+      const uint32_t action = random.Rand(0, 99);
+      if (action < 50) {
+        // Insert a packet up to 5 frames late or early, possibly a redundant
+        // copy with lower priority.
+        const int offset = random.Rand(-5, 5);
+        Packet packet;
+        packet.timestamp = timestamp + offset * 160;
+        packet.sequence_number = sequence_number + offset;
+        packet.payload_type = random.Rand(0, 2);
+        packet.priority.codec_level = random.Rand(0, 1);
+        packet.priority.red_level = random.Rand(0, 1);
+        packet.payload.SetSize(10);
+        EXPECT_EQ(reference.InsertPacket(packet.Clone()),
+                  buffer.InsertPacket(std::move(packet)));
+        if (random.Rand(0, 1)) {
+          timestamp += 160;
+          ++sequence_number;
+        }
+      } else if (action < 80) {
+        rtc::Optional<Packet> expected = reference.GetNextPacket();
+        rtc::Optional<Packet> packet = buffer.GetNextPacket();
+        ASSERT_EQ(!!expected, !!packet);
+        if (expected) {
+          EXPECT_EQ(*expected, *packet);
+        }
+      } else if (action < 90) {
+        const uint32_t limit = timestamp - random.Rand(0, 5) * 160;
+        const uint32_t horizon = random.Rand(0, 1) * 3 * 160;
+        reference.DiscardOldPackets(limit, horizon);
+        buffer.DiscardOldPackets(limit, horizon);
+      } else if (action < 95) {
+        const uint8_t payload_type = random.Rand(0, 2);
+        reference.DiscardPacketsWithPayloadType(payload_type);
+        buffer.DiscardPacketsWithPayloadType(payload_type);
+      } else if (action < 98) {
+        const uint32_t limit = timestamp - random.Rand(0, 5) * 160;
+        uint32_t expected_timestamp = 0;
+        uint32_t next_timestamp = 0;
+        EXPECT_EQ(reference.NextHigherTimestamp(limit, &expected_timestamp),
+                  buffer.NextHigherTimestamp(limit, &next_timestamp));
+        EXPECT_EQ(expected_timestamp, next_timestamp);
+      } else {
+        reference.Flush();
+        buffer.Flush();
+      }
+      ExpectSamePackets(reference, &buffer);
+      if (HasFatalFailure())
+        return;
+    }
+  }
+}
+
 namespace {
 void TestIsObsoleteTimestamp(uint32_t limit_timestamp) {
   // Check with zero horizon, which implies that the horizon is at 2^31, i.e.,
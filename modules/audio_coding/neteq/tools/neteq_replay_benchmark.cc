@@ -0,0 +1,457 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Replays RTP dumps, pcap files and RtcEventLog files through NetEq as fast as
+// the CPU allows, and writes one CSV line per trace with the CPU time NetEq
+// spent per second of produced audio, the expand, accelerate and preemptive
+// expand rates, the packet waiting times and the jitter buffer size. The
+// traces are replayed in parallel on a pool of worker threads, so that large
+// sets of production traces can be compared before and after a change to
+// NetEq or the decoders.
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/base/format_macros.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/audio_coding/neteq/include/neteq.h"
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_packet_source_input.h"
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_test.h"
+#include "webrtc/modules/audio_coding/neteq/tools/rtp_file_source.h"
+#include "webrtc/test/parallel_runner.h"
+
+namespace flags {
+
+DEFINE_string(input_list,
+              "",
+              "File with the paths of more traces to replay, one per line.");
+DEFINE_int32(audio_level, 1, "Extension ID for audio level (RFC 6464)");
+DEFINE_int32(abs_send_time, 3, "Extension ID for absolute sender time");
+
+}  // namespace flags
+
+namespace webrtc {
+namespace test {
+namespace {
+
+struct CodecInfo {
+  int payload_type;
+  NetEqDecoder decoder;
+  const char* name;
+  int sample_rate_hz;
+};
+
+// The default payload types of neteq_rtpplay.
+const CodecInfo kCodecs[] = {
+    {0, NetEqDecoder::kDecoderPCMu, "pcmu", 8000},
+    {8, NetEqDecoder::kDecoderPCMa, "pcma", 8000},
+    {102, NetEqDecoder::kDecoderILBC, "ilbc", 8000},
+    {103, NetEqDecoder::kDecoderISAC, "isac", 16000},
+    {104, NetEqDecoder::kDecoderISACswb, "isac-swb", 32000},
+    {111, NetEqDecoder::kDecoderOpus, "opus", 48000},
+    {93, NetEqDecoder::kDecoderPCM16B, "pcm16-nb", 8000},
+    {94, NetEqDecoder::kDecoderPCM16Bwb, "pcm16-wb", 16000},
+    {95, NetEqDecoder::kDecoderPCM16Bswb32kHz, "pcm16-swb32", 32000},
+    {96, NetEqDecoder::kDecoderPCM16Bswb48kHz, "pcm16-swb48", 48000},
+    {9, NetEqDecoder::kDecoderG722, "g722", 16000},
+    {106, NetEqDecoder::kDecoderAVT, "avt", 8000},
+    {114, NetEqDecoder::kDecoderAVT16kHz, "avt-16", 16000},
+    {115, NetEqDecoder::kDecoderAVT32kHz, "avt-32", 32000},
+    {116, NetEqDecoder::kDecoderAVT48kHz, "avt-48", 48000},
+    {117, NetEqDecoder::kDecoderRED, "red", 0},
+    {13, NetEqDecoder::kDecoderCNGnb, "cng-nb", 8000},
+    {98, NetEqDecoder::kDecoderCNGwb, "cng-wb", 16000},
+    {99, NetEqDecoder::kDecoderCNGswb32kHz, "cng-swb32", 32000},
+    {100, NetEqDecoder::kDecoderCNGswb48kHz, "cng-swb48", 48000}};
+
+const CodecInfo* FindCodec(int payload_type) {
+  for (const CodecInfo& codec : kCodecs) {
+    if (codec.payload_type == payload_type)
+      return &codec;
+  }
+  return nullptr;
+}
+
+// The CPU time used by the calling thread, which unlike the wall time doesn't
+// depend on how many other traces are replayed at the same time.
+int64_t ThreadCpuTimeUs() {
+#if defined(WEBRTC_WIN)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time,
+                      &kernel_time, &user_time)) {
+    return 0;
+  }
+  const uint64_t total_100ns =
+      ((static_cast<uint64_t>(kernel_time.dwHighDateTime) << 32) |
+       kernel_time.dwLowDateTime) +
+      ((static_cast<uint64_t>(user_time.dwHighDateTime) << 32) |
+       user_time.dwLowDateTime);
+  return static_cast<int64_t>(total_100ns / 10);
+#else
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * rtc::kNumMicrosecsPerSec +
+         ts.tv_nsec / rtc::kNumNanosecsPerMicrosec;
+#endif
+}
+
+// Reads all events of another NetEqInput up front, in the order NetEqTest
+// consumes them, so that the replay measures NetEq and not the file parsing.
+// Only the packets of the SSRC of the first packet are kept, since a trace may
+// hold several incoming audio streams.
+class PreloadedInput : public NetEqInput {
+ public:
+  explicit PreloadedInput(std::unique_ptr<NetEqInput> source) {
+    rtc::Optional<RTPHeader> first_header = source->NextHeader();
+    while (!source->ended()) {
+      const int64_t time_ms = *source->NextEventTime();
+      if (source->NextPacketTime() && time_ms >= *source->NextPacketTime()) {
+        std::unique_ptr<PacketData> packet = source->PopPacket();
+        if (packet->header.header.ssrc == first_header->ssrc)
+          packets_.push_back(std::move(packet));
+      }
+      if (source->NextOutputEventTime() &&
+          time_ms >= *source->NextOutputEventTime()) {
+        output_event_times_ms_.push_back(*source->NextOutputEventTime());
+        source->AdvanceOutputEvent();
+      }
+    }
+  }
+
+  rtc::Optional<int64_t> NextPacketTime() const override {
+    if (next_packet_ == packets_.size())
+      return rtc::Optional<int64_t>();
+    return rtc::Optional<int64_t>(
+        static_cast<int64_t>(packets_[next_packet_]->time_ms));
+  }
+
+  rtc::Optional<int64_t> NextOutputEventTime() const override {
+    if (next_output_event_ == output_event_times_ms_.size())
+      return rtc::Optional<int64_t>();
+    return rtc::Optional<int64_t>(output_event_times_ms_[next_output_event_]);
+  }
+
+  std::unique_ptr<PacketData> PopPacket() override {
+    if (next_packet_ == packets_.size())
+      return std::unique_ptr<PacketData>();
+    return std::move(packets_[next_packet_++]);
+  }
+
+  void AdvanceOutputEvent() override {
+    if (next_output_event_ < output_event_times_ms_.size())
+      ++next_output_event_;
+  }
+
+  bool ended() const override {
+    return next_output_event_ == output_event_times_ms_.size();
+  }
+
+  rtc::Optional<RTPHeader> NextHeader() const override {
+    if (next_packet_ == packets_.size())
+      return rtc::Optional<RTPHeader>();
+    return rtc::Optional<RTPHeader>(packets_[next_packet_]->header.header);
+  }
+
+  size_t num_packets() const { return packets_.size(); }
+
+ private:
+  std::vector<std::unique_ptr<PacketData>> packets_;
+  size_t next_packet_ = 0;
+  std::vector<int64_t> output_event_times_ms_;
+  size_t next_output_event_ = 0;
+};
+
+// Counts the errors instead of aborting, since one broken trace shouldn't end
+// the replay of all others.
+class CountingErrorCallback : public NetEqTestErrorCallback {
+ public:
+  void OnInsertPacketError(int error_code,
+                           const NetEqInput::PacketData& packet) override {
+    ++num_insert_errors_;
+  }
+  void OnGetAudioError(int error_code) override { ++num_get_audio_errors_; }
+
+  int num_insert_errors() const { return num_insert_errors_; }
+  int num_get_audio_errors() const { return num_get_audio_errors_; }
+
+ private:
+  int num_insert_errors_ = 0;
+  int num_get_audio_errors_ = 0;
+};
+
+// The statistics of a whole trace, in percent where not noted.
+struct TraceStats {
+  double expand_rate = 0.0;
+  double speech_expand_rate = 0.0;
+  double accelerate_rate = 0.0;
+  double preemptive_rate = 0.0;
+  double packet_loss_rate = 0.0;
+  double mean_waiting_time_ms = 0.0;
+  int max_waiting_time_ms = 0;
+  double mean_buffer_size_ms = 0.0;
+};
+
+// NetEq only keeps the statistics of about a minute, and of the last 100
+// packets for the waiting times, so they are polled once a second like a call
+// does, and the rates of the intervals averaged by their duration.
+class StatsCollector : public NetEqGetAudioCallback {
+ public:
+  void AfterGetAudio(int64_t time_now_ms,
+                     const AudioFrame& audio_frame,
+                     NetEq* neteq) override {
+    interval_ms_ += kOutputPeriodMs;
+    if (interval_ms_ < kPollIntervalMs)
+      return;
+    NetEqNetworkStatistics stats;
+    if (neteq->NetworkStatistics(&stats) == 0)
+      AddInterval(stats);
+  }
+
+  // Adds the statistics since the last poll, at the end of the trace.
+  void AddInterval(const NetEqNetworkStatistics& stats) {
+    if (interval_ms_ == 0)
+      return;
+    expand_ += Q14ToFraction(stats.expand_rate) * interval_ms_;
+    speech_expand_ += Q14ToFraction(stats.speech_expand_rate) * interval_ms_;
+    accelerate_ += Q14ToFraction(stats.accelerate_rate) * interval_ms_;
+    preemptive_ += Q14ToFraction(stats.preemptive_rate) * interval_ms_;
+    packet_loss_ += Q14ToFraction(stats.packet_loss_rate) * interval_ms_;
+    if (stats.mean_waiting_time_ms >= 0) {
+      waiting_time_ms_ += stats.mean_waiting_time_ms * interval_ms_;
+      waiting_time_duration_ms_ += interval_ms_;
+      max_waiting_time_ms_ =
+          std::max(max_waiting_time_ms_, stats.max_waiting_time_ms);
+    }
+    buffer_size_ms_ += stats.current_buffer_size_ms * interval_ms_;
+    duration_ms_ += interval_ms_;
+    interval_ms_ = 0;
+  }
+
+  TraceStats GetStats() const {
+    TraceStats stats;
+    if (duration_ms_ == 0)
+      return stats;
+    stats.expand_rate = 100.0 * expand_ / duration_ms_;
+    stats.speech_expand_rate = 100.0 * speech_expand_ / duration_ms_;
+    stats.accelerate_rate = 100.0 * accelerate_ / duration_ms_;
+    stats.preemptive_rate = 100.0 * preemptive_ / duration_ms_;
+    stats.packet_loss_rate = 100.0 * packet_loss_ / duration_ms_;
+    if (waiting_time_duration_ms_ > 0)
+      stats.mean_waiting_time_ms = waiting_time_ms_ / waiting_time_duration_ms_;
+    stats.max_waiting_time_ms = max_waiting_time_ms_;
+    stats.mean_buffer_size_ms = buffer_size_ms_ / duration_ms_;
+    return stats;
+  }
+
+ private:
+  static const int64_t kOutputPeriodMs = 10;
+  static const int64_t kPollIntervalMs = 1000;
+
+  static double Q14ToFraction(uint16_t value) { return value / 16384.0; }
+
+  int64_t interval_ms_ = 0;
+  int64_t duration_ms_ = 0;
+  double expand_ = 0.0;
+  double speech_expand_ = 0.0;
+  double accelerate_ = 0.0;
+  double preemptive_ = 0.0;
+  double packet_loss_ = 0.0;
+  double waiting_time_ms_ = 0.0;
+  int64_t waiting_time_duration_ms_ = 0;
+  int max_waiting_time_ms_ = 0;
+  double buffer_size_ms_ = 0.0;
+};
+
+struct TraceResult {
+  // Empty if the trace was replayed.
+  std::string error;
+  std::string codec;
+  size_t num_packets = 0;
+  int64_t audio_ms = 0;
+  int64_t load_ms = 0;
+  int64_t cpu_us = 0;
+  TraceStats stats;
+  int num_insert_errors = 0;
+  int num_get_audio_errors = 0;
+};
+
+TraceResult ReplayTrace(const std::string& file_name) {
+  TraceResult result;
+  // The packet sources crash on files they can't open.
+  FILE* file = fopen(file_name.c_str(), "rb");
+  if (!file) {
+    result.error = "cannot open file";
+    return result;
+  }
+  fclose(file);
+  const int64_t load_start_ms = rtc::TimeMillis();
+  const NetEqPacketSourceInput::RtpHeaderExtensionMap rtp_ext_map = {
+      {flags::FLAGS_audio_level, kRtpExtensionAudioLevel},
+      {flags::FLAGS_abs_send_time, kRtpExtensionAbsoluteSendTime}};
+  std::unique_ptr<NetEqInput> source;
+  if (RtpFileSource::ValidRtpDump(file_name) ||
+      RtpFileSource::ValidPcap(file_name)) {
+    source.reset(new NetEqRtpDumpInput(file_name, rtp_ext_map));
+  } else {
+    source.reset(new NetEqEventLogInput(file_name, rtp_ext_map));
+  }
+  rtc::Optional<RTPHeader> first_header = source->NextHeader();
+  if (source->ended() || !first_header) {
+    result.error = "no audio packets";
+    return result;
+  }
+  const CodecInfo* codec = FindCodec(first_header->payloadType);
+  if (!codec || codec->sample_rate_hz == 0) {
+    result.error = "unknown payload type " +
+                   std::to_string(first_header->payloadType);
+    return result;
+  }
+  std::unique_ptr<PreloadedInput> input(new PreloadedInput(std::move(source)));
+  if (input->ended()) {
+    result.error = "no output events";
+    return result;
+  }
+  result.codec = codec->name;
+  result.num_packets = input->num_packets();
+  result.load_ms = rtc::TimeMillis() - load_start_ms;
+
+  NetEqTest::DecoderMap codecs;
+  for (const CodecInfo& info : kCodecs)
+    codecs[info.payload_type] = std::make_pair(info.decoder, info.name);
+  CountingErrorCallback error_callback;
+  StatsCollector stats_collector;
+  NetEq::Config config;
+  config.sample_rate_hz = codec->sample_rate_hz;
+  // Setting up NetEq is part of the cost of a call, so it is measured too.
+  const int64_t cpu_start_us = ThreadCpuTimeUs();
+  NetEqTest test(config, codecs, NetEqTest::ExtDecoderMap(), std::move(input),
+                 nullptr, &error_callback, &stats_collector);
+  result.audio_ms = test.Run();
+  result.cpu_us = ThreadCpuTimeUs() - cpu_start_us;
+  stats_collector.AddInterval(test.SimulationStats());
+  result.stats = stats_collector.GetStats();
+  result.num_insert_errors = error_callback.num_insert_errors();
+  result.num_get_audio_errors = error_callback.num_get_audio_errors();
+  return result;
+}
+
+bool ReadInputList(const std::string& list_name,
+                   std::vector<std::string>* file_names) {
+  std::ifstream list(list_name);
+  if (!list.good())
+    return false;
+  std::string line;
+  while (std::getline(list, line)) {
+    if (!line.empty())
+      file_names->push_back(line);
+  }
+  return true;
+}
+
+}  // namespace
+
+int RunReplay(int argc, char* argv[]) {
+  std::vector<std::string> file_names(argv + 1, argv + argc);
+  if (!flags::FLAGS_input_list.empty() &&
+      !ReadInputList(flags::FLAGS_input_list, &file_names)) {
+    fprintf(stderr, "Cannot open input list %s\n",
+            flags::FLAGS_input_list.c_str());
+    return 1;
+  }
+  if (file_names.empty()) {
+    fprintf(stderr, "No input files.\n");
+    return 1;
+  }
+  std::vector<TraceResult> results(file_names.size());
+  // Each result is written by one thread only, and read after all threads are
+  // done.
+  ParallelRunner runner(file_names.size(), "NetEqReplay",
+                        [&file_names, &results](size_t i) {
+                          results[i] = ReplayTrace(file_names[i]);
+                        });
+  if (!runner.OpenOutput())
+    return 1;
+  const int64_t wall_time_ms = runner.Run("traces");
+  FILE* output = runner.output();
+
+  fprintf(output,
+          "file,codec,packets,audio_ms,load_ms,cpu_ms,cpu_ms_per_audio_s,"
+          "expand_rate,speech_expand_rate,accelerate_rate,preemptive_rate,"
+          "packet_loss_rate,mean_waiting_time_ms,max_waiting_time_ms,"
+          "mean_buffer_size_ms,insert_errors,get_audio_errors,error\n");
+  int64_t total_audio_ms = 0;
+  int64_t total_cpu_us = 0;
+  size_t num_failed = 0;
+  for (size_t i = 0; i < file_names.size(); ++i) {
+    const TraceResult& result = results[i];
+    if (!result.error.empty()) {
+      ++num_failed;
+      fprintf(output, "%s,,,,,,,,,,,,,,,,,%s\n", file_names[i].c_str(),
+              result.error.c_str());
+      continue;
+    }
+    total_audio_ms += result.audio_ms;
+    total_cpu_us += result.cpu_us;
+    const TraceStats& stats = result.stats;
+    fprintf(output,
+            "%s,%s,%" PRIuS ",%lld,%lld,%.1f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,"
+            "%.1f,%d,%.1f,%d,%d,\n",
+            file_names[i].c_str(), result.codec.c_str(), result.num_packets,
+            static_cast<long long>(result.audio_ms),
+            static_cast<long long>(result.load_ms), result.cpu_us / 1000.0,
+            result.audio_ms > 0
+                ? static_cast<double>(result.cpu_us) / result.audio_ms
+                : 0.0,
+            stats.expand_rate, stats.speech_expand_rate, stats.accelerate_rate,
+            stats.preemptive_rate, stats.packet_loss_rate,
+            stats.mean_waiting_time_ms, stats.max_waiting_time_ms,
+            stats.mean_buffer_size_ms, result.num_insert_errors,
+            result.num_get_audio_errors);
+  }
+  fflush(output);
+
+  fprintf(stderr, "%" PRIuS " traces failed.\n", num_failed);
+  if (total_audio_ms > 0 && wall_time_ms > 0) {
+    fprintf(stderr,
+            "Replayed %.1f s of audio at %.1f CPU ms per second of audio, "
+            "%.0f times faster than realtime.\n",
+            total_audio_ms / 1000.0,
+            static_cast<double>(total_cpu_us) / total_audio_ms,
+            static_cast<double>(total_audio_ms) / wall_time_ms);
+  }
+  return num_failed == file_names.size() ? 1 : 0;
+}
+
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  google::SetUsageMessage(
+      "Replays RTP dumps, pcap files or RtcEventLog files through NetEq in "
+      "parallel, and writes one CSV line of statistics per trace.\n"
+      "Example usage:\n" +
+      std::string(argv[0]) +
+      " --threads=8 --output=results.csv trace1.rtp trace2.log\n" +
+      std::string(argv[0]) + " --input_list=traces.txt");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  return webrtc::test::RunReplay(argc, argv);
+}
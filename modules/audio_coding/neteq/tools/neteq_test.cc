@@ -45,11 +45,13 @@ NetEqTest::NetEqTest(const NetEq::Config& config,
                      const ExtDecoderMap& ext_codecs,
                      std::unique_ptr<NetEqInput> input,
                      std::unique_ptr<AudioSink> output,
-                     NetEqTestErrorCallback* error_callback)
+                     NetEqTestErrorCallback* error_callback,
+                     NetEqGetAudioCallback* get_audio_callback)
     : neteq_(NetEq::Create(config, CreateBuiltinAudioDecoderFactory())),
       input_(std::move(input)),
       output_(std::move(output)),
       error_callback_(error_callback),
+      get_audio_callback_(get_audio_callback),
       sample_rate_hz_(config.sample_rate_hz) {
   RTC_CHECK(!config.enable_muted_state)
       << "The code does not handle enable_muted_state";
@@ -98,6 +100,10 @@ int64_t NetEqTest::Run() {
             out_frame.data_,
             out_frame.samples_per_channel_ * out_frame.num_channels_));
       }
+      if (get_audio_callback_) {
+        get_audio_callback_->AfterGetAudio(time_now_ms, out_frame,
+                                           neteq_.get());
+      }
 
       input_->AdvanceOutputEvent();
     }
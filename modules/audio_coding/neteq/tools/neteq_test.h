@@ -37,6 +37,16 @@ class DefaultNetEqTestErrorCallback : public NetEqTestErrorCallback {
   void OnGetAudioError(int error_code) override;
 };
 
+class NetEqGetAudioCallback {
+ public:
+  virtual ~NetEqGetAudioCallback() = default;
+  // Called after each call to NetEq::GetAudio, with the produced audio. May
+  // query |neteq|, e.g. to poll the network statistics the way a call would.
+  virtual void AfterGetAudio(int64_t time_now_ms,
+                             const AudioFrame& audio_frame,
+                             NetEq* neteq) = 0;
+};
+
 // Class that provides an input--output test for NetEq. The input (both packets
 // and output events) is provided by a NetEqInput object, while the output is
 // directed to an AudioSink object.
@@ -53,13 +63,14 @@ class NetEqTest {
   using ExtDecoderMap = std::map<int, ExternalDecoderInfo>;
 
   // Sets up the test with given configuration, codec mappings, input, ouput,
-  // and callback objects for error reporting.
+  // and callback objects for error reporting and for the produced audio.
   NetEqTest(const NetEq::Config& config,
             const DecoderMap& codecs,
             const ExtDecoderMap& ext_codecs,
             std::unique_ptr<NetEqInput> input,
             std::unique_ptr<AudioSink> output,
-            NetEqTestErrorCallback* error_callback);
+            NetEqTestErrorCallback* error_callback,
+            NetEqGetAudioCallback* get_audio_callback = nullptr);
 
   ~NetEqTest() = default;
 
@@ -77,6 +88,7 @@ class NetEqTest {
   std::unique_ptr<NetEqInput> input_;
   std::unique_ptr<AudioSink> output_;
   NetEqTestErrorCallback* error_callback_ = nullptr;
+  NetEqGetAudioCallback* get_audio_callback_ = nullptr;
   int sample_rate_hz_;
 };
 
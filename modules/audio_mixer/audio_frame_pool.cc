@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/audio_frame_pool.h"
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+PooledAudioFrame::PooledAudioFrame() : pool_(nullptr), frame_(nullptr) {}
+
+PooledAudioFrame::PooledAudioFrame(AudioFramePool* pool, AudioFrame* frame)
+    : pool_(pool), frame_(frame) {}
+
+PooledAudioFrame::PooledAudioFrame(PooledAudioFrame&& other)
+    : pool_(other.pool_), frame_(other.frame_) {
+  other.pool_ = nullptr;
+  other.frame_ = nullptr;
+}
+
+PooledAudioFrame::~PooledAudioFrame() {
+  reset();
+}
+
+PooledAudioFrame& PooledAudioFrame::operator=(PooledAudioFrame&& other) {
+  if (this != &other) {
+    reset();
+    pool_ = other.pool_;
+    frame_ = other.frame_;
+    other.pool_ = nullptr;
+    other.frame_ = nullptr;
+  }
+  return *this;
+}
+
+void PooledAudioFrame::reset() {
+  if (frame_)
+    pool_->Return(frame_);
+  pool_ = nullptr;
+  frame_ = nullptr;
+}
+
+AudioFramePool::AudioFramePool() {}
+
+AudioFramePool::~AudioFramePool() {
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK_EQ(frames_.size(), free_frames_.size())
+      << "Frames outlive their pool";
+}
+
+PooledAudioFrame AudioFramePool::Get() {
+  AudioFrame* frame;
+  {
+    rtc::CritScope lock(&crit_);
+    if (free_frames_.empty()) {
+      frames_.emplace_back(new AudioFrame());
+      return PooledAudioFrame(this, frames_.back().get());
+    }
+    frame = free_frames_.back();
+    free_frames_.pop_back();
+  }
+  frame->Reset();
+  return PooledAudioFrame(this, frame);
+}
+
+size_t AudioFramePool::num_frames() const {
+  rtc::CritScope lock(&crit_);
+  return frames_.size();
+}
+
+void AudioFramePool::Return(AudioFrame* frame) {
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK_LT(free_frames_.size(), frames_.size());
+  free_frames_.push_back(frame);
+}
+
+}  // namespace webrtc
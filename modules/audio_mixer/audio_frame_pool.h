@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_MIXER_AUDIO_FRAME_POOL_H_
+#define WEBRTC_MODULES_AUDIO_MIXER_AUDIO_FRAME_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+
+class AudioFramePool;
+
+// Owns a frame of an AudioFramePool until it is destroyed or reset, and then
+// returns it to the pool. Frames are handed over by moving the handle.
+class PooledAudioFrame {
+ public:
+  PooledAudioFrame();
+  PooledAudioFrame(PooledAudioFrame&& other);
+  ~PooledAudioFrame();
+
+  PooledAudioFrame& operator=(PooledAudioFrame&& other);
+
+  // Returns the frame to the pool, leaving the handle empty.
+  void reset();
+
+  AudioFrame* get() const { return frame_; }
+  AudioFrame* operator->() const { return frame_; }
+  AudioFrame& operator*() const { return *frame_; }
+  explicit operator bool() const { return frame_ != nullptr; }
+
+ private:
+  friend class AudioFramePool;
+  PooledAudioFrame(AudioFramePool* pool, AudioFrame* frame);
+
+  AudioFramePool* pool_;
+  AudioFrame* frame_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PooledAudioFrame);
+};
+
+// AudioFrames for the sources and mixes of a mixer, which come and go with
+// the participants of a conference. Constructing an AudioFrame zeroes all of
+// its kMaxDataSizeSamples samples; a frame from the pool is only constructed
+// when all others are in use, and otherwise keeps the samples of its last
+// use. Its other fields are reset. The pool must outlive its frames.
+class AudioFramePool {
+ public:
+  AudioFramePool();
+  ~AudioFramePool();
+
+  PooledAudioFrame Get();
+
+  // The number of frames constructed so far.
+  size_t num_frames() const;
+
+ private:
+  friend class PooledAudioFrame;
+  void Return(AudioFrame* frame);
+
+  rtc::CriticalSection crit_;
+  std::vector<std::unique_ptr<AudioFrame>> frames_ GUARDED_BY(crit_);
+  std::vector<AudioFrame*> free_frames_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AudioFramePool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_MIXER_AUDIO_FRAME_POOL_H_
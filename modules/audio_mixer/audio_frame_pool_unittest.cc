@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/audio_frame_pool.h"
+
+#include <utility>
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+TEST(AudioFramePoolTest, ReusesReturnedFrames) {
+  AudioFramePool pool;
+  AudioFrame* first_frame;
+  {
+    PooledAudioFrame frame = pool.Get();
+    ASSERT_TRUE(frame);
+    first_frame = frame.get();
+  }
+  PooledAudioFrame frame = pool.Get();
+  EXPECT_EQ(first_frame, frame.get());
+  EXPECT_EQ(1u, pool.num_frames());
+
+  PooledAudioFrame other_frame = pool.Get();
+  EXPECT_NE(frame.get(), other_frame.get());
+  EXPECT_EQ(2u, pool.num_frames());
+}
+
+TEST(AudioFramePoolTest, ResetsFieldsButNotSamples) {
+  AudioFramePool pool;
+  {
+    PooledAudioFrame frame = pool.Get();
+    frame->UpdateFrame(7, 1234, nullptr, 480, 48000, AudioFrame::kNormalSpeech,
+                       AudioFrame::kVadActive, 1);
+    frame->data_[0] = 1000;
+  }
+  PooledAudioFrame frame = pool.Get();
+  EXPECT_EQ(-1, frame->id_);
+  EXPECT_EQ(0u, frame->samples_per_channel_);
+  EXPECT_EQ(0, frame->sample_rate_hz_);
+  EXPECT_EQ(AudioFrame::kVadUnknown, frame->vad_activity_);
+  EXPECT_EQ(1000, frame->data_[0]);
+}
+
+TEST(AudioFramePoolTest, MovesOwnership) {
+  AudioFramePool pool;
+  PooledAudioFrame frame = pool.Get();
+  AudioFrame* const pooled_frame = frame.get();
+
+  PooledAudioFrame moved_frame(std::move(frame));
+  EXPECT_FALSE(frame);
+  EXPECT_EQ(pooled_frame, moved_frame.get());
+
+  PooledAudioFrame assigned_frame = pool.Get();
+  assigned_frame = std::move(moved_frame);
+  EXPECT_FALSE(moved_frame);
+  EXPECT_EQ(pooled_frame, assigned_frame.get());
+  // The frame |assigned_frame| held went back to the pool.
+  EXPECT_EQ(2u, pool.num_frames());
+  PooledAudioFrame reused_frame = pool.Get();
+  EXPECT_NE(pooled_frame, reused_frame.get());
+  EXPECT_EQ(2u, pool.num_frames());
+
+  assigned_frame.reset();
+  EXPECT_FALSE(assigned_frame);
+  EXPECT_EQ(pooled_frame, pool.Get().get());
+}
+
+}  // namespace webrtc
@@ -17,8 +17,10 @@
 
 #include "webrtc/audio/utility/audio_frame_operations.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/audio_mixer/audio_frame_manipulator.h"
 #include "webrtc/modules/audio_mixer/default_output_rate_calculator.h"
+#include "webrtc/modules/audio_mixer/mix_accumulator.h"
 
 namespace webrtc {
 namespace {
@@ -118,6 +120,63 @@ int32_t MixFromList(AudioFrame* mixed_audio,
   return 0;
 }
 
+// Runs the GetAudioFrameWithInfo() calls of a round on |pool|. Adds the
+// frames of the sources done in time to |source_frames|, and the last frames
+// of the mixed sources which are late to |late_frames|.
+void GetAudioInParallel(FrameRetrievalPool* pool,
+                        int sample_rate_hz,
+                        int max_wait_ms,
+                        const AudioMixerImpl::SourceStatusList& source_list,
+                        std::vector<SourceFrame>* source_frames,
+                        std::vector<SourceFrame>* late_frames) {
+  // Sources whose call missed an earlier round sit this one out.
+  std::vector<FrameRetrievalPool::Task*> tasks;
+  for (const auto& source_status : source_list) {
+    if (!pool->IsRunning(source_status->retrieval_task))
+      tasks.push_back(&source_status->retrieval_task);
+  }
+  pool->Run(tasks, sample_rate_hz, rtc::TimeMillis() + max_wait_ms);
+
+  for (const auto& source_status : source_list) {
+    if (!pool->IsDone(source_status->retrieval_task)) {
+      if (source_status->has_last_frame && source_status->gain > 0.0f) {
+        late_frames->emplace_back(source_status.get(),
+                                  source_status->last_frame.get(), false, -1);
+      }
+      source_status->has_last_frame = false;
+      source_status->is_mixed = false;
+      continue;
+    }
+
+    const auto audio_frame_info =
+        pool->GetInfo(source_status->retrieval_task);
+    if (audio_frame_info == AudioMixer::Source::AudioFrameInfo::kError) {
+      LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
+      continue;
+    }
+    source_frames->emplace_back(
+        source_status.get(), source_status->audio_frame.get(),
+        audio_frame_info == AudioMixer::Source::AudioFrameInfo::kMuted);
+  }
+}
+
+// Keeps a copy of the frame of a source selected for mixing, taken before
+// the frame is ramped or mixed, for fading out if the next one is late. The
+// other sources give up their copy, so that the frames are only copied and
+// held for the few sources which are mixed.
+void UpdateLastFrame(AudioFramePool* frame_pool,
+                     AudioMixerImpl::SourceStatus* source_status,
+                     const AudioFrame* audio_frame) {
+  source_status->has_last_frame = audio_frame != nullptr;
+  if (!audio_frame) {
+    source_status->last_frame.reset();
+    return;
+  }
+  if (!source_status->last_frame)
+    source_status->last_frame = frame_pool->Get();
+  source_status->last_frame->CopyFrom(*audio_frame);
+}
+
 AudioMixerImpl::SourceStatusList::const_iterator FindSourceInList(
     AudioMixerImpl::Source const* audio_source,
     AudioMixerImpl::SourceStatusList const* audio_source_list) {
@@ -178,14 +237,17 @@ std::unique_ptr<AudioProcessing> CreateLimiter() {
 
 AudioMixerImpl::AudioMixerImpl(
     std::unique_ptr<AudioProcessing> limiter,
-    std::unique_ptr<OutputRateCalculator> output_rate_calculator)
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    int max_mixed_sources)
     : output_rate_calculator_(std::move(output_rate_calculator)),
+      max_mixed_sources_(max_mixed_sources),
       output_frequency_(0),
       sample_size_(0),
       audio_source_list_(),
       use_limiter_(true),
       time_stamp_(0),
-      limiter_(std::move(limiter)) {}
+      limiter_(std::move(limiter)),
+      max_retrieval_wait_ms_(0) {}
 
 AudioMixerImpl::~AudioMixerImpl() {}
 
@@ -200,7 +262,18 @@ AudioMixerImpl::CreateWithOutputRateCalculator(
     std::unique_ptr<OutputRateCalculator> output_rate_calculator) {
   return rtc::scoped_refptr<AudioMixerImpl>(
       new rtc::RefCountedObject<AudioMixerImpl>(
-          CreateLimiter(), std::move(output_rate_calculator)));
+          CreateLimiter(), std::move(output_rate_calculator),
+          kMaximumAmountOfMixedAudioSources));
+}
+
+rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::CreateWithMaxMixedSources(
+    int max_mixed_sources) {
+  RTC_DCHECK_GT(max_mixed_sources, 0);
+  return rtc::scoped_refptr<AudioMixerImpl>(
+      new rtc::RefCountedObject<AudioMixerImpl>(
+          CreateLimiter(), std::unique_ptr<OutputRateCalculator>(
+                               new DefaultOutputRateCalculator()),
+          max_mixed_sources));
 }
 
 void AudioMixerImpl::Mix(size_t number_of_channels,
@@ -243,6 +316,64 @@ void AudioMixerImpl::Mix(size_t number_of_channels,
   return;
 }
 
+void AudioMixerImpl::MixForEachSource(size_t number_of_channels,
+                                      std::vector<SourceMix>* mixes) {
+  RTC_DCHECK(number_of_channels == 1 || number_of_channels == 2);
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+
+  CalculateOutputFrequency();
+  mixes->clear();
+
+  rtc::CritScope lock(&crit_);
+  const AudioFrameList mix_list = GetAudioFromSources();
+  const size_t num_samples = sample_size_ * number_of_channels;
+  std::fill(mix_sum_, mix_sum_ + num_samples, 0);
+  for (AudioFrame* frame : mix_list) {
+    RemixFrame(number_of_channels, frame);
+    RTC_DCHECK_EQ(sample_size_, frame->samples_per_channel_);
+    AddToMix(frame->data_, num_samples, mix_sum_);
+  }
+
+  // Everyone not mixed hears the full mix.
+  AudioFrame* full_mix = GetMixFrame(0, number_of_channels);
+  SubtractFromMix(mix_sum_, nullptr, num_samples, full_mix->data_);
+  size_t num_mix_frames = 1;
+  for (const auto& source_status : audio_source_list_) {
+    // The own audio is the last frame if a late source is faded out.
+    const AudioFrame* own_frame = nullptr;
+    for (const AudioFrame* frame : mix_list) {
+      if (frame == source_status->audio_frame.get() ||
+          frame == source_status->last_frame.get()) {
+        own_frame = frame;
+        break;
+      }
+    }
+    AudioFrame* mix = full_mix;
+    if (own_frame) {
+      mix = GetMixFrame(num_mix_frames++, number_of_channels);
+      SubtractFromMix(mix_sum_, own_frame->data_, num_samples, mix->data_);
+    }
+    mixes->push_back({source_status->audio_source, mix});
+  }
+
+  time_stamp_ += static_cast<uint32_t>(sample_size_);
+}
+
+AudioFrame* AudioMixerImpl::GetMixFrame(size_t index,
+                                        size_t number_of_channels) {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  while (mix_frames_.size() <= index)
+    mix_frames_.push_back(frame_pool_.Get());
+  AudioFrame* frame = mix_frames_[index].get();
+  // The samples are written by the caller, so don't have UpdateFrame() clear
+  // them.
+  frame->UpdateFrame(-1, time_stamp_, nullptr, 0, OutputFrequency(),
+                     AudioFrame::kNormalSpeech, AudioFrame::kVadPassive,
+                     number_of_channels);
+  frame->samples_per_channel_ = sample_size_;
+  return frame;
+}
+
 void AudioMixerImpl::CalculateOutputFrequency() {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
   rtc::CritScope lock(&crit_);
@@ -270,7 +401,8 @@ bool AudioMixerImpl::AddSource(Source* audio_source) {
   RTC_DCHECK(FindSourceInList(audio_source, &audio_source_list_) ==
              audio_source_list_.end())
       << "Source already added to mixer";
-  audio_source_list_.emplace_back(new SourceStatus(audio_source, false, 0));
+  audio_source_list_.emplace_back(
+      new SourceStatus(audio_source, false, 0, frame_pool_.Get()));
   return true;
 }
 
@@ -279,41 +411,62 @@ void AudioMixerImpl::RemoveSource(Source* audio_source) {
   rtc::CritScope lock(&crit_);
   const auto iter = FindSourceInList(audio_source, &audio_source_list_);
   RTC_DCHECK(iter != audio_source_list_.end()) << "Source not present in mixer";
+  if (frame_retrieval_pool_)
+    frame_retrieval_pool_->WaitUntilNotRunning((*iter)->retrieval_task);
   audio_source_list_.erase(iter);
 }
 
+void AudioMixerImpl::EnableParallelFrameRetrieval(size_t num_threads,
+                                                  int max_wait_ms) {
+  RTC_DCHECK_GT(num_threads, 0u);
+  RTC_DCHECK_GE(max_wait_ms, 0);
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(!frame_retrieval_pool_);
+  frame_retrieval_pool_.reset(new FrameRetrievalPool(num_threads));
+  max_retrieval_wait_ms_ = max_wait_ms;
+}
+
 AudioFrameList AudioMixerImpl::GetAudioFromSources() {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
   AudioFrameList result;
   std::vector<SourceFrame> audio_source_mixing_data_list;
   std::vector<SourceFrame> ramp_list;
+  std::vector<SourceFrame> late_frames;
 
   // Get audio from the audio sources and put it in the SourceFrame vector.
-  for (auto& source_and_status : audio_source_list_) {
-    const auto audio_frame_info =
-        source_and_status->audio_source->GetAudioFrameWithInfo(
-            OutputFrequency(), &source_and_status->audio_frame);
-
-    if (audio_frame_info == Source::AudioFrameInfo::kError) {
-      LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
-      continue;
+  if (frame_retrieval_pool_) {
+    GetAudioInParallel(frame_retrieval_pool_.get(), OutputFrequency(),
+                       max_retrieval_wait_ms_, audio_source_list_,
+                       &audio_source_mixing_data_list, &late_frames);
+  } else {
+    for (auto& source_and_status : audio_source_list_) {
+      const auto audio_frame_info =
+          source_and_status->audio_source->GetAudioFrameWithInfo(
+              OutputFrequency(), source_and_status->audio_frame.get());
+
+      if (audio_frame_info == Source::AudioFrameInfo::kError) {
+        LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
+        continue;
+      }
+      audio_source_mixing_data_list.emplace_back(
+          source_and_status.get(), source_and_status->audio_frame.get(),
+          audio_frame_info == Source::AudioFrameInfo::kMuted);
     }
-    audio_source_mixing_data_list.emplace_back(
-        source_and_status.get(), &source_and_status->audio_frame,
-        audio_frame_info == Source::AudioFrameInfo::kMuted);
   }
 
   // Sort frames by sorting function.
   std::sort(audio_source_mixing_data_list.begin(),
             audio_source_mixing_data_list.end(), ShouldMixBefore);
 
-  int max_audio_frame_counter = kMaximumAmountOfMixedAudioSources;
+  int max_audio_frame_counter = max_mixed_sources_;
 
   // Go through list in order and put unmuted frames in result list.
   for (const auto& p : audio_source_mixing_data_list) {
     // Filter muted.
     if (p.muted) {
       p.source_status->is_mixed = false;
+      if (frame_retrieval_pool_)
+        UpdateLastFrame(&frame_pool_, p.source_status, nullptr);
       continue;
     }
 
@@ -326,8 +479,19 @@ AudioFrameList AudioMixerImpl::GetAudioFromSources() {
       is_mixed = true;
     }
     p.source_status->is_mixed = is_mixed;
+    if (frame_retrieval_pool_) {
+      UpdateLastFrame(&frame_pool_, p.source_status,
+                      is_mixed ? p.audio_frame : nullptr);
+    }
   }
   RampAndUpdateGain(ramp_list);
+
+  // Late sources fade out, and will ramp in from silence when back.
+  for (const auto& p : late_frames) {
+    Ramp(p.source_status->gain, 0.0f, p.audio_frame);
+    p.source_status->gain = 0.0f;
+    result.push_back(p.audio_frame);
+  }
   return result;
 }
 
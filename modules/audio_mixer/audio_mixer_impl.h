@@ -12,12 +12,15 @@
 #define WEBRTC_MODULES_AUDIO_MIXER_AUDIO_MIXER_IMPL_H_
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "webrtc/api/audio/audio_mixer.h"
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/base/race_checker.h"
+#include "webrtc/modules/audio_mixer/audio_frame_pool.h"
+#include "webrtc/modules/audio_mixer/frame_retrieval_pool.h"
 #include "webrtc/modules/audio_mixer/output_rate_calculator.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/include/module_common_types.h"
@@ -31,18 +34,39 @@ typedef std::vector<AudioFrame*> AudioFrameList;
 class AudioMixerImpl : public AudioMixer {
  public:
   struct SourceStatus {
-    SourceStatus(Source* audio_source, bool is_mixed, float gain)
-        : audio_source(audio_source), is_mixed(is_mixed), gain(gain) {}
+    SourceStatus(Source* audio_source,
+                 bool is_mixed,
+                 float gain,
+                 PooledAudioFrame audio_frame)
+        : audio_source(audio_source),
+          is_mixed(is_mixed),
+          gain(gain),
+          audio_frame(std::move(audio_frame)),
+          retrieval_task(audio_source, this->audio_frame.get()) {}
     Source* audio_source = nullptr;
     bool is_mixed = false;
     float gain = 0.0f;
 
     // A frame that will be passed to audio_source->GetAudioFrameWithInfo.
-    AudioFrame audio_frame;
+    PooledAudioFrame audio_frame;
+
+    // With parallel frame retrieval, the call to GetAudioFrameWithInfo, and
+    // a copy of the last frame the source returned in time if it was mixed.
+    // The copy is faded out when the next frame is late. Only mixed sources
+    // hold a frame for it.
+    FrameRetrievalPool::Task retrieval_task;
+    PooledAudioFrame last_frame;
+    bool has_last_frame = false;
   };
 
   using SourceStatusList = std::vector<std::unique_ptr<SourceStatus>>;
 
+  // The mix a source should hear, see MixForEachSource().
+  struct SourceMix {
+    Source* audio_source;
+    const AudioFrame* audio_frame;
+  };
+
   // AudioProcessing only accepts 10 ms frames.
   static const int kFrameDurationInMs = 10;
   static const int kMaximumAmountOfMixedAudioSources = 3;
@@ -50,6 +74,10 @@ class AudioMixerImpl : public AudioMixer {
   static rtc::scoped_refptr<AudioMixerImpl> Create();
   static rtc::scoped_refptr<AudioMixerImpl> CreateWithOutputRateCalculator(
       std::unique_ptr<OutputRateCalculator> output_rate_calculator);
+  // For bridges mixing more than kMaximumAmountOfMixedAudioSources of the
+  // loudest sources.
+  static rtc::scoped_refptr<AudioMixerImpl> CreateWithMaxMixedSources(
+      int max_mixed_sources);
 
   ~AudioMixerImpl() override;
 
@@ -60,6 +88,26 @@ class AudioMixerImpl : public AudioMixer {
   void Mix(size_t number_of_channels,
            AudioFrame* audio_frame_for_mixing) override LOCKS_EXCLUDED(crit_);
 
+  // N-1 mixing for a bridge, where every source is also a participant which
+  // should hear everyone but itself. Gets audio from every source once, sums
+  // the sources selected for mixing once, and sets |mixes| to one entry per
+  // source, holding that sum minus the source's own audio. Sources which are
+  // not mixed all share one frame holding the full mix. The frames are owned
+  // by the mixer and valid until the next call.
+  //
+  // Unlike Mix(), the mixes saturate instead of going through the limiter,
+  // which would need state for every distinct mix.
+  void MixForEachSource(size_t number_of_channels,
+                        std::vector<SourceMix>* mixes) LOCKS_EXCLUDED(crit_);
+
+  // Gets the audio from the sources on |num_threads| worker threads, waiting
+  // at most |max_wait_ms| for them each round instead of calling them one
+  // after the other. A source which is late is left out of the round, with
+  // its last frame faded out the way a decoder conceals a lost packet, and
+  // is ramped back in once it returns in time. Frames that arrive after
+  // their round are dropped. Should be called before mixing starts.
+  void EnableParallelFrameRetrieval(size_t num_threads, int max_wait_ms);
+
   // Returns true if the source was mixed last round. Returns
   // false and logs an error if the source was never added to the
   // mixer.
@@ -67,7 +115,8 @@ class AudioMixerImpl : public AudioMixer {
 
  protected:
   AudioMixerImpl(std::unique_ptr<AudioProcessing> limiter,
-                 std::unique_ptr<OutputRateCalculator> output_rate_calculator);
+                 std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+                 int max_mixed_sources);
 
  private:
   // Set mixing frequency through OutputFrequencyCalculator.
@@ -76,8 +125,8 @@ class AudioMixerImpl : public AudioMixer {
   int OutputFrequency() const;
 
   // Compute what audio sources to mix from audio_source_list_. Ramp
-  // in and out. Update mixed status. Mixes up to
-  // kMaximumAmountOfMixedAudioSources audio sources.
+  // in and out. Update mixed status. Mixes up to |max_mixed_sources_| audio
+  // sources.
   AudioFrameList GetAudioFromSources() EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Add/remove the MixerAudioSource to the specified
@@ -89,6 +138,10 @@ class AudioMixerImpl : public AudioMixer {
 
   bool LimitMixedAudio(AudioFrame* mixed_audio) const;
 
+  // Returns the |index|th frame of the pool used by MixForEachSource(), set
+  // up for the current output format.
+  AudioFrame* GetMixFrame(size_t index, size_t number_of_channels);
+
   // The critical section lock guards audio source insertion and
   // removal, which can be done from any thread. The race checker
   // checks that mixing is done sequentially.
@@ -96,10 +149,15 @@ class AudioMixerImpl : public AudioMixer {
   rtc::RaceChecker race_checker_;
 
   std::unique_ptr<OutputRateCalculator> output_rate_calculator_;
+  const int max_mixed_sources_;
   // The current sample frequency and sample size when mixing.
   int output_frequency_ GUARDED_BY(race_checker_);
   size_t sample_size_ GUARDED_BY(race_checker_);
 
+  // The frames of the sources and of MixForEachSource(). Declared before
+  // the users of its frames.
+  AudioFramePool frame_pool_;
+
   // List of all audio sources. Note all lists are disjunct
   SourceStatusList audio_source_list_ GUARDED_BY(crit_);  // May be mixed.
 
@@ -112,6 +170,16 @@ class AudioMixerImpl : public AudioMixer {
   // Used for inhibiting saturation in mixing.
   std::unique_ptr<AudioProcessing> limiter_ GUARDED_BY(race_checker_);
 
+  // The sum of the mixed sources, and the frames holding the mixes derived
+  // from it, reused by every call to MixForEachSource().
+  int32_t mix_sum_[AudioFrame::kMaxDataSizeSamples] GUARDED_BY(race_checker_);
+  std::vector<PooledAudioFrame> mix_frames_ GUARDED_BY(race_checker_);
+
+  // Declared after |audio_source_list_|, since late calls may write to the
+  // frames of the sources until the pool is destroyed.
+  std::unique_ptr<FrameRetrievalPool> frame_retrieval_pool_ GUARDED_BY(crit_);
+  int max_retrieval_wait_ms_ GUARDED_BY(crit_);
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioMixerImpl);
 };
 }  // namespace webrtc
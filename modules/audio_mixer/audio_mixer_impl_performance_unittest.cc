@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/audio_mixer/audio_mixer_impl.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kSampleRateHz = 48000;
+constexpr int kNumRounds = 100;
+
+// A participant of a bridge, which has already decoded its audio.
+class DecodedSource : public AudioMixer::Source {
+ public:
+  DecodedSource(int ssrc, Random* random) : ssrc_(ssrc) {
+    frame_.UpdateFrame(-1, 0, nullptr, kSampleRateHz / 100, kSampleRateHz,
+                       AudioFrame::kNormalSpeech, AudioFrame::kVadActive, 1);
+    const int amplitude = random->Rand(100, 8000);
+    for (size_t i = 0; i < frame_.samples_per_channel_; ++i)
+      frame_.data_[i] = random->Rand(-amplitude, amplitude);
+  }
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    audio_frame->CopyFrom(frame_);
+    return AudioFrameInfo::kNormal;
+  }
+  int Ssrc() const override { return ssrc_; }
+  int PreferredSampleRate() const override { return kSampleRateHz; }
+
+ private:
+  const int ssrc_;
+  AudioFrame frame_;
+};
+
+// A participant who is silent, like most of a large conference, or who talks.
+// A silent one reports a muted frame and leaves the samples alone, as a
+// receive channel does when NetEq plays out silence.
+class MaybeMutedSource : public AudioMixer::Source {
+ public:
+  MaybeMutedSource(int ssrc, bool talking) : ssrc_(ssrc), talking_(talking) {}
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    audio_frame->samples_per_channel_ = sample_rate_hz / 100;
+    audio_frame->sample_rate_hz_ = sample_rate_hz;
+    audio_frame->num_channels_ = 1;
+    if (!talking_)
+      return AudioFrameInfo::kMuted;
+    audio_frame->vad_activity_ = AudioFrame::kVadActive;
+    for (size_t i = 0; i < audio_frame->samples_per_channel_; ++i)
+      audio_frame->data_[i] = static_cast<int16_t>(ssrc_ * 10);
+    return AudioFrameInfo::kNormal;
+  }
+  int Ssrc() const override { return ssrc_; }
+  int PreferredSampleRate() const override { return kSampleRateHz; }
+
+ private:
+  const int ssrc_;
+  const bool talking_;
+};
+
+std::vector<std::unique_ptr<DecodedSource>> CreateSources(
+    int num_participants) {
+  Random random(0x3173 + num_participants);
+  std::vector<std::unique_ptr<DecodedSource>> sources;
+  for (int i = 0; i < num_participants; ++i)
+    sources.emplace_back(new DecodedSource(i, &random));
+  return sources;
+}
+
+// Prints how many participants one core could serve in real time, given that
+// a round produces 10 ms of audio for every participant.
+void PrintParticipantsPerCore(const std::string& test,
+                              int num_participants,
+                              int64_t elapsed_ns) {
+  const int64_t ns_per_round = elapsed_ns / kNumRounds;
+  const std::string trace = "_" + std::to_string(num_participants);
+  webrtc::test::PrintResult("audio_mixer", trace, test + "_round",
+                            ns_per_round / 1000, "us", true);
+  webrtc::test::PrintResult(
+      "audio_mixer", trace, test + "_participants_per_core",
+      num_participants * AudioMixerImpl::kFrameDurationInMs *
+          rtc::kNumNanosecsPerMillisec / std::max<int64_t>(1, ns_per_round),
+      "participants", false);
+}
+}  // namespace
+
+// Every participant's N-1 mix from one mixer.
+TEST(AudioMixerPerformanceTest, MixForEachSource) {
+  for (int num_participants : {10, 100, 500}) {
+    const auto sources = CreateSources(num_participants);
+    const auto mixer = AudioMixerImpl::CreateWithMaxMixedSources(
+        AudioMixerImpl::kMaximumAmountOfMixedAudioSources);
+    for (const auto& source : sources)
+      mixer->AddSource(source.get());
+
+    std::vector<AudioMixerImpl::SourceMix> mixes;
+    const int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumRounds; ++i)
+      mixer->MixForEachSource(1, &mixes);
+    const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+    EXPECT_EQ(static_cast<size_t>(num_participants), mixes.size());
+    PrintParticipantsPerCore("mix_for_each_source", num_participants,
+                             elapsed_ns);
+    for (const auto& source : sources)
+      mixer->RemoveSource(source.get());
+  }
+}
+
+// The same mixes with one mixer per participant, mixing everyone else.
+TEST(AudioMixerPerformanceTest, MixerPerParticipant) {
+  for (int num_participants : {10, 100}) {
+    const auto sources = CreateSources(num_participants);
+    std::vector<rtc::scoped_refptr<AudioMixerImpl>> mixers;
+    for (int i = 0; i < num_participants; ++i) {
+      mixers.push_back(AudioMixerImpl::Create());
+      for (int j = 0; j < num_participants; ++j) {
+        if (j != i)
+          mixers.back()->AddSource(sources[j].get());
+      }
+    }
+
+    AudioFrame mix;
+    const int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumRounds; ++i) {
+      for (const auto& mixer : mixers)
+        mixer->Mix(1, &mix);
+    }
+    const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+    PrintParticipantsPerCore("mixer_per_participant", num_participants,
+                             elapsed_ns);
+    for (int i = 0; i < num_participants; ++i) {
+      for (int j = 0; j < num_participants; ++j) {
+        if (j != i)
+          mixers[i]->RemoveSource(sources[j].get());
+      }
+    }
+  }
+}
+
+// The cost of a source in a large conference where only a few participants
+// talk, with the frames retrieved serially and on worker threads.
+TEST(AudioMixerPerformanceTest, MostlyMutedSources) {
+  constexpr int kNumTalking = 5;
+  for (int num_participants : {100, 500}) {
+    std::vector<std::unique_ptr<MaybeMutedSource>> sources;
+    for (int i = 0; i < num_participants; ++i)
+      sources.emplace_back(new MaybeMutedSource(i, i < kNumTalking));
+
+    for (bool parallel : {false, true}) {
+      const auto mixer = AudioMixerImpl::Create();
+      if (parallel)
+        mixer->EnableParallelFrameRetrieval(4, 10);
+      for (const auto& source : sources)
+        mixer->AddSource(source.get());
+
+      AudioFrame mix;
+      const int64_t start_ns = rtc::TimeNanos();
+      for (int i = 0; i < kNumRounds; ++i)
+        mixer->Mix(1, &mix);
+      const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+      const std::string trace = "_" + std::to_string(num_participants);
+      webrtc::test::PrintResult(
+          "audio_mixer", trace,
+          std::string(parallel ? "parallel" : "serial") + "_muted_source",
+          static_cast<size_t>(elapsed_ns / (kNumRounds * num_participants)),
+          "ns", true);
+      for (const auto& source : sources)
+        mixer->RemoveSource(source.get());
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -16,14 +16,17 @@
 
 #include "webrtc/api/audio/audio_mixer.h"
 #include "webrtc/base/bind.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/modules/audio_mixer/audio_mixer_impl.h"
 #include "webrtc/modules/audio_mixer/default_output_rate_calculator.h"
 #include "webrtc/test/gmock.h"
 
 using testing::_;
+using testing::DoAll;
 using testing::Exactly;
 using testing::Invoke;
+using testing::InvokeWithoutArgs;
 using testing::Return;
 
 namespace webrtc {
@@ -479,4 +482,178 @@ TEST(AudioMixer, ZeroSourceRateShouldBeDecidedByRateCalculator) {
 
   EXPECT_EQ(kOutputRate, frame_for_mixing.sample_rate_hz_);
 }
+
+TEST(AudioMixer, MixForEachSourceLeavesOwnAudioOut) {
+  constexpr int kAudioSources = 5;
+  constexpr int kMaxMixedSources = kAudioSources - 1;
+  const auto mixer = AudioMixerImpl::CreateWithMaxMixedSources(
+      kMaxMixedSources);
+  std::vector<MockMixerAudioSource> participants(kAudioSources);
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    // The first participant is the quietest, so it is the one left unmixed.
+    std::fill(participants[i].fake_frame()->data_,
+              participants[i].fake_frame()->data_ + kDefaultSampleRateHz / 100,
+              100 * (i + 1));
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(kDefaultSampleRateHz, _))
+        .Times(Exactly(2));
+  }
+
+  // The first round ramps the mixed sources in.
+  std::vector<AudioMixerImpl::SourceMix> mixes;
+  mixer->MixForEachSource(1, &mixes);
+  mixer->MixForEachSource(1, &mixes);
+
+  ASSERT_EQ(static_cast<size_t>(kAudioSources), mixes.size());
+  const int16_t full_mix = 200 + 300 + 400 + 500;
+  for (int i = 0; i < kAudioSources; ++i) {
+    EXPECT_EQ(&participants[i], mixes[i].audio_source);
+    const AudioFrame* mix = mixes[i].audio_frame;
+    EXPECT_EQ(kDefaultSampleRateHz, mix->sample_rate_hz_);
+    EXPECT_EQ(1u, mix->num_channels_);
+    ASSERT_EQ(static_cast<size_t>(kDefaultSampleRateHz / 100),
+              mix->samples_per_channel_);
+    const int16_t expected = i == 0 ? full_mix : full_mix - 100 * (i + 1);
+    for (size_t j = 0; j < mix->samples_per_channel_; ++j)
+      ASSERT_EQ(expected, mix->data_[j]) << "participant " << i;
+    EXPECT_EQ(i != 0, mixer->GetAudioSourceMixabilityStatusForTest(
+                          &participants[i]));
+  }
+}
+
+TEST(AudioMixer, MixForEachSourceSharesFullMixBetweenUnmixedSources) {
+  const auto mixer = AudioMixerImpl::CreateWithMaxMixedSources(1);
+  std::vector<MockMixerAudioSource> participants(3);
+  for (auto& participant : participants) {
+    ResetFrame(participant.fake_frame());
+    EXPECT_TRUE(mixer->AddSource(&participant));
+  }
+  participants[1].fake_frame()->data_[0] = 1000;
+
+  std::vector<AudioMixerImpl::SourceMix> mixes;
+  mixer->MixForEachSource(2, &mixes);
+
+  ASSERT_EQ(3u, mixes.size());
+  EXPECT_EQ(mixes[0].audio_frame, mixes[2].audio_frame);
+  EXPECT_NE(mixes[0].audio_frame, mixes[1].audio_frame);
+  EXPECT_EQ(2u, mixes[0].audio_frame->num_channels_);
+  // Silence for the only mixed source.
+  EXPECT_EQ(0, mixes[1].audio_frame->data_[0]);
+  EXPECT_EQ(0, mixes[1].audio_frame->data_[1]);
+}
+
+TEST(AudioMixer, ParallelFrameRetrievalMixesLoudestSources) {
+  constexpr int kAudioSources =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources + 2;
+  const auto mixer = AudioMixerImpl::Create();
+  mixer->EnableParallelFrameRetrieval(2, 1000);
+  std::vector<MockMixerAudioSource> participants(kAudioSources);
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->data_[0] = 100 * i;
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(kDefaultSampleRateHz, _))
+        .Times(Exactly(1));
+  }
+
+  mixer->Mix(1, &frame_for_mixing);
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    EXPECT_EQ(i >= kAudioSources -
+                       AudioMixerImpl::kMaximumAmountOfMixedAudioSources,
+              mixer->GetAudioSourceMixabilityStatusForTest(&participants[i]))
+        << "Mixed status of AudioSource #" << i << " wrong.";
+  }
+}
+
+TEST(AudioMixer, LateSourceIsFadedOutAndSkippedUntilItReturns) {
+  constexpr int kSamples = kDefaultSampleRateHz / 100;
+  const auto mixer = AudioMixerImpl::CreateWithMaxMixedSources(2);
+  mixer->EnableParallelFrameRetrieval(2, 10);
+  MockMixerAudioSource listener;
+  MockMixerAudioSource late_source;
+  ResetFrame(listener.fake_frame());
+  ResetFrame(late_source.fake_frame());
+  std::fill(late_source.fake_frame()->data_,
+            late_source.fake_frame()->data_ + kSamples, 1000);
+  EXPECT_TRUE(mixer->AddSource(&listener));
+  EXPECT_TRUE(mixer->AddSource(&late_source));
+
+  // Ramps the sources in.
+  std::vector<AudioMixerImpl::SourceMix> mixes;
+  mixer->MixForEachSource(1, &mixes);
+  ASSERT_TRUE(mixer->GetAudioSourceMixabilityStatusForTest(&late_source));
+
+  rtc::Event unblock(false, false);
+  EXPECT_CALL(late_source, GetAudioFrameWithInfo(_, _))
+      .WillOnce(DoAll(InvokeWithoutArgs([&unblock] {
+                        unblock.Wait(rtc::Event::kForever);
+                      }),
+                      Return(AudioMixer::Source::AudioFrameInfo::kNormal)));
+  mixer->MixForEachSource(1, &mixes);
+  EXPECT_FALSE(mixer->GetAudioSourceMixabilityStatusForTest(&late_source));
+  ASSERT_EQ(2u, mixes.size());
+  // The listener hears the last frame fading out, and the late source
+  // doesn't hear itself.
+  EXPECT_EQ(1000, mixes[0].audio_frame->data_[0]);
+  EXPECT_LT(mixes[0].audio_frame->data_[kSamples - 1], 10);
+  EXPECT_EQ(0, mixes[1].audio_frame->data_[0]);
+
+  // Not called again while the call is still going on.
+  mixer->MixForEachSource(1, &mixes);
+  EXPECT_EQ(0, mixes[0].audio_frame->data_[0]);
+
+  unblock.Set();
+  // Waits for the late call to return.
+  mixer->RemoveSource(&late_source);
+}
+
+TEST(AudioMixer, LateSourceWhichWasNotMixedIsNotFadedOut) {
+  constexpr int kSamples = kDefaultSampleRateHz / 100;
+  const auto mixer = AudioMixerImpl::CreateWithMaxMixedSources(1);
+  mixer->EnableParallelFrameRetrieval(2, 10);
+  MockMixerAudioSource loud_source;
+  MockMixerAudioSource late_source;
+  ResetFrame(loud_source.fake_frame());
+  ResetFrame(late_source.fake_frame());
+  std::fill(loud_source.fake_frame()->data_,
+            loud_source.fake_frame()->data_ + kSamples, 2000);
+  std::fill(late_source.fake_frame()->data_,
+            late_source.fake_frame()->data_ + kSamples, 500);
+  EXPECT_TRUE(mixer->AddSource(&loud_source));
+  EXPECT_TRUE(mixer->AddSource(&late_source));
+
+  // Ramps the late source in while the loud source is muted.
+  loud_source.set_fake_info(AudioMixer::Source::AudioFrameInfo::kMuted);
+  std::vector<AudioMixerImpl::SourceMix> mixes;
+  mixer->MixForEachSource(1, &mixes);
+  ASSERT_TRUE(mixer->GetAudioSourceMixabilityStatusForTest(&late_source));
+
+  // The loud source takes the only mixed slot.
+  loud_source.set_fake_info(AudioMixer::Source::AudioFrameInfo::kNormal);
+  mixer->MixForEachSource(1, &mixes);
+  ASSERT_TRUE(mixer->GetAudioSourceMixabilityStatusForTest(&loud_source));
+  ASSERT_FALSE(mixer->GetAudioSourceMixabilityStatusForTest(&late_source));
+
+  rtc::Event unblock(false, false);
+  EXPECT_CALL(late_source, GetAudioFrameWithInfo(_, _))
+      .WillOnce(DoAll(InvokeWithoutArgs([&unblock] {
+                        unblock.Wait(rtc::Event::kForever);
+                      }),
+                      Return(AudioMixer::Source::AudioFrameInfo::kNormal)));
+  mixer->MixForEachSource(1, &mixes);
+  EXPECT_TRUE(mixer->GetAudioSourceMixabilityStatusForTest(&loud_source));
+  EXPECT_FALSE(mixer->GetAudioSourceMixabilityStatusForTest(&late_source));
+  ASSERT_EQ(2u, mixes.size());
+  // The frame the late source gave when it wasn't mixed isn't faded out, so
+  // the loud source hears silence, and the late source hears the loud one.
+  EXPECT_EQ(0, mixes[0].audio_frame->data_[0]);
+  EXPECT_EQ(0, mixes[0].audio_frame->data_[kSamples / 2]);
+  EXPECT_EQ(2000, mixes[1].audio_frame->data_[0]);
+
+  unblock.Set();
+  // Waits for the late call to return.
+  mixer->RemoveSource(&late_source);
+}
 }  // namespace webrtc
@@ -0,0 +1,230 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/modules/audio_device/audio_device_buffer.h"
+#include "webrtc/modules/audio_device/dummy/file_audio_device.h"
+#include "webrtc/modules/audio_mixer/audio_mixer_impl.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumSources = 60;
+constexpr int kNumTicks = 200;
+// What decoding 10 ms of Opus and running NetEq typically costs.
+constexpr int64_t kDecodeTimeUs = 250;
+// Every this many frames a source takes longer, like when NetEq expands or
+// merges.
+constexpr int kSlowFrameInterval = 50;
+constexpr int64_t kSlowDecodeTimeUs = 3000;
+constexpr int kNumThreads = 4;
+constexpr int kMaxWaitMs = 6;
+
+// A receive channel which spends the time of a decode in every call, and
+// records the playout tick of the last frame it delivered.
+class DecodingSource : public AudioMixer::Source {
+ public:
+  DecodingSource(int ssrc, const volatile int* tick)
+      : ssrc_(ssrc), tick_(tick), num_calls_(0), delivered_tick_(-1) {}
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    const int tick = rtc::AtomicOps::AcquireLoad(tick_);
+    const int64_t decode_time_us =
+        (ssrc_ + num_calls_) % kSlowFrameInterval == 0 ? kSlowDecodeTimeUs
+                                                       : kDecodeTimeUs;
+    const int64_t end_us = rtc::TimeMicros() + decode_time_us;
+    while (rtc::TimeMicros() < end_us) {
+    }
+    audio_frame->UpdateFrame(-1, 0, nullptr, sample_rate_hz / 100,
+                             sample_rate_hz, AudioFrame::kNormalSpeech,
+                             AudioFrame::kVadActive, 1);
+    for (size_t i = 0; i < audio_frame->samples_per_channel_; ++i)
+      audio_frame->data_[i] = static_cast<int16_t>(ssrc_ * 10);
+    ++num_calls_;
+    rtc::AtomicOps::ReleaseStore(&delivered_tick_, tick);
+    return AudioFrameInfo::kNormal;
+  }
+  int Ssrc() const override { return ssrc_; }
+  int PreferredSampleRate() const override { return 48000; }
+
+  int delivered_tick() const {
+    return rtc::AtomicOps::AcquireLoad(&delivered_tick_);
+  }
+
+ private:
+  const int ssrc_;
+  const volatile int* const tick_;
+  // Only used on the thread calling the source.
+  int num_calls_;
+  volatile int delivered_tick_;
+};
+
+// Mixes on the playout thread of the audio device, and counts the ticks where
+// mixing took longer than the 10 ms the device plays out, and the sources
+// which didn't deliver a new frame for their tick.
+class MixingAudioTransport : public AudioTransport {
+ public:
+  MixingAudioTransport() : tick_(0), done_(false, false) {}
+
+  void SetMixer(AudioMixer* mixer,
+                const std::vector<std::unique_ptr<DecodingSource>>* sources) {
+    mixer_ = mixer;
+    sources_ = sources;
+  }
+  const volatile int* tick() const { return &tick_; }
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const size_t nSamples,
+                                  const size_t nBytesPerSample,
+                                  const size_t nChannels,
+                                  const uint32_t samplesPerSec,
+                                  const uint32_t totalDelayMS,
+                                  const int32_t clockDrift,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    return 0;
+  }
+
+  int32_t NeedMorePlayData(const size_t nSamples,
+                           const size_t nBytesPerSample,
+                           const size_t nChannels,
+                           const uint32_t samplesPerSec,
+                           void* audioSamples,
+                           size_t& nSamplesOut,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    if (num_ticks_ == kNumTicks) {
+      memset(audioSamples, 0, nSamples * nBytesPerSample);
+      nSamplesOut = nSamples;
+      return 0;
+    }
+
+    rtc::AtomicOps::ReleaseStore(&tick_, num_ticks_);
+    const int64_t start_us = rtc::TimeMicros();
+    mixer_->Mix(nChannels, &mix_);
+    const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+    for (const auto& source : *sources_) {
+      if (source->delivered_tick() != num_ticks_)
+        ++num_late_frames_;
+    }
+
+    total_mix_time_us_ += elapsed_us;
+    if (elapsed_us > AudioMixerImpl::kFrameDurationInMs * 1000)
+      ++num_deadline_misses_;
+    memcpy(audioSamples, mix_.data_,
+           mix_.samples_per_channel_ * nChannels * sizeof(int16_t));
+    nSamplesOut = mix_.samples_per_channel_;
+    *elapsed_time_ms = -1;
+    *ntp_time_ms = -1;
+    if (++num_ticks_ == kNumTicks)
+      done_.Set();
+    return 0;
+  }
+
+  void PushCaptureData(int voe_channel,
+                       const void* audio_data,
+                       int bits_per_sample,
+                       int sample_rate,
+                       size_t number_of_channels,
+                       size_t number_of_frames) override {}
+
+  void PullRenderData(int bits_per_sample,
+                      int sample_rate,
+                      size_t number_of_channels,
+                      size_t number_of_frames,
+                      void* audio_data,
+                      int64_t* elapsed_time_ms,
+                      int64_t* ntp_time_ms) override {}
+
+  // Returns false if playout stalls.
+  bool WaitUntilDone() { return done_.Wait(kNumTicks * 100); }
+
+  int num_deadline_misses() const { return num_deadline_misses_; }
+  int num_late_frames() const { return num_late_frames_; }
+  int64_t mean_mix_time_us() const { return total_mix_time_us_ / kNumTicks; }
+
+ private:
+  AudioMixer* mixer_ = nullptr;
+  const std::vector<std::unique_ptr<DecodingSource>>* sources_ = nullptr;
+  volatile int tick_;
+  AudioFrame mix_;
+  rtc::Event done_;
+  int num_ticks_ = 0;
+  int num_deadline_misses_ = 0;
+  int num_late_frames_ = 0;
+  int64_t total_mix_time_us_ = 0;
+};
+
+// Plays out the mix of |kNumSources| receive channels through a
+// FileAudioDevice, the way VoiceEngine does.
+void RunPlayout(const std::string& test, bool parallel) {
+  // Otherwise done by NetEq, for the level AudioDeviceBuffer measures.
+  WebRtcSpl_Init();
+  MixingAudioTransport transport;
+  std::vector<std::unique_ptr<DecodingSource>> sources;
+  const auto mixer = AudioMixerImpl::Create();
+  if (parallel)
+    mixer->EnableParallelFrameRetrieval(kNumThreads, kMaxWaitMs);
+  for (int i = 0; i < kNumSources; ++i) {
+    sources.emplace_back(new DecodingSource(i, transport.tick()));
+    mixer->AddSource(sources.back().get());
+  }
+  transport.SetMixer(mixer.get(), &sources);
+  AudioDeviceBuffer audio_device_buffer;
+  audio_device_buffer.RegisterAudioCallback(&transport);
+  FileAudioDevice audio_device(0, "", "");
+  audio_device.AttachAudioBuffer(&audio_device_buffer);
+  ASSERT_EQ(AudioDeviceGeneric::InitStatus::OK, audio_device.Init());
+  ASSERT_EQ(0, audio_device.InitPlayout());
+  audio_device_buffer.StartPlayout();
+  ASSERT_EQ(0, audio_device.StartPlayout());
+  EXPECT_TRUE(transport.WaitUntilDone());
+  audio_device.StopPlayout();
+  audio_device_buffer.StopPlayout();
+
+  for (const auto& source : sources)
+    mixer->RemoveSource(source.get());
+
+  const std::string trace = "_" + std::to_string(kNumSources) + "_sources";
+  webrtc::test::PrintResult(
+      "audio_mixer_playout", trace, test + "_deadline_misses",
+      100.0 * transport.num_deadline_misses() / kNumTicks, "%", true);
+  webrtc::test::PrintResult(
+      "audio_mixer_playout", trace, test + "_late_frames",
+      100.0 * transport.num_late_frames() / (kNumTicks * kNumSources), "%",
+      true);
+  webrtc::test::PrintResult("audio_mixer_playout", trace, test + "_mix_time",
+                            transport.mean_mix_time_us(), "us", false);
+}
+}  // namespace
+
+// All sources called one after the other on the playout thread.
+TEST(AudioMixerPlayoutPerformanceTest, SerialFrameRetrieval) {
+  RunPlayout("serial", false);
+}
+
+// The sources called on worker threads, with late ones concealed.
+TEST(AudioMixerPlayoutPerformanceTest, ParallelFrameRetrieval) {
+  RunPlayout("parallel", true);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/frame_retrieval_pool.h"
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+
+namespace webrtc {
+
+FrameRetrievalPool::FrameRetrievalPool(size_t num_threads)
+    : next_task_(0),
+      round_(0),
+      in_round_(false),
+      sample_rate_hz_(0),
+      num_pending_(0),
+      stop_(false),
+      work_event_(true, false),
+      task_done_event_(false, false) {
+  RTC_DCHECK_GT(num_threads, 0u);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(
+        new rtc::PlatformThread(&WorkerThread, this, "FrameRetrieval"));
+    threads_.back()->Start();
+    // Below the audio device thread waiting for them, which has to be able to
+    // end the round on time even when all cores are busy with the sources.
+    threads_.back()->SetPriority(rtc::kHighPriority);
+  }
+}
+
+FrameRetrievalPool::~FrameRetrievalPool() {
+  {
+    rtc::CritScope lock(&crit_);
+    stop_ = true;
+    work_event_.Set();
+  }
+  // Waits for calls that missed their round.
+  for (auto& thread : threads_)
+    thread->Stop();
+}
+
+void FrameRetrievalPool::Run(const std::vector<Task*>& tasks,
+                             int sample_rate_hz,
+                             int64_t deadline_ms) {
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK(!in_round_);
+    ++round_;
+    in_round_ = true;
+    queue_ = tasks;
+    next_task_ = 0;
+    num_pending_ = tasks.size();
+    sample_rate_hz_ = sample_rate_hz;
+    for (Task* task : tasks) {
+      RTC_DCHECK(task->state_ == Task::State::kIdle);
+      task->state_ = Task::State::kQueued;
+      task->round_ = round_;
+      task->done_ = false;
+    }
+    if (!tasks.empty())
+      work_event_.Set();
+  }
+
+  while (true) {
+    {
+      rtc::CritScope lock(&crit_);
+      if (num_pending_ == 0)
+        break;
+    }
+    const int64_t remaining_ms = deadline_ms - rtc::TimeMillis();
+    if (remaining_ms <= 0)
+      break;
+    task_done_event_.Wait(static_cast<int>(remaining_ms));
+  }
+
+  rtc::CritScope lock(&crit_);
+  for (size_t i = next_task_; i < queue_.size(); ++i)
+    queue_[i]->state_ = Task::State::kIdle;
+  queue_.clear();
+  next_task_ = 0;
+  in_round_ = false;
+  work_event_.Reset();
+}
+
+bool FrameRetrievalPool::IsDone(const Task& task) const {
+  rtc::CritScope lock(&crit_);
+  return task.done_;
+}
+
+AudioMixer::Source::AudioFrameInfo FrameRetrievalPool::GetInfo(
+    const Task& task) const {
+  rtc::CritScope lock(&crit_);
+  return task.done_ ? task.info_ : AudioMixer::Source::AudioFrameInfo::kError;
+}
+
+bool FrameRetrievalPool::IsRunning(const Task& task) const {
+  rtc::CritScope lock(&crit_);
+  return task.state_ == Task::State::kRunning;
+}
+
+void FrameRetrievalPool::WaitUntilNotRunning(const Task& task) const {
+  // Only happens when a source is removed while its call is late, so polling
+  // is good enough.
+  while (IsRunning(task))
+    SleepMs(1);
+}
+
+bool FrameRetrievalPool::WorkerThread(void* obj) {
+  return static_cast<FrameRetrievalPool*>(obj)->ProcessTask();
+}
+
+bool FrameRetrievalPool::ProcessTask() {
+  work_event_.Wait(rtc::Event::kForever);
+  Task* task;
+  int sample_rate_hz;
+  {
+    rtc::CritScope lock(&crit_);
+    if (stop_)
+      return false;
+    if (next_task_ >= queue_.size()) {
+      work_event_.Reset();
+      return true;
+    }
+    task = queue_[next_task_++];
+    if (next_task_ == queue_.size())
+      work_event_.Reset();
+    task->state_ = Task::State::kRunning;
+    sample_rate_hz = sample_rate_hz_;
+  }
+
+  const AudioMixer::Source::AudioFrameInfo info =
+      task->source_->GetAudioFrameWithInfo(sample_rate_hz, task->audio_frame_);
+
+  {
+    rtc::CritScope lock(&crit_);
+    task->state_ = Task::State::kIdle;
+    if (!in_round_ || task->round_ != round_)
+      return true;
+    task->info_ = info;
+    task->done_ = true;
+    --num_pending_;
+  }
+  task_done_event_.Set();
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_MIXER_FRAME_RETRIEVAL_POOL_H_
+#define WEBRTC_MODULES_AUDIO_MIXER_FRAME_RETRIEVAL_POOL_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/api/audio/audio_mixer.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/thread_annotations.h"
+
+namespace webrtc {
+
+// Worker threads which get the audio of a mixing round from the sources in
+// parallel, so that the sources are called concurrently instead of one after
+// the other on the audio device thread, and a round can end at a deadline
+// even if some sources are still busy, e.g. decoding.
+class FrameRetrievalPool {
+ public:
+  // One GetAudioFrameWithInfo() call. The fields other than the source and
+  // frame are guarded by the pool.
+  class Task {
+   public:
+    Task(AudioMixer::Source* source, AudioFrame* audio_frame)
+        : source_(source), audio_frame_(audio_frame) {}
+
+   private:
+    friend class FrameRetrievalPool;
+    enum class State { kIdle, kQueued, kRunning };
+
+    AudioMixer::Source* const source_;
+    AudioFrame* const audio_frame_;
+    State state_ = State::kIdle;
+    // The round the task was last queued in, and whether it finished within
+    // it.
+    uint64_t round_ = 0;
+    bool done_ = false;
+    AudioMixer::Source::AudioFrameInfo info_ =
+        AudioMixer::Source::AudioFrameInfo::kError;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(Task);
+  };
+
+  explicit FrameRetrievalPool(size_t num_threads);
+  ~FrameRetrievalPool();
+
+  // Calls the sources of |tasks| at |sample_rate_hz| on the worker threads,
+  // and returns when all are done or at |deadline_ms|, in rtc::TimeMillis()
+  // time. Tasks not started by then are dropped; tasks still running go on
+  // in the background and must not be passed in again while IsRunning().
+  // Must not be called concurrently.
+  void Run(const std::vector<Task*>& tasks,
+           int sample_rate_hz,
+           int64_t deadline_ms);
+
+  // Whether |task| finished within the last Run() it was passed to, and what
+  // its source returned then.
+  bool IsDone(const Task& task) const;
+  AudioMixer::Source::AudioFrameInfo GetInfo(const Task& task) const;
+
+  // Whether the source of |task| is still being called after its round.
+  bool IsRunning(const Task& task) const;
+  // Blocks until IsRunning() is false, so that |task| can be destroyed.
+  void WaitUntilNotRunning(const Task& task) const;
+
+ private:
+  static bool WorkerThread(void* obj);
+  bool ProcessTask();
+
+  rtc::CriticalSection crit_;
+  std::vector<Task*> queue_ GUARDED_BY(crit_);
+  size_t next_task_ GUARDED_BY(crit_);
+  uint64_t round_ GUARDED_BY(crit_);
+  bool in_round_ GUARDED_BY(crit_);
+  int sample_rate_hz_ GUARDED_BY(crit_);
+  size_t num_pending_ GUARDED_BY(crit_);
+  bool stop_ GUARDED_BY(crit_);
+
+  // Signaled while there are queued tasks, or on stop.
+  rtc::Event work_event_;
+  // Signaled when a task of the current round finishes.
+  rtc::Event task_done_event_;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FrameRetrievalPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_MIXER_FRAME_RETRIEVAL_POOL_H_
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/frame_retrieval_pool.h"
+
+#include "webrtc/base/event.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+constexpr int64_t kLongTimeMs = 10000;
+
+// Returns once |release| is set, having set |started|.
+class BlockingSource : public AudioMixer::Source {
+ public:
+  BlockingSource(rtc::Event* started, rtc::Event* release)
+      : started_(started), release_(release) {}
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    started_->Set();
+    release_->Wait(rtc::Event::kForever);
+    audio_frame->sample_rate_hz_ = sample_rate_hz;
+    return AudioFrameInfo::kMuted;
+  }
+  int Ssrc() const override { return 0; }
+  int PreferredSampleRate() const override { return 16000; }
+
+ private:
+  rtc::Event* const started_;
+  rtc::Event* const release_;
+};
+}  // namespace
+
+TEST(FrameRetrievalPoolTest, CallsSourcesConcurrently) {
+  // Each source only returns once the other one has been called.
+  rtc::Event first_called(true, false);
+  rtc::Event second_called(true, false);
+  BlockingSource first(&first_called, &second_called);
+  BlockingSource second(&second_called, &first_called);
+  AudioFrame first_frame;
+  AudioFrame second_frame;
+  FrameRetrievalPool::Task first_task(&first, &first_frame);
+  FrameRetrievalPool::Task second_task(&second, &second_frame);
+
+  FrameRetrievalPool pool(2);
+  pool.Run({&first_task, &second_task}, 32000,
+           rtc::TimeMillis() + kLongTimeMs);
+
+  EXPECT_TRUE(pool.IsDone(first_task));
+  EXPECT_TRUE(pool.IsDone(second_task));
+  EXPECT_EQ(AudioMixer::Source::AudioFrameInfo::kMuted,
+            pool.GetInfo(first_task));
+  EXPECT_EQ(32000, first_frame.sample_rate_hz_);
+  EXPECT_EQ(32000, second_frame.sample_rate_hz_);
+}
+
+TEST(FrameRetrievalPoolTest, LateTasksAreNotDone) {
+  rtc::Event started(true, false);
+  rtc::Event release(true, false);
+  BlockingSource source(&started, &release);
+  AudioFrame blocking_frame;
+  AudioFrame queued_frame;
+  FrameRetrievalPool::Task blocking_task(&source, &blocking_frame);
+  FrameRetrievalPool::Task queued_task(&source, &queued_frame);
+
+  // With one thread, the second task is never started.
+  FrameRetrievalPool pool(1);
+  pool.Run({&blocking_task, &queued_task}, 16000, rtc::TimeMillis() + 10);
+  ASSERT_TRUE(started.Wait(kLongTimeMs));
+
+  EXPECT_FALSE(pool.IsDone(blocking_task));
+  EXPECT_TRUE(pool.IsRunning(blocking_task));
+  EXPECT_EQ(AudioMixer::Source::AudioFrameInfo::kError,
+            pool.GetInfo(blocking_task));
+  EXPECT_FALSE(pool.IsDone(queued_task));
+  EXPECT_FALSE(pool.IsRunning(queued_task));
+
+  release.Set();
+  pool.WaitUntilNotRunning(blocking_task);
+  // Finishing after the round doesn't count.
+  EXPECT_FALSE(pool.IsDone(blocking_task));
+
+  pool.Run({&blocking_task, &queued_task}, 16000,
+           rtc::TimeMillis() + kLongTimeMs);
+  EXPECT_TRUE(pool.IsDone(blocking_task));
+  EXPECT_TRUE(pool.IsDone(queued_task));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/mix_accumulator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+typedef void (*AddToMixFunction)(const int16_t* src,
+                                 size_t num_samples,
+                                 int32_t* mix);
+typedef void (*SubtractFromMixFunction)(const int32_t* mix,
+                                        const int16_t* src,
+                                        size_t num_samples,
+                                        int16_t* dst);
+
+AddToMixFunction SelectAddToMix() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2))
+    return &AddToMix_SSE2;
+  return &AddToMix_C;
+#elif defined(WEBRTC_HAS_NEON)
+  return &AddToMix_NEON;
+#else
+  return &AddToMix_C;
+#endif
+}
+
+SubtractFromMixFunction SelectSubtractFromMix() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2))
+    return &SubtractFromMix_SSE2;
+  return &SubtractFromMix_C;
+#elif defined(WEBRTC_HAS_NEON)
+  return &SubtractFromMix_NEON;
+#else
+  return &SubtractFromMix_C;
+#endif
+}
+}  // namespace
+
+void AddToMix_C(const int16_t* src, size_t num_samples, int32_t* mix) {
+  for (size_t i = 0; i < num_samples; ++i)
+    mix[i] += src[i];
+}
+
+void SubtractFromMix_C(const int32_t* mix,
+                       const int16_t* src,
+                       size_t num_samples,
+                       int16_t* dst) {
+  for (size_t i = 0; i < num_samples; ++i) {
+    const int32_t sample = src ? mix[i] - src[i] : mix[i];
+    dst[i] = static_cast<int16_t>(std::min<int32_t>(
+        std::max<int32_t>(sample, std::numeric_limits<int16_t>::min()),
+        std::numeric_limits<int16_t>::max()));
+  }
+}
+
+void AddToMix(const int16_t* src, size_t num_samples, int32_t* mix) {
+  static const AddToMixFunction add_to_mix = SelectAddToMix();
+  add_to_mix(src, num_samples, mix);
+}
+
+void SubtractFromMix(const int32_t* mix,
+                     const int16_t* src,
+                     size_t num_samples,
+                     int16_t* dst) {
+  static const SubtractFromMixFunction subtract_from_mix =
+      SelectSubtractFromMix();
+  subtract_from_mix(mix, src, num_samples, dst);
+}
+
+}  // namespace webrtc
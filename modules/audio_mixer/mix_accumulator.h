@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_MIXER_MIX_ACCUMULATOR_H_
+#define WEBRTC_MODULES_AUDIO_MIXER_MIX_ACCUMULATOR_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Kernels for mixing many sources into 32 bit sums, from which the mix of
+// every subset leaving one source out is derived by subtraction. The sums
+// don't saturate, so the subtraction is exact.
+
+// Adds |num_samples| samples of |src| to |mix|.
+void AddToMix(const int16_t* src, size_t num_samples, int32_t* mix);
+
+// Writes |mix| minus |src|, saturated to 16 bits, to |dst|. A null |src|
+// writes |mix| itself.
+void SubtractFromMix(const int32_t* mix,
+                     const int16_t* src,
+                     size_t num_samples,
+                     int16_t* dst);
+
+// Kernels used by the functions above, which pick the widest one the CPU
+// supports.
+void AddToMix_C(const int16_t* src, size_t num_samples, int32_t* mix);
+void SubtractFromMix_C(const int32_t* mix,
+                       const int16_t* src,
+                       size_t num_samples,
+                       int16_t* dst);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void AddToMix_SSE2(const int16_t* src, size_t num_samples, int32_t* mix);
+void SubtractFromMix_SSE2(const int32_t* mix,
+                          const int16_t* src,
+                          size_t num_samples,
+                          int16_t* dst);
+#endif
+#if defined(WEBRTC_HAS_NEON)
+void AddToMix_NEON(const int16_t* src, size_t num_samples, int32_t* mix);
+void SubtractFromMix_NEON(const int32_t* mix,
+                          const int16_t* src,
+                          size_t num_samples,
+                          int16_t* dst);
+#endif
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_MIXER_MIX_ACCUMULATOR_H_
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/mix_accumulator.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+void AddToMix_NEON(const int16_t* src, size_t num_samples, int32_t* mix) {
+  size_t i = 0;
+  for (; i + 8 <= num_samples; i += 8) {
+    const int16x8_t samples = vld1q_s16(src + i);
+    vst1q_s32(mix + i, vaddw_s16(vld1q_s32(mix + i), vget_low_s16(samples)));
+    vst1q_s32(mix + i + 4,
+              vaddw_s16(vld1q_s32(mix + i + 4), vget_high_s16(samples)));
+  }
+  AddToMix_C(src + i, num_samples - i, mix + i);
+}
+
+void SubtractFromMix_NEON(const int32_t* mix,
+                          const int16_t* src,
+                          size_t num_samples,
+                          int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= num_samples; i += 8) {
+    int32x4_t low = vld1q_s32(mix + i);
+    int32x4_t high = vld1q_s32(mix + i + 4);
+    if (src) {
+      const int16x8_t samples = vld1q_s16(src + i);
+      low = vsubw_s16(low, vget_low_s16(samples));
+      high = vsubw_s16(high, vget_high_s16(samples));
+    }
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+  }
+  SubtractFromMix_C(mix + i, src ? src + i : nullptr, num_samples - i,
+                    dst + i);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/mix_accumulator.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+namespace {
+// Sign extends the low and high four samples of |samples| to 32 bits.
+__m128i WidenLow(__m128i samples) {
+  return _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+}
+__m128i WidenHigh(__m128i samples) {
+  return _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+}
+}  // namespace
+
+void AddToMix_SSE2(const int16_t* src, size_t num_samples, int32_t* mix) {
+  size_t i = 0;
+  for (; i + 8 <= num_samples; i += 8) {
+    const __m128i samples =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i* m = reinterpret_cast<__m128i*>(mix + i);
+    _mm_storeu_si128(m, _mm_add_epi32(_mm_loadu_si128(m), WidenLow(samples)));
+    _mm_storeu_si128(
+        m + 1, _mm_add_epi32(_mm_loadu_si128(m + 1), WidenHigh(samples)));
+  }
+  AddToMix_C(src + i, num_samples - i, mix + i);
+}
+
+void SubtractFromMix_SSE2(const int32_t* mix,
+                          const int16_t* src,
+                          size_t num_samples,
+                          int16_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= num_samples; i += 8) {
+    const __m128i* m = reinterpret_cast<const __m128i*>(mix + i);
+    __m128i low = _mm_loadu_si128(m);
+    __m128i high = _mm_loadu_si128(m + 1);
+    if (src) {
+      const __m128i samples =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      low = _mm_sub_epi32(low, WidenLow(samples));
+      high = _mm_sub_epi32(high, WidenHigh(samples));
+    }
+    // Packing saturates.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packs_epi32(low, high));
+  }
+  SubtractFromMix_C(mix + i, src ? src + i : nullptr, num_samples - i,
+                    dst + i);
+}
+
+}  // namespace webrtc
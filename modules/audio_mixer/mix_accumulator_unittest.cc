@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_mixer/mix_accumulator.h"
+
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/simd_kernels.h"
+
+namespace webrtc {
+namespace {
+typedef void (*AddToMixFunction)(const int16_t*, size_t, int32_t*);
+typedef void (*SubtractFromMixFunction)(const int32_t*,
+                                        const int16_t*,
+                                        size_t,
+                                        int16_t*);
+
+struct MixKernels {
+  AddToMixFunction add_to_mix;
+  SubtractFromMixFunction subtract_from_mix;
+};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+const MixKernels kSse2Kernels = {&AddToMix_SSE2, &SubtractFromMix_SSE2};
+#endif
+#if defined(WEBRTC_HAS_NEON)
+const MixKernels kNeonKernels = {&AddToMix_NEON, &SubtractFromMix_NEON};
+#endif
+
+// Sample counts around the vector width, so that every kernel runs both its
+// vector loop and its scalar tail.
+const size_t kNumSamples[] = {0, 1, 7, 8, 9, 160, 479, 480, 1920};
+
+std::vector<int16_t> RandomSamples(Random* random, size_t num_samples) {
+  std::vector<int16_t> samples(num_samples);
+  for (int16_t& sample : samples)
+    sample = random->Rand<int16_t>();
+  return samples;
+}
+
+void ExpectKernelsMatchC(const MixKernels& kernels) {
+  Random random(0x313);
+  for (size_t num_samples : kNumSamples) {
+    std::vector<int32_t> expected_mix(num_samples, 0);
+    std::vector<int32_t> actual_mix(num_samples, 0);
+    // Enough full scale sources to go far outside 16 bits.
+    std::vector<std::vector<int16_t>> sources;
+    for (int i = 0; i < 5; ++i) {
+      sources.push_back(RandomSamples(&random, num_samples));
+      AddToMix_C(sources.back().data(), num_samples, expected_mix.data());
+      kernels.add_to_mix(sources.back().data(), num_samples,
+                         actual_mix.data());
+    }
+    EXPECT_EQ(expected_mix, actual_mix) << num_samples << " samples";
+
+    std::vector<int16_t> expected(num_samples);
+    std::vector<int16_t> actual(num_samples);
+    SubtractFromMix_C(expected_mix.data(), nullptr, num_samples,
+                      expected.data());
+    kernels.subtract_from_mix(actual_mix.data(), nullptr, num_samples,
+                              actual.data());
+    EXPECT_EQ(expected, actual) << num_samples << " samples";
+    for (const auto& source : sources) {
+      SubtractFromMix_C(expected_mix.data(), source.data(), num_samples,
+                        expected.data());
+      kernels.subtract_from_mix(actual_mix.data(), source.data(),
+                                num_samples, actual.data());
+      EXPECT_EQ(expected, actual) << num_samples << " samples";
+    }
+  }
+}
+}  // namespace
+
+TEST(MixAccumulatorTest, LeavesOneSourceOut) {
+  const int16_t a[] = {100, -200, 30000, -30000};
+  const int16_t b[] = {1, 2, 30000, -30000};
+  int32_t mix[4] = {0};
+  AddToMix(a, 4, mix);
+  AddToMix(b, 4, mix);
+
+  int16_t result[4];
+  SubtractFromMix(mix, a, 4, result);
+  EXPECT_EQ(1, result[0]);
+  EXPECT_EQ(2, result[1]);
+  EXPECT_EQ(30000, result[2]);
+  EXPECT_EQ(-30000, result[3]);
+
+  // The full mix saturates.
+  SubtractFromMix(mix, nullptr, 4, result);
+  EXPECT_EQ(101, result[0]);
+  EXPECT_EQ(-198, result[1]);
+  EXPECT_EQ(32767, result[2]);
+  EXPECT_EQ(-32768, result[3]);
+}
+
+TEST(MixAccumulatorTest, SimdKernelsMatchC) {
+  for (const auto& simd : test::SupportedSimdKernels<const MixKernels*>(
+           WEBRTC_X86_KERNEL(&kSse2Kernels), nullptr,
+           WEBRTC_NEON_KERNEL(&kNeonKernels))) {
+    SCOPED_TRACE(simd.instruction_set);
+    ExpectKernelsMatchC(*simd.kernel);
+  }
+}
+
+}  // namespace webrtc
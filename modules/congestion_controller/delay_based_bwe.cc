@@ -20,6 +20,7 @@
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/congestion_controller/include/congestion_controller.h"
 #include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/bwe_trace.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 #include "webrtc/system_wrappers/include/field_trial.h"
@@ -246,9 +247,11 @@ DelayBasedBwe::Result DelayBasedBwe::IncomingPacketFeedbackVector(
                               BweNames::kBweNamesMax);
     uma_recorded_ = true;
   }
+  // The packets of one feedback are all handled at the same time.
+  const int64_t now_ms = clock_->TimeInMilliseconds();
   Result aggregated_result;
   for (const auto& packet_info : packet_feedback_vector) {
-    Result result = IncomingPacketInfo(packet_info);
+    Result result = IncomingPacketInfo(packet_info, now_ms);
     if (result.updated)
       aggregated_result = result;
   }
@@ -256,9 +259,8 @@ DelayBasedBwe::Result DelayBasedBwe::IncomingPacketFeedbackVector(
 }
 
 DelayBasedBwe::Result DelayBasedBwe::IncomingPacketInfo(
-    const PacketInfo& info) {
-  int64_t now_ms = clock_->TimeInMilliseconds();
-
+    const PacketInfo& info,
+    int64_t now_ms) {
   receiver_incoming_bitrate_.Update(info.arrival_time_ms, info.payload_size);
   Result result;
   // Reset if the stream has timed out.
@@ -293,29 +295,41 @@ DelayBasedBwe::Result DelayBasedBwe::IncomingPacketInfo(
                                     info.payload_size, &ts_delta, &t_delta,
                                     &size_delta)) {
     double ts_delta_ms = (1000.0 * ts_delta) / (1 << kInterArrivalShift);
+    const BandwidthUsage prev_state = detector_.State();
+    double offset;
     if (in_trendline_experiment_) {
       trendline_estimator_->Update(t_delta, ts_delta_ms, info.arrival_time_ms);
-      detector_.Detect(trendline_estimator_->trendline_slope(), ts_delta_ms,
+      offset = trendline_estimator_->trendline_slope();
+      detector_.Detect(offset, ts_delta_ms,
                        trendline_estimator_->num_of_deltas(),
                        info.arrival_time_ms);
     } else if (in_median_slope_experiment_) {
       median_slope_estimator_->Update(t_delta, ts_delta_ms,
                                       info.arrival_time_ms);
-      detector_.Detect(median_slope_estimator_->trendline_slope(), ts_delta_ms,
+      offset = median_slope_estimator_->trendline_slope();
+      detector_.Detect(offset, ts_delta_ms,
                        median_slope_estimator_->num_of_deltas(),
                        info.arrival_time_ms);
     } else {
       kalman_estimator_->Update(t_delta, ts_delta_ms, size_delta,
                                 detector_.State(), info.arrival_time_ms);
-      detector_.Detect(kalman_estimator_->offset(), ts_delta_ms,
+      offset = kalman_estimator_->offset();
+      detector_.Detect(offset, ts_delta_ms,
                        kalman_estimator_->num_of_deltas(),
                        info.arrival_time_ms);
     }
+    if (detector_.State() != prev_state) {
+      BWE_TRACE(kDelayBasedDetection, now_ms, detector_.State(), offset,
+                detector_.threshold());
+    }
   }
 
   int probing_bps = 0;
   if (info.probe_cluster_id != PacketInfo::kNotAProbe) {
     probing_bps = probe_bitrate_estimator_.HandleProbeAndEstimateBitrate(info);
+    if (probing_bps > 0) {
+      BWE_TRACE(kProbeResult, now_ms, info.probe_cluster_id, probing_bps, 0);
+    }
   }
   rtc::Optional<uint32_t> acked_bitrate_bps =
       receiver_incoming_bitrate_.bitrate_bps();
@@ -346,6 +360,9 @@ DelayBasedBwe::Result DelayBasedBwe::IncomingPacketInfo(
     last_update_ms_ = now_ms;
     BWE_TEST_LOGGING_PLOT(1, "target_bitrate_bps", now_ms,
                           result.target_bitrate_bps);
+    BWE_TRACE(kDelayBasedEstimate, now_ms, result.probe,
+              result.target_bitrate_bps,
+              acked_bitrate_bps ? *acked_bitrate_bps : -1.0);
   }
 
   return result;
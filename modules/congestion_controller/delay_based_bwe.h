@@ -78,7 +78,7 @@ class DelayBasedBwe {
     const bool in_experiment_;
   };
 
-  Result IncomingPacketInfo(const PacketInfo& info);
+  Result IncomingPacketInfo(const PacketInfo& info, int64_t now_ms);
   // Updates the current remote rate estimate and returns true if a valid
   // estimate exists.
   bool UpdateEstimate(int64_t packet_arrival_time_ms,
@@ -90,8 +90,9 @@ int64_t TransportFeedbackAdapter::GetProbingIntervalMs() const {
   return delay_based_bwe_->GetProbingIntervalMs();
 }
 
-std::vector<PacketInfo> TransportFeedbackAdapter::GetPacketFeedbackVector(
-    const rtcp::TransportFeedback& feedback) {
+void TransportFeedbackAdapter::GetPacketFeedbackVector(
+    const rtcp::TransportFeedback& feedback,
+    std::vector<PacketInfo>* packet_feedback_vector) {
   int64_t timestamp_us = feedback.GetBaseTimeUs();
   // Add timestamp deltas to a local time base selected on first packet arrival.
   // This won't be the true time base, but makes it easier to manually inspect
@@ -112,45 +113,39 @@ std::vector<PacketInfo> TransportFeedbackAdapter::GetPacketFeedbackVector(
   }
   last_timestamp_us_ = timestamp_us;
 
-  uint16_t sequence_number = feedback.GetBaseSequence();
-  std::vector<int64_t> delta_vec = feedback.GetReceiveDeltasUs();
-  auto delta_it = delta_vec.begin();
-  std::vector<PacketInfo> packet_feedback_vector;
-  packet_feedback_vector.reserve(delta_vec.size());
-
+  packet_feedback_vector->clear();
   {
     rtc::CritScope cs(&lock_);
     size_t failed_lookups = 0;
     int64_t offset_us = 0;
-    for (auto symbol : feedback.GetStatusVector()) {
-      if (symbol != rtcp::TransportFeedback::StatusSymbol::kNotReceived) {
-        RTC_DCHECK(delta_it != delta_vec.end());
-        offset_us += *(delta_it++);
-        int64_t timestamp_ms = current_offset_ms_ + (offset_us / 1000);
-        PacketInfo info(timestamp_ms, sequence_number);
-        if (send_time_history_.GetInfo(&info, true) && info.send_time_ms >= 0) {
-          packet_feedback_vector.push_back(info);
-        } else {
-          ++failed_lookups;
-        }
+    for (const auto& packet : feedback.GetReceivedPackets()) {
+      offset_us += packet.delta_us();
+      int64_t timestamp_ms = current_offset_ms_ + (offset_us / 1000);
+      PacketInfo info(timestamp_ms, packet.sequence_number());
+      if (send_time_history_.GetInfo(&info, true) && info.send_time_ms >= 0) {
+        packet_feedback_vector->push_back(info);
+      } else {
+        ++failed_lookups;
       }
-      ++sequence_number;
     }
-    std::sort(packet_feedback_vector.begin(), packet_feedback_vector.end(),
-              PacketInfoComparator());
-    RTC_DCHECK(delta_it == delta_vec.end());
+    // Packets usually arrive in the order they were sent.
+    if (!std::is_sorted(packet_feedback_vector->begin(),
+                        packet_feedback_vector->end(), PacketInfoComparator())) {
+      std::sort(packet_feedback_vector->begin(), packet_feedback_vector->end(),
+                PacketInfoComparator());
+    }
     if (failed_lookups > 0) {
       LOG(LS_WARNING) << "Failed to lookup send time for " << failed_lookups
                       << " packet" << (failed_lookups > 1 ? "s" : "")
                       << ". Send time history too small?";
     }
   }
-  return packet_feedback_vector;
 }
 
 void TransportFeedbackAdapter::OnTransportFeedback(
     const rtcp::TransportFeedback& feedback) {
-  last_packet_feedback_vector_ = GetPacketFeedbackVector(feedback);
+  // Reuses the storage of the previous feedback vector.
+  GetPacketFeedbackVector(feedback, &last_packet_feedback_vector_);
   DelayBasedBwe::Result result;
   {
     rtc::CritScope cs(&bwe_lock_);
@@ -54,8 +54,10 @@ class TransportFeedbackAdapter : public TransportFeedbackObserver,
   int64_t GetProbingIntervalMs() const;
 
  private:
-  std::vector<PacketInfo> GetPacketFeedbackVector(
-      const rtcp::TransportFeedback& feedback);
+  // Looks up the packets in |feedback| and fills |packet_feedback_vector|
+  // with them, sorted by arrival time.
+  void GetPacketFeedbackVector(const rtcp::TransportFeedback& feedback,
+                               std::vector<PacketInfo>* packet_feedback_vector);
 
   rtc::CriticalSection lock_;
   rtc::CriticalSection bwe_lock_;
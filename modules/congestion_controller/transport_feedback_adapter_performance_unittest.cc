@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/bitrate_controller/include/mock/mock_bitrate_controller.h"
+#include "webrtc/modules/congestion_controller/transport_feedback_adapter.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gmock.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumTransports = 50;
+constexpr int kFeedbackIntervalMs = 10;
+constexpr int kPacketsPerFeedback = 20;
+constexpr int kDurationMs = 10000;
+constexpr size_t kPacketSize = 1200;
+constexpr int64_t kPropagationDelayMs = 50;
+constexpr int kLossPercent = 2;
+
+class BitrateControllerCounter : public test::MockBitrateController {
+ public:
+  void OnDelayBasedBweResult(const DelayBasedBwe::Result& result) override {
+    ++num_results_;
+  }
+  int num_results() const { return num_results_; }
+
+ private:
+  int num_results_ = 0;
+};
+
+// The feedback one transport receives for the packets it sent during the last
+// feedback interval. Arrival times spread the packets evenly over the
+// interval, with some jitter and loss.
+rtc::Buffer BuildFeedback(uint16_t base_sequence_number,
+                          int64_t send_time_ms,
+                          Random* random) {
+  rtcp::TransportFeedback feedback;
+  const int64_t base_time_us = (send_time_ms + kPropagationDelayMs) * 1000;
+  feedback.SetBase(base_sequence_number, base_time_us);
+  for (int i = 0; i < kPacketsPerFeedback; ++i) {
+    if (i > 0 && random->Rand(1, 100) <= kLossPercent)
+      continue;
+    const int64_t arrival_time_us =
+        base_time_us + i * kFeedbackIntervalMs * 1000 / kPacketsPerFeedback +
+        random->Rand(0, 200);
+    EXPECT_TRUE(feedback.AddReceivedPacket(
+        static_cast<uint16_t>(base_sequence_number + i), arrival_time_us));
+  }
+  return feedback.Build();
+}
+}  // namespace
+
+TEST(TransportFeedbackAdapterPerformanceTest, FeedbackFromManyTransports) {
+  SimulatedClock clock(0);
+  Random random(0xfeed);
+  ::testing::NiceMock<BitrateControllerCounter> bitrate_controller;
+  std::vector<std::unique_ptr<TransportFeedbackAdapter>> adapters;
+  for (int i = 0; i < kNumTransports; ++i) {
+    adapters.emplace_back(
+        new TransportFeedbackAdapter(&clock, &bitrate_controller));
+    adapters.back()->InitBwe();
+  }
+
+  // Feedback is parsed into the same object every time, the way a receiver
+  // would hold on to it.
+  rtcp::TransportFeedback feedback;
+  uint16_t sequence_number = 0;
+  int64_t elapsed_ns = 0;
+  int num_feedbacks = 0;
+  for (int ms = 0; ms < kDurationMs; ms += kFeedbackIntervalMs) {
+    const int64_t send_time_ms = clock.TimeInMilliseconds();
+    const uint16_t base_sequence_number = sequence_number;
+    for (auto& adapter : adapters) {
+      for (int i = 0; i < kPacketsPerFeedback; ++i) {
+        const uint16_t seq = base_sequence_number + i;
+        adapter->AddPacket(seq, kPacketSize, PacketInfo::kNotAProbe);
+        adapter->OnSentPacket(seq, send_time_ms + i);
+      }
+    }
+    sequence_number += kPacketsPerFeedback;
+    clock.AdvanceTimeMilliseconds(kFeedbackIntervalMs);
+
+    for (auto& adapter : adapters) {
+      const rtc::Buffer packet =
+          BuildFeedback(base_sequence_number, send_time_ms, &random);
+      const int64_t start_ns = rtc::TimeNanos();
+      rtcp::CommonHeader header;
+      ASSERT_TRUE(header.Parse(packet.data(), packet.size()));
+      ASSERT_TRUE(feedback.Parse(header));
+      adapter->OnTransportFeedback(feedback);
+      elapsed_ns += rtc::TimeNanos() - start_ns;
+      EXPECT_FALSE(adapter->GetTransportFeedbackVector().empty());
+      ++num_feedbacks;
+    }
+  }
+  EXPECT_GT(bitrate_controller.num_results(), 0);
+
+  webrtc::test::PrintResult("transport_feedback_adapter", "_50_transports",
+                            "parse_and_process", elapsed_ns / num_feedbacks,
+                            "ns/feedback", true);
+  // Processing time per second of feedback at 100 feedbacks per second and
+  // transport.
+  webrtc::test::PrintResult("transport_feedback_adapter", "_50_transports",
+                            "cpu_time", elapsed_ns / 1000 / (kDurationMs / 1000),
+                            "us/s", true);
+}
+
+}  // namespace webrtc
@@ -19,24 +19,24 @@
 namespace webrtc {
 
 namespace {
-rtc::Optional<double> LinearFitSlope(
-    const std::list<std::pair<double, double>> points) {
-  RTC_DCHECK(points.size() >= 2);
+rtc::Optional<double> LinearFitSlope(const std::pair<double, double>* points,
+                                     size_t num_points) {
+  RTC_DCHECK(num_points >= 2);
   // Compute the "center of mass".
   double sum_x = 0;
   double sum_y = 0;
-  for (const auto& point : points) {
-    sum_x += point.first;
-    sum_y += point.second;
+  for (size_t i = 0; i < num_points; ++i) {
+    sum_x += points[i].first;
+    sum_y += points[i].second;
   }
-  double x_avg = sum_x / points.size();
-  double y_avg = sum_y / points.size();
+  double x_avg = sum_x / num_points;
+  double y_avg = sum_y / num_points;
   // Compute the slope k = \sum (x_i-x_avg)(y_i-y_avg) / \sum (x_i-x_avg)^2
   double numerator = 0;
   double denominator = 0;
-  for (const auto& point : points) {
-    numerator += (point.first - x_avg) * (point.second - y_avg);
-    denominator += (point.first - x_avg) * (point.first - x_avg);
+  for (size_t i = 0; i < num_points; ++i) {
+    numerator += (points[i].first - x_avg) * (points[i].second - y_avg);
+    denominator += (points[i].first - x_avg) * (points[i].first - x_avg);
   }
   if (denominator == 0)
     return rtc::Optional<double>();
@@ -57,7 +57,9 @@ TrendlineEstimator::TrendlineEstimator(size_t window_size,
       accumulated_delay_(0),
       smoothed_delay_(0),
       delay_hist_(),
-      trendline_(0) {}
+      trendline_(0) {
+  delay_hist_.reserve(2 * window_size_);
+}
 
 TrendlineEstimator::~TrendlineEstimator() {}
 
@@ -81,14 +83,18 @@ void TrendlineEstimator::Update(double recv_delta_ms,
                         smoothed_delay_);
 
   // Simple linear regression.
+  if (delay_hist_.size() == 2 * window_size_) {
+    delay_hist_.erase(delay_hist_.begin(),
+                      delay_hist_.begin() + window_size_ + 1);
+  }
   delay_hist_.push_back(std::make_pair(
       static_cast<double>(arrival_time_ms - first_arrival_time_ms),
       smoothed_delay_));
-  if (delay_hist_.size() > window_size_)
-    delay_hist_.pop_front();
-  if (delay_hist_.size() == window_size_) {
+  if (delay_hist_.size() >= window_size_) {
     // Only update trendline_ if it is possible to fit a line to the data.
-    trendline_ = LinearFitSlope(delay_hist_).value_or(trendline_);
+    trendline_ = LinearFitSlope(&delay_hist_[delay_hist_.size() - window_size_],
+                                window_size_)
+                     .value_or(trendline_);
   }
 
   BWE_TEST_LOGGING_PLOT(1, "trendline_slope", arrival_time_ms, trendline_);
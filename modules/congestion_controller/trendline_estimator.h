@@ -13,8 +13,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <list>
 #include <utility>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 
@@ -60,8 +60,10 @@ class TrendlineEstimator {
   // Exponential backoff filtering.
   double accumulated_delay_;
   double smoothed_delay_;
-  // Linear least squares regression.
-  std::list<std::pair<double, double>> delay_hist_;
+  // Linear least squares regression over the last |window_size_| points.
+  // Older points are dropped a window at a time, so the points of the window
+  // stay contiguous without moving them on every update.
+  std::vector<std::pair<double, double>> delay_hist_;
   double trendline_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(TrendlineEstimator);
@@ -8,6 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <list>
+#include <utility>
+
 #include "webrtc/test/gtest.h"
 #include "webrtc/base/random.h"
 #include "webrtc/modules/congestion_controller/trendline_estimator.h"
@@ -44,8 +48,94 @@ void TestEstimator(double slope, double jitter_stddev, double tolerance) {
       EXPECT_NEAR(estimator.trendline_slope(), slope, tolerance);
   }
 }
+
+// The estimator as it was when it kept its window in a list, refitting a copy
+// of it on every update.
+class ListTrendlineEstimator {
+ public:
+  ListTrendlineEstimator(size_t window_size,
+                         double smoothing_coef,
+                         double threshold_gain)
+      : window_size_(window_size),
+        smoothing_coef_(smoothing_coef),
+        threshold_gain_(threshold_gain) {}
+
+  void Update(double recv_delta_ms,
+              double send_delta_ms,
+              int64_t arrival_time_ms) {
+    const double delta_ms = recv_delta_ms - send_delta_ms;
+    if (first_arrival_time_ms_ == -1)
+      first_arrival_time_ms_ = arrival_time_ms;
+    accumulated_delay_ += delta_ms;
+    smoothed_delay_ = smoothing_coef_ * smoothed_delay_ +
+                      (1 - smoothing_coef_) * accumulated_delay_;
+    delay_hist_.push_back(std::make_pair(
+        static_cast<double>(arrival_time_ms - first_arrival_time_ms_),
+        smoothed_delay_));
+    if (delay_hist_.size() > window_size_)
+      delay_hist_.pop_front();
+    if (delay_hist_.size() == window_size_)
+      trendline_ = LinearFitSlope(delay_hist_, trendline_);
+  }
+
+  double trendline_slope() const { return trendline_ * threshold_gain_; }
+
+ private:
+  static double LinearFitSlope(
+      const std::list<std::pair<double, double>> points,
+      double previous_slope) {
+    double sum_x = 0;
+    double sum_y = 0;
+    for (const auto& point : points) {
+      sum_x += point.first;
+      sum_y += point.second;
+    }
+    double x_avg = sum_x / points.size();
+    double y_avg = sum_y / points.size();
+    double numerator = 0;
+    double denominator = 0;
+    for (const auto& point : points) {
+      numerator += (point.first - x_avg) * (point.second - y_avg);
+      denominator += (point.first - x_avg) * (point.first - x_avg);
+    }
+    return denominator == 0 ? previous_slope : numerator / denominator;
+  }
+
+  const size_t window_size_;
+  const double smoothing_coef_;
+  const double threshold_gain_;
+  int64_t first_arrival_time_ms_ = -1;
+  double accumulated_delay_ = 0;
+  double smoothed_delay_ = 0;
+  std::list<std::pair<double, double>> delay_hist_;
+  double trendline_ = 0;
+};
 }  // namespace
 
+// The slopes, and so the decisions of the detector, must not change with how
+// the window is stored.
+TEST(TrendlineEstimator, SameSlopesAsListImplementation) {
+  const size_t kWindowSizes[] = {2, 15, 20};
+  for (size_t window_size : kWindowSizes) {
+    TrendlineEstimator estimator(window_size, 0.9, 4.0);
+    ListTrendlineEstimator reference(window_size, 0.9, 4.0);
+    Random random(0x2b5a);
+    int64_t arrival_time_ms = random.Rand(1000000);
+    for (int i = 0; i < 10000; ++i) {
+      const double send_delta_ms = random.Rand(0, 40);
+      // Alternating periods of growing and shrinking queues.
+      const double queue_delta_ms = (i / 500) % 2 == 0 ? 1 : -1;
+      const double recv_delta_ms = std::max(
+          0.0, send_delta_ms + queue_delta_ms + random.Gaussian(0, 3));
+      arrival_time_ms += static_cast<int64_t>(recv_delta_ms);
+      estimator.Update(recv_delta_ms, send_delta_ms, arrival_time_ms);
+      reference.Update(recv_delta_ms, send_delta_ms, arrival_time_ms);
+      ASSERT_EQ(reference.trendline_slope(), estimator.trendline_slope())
+          << "Window size " << window_size << ", update " << i;
+    }
+  }
+}
+
 TEST(TrendlineEstimator, PerfectLineSlopeOneHalf) {
   TestEstimator(0.5, 0, 0.001);
 }
@@ -21,6 +21,7 @@
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/pacing/alr_detector.h"
 #include "webrtc/modules/pacing/bitrate_prober.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/bwe_trace.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/field_trial.h"
@@ -270,6 +271,7 @@ PacedSender::~PacedSender() {}
 void PacedSender::CreateProbeCluster(int bitrate_bps) {
   CriticalSectionScoped cs(critsect_.get());
   prober_->CreateProbeCluster(bitrate_bps);
+  BWE_TRACE(kProbeCluster, clock_->TimeInMilliseconds(), 0, bitrate_bps, 0);
 }
 
 void PacedSender::Pause() {
@@ -402,6 +404,9 @@ void PacedSender::Process() {
           static_cast<int>(queue_size_bytes * 8 / avg_time_left_ms);
       if (min_bitrate_needed_kbps > target_bitrate_kbps)
         target_bitrate_kbps = min_bitrate_needed_kbps;
+      BWE_TRACE(kPacerQueue, now_us / 1000,
+                static_cast<int32_t>(packets_->SizeInPackets()),
+                queue_size_bytes, packets_->AverageQueueTimeMs());
     }
 
     media_budget_->set_target_rate_kbps(target_bitrate_kbps);
@@ -18,6 +18,7 @@
 
 #include "webrtc/modules/remote_bitrate_estimator/overuse_detector.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/bwe_defines.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/bwe_trace.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 
@@ -238,6 +239,10 @@ uint32_t AimdRateControl::ChangeBitrate(uint32_t current_bitrate_bps,
     current_bitrate_bps = std::max(current_bitrate_bps_, max_bitrate_bps);
     time_last_bitrate_change_ = now_ms;
   }
+  if (current_bitrate_bps != current_bitrate_bps_) {
+    BWE_TRACE(kRateControl, now_ms, rate_control_state_, current_bitrate_bps,
+              incoming_bitrate_bps);
+  }
   return current_bitrate_bps;
 }
 
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/include/bwe_trace.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/criticalsection.h"
+
+namespace webrtc {
+namespace bwe_trace {
+namespace {
+
+static_assert(sizeof(BweTraceRecord) == 32, "Trace records must stay small");
+static_assert((kBweTraceRingSize & (kBweTraceRingSize - 1)) == 0,
+              "The ring size must be a power of 2");
+
+const char kMagic[8] = {'B', 'W', 'E', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t kVersion = 1;
+// Rings are never freed, so that the records of threads which have ended can
+// still be dumped. On POSIX the ring of an ended thread is reused by the next
+// new thread; threads beyond this many at a time are not traced.
+const int kMaxRings = 64;
+// |position| counts the records written modulo this, a multiple of the ring
+// size which doesn't overflow.
+const int kPositionWrap = 1 << 30;
+const int kRingMask = static_cast<int>(kBweTraceRingSize) - 1;
+
+// Written by its thread only. The slot at |position| is written before
+// |position| is advanced, so a reader which loads |position| can copy the
+// slots before it, and detect the ones overwritten meanwhile by loading
+// |position| again.
+struct ThreadRing {
+  BweTraceRecord records[kBweTraceRingSize];
+  volatile int position;
+  volatile int full;
+  volatile int in_use;
+};
+
+// POD, to be usable from threads started before or after static
+// initialization.
+rtc::GlobalLockPod g_lock;
+volatile int g_key_created = 0;
+#if defined(WEBRTC_WIN)
+DWORD g_key;
+#else
+pthread_key_t g_key;
+#endif
+ThreadRing* volatile g_rings[kMaxRings];
+volatile int g_num_rings = 0;
+// Set for the threads which found no free ring.
+ThreadRing g_no_ring;
+
+#if !defined(WEBRTC_WIN)
+void ReleaseRing(void* ring) {
+  if (ring != &g_no_ring)
+    rtc::AtomicOps::ReleaseStore(&static_cast<ThreadRing*>(ring)->in_use, 0);
+}
+#endif
+
+void* GetThreadLocal() {
+#if defined(WEBRTC_WIN)
+  return TlsGetValue(g_key);
+#else
+  return pthread_getspecific(g_key);
+#endif
+}
+
+void SetThreadLocal(void* value) {
+#if defined(WEBRTC_WIN)
+  TlsSetValue(g_key, value);
+#else
+  pthread_setspecific(g_key, value);
+#endif
+}
+
+ThreadRing* AcquireRing() {
+  rtc::GlobalLockScope lock(&g_lock);
+  if (!g_key_created) {
+#if defined(WEBRTC_WIN)
+    g_key = TlsAlloc();
+#else
+    pthread_key_create(&g_key, &ReleaseRing);
+#endif
+    rtc::AtomicOps::ReleaseStore(&g_key_created, 1);
+  }
+  ThreadRing* ring = static_cast<ThreadRing*>(GetThreadLocal());
+  if (ring)
+    return ring;
+  for (int i = 0; i < g_num_rings && !ring; ++i) {
+    if (!g_rings[i]->in_use)
+      ring = g_rings[i];
+  }
+  if (!ring && g_num_rings < kMaxRings) {
+    ring = new ThreadRing();
+    g_rings[g_num_rings] = ring;
+    rtc::AtomicOps::ReleaseStore(&g_num_rings, g_num_rings + 1);
+  }
+  if (!ring) {
+    ring = &g_no_ring;
+  } else {
+    ring->in_use = 1;
+  }
+  SetThreadLocal(ring);
+  return ring;
+}
+
+ThreadRing* GetRing() {
+  ThreadRing* ring = nullptr;
+  if (rtc::AtomicOps::AcquireLoad(&g_key_created))
+    ring = static_cast<ThreadRing*>(GetThreadLocal());
+  return ring ? ring : AcquireRing();
+}
+
+void CollectRing(ThreadRing* ring, std::vector<BweTraceRecord>* records) {
+  const int end = rtc::AtomicOps::AcquireLoad(&ring->position);
+  const bool full = rtc::AtomicOps::AcquireLoad(&ring->full) != 0;
+  const int count = full ? static_cast<int>(kBweTraceRingSize) : end;
+  // The records from |begin| to the end of the array, then from the start.
+  const int begin = (end - count) & kRingMask;
+  const int first_part = std::min(count, kRingMask + 1 - begin);
+  const size_t first = records->size();
+  records->resize(first + count);
+  memcpy(&(*records)[first], &ring->records[begin],
+         first_part * sizeof(BweTraceRecord));
+  memcpy(&(*records)[first + first_part], &ring->records[0],
+         (count - first_part) * sizeof(BweTraceRecord));
+
+  // Drop what the thread has overwritten while copying, and the slot it may
+  // be writing now.
+  const int new_end = rtc::AtomicOps::AcquireLoad(&ring->position);
+  const int written = (new_end - end) & (kPositionWrap - 1);
+  const int overwritten = std::min(
+      count, std::max(0, written + 1 + count -
+                             static_cast<int>(kBweTraceRingSize)));
+  records->erase(records->begin() + first,
+                 records->begin() + first + overwritten);
+}
+
+bool CompareTime(const BweTraceRecord& a, const BweTraceRecord& b) {
+  return a.time_ms < b.time_ms;
+}
+
+}  // namespace
+
+void Add(BweTraceRecord::Type type,
+         int64_t time_ms,
+         int32_t state,
+         double value0,
+         double value1) {
+  ThreadRing* ring = GetRing();
+  if (ring == &g_no_ring)
+    return;
+  const int position = ring->position;
+  BweTraceRecord& record = ring->records[position & kRingMask];
+  record.time_ms = time_ms;
+  record.type = type;
+  record.state = state;
+  record.values[0] = value0;
+  record.values[1] = value1;
+  const int next = (position + 1) & (kPositionWrap - 1);
+  if (next == static_cast<int>(kBweTraceRingSize))
+    rtc::AtomicOps::ReleaseStore(&ring->full, 1);
+  rtc::AtomicOps::ReleaseStore(&ring->position, next);
+}
+
+std::vector<BweTraceRecord> Collect() {
+  std::vector<BweTraceRecord> records;
+  const int num_rings = rtc::AtomicOps::AcquireLoad(&g_num_rings);
+  for (int i = 0; i < num_rings; ++i)
+    CollectRing(g_rings[i], &records);
+  std::stable_sort(records.begin(), records.end(), &CompareTime);
+  return records;
+}
+
+bool Dump(FILE* file) {
+  const std::vector<BweTraceRecord> records = Collect();
+  const uint32_t record_size = sizeof(BweTraceRecord);
+  return fwrite(kMagic, sizeof(kMagic), 1, file) == 1 &&
+         fwrite(&kVersion, sizeof(kVersion), 1, file) == 1 &&
+         fwrite(&record_size, sizeof(record_size), 1, file) == 1 &&
+         fwrite(records.data(), sizeof(BweTraceRecord), records.size(),
+                file) == records.size();
+}
+
+bool Read(FILE* file, std::vector<BweTraceRecord>* records) {
+  char magic[sizeof(kMagic)];
+  uint32_t version;
+  uint32_t record_size;
+  if (fread(magic, sizeof(magic), 1, file) != 1 ||
+      memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      fread(&version, sizeof(version), 1, file) != 1 || version != kVersion ||
+      fread(&record_size, sizeof(record_size), 1, file) != 1 ||
+      record_size != sizeof(BweTraceRecord)) {
+    return false;
+  }
+  records->clear();
+  BweTraceRecord record;
+  while (fread(&record, sizeof(record), 1, file) == 1)
+    records->push_back(record);
+  return feof(file) != 0;
+}
+
+}  // namespace bwe_trace
+}  // namespace webrtc
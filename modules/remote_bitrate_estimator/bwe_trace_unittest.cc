@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/bwe_trace.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+// The rings are shared by all tests in the binary, and other modules may
+// trace to them, so each test picks out its records by |state|.
+const int32_t kMultiThreadState = 0x7e571;
+const int32_t kWrapAroundState = 0x7e572;
+const int32_t kDumpState = 0x7e573;
+const int kNumThreads = 4;
+
+std::vector<BweTraceRecord> CollectWithState(int32_t state) {
+  std::vector<BweTraceRecord> records;
+  for (const BweTraceRecord& record : bwe_trace::Collect()) {
+    if (record.state == state)
+      records.push_back(record);
+  }
+  return records;
+}
+
+struct WriterArgs {
+  int thread_index;
+  int num_records;
+};
+
+bool WriteRecords(void* obj) {
+  const WriterArgs* args = static_cast<const WriterArgs*>(obj);
+  for (int i = 0; i < args->num_records; ++i) {
+    bwe_trace::Add(BweTraceRecord::kRateControl,
+                   i * kNumThreads + args->thread_index, kMultiThreadState,
+                   args->thread_index, i);
+  }
+  return false;
+}
+
+// Writes a counter until told to stop, in bursts a reader can keep up with.
+struct CounterArgs {
+  volatile int stop;
+  volatile int num_written;
+};
+
+bool WriteCounter(void* obj) {
+  CounterArgs* args = static_cast<CounterArgs*>(obj);
+  for (int i = 0; !rtc::AtomicOps::AcquireLoad(&args->stop); ++i) {
+    bwe_trace::Add(BweTraceRecord::kPacerQueue, i, kWrapAroundState, i, 0);
+    rtc::AtomicOps::ReleaseStore(&args->num_written, i + 1);
+    if (i % 50 == 0)
+      SleepMs(1);
+  }
+  return false;
+}
+}  // namespace
+
+TEST(BweTraceTest, CollectsAllThreadsInTimeOrder) {
+  const int kNumRecords = 1000;
+  std::vector<WriterArgs> args(kNumThreads);
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    args[i] = {i, kNumRecords};
+    threads.emplace_back(
+        new rtc::PlatformThread(&WriteRecords, &args[i], "BweTraceWriter"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+
+  std::vector<BweTraceRecord> records = CollectWithState(kMultiThreadState);
+  ASSERT_EQ(static_cast<size_t>(kNumThreads * kNumRecords), records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(static_cast<int64_t>(i), records[i].time_ms);
+    EXPECT_EQ(BweTraceRecord::kRateControl, records[i].type);
+    EXPECT_EQ(static_cast<double>(i % kNumThreads), records[i].values[0]);
+    EXPECT_EQ(static_cast<double>(i / kNumThreads), records[i].values[1]);
+  }
+}
+
+TEST(BweTraceTest, KeepsLatestRecordsWhileWriting) {
+  CounterArgs args = {0, 0};
+  rtc::PlatformThread thread(&WriteCounter, &args, "BweTraceCounter");
+  thread.Start();
+  while (rtc::AtomicOps::AcquireLoad(&args.num_written) <
+         static_cast<int>(2 * kBweTraceRingSize)) {
+    SleepMs(1);
+  }
+  // Collect while the ring is being overwritten; every record returned must
+  // be one which was completely written, and they must be consecutive.
+  for (int i = 0; i < 20; ++i) {
+    std::vector<BweTraceRecord> records = CollectWithState(kWrapAroundState);
+    ASSERT_FALSE(records.empty());
+    EXPECT_LE(records.size(), kBweTraceRingSize);
+    for (size_t j = 0; j < records.size(); ++j) {
+      EXPECT_EQ(static_cast<double>(records[j].time_ms),
+                records[j].values[0]);
+      if (j > 0) {
+        EXPECT_EQ(records[j - 1].time_ms + 1, records[j].time_ms);
+      }
+    }
+  }
+  rtc::AtomicOps::ReleaseStore(&args.stop, 1);
+  thread.Stop();
+
+  // The oldest slot of a full ring is always assumed to be overwritten.
+  std::vector<BweTraceRecord> records = CollectWithState(kWrapAroundState);
+  ASSERT_EQ(kBweTraceRingSize - 1, records.size());
+  EXPECT_EQ(rtc::AtomicOps::AcquireLoad(&args.num_written) - 1,
+            records.back().time_ms);
+}
+
+TEST(BweTraceTest, ReadsDump) {
+  bwe_trace::Add(BweTraceRecord::kProbeCluster, 17, kDumpState, 900000, 0);
+  bwe_trace::Add(BweTraceRecord::kProbeResult, 42, kDumpState, 850000, -1);
+
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file != nullptr);
+  ASSERT_TRUE(bwe_trace::Dump(file));
+  rewind(file);
+  std::vector<BweTraceRecord> records;
+  ASSERT_TRUE(bwe_trace::Read(file, &records));
+  fclose(file);
+
+  std::vector<BweTraceRecord> dumped;
+  for (const BweTraceRecord& record : records) {
+    if (record.state == kDumpState)
+      dumped.push_back(record);
+  }
+  ASSERT_EQ(2u, dumped.size());
+  EXPECT_EQ(17, dumped[0].time_ms);
+  EXPECT_EQ(BweTraceRecord::kProbeCluster, dumped[0].type);
+  EXPECT_EQ(900000, dumped[0].values[0]);
+  EXPECT_EQ(42, dumped[1].time_ms);
+  EXPECT_EQ(BweTraceRecord::kProbeResult, dumped[1].type);
+  EXPECT_EQ(-1, dumped[1].values[1]);
+}
+
+TEST(BweTraceTest, RejectsOtherFiles) {
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file != nullptr);
+  fputs("RTCEVENTLOG", file);
+  rewind(file);
+  std::vector<BweTraceRecord> records;
+  EXPECT_FALSE(bwe_trace::Read(file, &records));
+  fclose(file);
+}
+
+}  // namespace webrtc
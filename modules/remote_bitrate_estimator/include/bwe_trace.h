@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_BWE_TRACE_H_
+#define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_BWE_TRACE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <vector>
+
+// The BWE trace records the decisions of the congestion controller, the
+// bandwidth estimators and the pacer as fixed size binary records in memory,
+// to be dumped when a bandwidth drop needs to be explained. Each thread writes
+// to a ring of its own without locking, so tracing is cheap enough to leave
+// on; only the last kBweTraceRingSize - 1 records of each thread are kept.
+//
+// The trace points compile to nothing unless the build sets
+// rtc_enable_bwe_trace=true. The functions below are always available, so
+// that a dump can be requested regardless.
+#ifndef BWE_TRACE_COMPILE_TIME_ENABLE
+#define BWE_TRACE_COMPILE_TIME_ENABLE 0
+#endif  // BWE_TRACE_COMPILE_TIME_ENABLE
+
+namespace webrtc {
+
+struct BweTraceRecord {
+  // What |state| and |values| are for each type of record.
+  enum Type : uint32_t {
+    // The detector of DelayBasedBwe changed its hypothesis. |state| is the
+    // BandwidthUsage, |values| the delay trend or offset and the threshold.
+    kDelayBasedDetection = 1,
+    // DelayBasedBwe updated its estimate. |state| is 1 if it was set by a
+    // probe, |values| the target bitrate and the acked bitrate, or -1 if
+    // unknown, in bps.
+    kDelayBasedEstimate = 2,
+    // A probe cluster was measured. |state| is the cluster id, |values[0]|
+    // the measured bitrate in bps.
+    kProbeResult = 3,
+    // AimdRateControl changed the bitrate. |state| is the RateControlState,
+    // |values| the new bitrate and the incoming bitrate in bps.
+    kRateControl = 4,
+    // The pacer was asked to probe. |values[0]| is the bitrate in bps.
+    kProbeCluster = 5,
+    // The pacer sent from a non-empty queue. |state| is the number of queued
+    // packets, |values| the queued bytes and their average queue time in ms.
+    kPacerQueue = 6,
+  };
+
+  int64_t time_ms;
+  uint32_t type;
+  int32_t state;
+  double values[2];
+};
+
+const size_t kBweTraceRingSize = 4096;
+
+namespace bwe_trace {
+
+// Adds a record to the ring of the calling thread. Use BWE_TRACE() instead,
+// to compile it out of builds without the trace.
+void Add(BweTraceRecord::Type type,
+         int64_t time_ms,
+         int32_t state,
+         double value0,
+         double value1);
+
+// Returns the records of all threads which are not being overwritten, in
+// time order. Can be called from any thread.
+std::vector<BweTraceRecord> Collect();
+
+// Writes the records returned by Collect() to |file|, in a format read by
+// Read() and the bwe_trace_visualizer tool.
+bool Dump(FILE* file);
+
+// Reads the records written by Dump(), on a machine of the same endianness.
+bool Read(FILE* file, std::vector<BweTraceRecord>* records);
+
+}  // namespace bwe_trace
+}  // namespace webrtc
+
+#if BWE_TRACE_COMPILE_TIME_ENABLE
+#define BWE_TRACE(type, time_ms, state, value0, value1)                   \
+  webrtc::bwe_trace::Add(webrtc::BweTraceRecord::type, time_ms, state, \
+                         value0, value1)
+#else
+#define BWE_TRACE(type, time_ms, state, value0, value1)
+#endif  // BWE_TRACE_COMPILE_TIME_ENABLE
+
+#endif  // WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_BWE_TRACE_H_
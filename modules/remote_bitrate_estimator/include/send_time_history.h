@@ -11,15 +11,14 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 
-#include <map>
-
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/remote_bitrate_estimator/packet_ring.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 
 namespace webrtc {
 class Clock;
-struct PacketInfo;
 
 class SendTimeHistory {
  public:
@@ -46,7 +45,10 @@ class SendTimeHistory {
   Clock* const clock_;
   const int64_t packet_age_limit_ms_;
   SequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketInfo> history_;
+  // Packets more than half the sequence number space older than the newest
+  // one can't be unwrapped correctly anyway, so that is all that is kept, even
+  // if the packets are younger than |packet_age_limit_ms_|.
+  PacketRing<PacketInfo> history_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(SendTimeHistory);
 };
@@ -41,6 +41,9 @@ class OveruseDetector {
   // Returns the current detector state.
   BandwidthUsage State() const;
 
+  // Returns the threshold the modified offset is compared to.
+  double threshold() const { return threshold_; }
+
  private:
   void UpdateThreshold(double modified_offset, int64_t now_ms);
   void InitializeExperiment();
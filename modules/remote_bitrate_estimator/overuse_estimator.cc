@@ -23,7 +23,6 @@
 
 namespace webrtc {
 
-enum { kMinFramePeriodHistoryLength = 60 };
 enum { kDeltaCounterMax = 1000 };
 
 OveruseEstimator::OveruseEstimator(const OverUseDetectorOptions& options)
@@ -36,15 +35,15 @@ OveruseEstimator::OveruseEstimator(const OverUseDetectorOptions& options)
       process_noise_(),
       avg_noise_(options_.initial_avg_noise),
       var_noise_(options_.initial_var_noise),
-      ts_delta_hist_() {
+      ts_delta_hist_(),
+      ts_delta_hist_size_(0),
+      ts_delta_hist_next_(0) {
   memcpy(E_, options_.initial_e, sizeof(E_));
   memcpy(process_noise_, options_.initial_process_noise,
          sizeof(process_noise_));
 }
 
-OveruseEstimator::~OveruseEstimator() {
-  ts_delta_hist_.clear();
-}
+OveruseEstimator::~OveruseEstimator() {}
 
 void OveruseEstimator::Update(int64_t t_delta,
                               double ts_delta,
@@ -125,15 +124,15 @@ void OveruseEstimator::Update(int64_t t_delta,
 }
 
 double OveruseEstimator::UpdateMinFramePeriod(double ts_delta) {
+  // Replaces the oldest delta once the history is full.
+  ts_delta_hist_[ts_delta_hist_next_] = ts_delta;
+  ts_delta_hist_next_ =
+      (ts_delta_hist_next_ + 1) % kMinFramePeriodHistoryLength;
+  if (ts_delta_hist_size_ < kMinFramePeriodHistoryLength)
+    ++ts_delta_hist_size_;
   double min_frame_period = ts_delta;
-  if (ts_delta_hist_.size() >= kMinFramePeriodHistoryLength) {
-    ts_delta_hist_.pop_front();
-  }
-  std::list<double>::iterator it = ts_delta_hist_.begin();
-  for (; it != ts_delta_hist_.end(); it++) {
-    min_frame_period = std::min(*it, min_frame_period);
-  }
-  ts_delta_hist_.push_back(ts_delta);
+  for (size_t i = 0; i < ts_delta_hist_size_; ++i)
+    min_frame_period = std::min(ts_delta_hist_[i], min_frame_period);
   return min_frame_period;
 }
 
@@ -10,7 +10,7 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_OVERUSE_ESTIMATOR_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_OVERUSE_ESTIMATOR_H_
 
-#include <list>
+#include <stddef.h>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/common_types.h"
@@ -50,6 +50,8 @@ class OveruseEstimator {
   }
 
  private:
+  static const size_t kMinFramePeriodHistoryLength = 60;
+
   double UpdateMinFramePeriod(double ts_delta);
   void UpdateNoiseEstimate(double residual, double ts_delta, bool stable_state);
 
@@ -64,7 +66,11 @@ class OveruseEstimator {
   double process_noise_[2];
   double avg_noise_;
   double var_noise_;
-  std::list<double> ts_delta_hist_;
+  // The last |kMinFramePeriodHistoryLength| timestamp deltas, in a circular
+  // buffer where |ts_delta_hist_next_| is the next to be replaced.
+  double ts_delta_hist_[kMinFramePeriodHistoryLength];
+  size_t ts_delta_hist_size_;
+  size_t ts_delta_hist_next_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(OveruseEstimator);
 };
@@ -0,0 +1,245 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_PACKET_RING_H_
+#define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_PACKET_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/optional.h"
+
+namespace webrtc {
+
+// Per packet state keyed by unwrapped transport sequence numbers, as a
+// replacement for std::map<int64_t, T>. Packets are stored in a circular
+// array indexed by their sequence number, so lookup is constant time and
+// iteration is in sequence number order. Moving to the next packet, as in
+// lower_bound(), iterator increments, and erasing the oldest or newest packet,
+// checks one slot per missing sequence number in between. That is constant
+// time when packets are mostly received, and bounded by the span otherwise.
+// Insertion is constant time, apart from growing the array and evicting.
+//
+// The array grows in powers of two until it spans |max_size| sequence
+// numbers. After that, inserting a sequence number newer than the span allows
+// evicts the oldest packets, and inserting one older than it does nothing.
+// Iterators are invalidated by any insertion or erasure.
+template <typename T>
+class PacketRing {
+ private:
+  template <typename Ring, typename Element>
+  class Iterator : public std::iterator<std::forward_iterator_tag, Element> {
+   public:
+    Iterator() : ring_(nullptr), seq_(0) {}
+    Iterator(Ring* ring, int64_t seq) : ring_(ring), seq_(seq) {}
+    // Allows conversion from iterator to const_iterator.
+    template <typename OtherRing, typename OtherElement>
+    Iterator(const Iterator<OtherRing, OtherElement>& other)
+        : ring_(other.ring_), seq_(other.seq_) {}
+
+    Element& operator*() const { return *ring_->SlotAt(seq_); }
+    Element* operator->() const { return &*ring_->SlotAt(seq_); }
+
+    Iterator& operator++() {
+      seq_ = ring_->NextSeq(seq_ + 1);
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return ring_ == other.ring_ && seq_ == other.seq_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class PacketRing;
+    template <typename, typename>
+    friend class Iterator;
+
+    Ring* ring_;
+    int64_t seq_;
+  };
+
+ public:
+  typedef std::pair<int64_t, T> value_type;
+  typedef Iterator<PacketRing, value_type> iterator;
+  typedef Iterator<const PacketRing, const value_type> const_iterator;
+
+  // |max_size| must be a power of two.
+  explicit PacketRing(size_t max_size)
+      : max_size_(max_size),
+        slots_(std::min(max_size, kInitialSize)),
+        first_seq_(0),
+        end_seq_(0),
+        size_(0) {
+    RTC_DCHECK_GT(max_size, 0);
+    RTC_DCHECK_EQ(0, max_size & (max_size - 1));
+  }
+
+  iterator begin() { return iterator(this, first_seq_); }
+  iterator end() { return iterator(this, end_seq_); }
+  const_iterator begin() const { return const_iterator(this, first_seq_); }
+  const_iterator end() const { return const_iterator(this, end_seq_); }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  void clear() {
+    for (int64_t seq = first_seq_; seq < end_seq_; ++seq)
+      SlotAt(seq).reset();
+    first_seq_ = end_seq_ = 0;
+    size_ = 0;
+  }
+
+  iterator find(int64_t seq) { return iterator(this, Find(seq)); }
+  const_iterator find(int64_t seq) const {
+    return const_iterator(this, Find(seq));
+  }
+
+  // Returns the first packet with a sequence number not older than |seq|.
+  iterator lower_bound(int64_t seq) {
+    return iterator(this, NextSeq(std::max(seq, first_seq_)));
+  }
+  const_iterator lower_bound(int64_t seq) const {
+    return const_iterator(this, NextSeq(std::max(seq, first_seq_)));
+  }
+
+  // Inserts |element| unless a packet with the same sequence number already
+  // exists, or the sequence number is too old to fit. Returns the position of
+  // the packet with that sequence number, or end(), and whether |element| was
+  // inserted.
+  std::pair<iterator, bool> insert(const value_type& element) {
+    const int64_t seq = element.first;
+    if (empty()) {
+      first_seq_ = seq;
+      end_seq_ = seq;
+    } else if (seq >= end_seq_) {
+      if (!Reserve(seq + 1 - first_seq_)) {
+        // Evict the oldest packets, at least up to where the new span starts.
+        const int64_t new_first_seq =
+            seq + 1 - static_cast<int64_t>(slots_.size());
+        while (size_ > 0 && first_seq_ < new_first_seq)
+          erase(begin());
+        if (empty())
+          end_seq_ = first_seq_ = seq;
+      }
+    } else if (seq < first_seq_) {
+      if (!Reserve(end_seq_ - seq))
+        return std::make_pair(end(), false);
+    } else if (SlotAt(seq)) {
+      return std::make_pair(iterator(this, seq), false);
+    }
+
+    SlotAt(seq).emplace(element);
+    ++size_;
+    first_seq_ = std::min(first_seq_, seq);
+    end_seq_ = std::max(end_seq_, seq + 1);
+    return std::make_pair(iterator(this, seq), true);
+  }
+
+  // Returns the position of the packet following the erased one.
+  iterator erase(const_iterator position) {
+    RTC_DCHECK(position.ring_ == this);
+    const int64_t seq = position.seq_;
+    RTC_DCHECK(SlotAt(seq));
+    SlotAt(seq).reset();
+    if (--size_ == 0) {
+      first_seq_ = end_seq_;
+      return end();
+    }
+    // Keep the span tight around the stored packets, so that expiring the
+    // oldest packets one at a time stays cheap.
+    if (seq == first_seq_)
+      first_seq_ = NextSeq(seq + 1);
+    if (seq == end_seq_ - 1) {
+      while (!SlotAt(end_seq_ - 1))
+        --end_seq_;
+    }
+    return iterator(this, NextSeq(seq + 1));
+  }
+
+  size_t erase(int64_t seq) {
+    if (Find(seq) == end_seq_)
+      return 0;
+    erase(const_iterator(this, seq));
+    return 1;
+  }
+
+ private:
+  typedef rtc::Optional<value_type> Slot;
+
+  static constexpr size_t kInitialSize = 64;
+
+  Slot& SlotAt(int64_t seq) {
+    return slots_[static_cast<uint64_t>(seq) & (slots_.size() - 1)];
+  }
+  const Slot& SlotAt(int64_t seq) const {
+    return slots_[static_cast<uint64_t>(seq) & (slots_.size() - 1)];
+  }
+
+  int64_t Find(int64_t seq) const {
+    if (seq < first_seq_ || seq >= end_seq_ || !SlotAt(seq))
+      return end_seq_;
+    return seq;
+  }
+
+  // Returns the first stored sequence number from |seq|, which must not be
+  // older than the oldest packet, or |end_seq_|.
+  int64_t NextSeq(int64_t seq) const {
+    while (seq < end_seq_ && !SlotAt(seq))
+      ++seq;
+    return std::min(seq, end_seq_);
+  }
+
+  // Grows the array, up to |max_size_|, to span |span| sequence numbers.
+  // Returns false if it can't.
+  bool Reserve(int64_t span) {
+    if (span <= static_cast<int64_t>(slots_.size()))
+      return true;
+    size_t new_size = slots_.size();
+    while (new_size < max_size_ && static_cast<int64_t>(new_size) < span)
+      new_size *= 2;
+    if (new_size != slots_.size()) {
+      std::vector<Slot> slots(new_size);
+      for (int64_t seq = first_seq_; seq < end_seq_; ++seq) {
+        Slot& slot = SlotAt(seq);
+        if (slot)
+          slots[static_cast<uint64_t>(seq) & (new_size - 1)] = std::move(slot);
+      }
+      slots_.swap(slots);
+    }
+    return span <= static_cast<int64_t>(slots_.size());
+  }
+
+  const size_t max_size_;
+  std::vector<Slot> slots_;
+  // The stored packets have sequence numbers in [first_seq_, end_seq_), with
+  // packets at both ends unless empty.
+  int64_t first_seq_;
+  int64_t end_seq_;
+  size_t size_;
+};
+
+template <typename T>
+constexpr size_t PacketRing<T>::kInitialSize;
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_PACKET_RING_H_
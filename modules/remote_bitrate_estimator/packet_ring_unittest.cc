@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+#include <utility>
+
+#include "webrtc/base/random.h"
+#include "webrtc/modules/remote_bitrate_estimator/packet_ring.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+
+TEST(PacketRingTest, IteratesInSequenceNumberOrder) {
+  PacketRing<int> ring(1024);
+  EXPECT_TRUE(ring.insert(std::make_pair(100, 0)).second);
+  EXPECT_TRUE(ring.insert(std::make_pair(103, 3)).second);
+  EXPECT_TRUE(ring.insert(std::make_pair(98, -2)).second);
+  EXPECT_TRUE(ring.insert(std::make_pair(101, 1)).second);
+  EXPECT_FALSE(ring.insert(std::make_pair(101, 10)).second);
+  EXPECT_EQ(1, ring.find(101)->second);
+
+  std::map<int64_t, int> expected = {{98, -2}, {100, 0}, {101, 1}, {103, 3}};
+  EXPECT_EQ(expected, (std::map<int64_t, int>(ring.begin(), ring.end())));
+  EXPECT_EQ(100, ring.lower_bound(99)->first);
+  EXPECT_EQ(98, ring.lower_bound(0)->first);
+  EXPECT_TRUE(ring.lower_bound(104) == ring.end());
+  EXPECT_TRUE(ring.find(99) == ring.end());
+}
+
+TEST(PacketRingTest, GrowsUpToMaxSize) {
+  PacketRing<int> ring(512);
+  for (int i = 0; i < 512; ++i)
+    EXPECT_TRUE(ring.insert(std::make_pair(1000 + i, i)).second);
+  EXPECT_EQ(512u, ring.size());
+  for (int i = 0; i < 512; ++i)
+    EXPECT_EQ(i, ring.find(1000 + i)->second);
+}
+
+TEST(PacketRingTest, EvictsOldestWhenFull) {
+  PacketRing<int> ring(64);
+  ring.insert(std::make_pair(10, 0));
+  ring.insert(std::make_pair(12, 2));
+  ring.insert(std::make_pair(40, 30));
+  // Spanning [12, 75] evicts 10 only.
+  EXPECT_TRUE(ring.insert(std::make_pair(75, 65)).second);
+  EXPECT_EQ(3u, ring.size());
+  EXPECT_EQ(12, ring.begin()->first);
+  // Too old to fit along with 75.
+  EXPECT_FALSE(ring.insert(std::make_pair(11, 1)).second);
+  EXPECT_TRUE(ring.find(11) == ring.end());
+
+  // Far newer than everything stored.
+  EXPECT_TRUE(ring.insert(std::make_pair(1000, 990)).second);
+  EXPECT_EQ(1u, ring.size());
+  EXPECT_EQ(1000, ring.begin()->first);
+}
+
+TEST(PacketRingTest, MatchesStdMap) {
+  constexpr size_t kMaxSize = 256;
+  Random random(0x9a1e);
+  PacketRing<int> ring(kMaxSize);
+  std::map<int64_t, int> map;
+
+  int64_t newest = 1 << 20;
+  for (int i = 0; i < 50000; ++i) {
+    // Mostly increasing sequence numbers with some loss and reordering, with
+    // the oldest ones expired well within the capacity.
+    newest += random.Rand(0, 2);
+    int64_t seq = newest - random.Rand(0, 10);
+    switch (random.Rand(0, 3)) {
+      case 0:
+      case 1:
+        EXPECT_EQ(map.insert(std::make_pair(seq, i)).second,
+                  ring.insert(std::make_pair(seq, i)).second);
+        break;
+      case 2:
+        EXPECT_EQ(map.erase(seq), ring.erase(seq));
+        break;
+      case 3: {
+        while (!map.empty() && map.begin()->first < newest - 100) {
+          ASSERT_EQ(map.begin()->first, ring.begin()->first);
+          map.erase(map.begin());
+          ring.erase(ring.begin());
+        }
+        auto map_it = map.lower_bound(seq);
+        auto ring_it = ring.lower_bound(seq);
+        ASSERT_EQ(map_it == map.end(), ring_it == ring.end());
+        if (map_it != map.end()) {
+          EXPECT_EQ(map_it->first, ring_it->first);
+        }
+        break;
+      }
+    }
+    ASSERT_EQ(map.size(), ring.size());
+  }
+  EXPECT_EQ(map, (std::map<int64_t, int>(ring.begin(), ring.end())));
+
+  ring.clear();
+  EXPECT_TRUE(ring.empty());
+  EXPECT_TRUE(ring.begin() == ring.end());
+}
+
+}  // namespace webrtc
@@ -12,6 +12,7 @@
 
 #include <limits>
 #include <algorithm>
+#include <utility>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
@@ -33,6 +34,11 @@ const int RemoteEstimatorProxy::kDefaultSendIntervalMs = 100;
 static constexpr int64_t kMaxTimeMs =
     std::numeric_limits<int64_t>::max() / 1000;
 
+// Sequence numbers more than half the sequence number space newer than the
+// feedback window are dropped, so this covers the window and the older
+// packets kept around for reordering.
+static constexpr size_t kMaxArrivalTimes = 1 << 15;
+
 RemoteEstimatorProxy::RemoteEstimatorProxy(Clock* clock,
                                            PacketRouter* packet_router)
     : clock_(clock),
@@ -41,6 +47,7 @@ RemoteEstimatorProxy::RemoteEstimatorProxy(Clock* clock,
       media_ssrc_(0),
       feedback_sequence_(0),
       window_start_seq_(-1),
+      packet_arrival_times_(kMaxArrivalTimes),
       send_interval_ms_(kDefaultSendIntervalMs) {}
 
 RemoteEstimatorProxy::~RemoteEstimatorProxy() {}
@@ -138,12 +145,11 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
   if (packet_arrival_times_.lower_bound(window_start_seq_) ==
       packet_arrival_times_.end()) {
     // Start new feedback packet, cull old packets.
-    for (auto it = packet_arrival_times_.begin();
-         it != packet_arrival_times_.end() && it->first < seq &&
-         arrival_time - it->second >= kBackWindowMs;) {
-      auto delete_it = it;
-      ++it;
-      packet_arrival_times_.erase(delete_it);
+    while (!packet_arrival_times_.empty() &&
+           packet_arrival_times_.begin()->first < seq &&
+           arrival_time - packet_arrival_times_.begin()->second >=
+               kBackWindowMs) {
+      packet_arrival_times_.erase(packet_arrival_times_.begin());
     }
   }
 
@@ -154,10 +160,7 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
   }
 
   // We are only interested in the first time a packet is received.
-  if (packet_arrival_times_.find(seq) != packet_arrival_times_.end())
-    return;
-
-  packet_arrival_times_[seq] = arrival_time;
+  packet_arrival_times_.insert(std::make_pair(seq, arrival_time));
 }
 
 bool RemoteEstimatorProxy::BuildFeedbackPacket(
@@ -11,12 +11,12 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
 #include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/remote_bitrate_estimator/packet_ring.h"
 
 namespace webrtc {
 
@@ -70,7 +70,7 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   SequenceNumberUnwrapper unwrapper_ GUARDED_BY(&lock_);
   int64_t window_start_seq_ GUARDED_BY(&lock_);
   // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
+  PacketRing<int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
   int64_t send_interval_ms_ GUARDED_BY(&lock_);
 };
 
@@ -11,13 +11,17 @@
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 
 #include "webrtc/base/checks.h"
-#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/system_wrappers/include/clock.h"
 
 namespace webrtc {
+namespace {
+constexpr size_t kMaxHistorySize = 1 << 15;
+}  // namespace
 
 SendTimeHistory::SendTimeHistory(Clock* clock, int64_t packet_age_limit_ms)
-    : clock_(clock), packet_age_limit_ms_(packet_age_limit_ms) {}
+    : clock_(clock),
+      packet_age_limit_ms_(packet_age_limit_ms),
+      history_(kMaxHistorySize) {}
 
 SendTimeHistory::~SendTimeHistory() {}
 
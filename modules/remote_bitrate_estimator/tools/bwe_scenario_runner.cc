@@ -0,0 +1,382 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Runs every combination of the given link models, estimators and flow counts
+// through the BWE simulation framework and writes one CSV line of metrics per
+// scenario. The simulations run on simulated time only, so they run as fast
+// as the CPU allows, and independent scenarios run in parallel on a pool of
+// worker threads.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/base/format_macros.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_framework.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/packet_receiver.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/packet_sender.h"
+#include "webrtc/test/parallel_runner.h"
+
+namespace flags {
+
+DEFINE_string(links,
+              "1000:50:5:0,2500:50:10:0,4000:100:15:1,2000:50:5:0:500@30",
+              "Comma-separated list of link models, each given as "
+              "capacity_kbps:one_way_delay_ms:max_jitter_ms:loss_percent, "
+              "optionally followed by :capacity_kbps@seconds to change the "
+              "capacity at that time.");
+DEFINE_string(estimators,
+              "REMB,GCC",
+              "Comma-separated list of estimators: REMB for the receive-side "
+              "RemoteBitrateEstimatorAbsSendTime, GCC for the send-side "
+              "DelayBasedBwe, and NADA.");
+DEFINE_string(flows,
+              "1,2,4",
+              "Comma-separated list of the number of media flows sharing "
+              "the link.");
+DEFINE_int32(duration_s, 60, "Simulated duration of each scenario.");
+
+}  // namespace flags
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+namespace {
+
+// The total target bitrate of the senders has converged once it has stayed
+// within this fraction of the capacity for |kConvergenceHoldMs|.
+const double kConvergenceTolerance = 0.2;
+const int64_t kConvergenceHoldMs = 1000;
+
+struct LinkModel {
+  std::string name;
+  uint32_t capacity_kbps = 0;
+  int64_t one_way_delay_ms = 0;
+  int64_t max_jitter_ms = 0;
+  float loss_percent = 0.0f;
+  // The capacity from |step_time_ms| on, if |step_time_ms| > 0.
+  uint32_t step_capacity_kbps = 0;
+  int64_t step_time_ms = 0;
+};
+
+struct Scenario {
+  LinkModel link;
+  BandwidthEstimatorType estimator;
+  size_t num_flows;
+};
+
+struct ScenarioResult {
+  double throughput_kbps = 0.0;
+  double utilization = 0.0;
+  int64_t delay_p50_ms = 0;
+  int64_t delay_p95_ms = 0;
+  int64_t delay_p99_ms = 0;
+  // From the start, or from the capacity change; -1 if it never converged.
+  int64_t convergence_ms = -1;
+  int64_t wall_time_ms = 0;
+};
+
+std::vector<std::string> SplitList(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty())
+      items.push_back(item);
+  }
+  return items;
+}
+
+bool ParseLinkModel(const std::string& spec, LinkModel* link) {
+  unsigned int capacity_kbps = 0;
+  int one_way_delay_ms = 0;
+  int max_jitter_ms = 0;
+  float loss_percent = 0.0f;
+  unsigned int step_capacity_kbps = 0;
+  int step_time_s = 0;
+  int num_fields = sscanf(spec.c_str(), "%u:%d:%d:%f:%u@%d", &capacity_kbps,
+                          &one_way_delay_ms, &max_jitter_ms, &loss_percent,
+                          &step_capacity_kbps, &step_time_s);
+  if (num_fields != 4 && num_fields != 6)
+    return false;
+  if (capacity_kbps == 0 || one_way_delay_ms < 0 || max_jitter_ms < 0 ||
+      loss_percent < 0.0f || loss_percent > 100.0f) {
+    return false;
+  }
+  if (num_fields == 6 && (step_capacity_kbps == 0 || step_time_s <= 0))
+    return false;
+  link->name = spec;
+  link->capacity_kbps = capacity_kbps;
+  link->one_way_delay_ms = one_way_delay_ms;
+  link->max_jitter_ms = max_jitter_ms;
+  link->loss_percent = loss_percent;
+  link->step_capacity_kbps = step_capacity_kbps;
+  link->step_time_ms = step_time_s * 1000;
+  return true;
+}
+
+bool ParseEstimator(const std::string& name, BandwidthEstimatorType* type) {
+  for (BandwidthEstimatorType candidate :
+       {kRembEstimator, kSendSideEstimator, kNadaEstimator}) {
+    if (name == bwe_names[candidate]) {
+      *type = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Records the end-to-end delay and the received bytes of the media packets
+// passing through it, in the place of the receivers.
+class MediaMetricsFilter : public PacketProcessor {
+ public:
+  MediaMetricsFilter(PacketProcessorListener* listener,
+                     const FlowIds& flow_ids)
+      : PacketProcessor(listener, flow_ids, kRegular) {}
+
+  void RunFor(int64_t time_ms, Packets* in_out) override {
+    for (const Packet* packet : *in_out) {
+      if (packet->GetPacketType() != Packet::kMedia)
+        continue;
+      delays_ms_.push_back(packet->send_time_ms() -
+                           packet->creation_time_ms());
+      received_bytes_ += packet->payload_size();
+    }
+  }
+
+  std::vector<int64_t>* delays_ms() { return &delays_ms_; }
+  size_t received_bytes() const { return received_bytes_; }
+
+ private:
+  std::vector<int64_t> delays_ms_;
+  size_t received_bytes_ = 0;
+};
+
+int64_t Percentile(std::vector<int64_t>* values, double fraction) {
+  if (values->empty())
+    return -1;
+  auto it = values->begin() + static_cast<size_t>(fraction *
+                                                  (values->size() - 1));
+  std::nth_element(values->begin(), it, values->end());
+  return *it;
+}
+
+// A simulation of one scenario, set up like BweTest::RunFairnessTest but
+// without depending on a running gtest.
+class ScenarioSimulation {
+ public:
+  explicit ScenarioSimulation(const Scenario& scenario)
+      : scenario_(scenario) {}
+
+  ScenarioResult Run(int64_t duration_ms) {
+    const LinkModel& link = scenario_.link;
+    FlowIds flow_ids;
+    for (size_t i = 0; i < scenario_.num_flows; ++i)
+      flow_ids.insert(static_cast<int>(i));
+
+    std::vector<std::unique_ptr<VideoSource>> sources;
+    std::vector<std::unique_ptr<PacketSender>> senders;
+    for (int flow_id : flow_ids) {
+      sources.emplace_back(new AdaptiveVideoSource(flow_id, 30, 300, 0, 0));
+      senders.emplace_back(new PacedVideoSender(&uplink_, sources.back().get(),
+                                                scenario_.estimator));
+    }
+    ChokeFilter choke(&uplink_, flow_ids);
+    choke.set_capacity_kbps(link.capacity_kbps);
+    choke.set_max_delay_ms(kMaxQueueingDelayMs);
+    DelayFilter delay_uplink(&uplink_, flow_ids);
+    delay_uplink.SetOneWayDelayMs(link.one_way_delay_ms);
+    JitterFilter jitter(&uplink_, flow_ids);
+    jitter.SetMaxJitter(link.max_jitter_ms);
+    LossFilter loss(&uplink_, flow_ids);
+    loss.SetLoss(link.loss_percent);
+    MediaMetricsFilter metrics(&uplink_, flow_ids);
+    std::vector<std::unique_ptr<PacketReceiver>> receivers;
+    for (int flow_id : flow_ids) {
+      receivers.emplace_back(new PacketReceiver(
+          &uplink_, flow_id, scenario_.estimator, false, false));
+    }
+    DelayFilter delay_downlink(&downlink_, flow_ids);
+    delay_downlink.SetOneWayDelayMs(link.one_way_delay_ms);
+
+    const int64_t interval_ms = senders[0]->GetFeedbackIntervalMs();
+    const bool has_step =
+        link.step_time_ms > 0 && link.step_time_ms < duration_ms;
+    int64_t capacity_change_ms = 0;
+    uint32_t capacity_kbps = link.capacity_kbps;
+    int64_t in_band_since_ms = -1;
+    int64_t converged_ms = -1;
+    for (int64_t now_ms = interval_ms; now_ms <= duration_ms;
+         now_ms += interval_ms) {
+      if (has_step && now_ms > link.step_time_ms &&
+          capacity_change_ms == 0) {
+        capacity_change_ms = link.step_time_ms;
+        capacity_kbps = link.step_capacity_kbps;
+        choke.set_capacity_kbps(capacity_kbps);
+        in_band_since_ms = -1;
+        converged_ms = -1;
+      }
+      uplink_.Run(interval_ms, now_ms, &packets_);
+      downlink_.Run(interval_ms, now_ms, &packets_);
+
+      uint32_t target_kbps = 0;
+      for (const auto& sender : senders)
+        target_kbps += sender->TargetBitrateKbps();
+      const double error =
+          std::abs(static_cast<double>(target_kbps) - capacity_kbps);
+      if (error > kConvergenceTolerance * capacity_kbps) {
+        in_band_since_ms = -1;
+      } else if (in_band_since_ms < 0) {
+        in_band_since_ms = now_ms;
+      }
+      if (converged_ms < 0 && in_band_since_ms >= 0 &&
+          now_ms - in_band_since_ms >= kConvergenceHoldMs) {
+        converged_ms = in_band_since_ms;
+      }
+    }
+
+    ScenarioResult result;
+    result.throughput_kbps = 8.0 * metrics.received_bytes() / duration_ms;
+    double mean_capacity_kbps = link.capacity_kbps;
+    if (has_step) {
+      mean_capacity_kbps =
+          (static_cast<double>(link.capacity_kbps) * link.step_time_ms +
+           static_cast<double>(link.step_capacity_kbps) *
+               (duration_ms - link.step_time_ms)) /
+          duration_ms;
+    }
+    result.utilization = result.throughput_kbps / mean_capacity_kbps;
+    result.delay_p50_ms = Percentile(metrics.delays_ms(), 0.5);
+    result.delay_p95_ms = Percentile(metrics.delays_ms(), 0.95);
+    result.delay_p99_ms = Percentile(metrics.delays_ms(), 0.99);
+    if (converged_ms >= 0)
+      result.convergence_ms = converged_ms - capacity_change_ms;
+
+    for (Packet* packet : packets_)
+      delete packet;
+    packets_.clear();
+    return result;
+  }
+
+ private:
+  const Scenario scenario_;
+  Link uplink_;
+  Link downlink_;
+  Packets packets_;
+};
+
+bool BuildScenarios(std::vector<Scenario>* scenarios) {
+  std::vector<LinkModel> links;
+  for (const std::string& spec : SplitList(flags::FLAGS_links)) {
+    LinkModel link;
+    if (!ParseLinkModel(spec, &link)) {
+      fprintf(stderr, "Invalid link model: %s\n", spec.c_str());
+      return false;
+    }
+    links.push_back(link);
+  }
+  std::vector<BandwidthEstimatorType> estimators;
+  for (const std::string& name : SplitList(flags::FLAGS_estimators)) {
+    BandwidthEstimatorType estimator;
+    if (!ParseEstimator(name, &estimator)) {
+      fprintf(stderr, "Unknown estimator: %s\n", name.c_str());
+      return false;
+    }
+    estimators.push_back(estimator);
+  }
+  std::vector<size_t> flow_counts;
+  for (const std::string& count : SplitList(flags::FLAGS_flows)) {
+    int num_flows = atoi(count.c_str());
+    if (num_flows <= 0) {
+      fprintf(stderr, "Invalid flow count: %s\n", count.c_str());
+      return false;
+    }
+    flow_counts.push_back(static_cast<size_t>(num_flows));
+  }
+
+  for (const LinkModel& link : links) {
+    for (BandwidthEstimatorType estimator : estimators) {
+      for (size_t num_flows : flow_counts)
+        scenarios->push_back({link, estimator, num_flows});
+    }
+  }
+  return !scenarios->empty();
+}
+
+}  // namespace
+
+int RunScenarios() {
+  std::vector<Scenario> scenarios;
+  if (!BuildScenarios(&scenarios))
+    return 1;
+  if (flags::FLAGS_duration_s <= 0) {
+    fprintf(stderr, "Invalid duration: %d\n", flags::FLAGS_duration_s);
+    return 1;
+  }
+  const int64_t duration_ms = flags::FLAGS_duration_s * 1000;
+  std::vector<ScenarioResult> results(scenarios.size());
+  // Each result is written by one thread only, and read after all threads are
+  // done.
+  test::ParallelRunner runner(
+      scenarios.size(), "BweScenario",
+      [&scenarios, &results, duration_ms](size_t i) {
+        const int64_t start_ms = rtc::TimeMillis();
+        ScenarioSimulation simulation(scenarios[i]);
+        results[i] = simulation.Run(duration_ms);
+        results[i].wall_time_ms = rtc::TimeMillis() - start_ms;
+      });
+  if (!runner.OpenOutput())
+    return 1;
+  runner.Run("scenarios");
+  FILE* output = runner.output();
+
+  fprintf(output,
+          "link,estimator,flows,throughput_kbps,utilization,delay_p50_ms,"
+          "delay_p95_ms,delay_p99_ms,convergence_ms,wall_time_ms\n");
+  for (size_t i = 0; i < scenarios.size(); ++i) {
+    const Scenario& scenario = scenarios[i];
+    const ScenarioResult& result = results[i];
+    fprintf(output, "%s,%s,%" PRIuS ",%.1f,%.3f,%lld,%lld,%lld,%lld,%lld\n",
+            scenario.link.name.c_str(), bwe_names[scenario.estimator].c_str(),
+            scenario.num_flows, result.throughput_kbps, result.utilization,
+            static_cast<long long>(result.delay_p50_ms),
+            static_cast<long long>(result.delay_p95_ms),
+            static_cast<long long>(result.delay_p99_ms),
+            static_cast<long long>(result.convergence_ms),
+            static_cast<long long>(result.wall_time_ms));
+  }
+  return 0;
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  google::SetUsageMessage(
+      "Simulates each combination of the given link models, estimators and "
+      "flow counts, and writes one CSV line of metrics per scenario.\n"
+      "Example usage:\n" +
+      std::string(argv[0]) +
+      " --links=1000:50:5:0,2000:50:5:0:500@30 --estimators=REMB,GCC "
+      "--flows=1,4 --output=results.csv");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  return webrtc::testing::bwe::RunScenarios();
+}
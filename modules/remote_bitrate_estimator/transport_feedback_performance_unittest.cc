@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/pacing/packet_router.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
+#include "webrtc/modules/remote_bitrate_estimator/remote_estimator_proxy.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kPacketsPerMs = 10;
+constexpr int kDurationMs = 30000;
+constexpr int64_t kSendTimeHistoryWindowMs = 10000;
+constexpr size_t kPacketSize = 1200;
+constexpr int kLossPercent = 2;
+constexpr int kReorderPercent = 1;
+constexpr uint32_t kMediaSsrc = 0x1234;
+
+// Hands the transport feedback built by the receiver straight back to the
+// sender's history, the way TransportFeedbackAdapter looks it up.
+class FeedbackLoop : public PacketRouter {
+ public:
+  explicit FeedbackLoop(SendTimeHistory* send_time_history)
+      : send_time_history_(send_time_history) {}
+
+  bool SendFeedback(rtcp::TransportFeedback* packet) override {
+    const int64_t start_ns = rtc::TimeNanos();
+    uint16_t sequence_number = packet->GetBaseSequence();
+    for (auto symbol : packet->GetStatusVector()) {
+      if (symbol != rtcp::TransportFeedback::StatusSymbol::kNotReceived) {
+        PacketInfo info(0, sequence_number);
+        if (send_time_history_->GetInfo(&info, true))
+          ++num_acked_packets_;
+      }
+      ++sequence_number;
+    }
+    elapsed_ns_ += rtc::TimeNanos() - start_ns;
+    return true;
+  }
+
+  int num_acked_packets() const { return num_acked_packets_; }
+  int64_t elapsed_ns() const { return elapsed_ns_; }
+
+ private:
+  SendTimeHistory* const send_time_history_;
+  int num_acked_packets_ = 0;
+  int64_t elapsed_ns_ = 0;
+};
+}  // namespace
+
+TEST(TransportFeedbackPerformanceTest, SendTimeHistoryAndArrivalTimes) {
+  SimulatedClock clock(0);
+  Random random(0x7cc);
+  SendTimeHistory send_time_history(&clock, kSendTimeHistoryWindowMs);
+  FeedbackLoop feedback_loop(&send_time_history);
+  RemoteEstimatorProxy proxy(&clock, &feedback_loop);
+
+  RTPHeader header;
+  header.ssrc = kMediaSsrc;
+  header.extension.hasTransportSequenceNumber = true;
+  uint16_t sequence_number = 0;
+  std::vector<uint16_t> arrived;
+  int64_t send_ns = 0;
+  int64_t receive_ns = 0;
+  for (int ms = 0; ms < kDurationMs; ++ms) {
+    clock.AdvanceTimeMilliseconds(1);
+    const int64_t now_ms = clock.TimeInMilliseconds();
+
+    // The packets sent this millisecond arrive within the same millisecond,
+    // with some lost and some swapped with their predecessor.
+    arrived.clear();
+    int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kPacketsPerMs; ++i, ++sequence_number) {
+      send_time_history.AddAndRemoveOld(sequence_number, kPacketSize,
+                                        PacketInfo::kNotAProbe);
+      send_time_history.OnSentPacket(sequence_number, now_ms);
+    }
+    send_ns += rtc::TimeNanos() - start_ns;
+    for (uint16_t seq = sequence_number - kPacketsPerMs; seq != sequence_number;
+         ++seq) {
+      if (random.Rand(1, 100) <= kLossPercent)
+        continue;
+      arrived.push_back(seq);
+      if (arrived.size() > 1 && random.Rand(1, 100) <= kReorderPercent)
+        std::swap(arrived[arrived.size() - 1], arrived[arrived.size() - 2]);
+    }
+
+    start_ns = rtc::TimeNanos();
+    for (uint16_t seq : arrived) {
+      header.extension.transportSequenceNumber = seq;
+      proxy.IncomingPacket(now_ms, kPacketSize, header);
+    }
+    if (proxy.TimeUntilNextProcess() <= 0)
+      proxy.Process();
+    receive_ns += rtc::TimeNanos() - start_ns;
+  }
+  // Looking up the fed back packets is part of the sender's work.
+  receive_ns -= feedback_loop.elapsed_ns();
+  send_ns += feedback_loop.elapsed_ns();
+
+  const int num_packets = kDurationMs * kPacketsPerMs;
+  EXPECT_GT(feedback_loop.num_acked_packets(), num_packets * 9 / 10);
+  webrtc::test::PrintResult("transport_feedback", "_10000_pps",
+                            "send_time_history", send_ns / num_packets,
+                            "ns/packet", true);
+  webrtc::test::PrintResult("transport_feedback", "_10000_pps",
+                            "remote_estimator_proxy", receive_ns / num_packets,
+                            "ns/packet", true);
+}
+
+}  // namespace webrtc
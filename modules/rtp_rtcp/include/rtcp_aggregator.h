@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_INCLUDE_RTCP_AGGREGATOR_H_
+#define WEBRTC_MODULES_RTP_RTCP_INCLUDE_RTCP_AGGREGATOR_H_
+
+#include "webrtc/api/call/transport.h"
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/include/module.h"
+
+namespace webrtc {
+
+class Clock;
+
+// Combines the RTCP packets of the RtpRtcp modules sharing one transport into
+// fewer, larger datagrams. Each module keeps building its compound packets on
+// its own RFC 3550 schedule and hands them to the aggregator as its outgoing
+// transport. Packets holding only SR, RR, SDES and XR are appended, unchanged,
+// to a pending datagram that is sent when the next packet wouldn't fit in
+// |max_packet_size|, or at the latest every |flush_interval_ms| when processed
+// on a ProcessThread. Any other packet, e.g. with NACK, PLI, FIR or transport
+// feedback, is sent right away, together with the pending reports if they fit,
+// so that feedback is never delayed.
+//
+// Concatenated compound packets form a valid compound packet, so receivers
+// need no changes, and the transport protects and sends one datagram instead
+// of one per module.
+//
+// RTP packets are passed on to |transport| right away. |transport| is called
+// without holding a lock.
+class RtcpAggregator : public Transport, public Module {
+ public:
+  RtcpAggregator(Clock* clock,
+                 Transport* transport,
+                 size_t max_packet_size,
+                 int64_t flush_interval_ms);
+  ~RtcpAggregator() override;
+
+  // Implements Transport. For periodic reports, SendRtcp() returns true once
+  // the packet is queued, so a failure to send the combined datagram is only
+  // logged. Otherwise it returns whether the transport sent the packet.
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override;
+  bool SendRtcp(const uint8_t* packet, size_t length) override;
+
+  // Sends the pending RTCP packets now.
+  void Flush();
+
+  // Implements Module.
+  int64_t TimeUntilNextProcess() override;
+  void Process() override;
+
+ private:
+  // Returns the pending packets, leaving an empty buffer for the next ones.
+  rtc::Buffer TakePending() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void SendDatagram(const rtc::Buffer& datagram);
+
+  Clock* const clock_;
+  Transport* const transport_;
+  const size_t max_packet_size_;
+  const int64_t flush_interval_ms_;
+
+  rtc::CriticalSection crit_;
+  rtc::Buffer pending_ GUARDED_BY(crit_);
+  int64_t next_flush_ms_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtcpAggregator);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_INCLUDE_RTCP_AGGREGATOR_H_
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <string.h>
+
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+typedef void (*XorToManyFunction)(const uint8_t* src,
+                                  size_t length,
+                                  uint8_t* const* dsts,
+                                  size_t num_dsts);
+
+XorToManyFunction SelectXorToMany() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2))
+    return &XorToMany_AVX2;
+  if (WebRtc_GetCPUInfo(kSSE2))
+    return &XorToMany_SSE2;
+  return &XorToMany_C;
+#elif defined(WEBRTC_HAS_NEON)
+  return &XorToMany_NEON;
+#else
+  return &XorToMany_C;
+#endif
+}
+}  // namespace
+
+void XorToMany_C(const uint8_t* src,
+                 size_t length,
+                 uint8_t* const* dsts,
+                 size_t num_dsts) {
+  // Word at a time where possible. memcpy keeps the unaligned accesses legal
+  // and compiles to plain loads and stores.
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t s;
+    memcpy(&s, src + i, sizeof(s));
+    for (size_t k = 0; k < num_dsts; ++k) {
+      uint64_t d;
+      memcpy(&d, dsts[k] + i, sizeof(d));
+      d ^= s;
+      memcpy(dsts[k] + i, &d, sizeof(d));
+    }
+  }
+  for (; i < length; ++i) {
+    for (size_t k = 0; k < num_dsts; ++k)
+      dsts[k][i] ^= src[i];
+  }
+}
+
+void XorToMany(const uint8_t* src,
+               size_t length,
+               uint8_t* const* dsts,
+               size_t num_dsts) {
+  static const XorToManyFunction xor_to_many = SelectXorToMany();
+  xor_to_many(src, length, dsts, num_dsts);
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace internal {
+
+// XORs the |length| bytes at |src| into each of the |num_dsts| buffers in
+// |dsts|, i.e. dsts[k][i] ^= src[i]. Each chunk of |src| is loaded once and
+// applied to all destinations, so a media packet is folded into every FEC
+// packet protecting it in a single pass. The buffers may be unaligned but must
+// not overlap |src|.
+void XorToMany(const uint8_t* src,
+               size_t length,
+               uint8_t* const* dsts,
+               size_t num_dsts);
+
+// Kernels used by XorToMany, which picks the widest one the CPU supports.
+void XorToMany_C(const uint8_t* src,
+                 size_t length,
+                 uint8_t* const* dsts,
+                 size_t num_dsts);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void XorToMany_SSE2(const uint8_t* src,
+                    size_t length,
+                    uint8_t* const* dsts,
+                    size_t num_dsts);
+void XorToMany_AVX2(const uint8_t* src,
+                    size_t length,
+                    uint8_t* const* dsts,
+                    size_t num_dsts);
+#endif
+#if defined(WEBRTC_HAS_NEON)
+void XorToMany_NEON(const uint8_t* src,
+                    size_t length,
+                    uint8_t* const* dsts,
+                    size_t num_dsts);
+#endif
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
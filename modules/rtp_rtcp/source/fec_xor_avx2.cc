@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+namespace internal {
+
+// Same as XorToMany_SSE2, 128 bytes of |src| at a time.
+void XorToMany_AVX2(const uint8_t* src,
+                    size_t length,
+                    uint8_t* const* dsts,
+                    size_t num_dsts) {
+  size_t i = 0;
+  for (; i + 128 <= length; i += 128) {
+    const __m256i* s = reinterpret_cast<const __m256i*>(src + i);
+    const __m256i s0 = _mm256_loadu_si256(s);
+    const __m256i s1 = _mm256_loadu_si256(s + 1);
+    const __m256i s2 = _mm256_loadu_si256(s + 2);
+    const __m256i s3 = _mm256_loadu_si256(s + 3);
+    for (size_t k = 0; k < num_dsts; ++k) {
+      __m256i* d = reinterpret_cast<__m256i*>(dsts[k] + i);
+      _mm256_storeu_si256(d,
+                          _mm256_xor_si256(_mm256_loadu_si256(d), s0));
+      _mm256_storeu_si256(d + 1,
+                          _mm256_xor_si256(_mm256_loadu_si256(d + 1), s1));
+      _mm256_storeu_si256(d + 2,
+                          _mm256_xor_si256(_mm256_loadu_si256(d + 2), s2));
+      _mm256_storeu_si256(d + 3,
+                          _mm256_xor_si256(_mm256_loadu_si256(d + 3), s3));
+    }
+  }
+  for (; i + 32 <= length; i += 32) {
+    const __m256i s =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    for (size_t k = 0; k < num_dsts; ++k) {
+      __m256i* d = reinterpret_cast<__m256i*>(dsts[k] + i);
+      _mm256_storeu_si256(d, _mm256_xor_si256(_mm256_loadu_si256(d), s));
+    }
+  }
+  for (size_t k = 0; k < num_dsts; ++k) {
+    for (size_t j = i; j < length; ++j)
+      dsts[k][j] ^= src[j];
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+namespace internal {
+
+// Same as XorToMany_SSE2, with four quad registers of |src| per iteration.
+void XorToMany_NEON(const uint8_t* src,
+                    size_t length,
+                    uint8_t* const* dsts,
+                    size_t num_dsts) {
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    const uint8x16_t s0 = vld1q_u8(src + i);
+    const uint8x16_t s1 = vld1q_u8(src + i + 16);
+    const uint8x16_t s2 = vld1q_u8(src + i + 32);
+    const uint8x16_t s3 = vld1q_u8(src + i + 48);
+    for (size_t k = 0; k < num_dsts; ++k) {
+      uint8_t* d = dsts[k] + i;
+      vst1q_u8(d, veorq_u8(vld1q_u8(d), s0));
+      vst1q_u8(d + 16, veorq_u8(vld1q_u8(d + 16), s1));
+      vst1q_u8(d + 32, veorq_u8(vld1q_u8(d + 32), s2));
+      vst1q_u8(d + 48, veorq_u8(vld1q_u8(d + 48), s3));
+    }
+  }
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t s = vld1q_u8(src + i);
+    for (size_t k = 0; k < num_dsts; ++k)
+      vst1q_u8(dsts[k] + i, veorq_u8(vld1q_u8(dsts[k] + i), s));
+  }
+  for (size_t k = 0; k < num_dsts; ++k) {
+    for (size_t j = i; j < length; ++j)
+      dsts[k][j] ^= src[j];
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
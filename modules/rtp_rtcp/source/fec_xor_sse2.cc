@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+namespace internal {
+
+// Works on 64 bytes of |src| at a time, held in four registers while they are
+// applied to every destination.
+void XorToMany_SSE2(const uint8_t* src,
+                    size_t length,
+                    uint8_t* const* dsts,
+                    size_t num_dsts) {
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    const __m128i* s = reinterpret_cast<const __m128i*>(src + i);
+    const __m128i s0 = _mm_loadu_si128(s);
+    const __m128i s1 = _mm_loadu_si128(s + 1);
+    const __m128i s2 = _mm_loadu_si128(s + 2);
+    const __m128i s3 = _mm_loadu_si128(s + 3);
+    for (size_t k = 0; k < num_dsts; ++k) {
+      __m128i* d = reinterpret_cast<__m128i*>(dsts[k] + i);
+      _mm_storeu_si128(d, _mm_xor_si128(_mm_loadu_si128(d), s0));
+      _mm_storeu_si128(d + 1, _mm_xor_si128(_mm_loadu_si128(d + 1), s1));
+      _mm_storeu_si128(d + 2, _mm_xor_si128(_mm_loadu_si128(d + 2), s2));
+      _mm_storeu_si128(d + 3, _mm_xor_si128(_mm_loadu_si128(d + 3), s3));
+    }
+  }
+  for (; i + 16 <= length; i += 16) {
+    const __m128i s =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    for (size_t k = 0; k < num_dsts; ++k) {
+      __m128i* d = reinterpret_cast<__m128i*>(dsts[k] + i);
+      _mm_storeu_si128(d, _mm_xor_si128(_mm_loadu_si128(d), s));
+    }
+  }
+  for (size_t k = 0; k < num_dsts; ++k) {
+    for (size_t j = i; j < length; ++j)
+      dsts[k][j] ^= src[j];
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
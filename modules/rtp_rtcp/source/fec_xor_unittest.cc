@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/simd_kernels.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+typedef void (*XorToManyFunction)(const uint8_t*,
+                                  size_t,
+                                  uint8_t* const*,
+                                  size_t);
+
+void ExpectKernelMatchesC(XorToManyFunction kernel) {
+  Random random(0x7e57);
+  std::vector<uint8_t> src(1500);
+  for (uint8_t& byte : src)
+    byte = random.Rand<uint8_t>();
+  // Lengths around the vector widths and odd offsets, so that every kernel
+  // runs its unrolled loop, its single vector loop and its scalar tail on
+  // unaligned buffers.
+  for (size_t length : {0, 1, 15, 16, 17, 63, 64, 65, 129, 1000, 1487}) {
+    for (size_t num_dsts : {1, 2, 7, 48}) {
+      std::vector<std::vector<uint8_t>> expected(num_dsts);
+      std::vector<std::vector<uint8_t>> actual(num_dsts);
+      std::vector<uint8_t*> expected_ptrs;
+      std::vector<uint8_t*> actual_ptrs;
+      for (size_t k = 0; k < num_dsts; ++k) {
+        expected[k].resize(length + 3);
+        for (uint8_t& byte : expected[k])
+          byte = random.Rand<uint8_t>();
+        actual[k] = expected[k];
+        expected_ptrs.push_back(expected[k].data() + k % 4);
+        actual_ptrs.push_back(actual[k].data() + k % 4);
+      }
+      XorToMany_C(src.data() + 1, length, expected_ptrs.data(), num_dsts);
+      kernel(src.data() + 1, length, actual_ptrs.data(), num_dsts);
+      EXPECT_EQ(expected, actual) << "length " << length << ", " << num_dsts
+                                  << " destinations";
+    }
+  }
+}
+}  // namespace
+
+TEST(FecXorTest, CKernelXorsIntoEveryDestination) {
+  const uint8_t src[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+  uint8_t dst1[sizeof(src)] = {0};
+  uint8_t dst2[sizeof(src)];
+  for (size_t i = 0; i < sizeof(src); ++i)
+    dst2[i] = src[i];
+  uint8_t* dsts[] = {dst1, dst2};
+  XorToMany_C(src, sizeof(src), dsts, 2);
+  for (size_t i = 0; i < sizeof(src); ++i) {
+    EXPECT_EQ(src[i], dst1[i]);
+    EXPECT_EQ(0, dst2[i]);
+  }
+}
+
+TEST(FecXorTest, DispatchedKernelMatchesC) {
+  ExpectKernelMatchesC(&XorToMany);
+}
+
+TEST(FecXorTest, SimdKernelsMatchC) {
+  for (const auto& simd : test::SupportedSimdKernels<XorToManyFunction>(
+           WEBRTC_X86_KERNEL(&XorToMany_SSE2),
+           WEBRTC_X86_KERNEL(&XorToMany_AVX2),
+           WEBRTC_NEON_KERNEL(&XorToMany_NEON))) {
+    SCOPED_TRACE(simd.instruction_set);
+    ExpectKernelMatchesC(simd.kernel);
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_FLAT_MAP_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_FLAT_MAP_H_
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace webrtc {
+
+// A replacement for std::map for the small per-SSRC tables of the RTCP
+// modules. The elements are kept sorted by key in one vector, so lookups are
+// a binary search over contiguous memory and iteration is in key order, with
+// no allocation per element. Insertion and erasure move the elements after
+// the position, and invalidate iterators and pointers to elements.
+template <typename Key, typename T>
+class FlatMap {
+ public:
+  typedef std::pair<Key, T> value_type;
+  typedef typename std::vector<value_type>::iterator iterator;
+  typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+  iterator begin() { return elements_.begin(); }
+  iterator end() { return elements_.end(); }
+  const_iterator begin() const { return elements_.begin(); }
+  const_iterator end() const { return elements_.end(); }
+
+  bool empty() const { return elements_.empty(); }
+  size_t size() const { return elements_.size(); }
+  void clear() { elements_.clear(); }
+
+  iterator find(const Key& key) {
+    iterator it = LowerBound(key);
+    return it != end() && it->first == key ? it : end();
+  }
+  const_iterator find(const Key& key) const {
+    const_iterator it = LowerBound(key);
+    return it != end() && it->first == key ? it : end();
+  }
+  size_t count(const Key& key) const { return find(key) != end() ? 1 : 0; }
+
+  // Returns the element with |key|, inserting a value-initialized one if there
+  // is none.
+  T& operator[](const Key& key) {
+    iterator it = LowerBound(key);
+    if (it == end() || it->first != key)
+      it = elements_.insert(it, value_type(key, T()));
+    return it->second;
+  }
+
+  iterator erase(const_iterator position) { return elements_.erase(position); }
+  size_t erase(const Key& key) {
+    iterator it = find(key);
+    if (it == end())
+      return 0;
+    elements_.erase(it);
+    return 1;
+  }
+
+ private:
+  static bool KeyLess(const value_type& element, const Key& key) {
+    return element.first < key;
+  }
+  iterator LowerBound(const Key& key) {
+    return std::lower_bound(elements_.begin(), elements_.end(), key, KeyLess);
+  }
+  const_iterator LowerBound(const Key& key) const {
+    return std::lower_bound(elements_.begin(), elements_.end(), key, KeyLess);
+  }
+
+  std::vector<value_type> elements_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FLAT_MAP_H_
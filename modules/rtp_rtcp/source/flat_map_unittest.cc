@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/flat_map.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+TEST(FlatMapTest, InsertsValueInitialized) {
+  FlatMap<uint32_t, int> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(0, map[7]);
+  map[7] = 5;
+  EXPECT_EQ(5, map[7]);
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(FlatMapTest, IteratesInKeyOrder) {
+  FlatMap<uint32_t, std::string> map;
+  map[30] = "c";
+  map[10] = "a";
+  map[20] = "b";
+  std::vector<uint32_t> keys;
+  std::string values;
+  for (const auto& element : map) {
+    keys.push_back(element.first);
+    values += element.second;
+  }
+  EXPECT_EQ(std::vector<uint32_t>({10, 20, 30}), keys);
+  EXPECT_EQ("abc", values);
+}
+
+TEST(FlatMapTest, FindsOnlyInsertedKeys) {
+  FlatMap<uint32_t, int> map;
+  map[10] = 1;
+  map[30] = 3;
+  EXPECT_EQ(map.end(), map.find(20));
+  EXPECT_EQ(0u, map.count(20));
+  EXPECT_EQ(map.end(), map.find(40));
+  ASSERT_NE(map.end(), map.find(30));
+  EXPECT_EQ(3, map.find(30)->second);
+  EXPECT_EQ(1u, map.count(10));
+}
+
+TEST(FlatMapTest, ErasesByKeyAndPosition) {
+  FlatMap<uint32_t, int> map;
+  for (uint32_t key = 0; key < 5; ++key)
+    map[key] = key;
+  EXPECT_EQ(1u, map.erase(2));
+  EXPECT_EQ(0u, map.erase(2));
+
+  // Erase odd keys while iterating.
+  for (auto it = map.begin(); it != map.end();) {
+    if (it->first % 2 == 1)
+      it = map.erase(it);
+    else
+      ++it;
+  }
+  ASSERT_EQ(2u, map.size());
+  EXPECT_EQ(0u, map.begin()->first);
+  EXPECT_EQ(4u, (map.begin() + 1)->first);
+}
+
+TEST(FlatMapTest, OrdersPairKeysByFirstThenSecond) {
+  FlatMap<std::pair<uint32_t, uint32_t>, int> map;
+  map[std::make_pair(2u, 1u)] = 3;
+  map[std::make_pair(1u, 2u)] = 2;
+  map[std::make_pair(1u, 1u)] = 1;
+  std::vector<int> values;
+  for (const auto& element : map)
+    values.push_back(element.second);
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), values);
+}
+
+}  // namespace
+}  // namespace webrtc
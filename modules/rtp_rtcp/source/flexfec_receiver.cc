@@ -11,13 +11,11 @@
 #include "webrtc/modules/rtp_rtcp/include/flexfec_receiver.h"
 
 #include "webrtc/base/logging.h"
-#include "webrtc/base/scoped_ref_ptr.h"
 
 namespace webrtc {
 
 namespace {
 
-using Packet = ForwardErrorCorrection::Packet;
 using ReceivedPacket = ForwardErrorCorrection::ReceivedPacket;
 
 // Minimum header size (in bytes) of a well-formed non-singular FlexFEC packet.
@@ -83,7 +81,7 @@ bool FlexfecReceiver::AddReceivedPacket(const RtpPacketReceived& packet) {
     // Insert packet payload into erasure code.
     // TODO(brandtr): Remove this memcpy when the FEC packet classes
     // are using COW buffers internally.
-    received_packet->pkt = rtc::scoped_refptr<Packet>(new Packet());
+    received_packet->pkt = erasure_code_->AllocatePacket();
     auto payload = packet.payload();
     memcpy(received_packet->pkt->data, payload.data(), payload.size());
     received_packet->pkt->length = payload.size();
@@ -97,7 +95,7 @@ bool FlexfecReceiver::AddReceivedPacket(const RtpPacketReceived& packet) {
 
     // Insert entire packet into erasure code.
     // TODO(brandtr): Remove this memcpy too.
-    received_packet->pkt = rtc::scoped_refptr<Packet>(new Packet());
+    received_packet->pkt = erasure_code_->AllocatePacket();
     memcpy(received_packet->pkt->data, packet.data(), packet.size());
     received_packet->pkt->length = packet.size();
   }
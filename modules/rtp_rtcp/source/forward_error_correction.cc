@@ -20,6 +20,7 @@
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
 #include "webrtc/modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction_internal.h"
 #include "webrtc/modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
@@ -29,9 +30,89 @@ namespace webrtc {
 namespace {
 // Transport header size in bytes. Assume UDP/IPv4 as a reasonable minimum.
 constexpr size_t kTransportOverhead = 28;
+// Enough free packets to cover the received FEC packets and the recovered
+// packet window of one decoder.
+constexpr size_t kMaxPooledPackets = 2 * kUlpfecMaxMediaPackets;
+
+// Inserts |packet| into the sorted |packets|, after any equal elements, as
+// push_back() followed by a stable sort would. Packets mostly arrive in order,
+// so the position is searched for from the back.
+template <typename T>
+typename std::list<std::unique_ptr<T>>::iterator InsertSorted(
+    std::unique_ptr<T> packet,
+    std::list<std::unique_ptr<T>>* packets) {
+  ForwardErrorCorrection::SortablePacket::LessThan less_than;
+  auto it = packets->end();
+  while (it != packets->begin() && less_than(packet, *std::prev(it)))
+    --it;
+  return packets->insert(it, std::move(packet));
+}
+
+// Returns true if the sorted |packets| holds a packet with |seq_num|. It is
+// searched for from the back, where new packets usually go.
+template <typename T>
+bool ContainsSeqNum(const std::list<std::unique_ptr<T>>& packets,
+                    uint16_t seq_num) {
+  for (auto it = packets.rbegin(); it != packets.rend(); ++it) {
+    if ((*it)->seq_num == seq_num)
+      return true;
+    if (IsNewerSequenceNumber(seq_num, (*it)->seq_num))
+      return false;
+  }
+  return false;
+}
 }  // namespace
 
+// Recycles packet storage. Handed out packets keep the pool alive through
+// Packet::pool_, so it is destroyed, along with the free packets, when both
+// its ForwardErrorCorrection and the last outstanding packet are gone.
+class ForwardErrorCorrection::PacketPool : public rtc::RefCountInterface {
+ public:
+  rtc::scoped_refptr<Packet> Allocate() {
+    Packet* packet;
+    if (free_packets_.empty()) {
+      packet = new Packet();
+    } else {
+      packet = free_packets_.back().release();
+      free_packets_.pop_back();
+      packet->length = 0;
+      memset(packet->data, 0, sizeof(packet->data));
+    }
+    packet->pool_ = this;
+    return packet;
+  }
+
+  void Recycle(Packet* packet) {
+    if (free_packets_.size() < kMaxPooledPackets) {
+      free_packets_.push_back(std::unique_ptr<Packet>(packet));
+    } else {
+      delete packet;
+    }
+  }
+
+ protected:
+  ~PacketPool() override = default;
+
+ private:
+  std::vector<std::unique_ptr<Packet>> free_packets_;
+};
+
 ForwardErrorCorrection::Packet::Packet() : length(0), data(), ref_count_(0) {}
+
+ForwardErrorCorrection::Packet::Packet(const Packet& other)
+    : length(other.length), ref_count_(0) {
+  memcpy(data, other.data, sizeof(data));
+}
+
+ForwardErrorCorrection::Packet& ForwardErrorCorrection::Packet::operator=(
+    const Packet& other) {
+  if (this != &other) {
+    length = other.length;
+    memcpy(data, other.data, sizeof(data));
+  }
+  return *this;
+}
+
 ForwardErrorCorrection::Packet::~Packet() = default;
 
 int32_t ForwardErrorCorrection::Packet::AddRef() {
@@ -41,8 +122,16 @@ int32_t ForwardErrorCorrection::Packet::AddRef() {
 int32_t ForwardErrorCorrection::Packet::Release() {
   int32_t ref_count;
   ref_count = --ref_count_;
-  if (ref_count == 0)
-    delete this;
+  if (ref_count == 0) {
+    if (pool_) {
+      // The pool may only be referenced by this packet, so it must outlive
+      // the call.
+      rtc::scoped_refptr<PacketPool> pool(std::move(pool_));
+      pool->Recycle(this);
+    } else {
+      delete this;
+    }
+  }
   return ref_count;
 }
 
@@ -75,6 +164,7 @@ ForwardErrorCorrection::ForwardErrorCorrection(
     : fec_header_reader_(std::move(fec_header_reader)),
       fec_header_writer_(std::move(fec_header_writer)),
       generated_fec_packets_(fec_header_writer_->MaxFecPackets()),
+      packet_pool_(new rtc::RefCountedObject<PacketPool>()),
       packet_mask_size_(0) {}
 
 ForwardErrorCorrection::~ForwardErrorCorrection() = default;
@@ -186,60 +276,57 @@ void ForwardErrorCorrection::GenerateFecPayloads(
     const PacketList& media_packets,
     size_t num_fec_packets) {
   RTC_DCHECK(!media_packets.empty());
+  RTC_DCHECK_LE(num_fec_packets, kUlpfecMaxMediaPackets);
+  size_t fec_header_sizes[kUlpfecMaxMediaPackets];
   for (size_t i = 0; i < num_fec_packets; ++i) {
-    Packet* const fec_packet = &generated_fec_packets_[i];
-    size_t pkt_mask_idx = i * packet_mask_size_;
     const size_t min_packet_mask_size = fec_header_writer_->MinPacketMaskSize(
-        &packet_masks_[pkt_mask_idx], packet_mask_size_);
-    const size_t fec_header_size =
+        &packet_masks_[i * packet_mask_size_], packet_mask_size_);
+    fec_header_sizes[i] =
         fec_header_writer_->FecHeaderSize(min_packet_mask_size);
+  }
 
-    size_t media_pkt_idx = 0;
-    auto media_packets_it = media_packets.cbegin();
-    uint16_t prev_seq_num = ParseSequenceNumber((*media_packets_it)->data);
-    while (media_packets_it != media_packets.end()) {
-      Packet* const media_packet = media_packets_it->get();
-      // Should |media_packet| be protected by |fec_packet|?
-      if (packet_masks_[pkt_mask_idx] & (1 << (7 - media_pkt_idx))) {
-        size_t media_payload_length = media_packet->length - kRtpHeaderSize;
-
-        bool first_protected_packet = (fec_packet->length == 0);
-        size_t fec_packet_length = fec_header_size + media_payload_length;
-        if (fec_packet_length > fec_packet->length) {
-          // Recall that XORing with zero (which the FEC packets are prefilled
-          // with) is the identity operator, thus all prior XORs are
-          // still correct even though we expand the packet length here.
-          fec_packet->length = fec_packet_length;
-        }
-        if (first_protected_packet) {
-          // Write P, X, CC, M, and PT recovery fields.
-          // Note that bits 0, 1, and 16 are overwritten in FinalizeFecHeaders.
-          memcpy(&fec_packet->data[0], &media_packet->data[0], 2);
-          // Write length recovery field. (This is a temporary location for
-          // ULPFEC.)
-          ByteWriter<uint16_t>::WriteBigEndian(&fec_packet->data[2],
-                                               media_payload_length);
-          // Write timestamp recovery field.
-          memcpy(&fec_packet->data[4], &media_packet->data[4], 4);
-          // Write payload.
-          memcpy(&fec_packet->data[fec_header_size],
-                 &media_packet->data[kRtpHeaderSize], media_payload_length);
-        } else {
-          XorHeaders(*media_packet, fec_packet);
-          XorPayloads(*media_packet, media_payload_length, fec_header_size,
-                      fec_packet);
-        }
-      }
-      media_packets_it++;
-      if (media_packets_it != media_packets.end()) {
-        uint16_t seq_num = ParseSequenceNumber((*media_packets_it)->data);
-        media_pkt_idx += static_cast<uint16_t>(seq_num - prev_seq_num);
-        prev_seq_num = seq_num;
-      }
-      pkt_mask_idx += media_pkt_idx / 8;
-      media_pkt_idx %= 8;
+  // The FEC packets are zero-filled, so XORing the first protected media
+  // packet into one is the same as copying it. That lets each media packet
+  // be folded into all the FEC packets protecting it, as given by its column
+  // in the packet masks, in a single pass over its payload.
+  uint8_t* fec_payloads[kUlpfecMaxMediaPackets];
+  size_t media_pkt_idx = 0;
+  auto media_packets_it = media_packets.cbegin();
+  uint16_t prev_seq_num = ParseSequenceNumber((*media_packets_it)->data);
+  while (media_packets_it != media_packets.end()) {
+    Packet* const media_packet = media_packets_it->get();
+    const size_t media_payload_length = media_packet->length - kRtpHeaderSize;
+    const size_t mask_byte_idx = media_pkt_idx / 8;
+    const uint8_t mask_bit = 1 << (7 - media_pkt_idx % 8);
+    RTC_DCHECK_LT(mask_byte_idx, packet_mask_size_);
+    size_t num_fec_payloads = 0;
+    for (size_t i = 0; i < num_fec_packets; ++i) {
+      // Should |media_packet| be protected by this FEC packet?
+      if (!(packet_masks_[i * packet_mask_size_ + mask_byte_idx] & mask_bit))
+        continue;
+      Packet* const fec_packet = &generated_fec_packets_[i];
+      // Recall that XORing with zero is the identity operator, thus all prior
+      // XORs are still correct even though we expand the packet length here.
+      fec_packet->length = std::max(fec_packet->length,
+                                    fec_header_sizes[i] + media_payload_length);
+      // Writes the P, X, CC, M, PT, length recovery (a temporary location for
+      // ULPFEC) and timestamp recovery fields. Bits 0, 1, and 16 are
+      // overwritten in FinalizeFecHeaders.
+      XorHeaders(*media_packet, fec_packet);
+      fec_payloads[num_fec_payloads++] = &fec_packet->data[fec_header_sizes[i]];
+    }
+    internal::XorToMany(&media_packet->data[kRtpHeaderSize],
+                        media_payload_length, fec_payloads, num_fec_payloads);
+
+    media_packets_it++;
+    if (media_packets_it != media_packets.end()) {
+      uint16_t seq_num = ParseSequenceNumber((*media_packets_it)->data);
+      media_pkt_idx += static_cast<uint16_t>(seq_num - prev_seq_num);
+      prev_seq_num = seq_num;
     }
-    RTC_DCHECK_GT(fec_packet->length, 0)
+  }
+  for (size_t i = 0; i < num_fec_packets; ++i) {
+    RTC_DCHECK_GT(generated_fec_packets_[i].length, 0)
         << "Packet mask is wrong or poorly designed.";
   }
 }
@@ -332,17 +419,20 @@ void ForwardErrorCorrection::ResetState(
   received_fec_packets_.clear();
 }
 
+rtc::scoped_refptr<ForwardErrorCorrection::Packet>
+ForwardErrorCorrection::AllocatePacket() {
+  return packet_pool_->Allocate();
+}
+
 void ForwardErrorCorrection::InsertMediaPacket(
     RecoveredPacketList* recovered_packets,
     ReceivedPacket* received_packet) {
   // Search for duplicate packets.
-  for (const auto& recovered_packet : *recovered_packets) {
-    if (received_packet->seq_num == recovered_packet->seq_num) {
-      // Duplicate packet, no need to add to list.
-      // Delete duplicate media packet data.
-      received_packet->pkt = nullptr;
-      return;
-    }
+  if (ContainsSeqNum(*recovered_packets, received_packet->seq_num)) {
+    // Duplicate packet, no need to add to list.
+    // Delete duplicate media packet data.
+    received_packet->pkt = nullptr;
+    return;
   }
   std::unique_ptr<RecoveredPacket> recovered_packet(new RecoveredPacket());
   // This "recovered packet" was not recovered using parity packets.
@@ -352,18 +442,22 @@ void ForwardErrorCorrection::InsertMediaPacket(
   recovered_packet->seq_num = received_packet->seq_num;
   recovered_packet->pkt = received_packet->pkt;
   recovered_packet->pkt->length = received_packet->pkt->length;
-  // TODO(holmer): Consider replacing this with a binary search for the right
-  // position, and then just insert the new packet. Would get rid of the sort.
   RecoveredPacket* recovered_packet_ptr = recovered_packet.get();
-  recovered_packets->push_back(std::move(recovered_packet));
-  recovered_packets->sort(SortablePacket::LessThan());
+  InsertSorted(std::move(recovered_packet), recovered_packets);
   UpdateCoveringFecPackets(*recovered_packet_ptr);
 }
 
 void ForwardErrorCorrection::UpdateCoveringFecPackets(
     const RecoveredPacket& packet) {
+  SortablePacket::LessThan less_than;
   for (auto& fec_packet : received_fec_packets_) {
-    // Is this FEC packet protecting the media packet |packet|?
+    // Is this FEC packet protecting the media packet |packet|? Most are not,
+    // which shows from the ends of its sorted protected packets.
+    const ProtectedPacketList& protected_packets = fec_packet->protected_packets;
+    if (less_than(&packet, protected_packets.front()) ||
+        less_than(protected_packets.back(), &packet)) {
+      continue;
+    }
     auto protected_it = std::lower_bound(fec_packet->protected_packets.begin(),
                                          fec_packet->protected_packets.end(),
                                          &packet, SortablePacket::LessThan());
@@ -379,12 +473,10 @@ void ForwardErrorCorrection::InsertFecPacket(
     const RecoveredPacketList& recovered_packets,
     ReceivedPacket* received_packet) {
   // Check for duplicate.
-  for (const auto& existing_fec_packet : received_fec_packets_) {
-    if (received_packet->seq_num == existing_fec_packet->seq_num) {
-      // Delete duplicate FEC packet data.
-      received_packet->pkt = nullptr;
-      return;
-    }
+  if (ContainsSeqNum(received_fec_packets_, received_packet->seq_num)) {
+    // Delete duplicate FEC packet data.
+    received_packet->pkt = nullptr;
+    return;
   }
   std::unique_ptr<ReceivedFecPacket> fec_packet(new ReceivedFecPacket());
   fec_packet->pkt = received_packet->pkt;
@@ -417,15 +509,11 @@ void ForwardErrorCorrection::InsertFecPacket(
     LOG(LS_WARNING) << "Received FEC packet has an all-zero packet mask.";
   } else {
     AssignRecoveredPackets(recovered_packets, fec_packet.get());
-    // TODO(holmer): Consider replacing this with a binary search for the right
-    // position, and then just insert the new packet. Would get rid of the sort.
-    //
     // For correct decoding, |received_fec_packets_| does not necessarily
     // need to be sorted by sequence number (see decoding algorithm in
     // AttemptRecover()). By keeping it sorted we try to recover the
     // oldest lost packets first, however.
-    received_fec_packets_.push_back(std::move(fec_packet));
-    received_fec_packets_.sort(SortablePacket::LessThan());
+    InsertSorted(std::move(fec_packet), &received_fec_packets_);
     const size_t max_fec_packets = fec_header_reader_->MaxFecPackets();
     if (received_fec_packets_.size() > max_fec_packets) {
       received_fec_packets_.pop_front();
@@ -506,8 +594,7 @@ bool ForwardErrorCorrection::StartPacketRecovery(
     return false;
   }
   // Initialize recovered packet data.
-  recovered_packet->pkt = new Packet();
-  memset(recovered_packet->pkt->data, 0, IP_PACKET_SIZE);
+  recovered_packet->pkt = packet_pool_->Allocate();
   recovered_packet->returned = false;
   recovered_packet->was_recovered = true;
   // Copy bytes corresponding to minimum RTP header size.
@@ -580,9 +667,9 @@ void ForwardErrorCorrection::XorPayloads(const Packet& src,
   // XOR the payload.
   RTC_DCHECK_LE(kRtpHeaderSize + payload_length, sizeof(src.data));
   RTC_DCHECK_LE(dst_offset + payload_length, sizeof(dst->data));
-  for (size_t i = 0; i < payload_length; ++i) {
-    dst->data[dst_offset + i] ^= src.data[kRtpHeaderSize + i];
-  }
+  uint8_t* const dst_payload = &dst->data[dst_offset];
+  internal::XorToMany(&src.data[kRtpHeaderSize], payload_length, &dst_payload,
+                      1);
 }
 
 bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
@@ -627,11 +714,7 @@ void ForwardErrorCorrection::AttemptRecovery(
       auto recovered_packet_ptr = recovered_packet.get();
       // Add recovered packet to the list of recovered packets and update any
       // FEC packets covering this packet with a pointer to the data.
-      // TODO(holmer): Consider replacing this with a binary search for the
-      // right position, and then just insert the new packet. Would get rid of
-      // the sort.
-      recovered_packets->push_back(std::move(recovered_packet));
-      recovered_packets->sort(SortablePacket::LessThan());
+      InsertSorted(std::move(recovered_packet), recovered_packets);
       UpdateCoveringFecPackets(*recovered_packet_ptr);
       DiscardOldRecoveredPackets(recovered_packets);
       fec_packet_it = received_fec_packets_.erase(fec_packet_it);
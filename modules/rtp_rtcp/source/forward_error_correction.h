@@ -39,23 +39,33 @@ class ForwardErrorCorrection {
   // refactored into proper classes, and their members should be made private.
   // This will require parts of the functionality in forward_error_correction.cc
   // and receiver_fec.cc to be refactored into the packet classes.
+  class PacketPool;
+
   class Packet {
    public:
     Packet();
+    // Copies the length and data only; the copy starts unreferenced and does
+    // not belong to a pool.
+    Packet(const Packet& other);
+    Packet& operator=(const Packet& other);
     virtual ~Packet();
 
     // Add a reference.
     virtual int32_t AddRef();
 
-    // Release a reference. Will delete the object if the reference count
-    // reaches zero.
+    // Release a reference. Will delete the object, or return it to the pool
+    // it was allocated from, if the reference count reaches zero.
     virtual int32_t Release();
 
     size_t length;                 // Length of packet in bytes.
     uint8_t data[IP_PACKET_SIZE];  // Packet data.
 
    private:
+    friend class PacketPool;
+
     int32_t ref_count_;  // Counts the number of references to a packet.
+    // Set while the packet is handed out by a PacketPool.
+    rtc::scoped_refptr<PacketPool> pool_;
   };
 
   // TODO(holmer): Refactor into a proper class.
@@ -235,6 +245,12 @@ class ForwardErrorCorrection {
   // Frees all memory allocated by this class.
   void ResetState(RecoveredPacketList* recovered_packets);
 
+  // Returns a zeroed packet of length 0 for a received packet. The storage
+  // comes from a pool shared with the packets recovered by DecodeFec() and is
+  // recycled when the last reference is released, on the sequence this
+  // object is used on. Packets may outlive this object.
+  rtc::scoped_refptr<Packet> AllocatePacket();
+
   // TODO(brandtr): Remove these functions when the Packet classes
   // have been refactored.
   static uint16_t ParseSequenceNumber(uint8_t* packet);
@@ -295,8 +311,8 @@ class ForwardErrorCorrection {
 
   // Initializes headers and payload before the XOR operation
   // that recovers a packet.
-  static bool StartPacketRecovery(const ReceivedFecPacket& fec_packet,
-                                  RecoveredPacket* recovered_packet);
+  bool StartPacketRecovery(const ReceivedFecPacket& fec_packet,
+                           RecoveredPacket* recovered_packet);
 
   // Performs XOR between the first 8 bytes of |src| and |dst| and stores
   // the result in |dst|. The 3rd and 4th bytes are used for storing
@@ -317,8 +333,8 @@ class ForwardErrorCorrection {
                                    RecoveredPacket* recovered_packet);
 
   // Recover a missing packet.
-  static bool RecoverPacket(const ReceivedFecPacket& fec_packet,
-                            RecoveredPacket* recovered_packet);
+  bool RecoverPacket(const ReceivedFecPacket& fec_packet,
+                     RecoveredPacket* recovered_packet);
 
   // Get the number of missing media packets which are covered by |fec_packet|.
   // An FEC packet can recover at most one packet, and if zero packets are
@@ -335,6 +351,7 @@ class ForwardErrorCorrection {
 
   std::vector<Packet> generated_fec_packets_;
   ReceivedFecPacketList received_fec_packets_;
+  const rtc::scoped_refptr<PacketPool> packet_pool_;
 
   // Arrays used to avoid dynamically allocating memory when generating
   // the packet masks.
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/include/rtcp_aggregator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+// Returns true if |packet| only holds the reports a module sends on its
+// regular schedule, which can wait for the next flush. Anything else, such as
+// NACK, PLI, FIR or transport feedback, is sent right away.
+bool IsPeriodicReport(const uint8_t* packet, size_t length) {
+  const uint8_t* const end = packet + length;
+  rtcp::CommonHeader header;
+  for (const uint8_t* next = packet; next != end; next = header.NextPacket()) {
+    if (!header.Parse(next, end - next))
+      return false;
+    switch (header.type()) {
+      case rtcp::SenderReport::kPacketType:
+      case rtcp::ReceiverReport::kPacketType:
+      case rtcp::Sdes::kPacketType:
+      case rtcp::ExtendedReports::kPacketType:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+RtcpAggregator::RtcpAggregator(Clock* clock,
+                               Transport* transport,
+                               size_t max_packet_size,
+                               int64_t flush_interval_ms)
+    : clock_(clock),
+      transport_(transport),
+      max_packet_size_(max_packet_size),
+      flush_interval_ms_(flush_interval_ms),
+      next_flush_ms_(clock->TimeInMilliseconds() + flush_interval_ms) {
+  RTC_DCHECK(transport);
+  RTC_DCHECK_GT(max_packet_size, 0);
+  RTC_DCHECK_GT(flush_interval_ms, 0);
+  pending_.EnsureCapacity(max_packet_size);
+}
+
+RtcpAggregator::~RtcpAggregator() {
+  Flush();
+}
+
+bool RtcpAggregator::SendRtp(const uint8_t* packet,
+                             size_t length,
+                             const PacketOptions& options) {
+  return transport_->SendRtp(packet, length, options);
+}
+
+bool RtcpAggregator::SendRtcp(const uint8_t* packet, size_t length) {
+  const bool send_now =
+      length > max_packet_size_ || !IsPeriodicReport(packet, length);
+  // The packets pending which |packet| doesn't fit with, and |packet| together
+  // with the packets pending if it has to be sent now.
+  rtc::Buffer full;
+  rtc::Buffer datagram;
+  {
+    rtc::CritScope lock(&crit_);
+    if (pending_.size() + length > max_packet_size_)
+      full = TakePending();
+    if (length <= max_packet_size_) {
+      pending_.AppendData(packet, length);
+      if (send_now)
+        datagram = TakePending();
+    }
+  }
+  SendDatagram(full);
+  if (!send_now)
+    return true;
+  if (length > max_packet_size_) {
+    // Nothing to combine it with.
+    return transport_->SendRtcp(packet, length);
+  }
+  return transport_->SendRtcp(datagram.data(), datagram.size());
+}
+
+void RtcpAggregator::Flush() {
+  rtc::Buffer datagram;
+  {
+    rtc::CritScope lock(&crit_);
+    datagram = TakePending();
+  }
+  SendDatagram(datagram);
+}
+
+int64_t RtcpAggregator::TimeUntilNextProcess() {
+  rtc::CritScope lock(&crit_);
+  return std::max<int64_t>(0, next_flush_ms_ - clock_->TimeInMilliseconds());
+}
+
+void RtcpAggregator::Process() {
+  rtc::Buffer datagram;
+  {
+    rtc::CritScope lock(&crit_);
+    datagram = TakePending();
+    next_flush_ms_ = clock_->TimeInMilliseconds() + flush_interval_ms_;
+  }
+  SendDatagram(datagram);
+}
+
+rtc::Buffer RtcpAggregator::TakePending() {
+  if (pending_.empty())
+    return rtc::Buffer();
+  rtc::Buffer taken(std::move(pending_));
+  pending_.Clear();
+  pending_.EnsureCapacity(max_packet_size_);
+  return taken;
+}
+
+void RtcpAggregator::SendDatagram(const rtc::Buffer& datagram) {
+  if (datagram.empty())
+    return;
+  if (!transport_->SendRtcp(datagram.data(), datagram.size())) {
+    LOG(LS_WARNING) << "Failed to send " << datagram.size()
+                    << " bytes of aggregated RTCP.";
+  }
+}
+
+}  // namespace webrtc
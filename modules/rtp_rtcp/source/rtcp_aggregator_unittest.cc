@@ -0,0 +1,250 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/modules/rtp_rtcp/include/rtcp_aggregator.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gmock.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/mock_transport.h"
+
+using ::testing::_;
+using ::testing::ElementsAreArray;
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace webrtc {
+namespace {
+constexpr size_t kMaxPacketSize = 100;
+constexpr int64_t kFlushIntervalMs = 5;
+
+// A receiver report takes 8 bytes plus 24 per report block.
+rtc::Buffer BuildReceiverReport(uint32_t sender_ssrc, size_t num_blocks) {
+  rtcp::ReceiverReport rr;
+  rr.SetSenderSsrc(sender_ssrc);
+  for (size_t i = 0; i < num_blocks; ++i) {
+    rtcp::ReportBlock block;
+    block.SetMediaSsrc(sender_ssrc + 1 + i);
+    rr.AddReportBlock(block);
+  }
+  return rr.Build();
+}
+
+// 24 bytes, the packet ids being too far apart to share a NACK item.
+rtc::Buffer BuildNack(uint32_t sender_ssrc) {
+  rtcp::Nack nack;
+  nack.SetSenderSsrc(sender_ssrc);
+  nack.SetMediaSsrc(sender_ssrc + 1);
+  const uint16_t kNackList[] = {1, 20, 40};
+  nack.SetPacketIds(kNackList, 3);
+  return nack.Build();
+}
+
+std::vector<uint8_t> Concat(const rtc::Buffer& first,
+                            const rtc::Buffer& second) {
+  std::vector<uint8_t> packet(first.data(), first.data() + first.size());
+  packet.insert(packet.end(), second.data(), second.data() + second.size());
+  return packet;
+}
+
+std::vector<uint8_t> ToVector(const rtc::Buffer& packet) {
+  return std::vector<uint8_t>(packet.data(), packet.data() + packet.size());
+}
+
+class RtcpAggregatorTest : public ::testing::Test {
+ protected:
+  RtcpAggregatorTest()
+      : clock_(1000),
+        aggregator_(&clock_, &transport_, kMaxPacketSize, kFlushIntervalMs) {
+    ON_CALL(transport_, SendRtcp(_, _))
+        .WillByDefault(Invoke([this](const uint8_t* data, size_t length) {
+          sent_.emplace_back(data, data + length);
+          return true;
+        }));
+  }
+
+  SimulatedClock clock_;
+  ::testing::NiceMock<MockTransport> transport_;
+  RtcpAggregator aggregator_;
+  std::vector<std::vector<uint8_t>> sent_;
+};
+
+TEST_F(RtcpAggregatorTest, CombinesReportsUntilProcessed) {
+  const rtc::Buffer report1 = BuildReceiverReport(0x1111, 0);
+  const rtc::Buffer report2 = BuildReceiverReport(0x2222, 1);
+  EXPECT_TRUE(aggregator_.SendRtcp(report1.data(), report1.size()));
+  EXPECT_TRUE(aggregator_.SendRtcp(report2.data(), report2.size()));
+  EXPECT_TRUE(sent_.empty());
+
+  aggregator_.Process();
+  ASSERT_EQ(1u, sent_.size());
+  EXPECT_EQ(Concat(report1, report2), sent_[0]);
+
+  // Nothing left to send.
+  aggregator_.Process();
+  EXPECT_EQ(1u, sent_.size());
+}
+
+TEST_F(RtcpAggregatorTest, FlushesWhenNextReportDoesNotFit) {
+  // 56 bytes each.
+  const rtc::Buffer report = BuildReceiverReport(0x1111, 2);
+  aggregator_.SendRtcp(report.data(), report.size());
+  EXPECT_TRUE(sent_.empty());
+  aggregator_.SendRtcp(report.data(), report.size());
+  ASSERT_EQ(1u, sent_.size());
+  EXPECT_EQ(ToVector(report), sent_[0]);
+
+  aggregator_.Flush();
+  ASSERT_EQ(2u, sent_.size());
+  EXPECT_EQ(ToVector(report), sent_[1]);
+}
+
+TEST_F(RtcpAggregatorTest, SendsOversizedPacketRightAway) {
+  const rtc::Buffer report = BuildReceiverReport(0x1111, 0);
+  // 104 bytes.
+  const rtc::Buffer oversized = BuildReceiverReport(0x2222, 4);
+  aggregator_.SendRtcp(report.data(), report.size());
+  aggregator_.SendRtcp(oversized.data(), oversized.size());
+  // The pending packet is sent first, to keep the order.
+  ASSERT_EQ(2u, sent_.size());
+  EXPECT_EQ(ToVector(report), sent_[0]);
+  EXPECT_EQ(ToVector(oversized), sent_[1]);
+}
+
+TEST_F(RtcpAggregatorTest, SendsFeedbackRightAwayWithPendingReports) {
+  const rtc::Buffer report = BuildReceiverReport(0x1111, 1);
+  const rtc::Buffer nack = BuildNack(0x2222);
+  aggregator_.SendRtcp(report.data(), report.size());
+  EXPECT_TRUE(aggregator_.SendRtcp(nack.data(), nack.size()));
+  ASSERT_EQ(1u, sent_.size());
+  EXPECT_EQ(Concat(report, nack), sent_[0]);
+
+  // Nothing left to send.
+  aggregator_.Flush();
+  EXPECT_EQ(1u, sent_.size());
+}
+
+TEST_F(RtcpAggregatorTest, SendsFeedbackAloneIfPendingReportsDoNotFit) {
+  // 80 bytes.
+  const rtc::Buffer report = BuildReceiverReport(0x1111, 3);
+  const rtc::Buffer nack = BuildNack(0x2222);
+  aggregator_.SendRtcp(report.data(), report.size());
+  aggregator_.SendRtcp(nack.data(), nack.size());
+  ASSERT_EQ(2u, sent_.size());
+  EXPECT_EQ(ToVector(report), sent_[0]);
+  EXPECT_EQ(ToVector(nack), sent_[1]);
+}
+
+TEST_F(RtcpAggregatorTest, ReturnsWhetherFeedbackWasSent) {
+  const rtc::Buffer report = BuildReceiverReport(0x1111, 0);
+  const rtc::Buffer nack = BuildNack(0x2222);
+  EXPECT_CALL(transport_, SendRtcp(_, _)).WillOnce(Return(false));
+  // A queued report can't fail.
+  EXPECT_TRUE(aggregator_.SendRtcp(report.data(), report.size()));
+  EXPECT_FALSE(aggregator_.SendRtcp(nack.data(), nack.size()));
+}
+
+TEST_F(RtcpAggregatorTest, ProcessesAtFlushInterval) {
+  EXPECT_EQ(kFlushIntervalMs, aggregator_.TimeUntilNextProcess());
+  clock_.AdvanceTimeMilliseconds(kFlushIntervalMs - 1);
+  EXPECT_EQ(1, aggregator_.TimeUntilNextProcess());
+  clock_.AdvanceTimeMilliseconds(2);
+  EXPECT_EQ(0, aggregator_.TimeUntilNextProcess());
+  aggregator_.Process();
+  EXPECT_EQ(kFlushIntervalMs, aggregator_.TimeUntilNextProcess());
+}
+
+TEST_F(RtcpAggregatorTest, PassesRtpThrough) {
+  const uint8_t kPacket[] = {0x80, 96, 0, 1};
+  EXPECT_CALL(transport_, SendRtp(kPacket, sizeof(kPacket), _))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(aggregator_.SendRtp(kPacket, sizeof(kPacket), PacketOptions()));
+}
+
+TEST_F(RtcpAggregatorTest, FlushesOnDestruction) {
+  const rtc::Buffer report = BuildReceiverReport(0x1111, 0);
+  {
+    RtcpAggregator aggregator(&clock_, &transport_, kMaxPacketSize,
+                              kFlushIntervalMs);
+    aggregator.SendRtcp(report.data(), report.size());
+  }
+  ASSERT_EQ(1u, sent_.size());
+  EXPECT_EQ(ToVector(report), sent_[0]);
+}
+
+// Another module can queue its packets while the transport is sending.
+TEST_F(RtcpAggregatorTest, DoesNotHoldLockWhileSending) {
+  const rtc::Buffer report = BuildReceiverReport(0x1111, 0);
+  struct Sender {
+    static bool Run(void* obj) {
+      Sender* sender = static_cast<Sender*>(obj);
+      sender->aggregator->SendRtcp(sender->report->data(),
+                                   sender->report->size());
+      sender->done.Set();
+      return false;
+    }
+    RtcpAggregator* aggregator;
+    const rtc::Buffer* report;
+    rtc::Event done{false, false};
+  } sender{&aggregator_, &report};
+  rtc::PlatformThread thread(&Sender::Run, &sender, "RtcpSender");
+
+  EXPECT_CALL(transport_, SendRtcp(_, _))
+      .WillOnce(Invoke([&](const uint8_t* data, size_t length) {
+        thread.Start();
+        EXPECT_TRUE(sender.done.Wait(1000));
+        return true;
+      }));
+  aggregator_.SendRtcp(report.data(), report.size());
+  aggregator_.Flush();
+  thread.Stop();
+  ::testing::Mock::VerifyAndClearExpectations(&transport_);
+
+  // The report queued by the other thread is still pending.
+  aggregator_.Flush();
+  ASSERT_EQ(1u, sent_.size());
+  EXPECT_EQ(ToVector(report), sent_[0]);
+}
+
+// The combined packets of two modules parse as one compound packet.
+TEST_F(RtcpAggregatorTest, CombinedPacketsFormCompoundPacket) {
+  const rtc::Buffer packet1 = BuildReceiverReport(0x1111, 0);
+  rtc::Buffer packet2 = BuildReceiverReport(0x2222, 0);
+  packet2.AppendData(BuildNack(0x2222));
+
+  aggregator_.SendRtcp(packet1.data(), packet1.size());
+  aggregator_.SendRtcp(packet2.data(), packet2.size());
+  ASSERT_EQ(1u, sent_.size());
+
+  std::vector<uint8_t> packet_types;
+  const uint8_t* next = sent_[0].data();
+  const uint8_t* const end = sent_[0].data() + sent_[0].size();
+  while (next != end) {
+    rtcp::CommonHeader header;
+    ASSERT_TRUE(header.Parse(next, end - next));
+    packet_types.push_back(header.type());
+    next = header.NextPacket();
+  }
+  const uint8_t kExpectedTypes[] = {rtcp::ReceiverReport::kPacketType,
+                                    rtcp::ReceiverReport::kPacketType,
+                                    rtcp::Nack::kPacketType};
+  EXPECT_THAT(packet_types, ElementsAreArray(kExpectedTypes));
+}
+
+}  // namespace
+}  // namespace webrtc
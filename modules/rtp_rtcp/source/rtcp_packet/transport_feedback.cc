@@ -97,6 +97,10 @@ class TransportFeedback::LastChunk {
   void Decode(uint16_t chunk, size_t max_size);
   // Appends content of the Lastchunk to |deltas|.
   void AppendTo(std::vector<DeltaSize>* deltas) const;
+  // Number of stored delta sizes.
+  size_t Size() const;
+  // Returns the |index|th stored delta size, assumes |index| < Size().
+  DeltaSize Get(size_t index) const;
 
  private:
   static constexpr size_t kMaxRunLengthCapacity = 0x1fff;
@@ -207,6 +211,16 @@ void TransportFeedback::LastChunk::AppendTo(
   }
 }
 
+size_t TransportFeedback::LastChunk::Size() const {
+  return size_;
+}
+
+TransportFeedback::LastChunk::DeltaSize TransportFeedback::LastChunk::Get(
+    size_t index) const {
+  RTC_DCHECK_LT(index, size_);
+  return all_same_ ? delta_sizes_[0] : delta_sizes_[index];
+}
+
 void TransportFeedback::LastChunk::Decode(uint16_t chunk, size_t max_size) {
   if ((chunk & 0x8000) == 0) {
     DecodeRunLength(chunk, max_size);
@@ -370,14 +384,19 @@ uint16_t TransportFeedback::GetBaseSequence() const {
   return base_seq_no_;
 }
 
+const std::vector<TransportFeedback::ReceivedPacket>&
+TransportFeedback::GetReceivedPackets() const {
+  return packets_;
+}
+
 std::vector<TransportFeedback::StatusSymbol>
 TransportFeedback::GetStatusVector() const {
   std::vector<TransportFeedback::StatusSymbol> symbols;
   uint16_t seq_no = GetBaseSequence();
   for (const auto& packet : packets_) {
-    for (; seq_no != packet.sequence_number; ++seq_no)
+    for (; seq_no != packet.sequence_number(); ++seq_no)
       symbols.push_back(StatusSymbol::kNotReceived);
-    if (packet.delta_ticks >= 0x00 && packet.delta_ticks <= 0xff) {
+    if (packet.delta_ticks() >= 0x00 && packet.delta_ticks() <= 0xff) {
       symbols.push_back(StatusSymbol::kReceivedSmallDelta);
     } else {
       symbols.push_back(StatusSymbol::kReceivedLargeDelta);
@@ -390,7 +409,7 @@ TransportFeedback::GetStatusVector() const {
 std::vector<int16_t> TransportFeedback::GetReceiveDeltas() const {
   std::vector<int16_t> deltas;
   for (const auto& packet : packets_)
-    deltas.push_back(packet.delta_ticks);
+    deltas.push_back(packet.delta_ticks());
   return deltas;
 }
 
@@ -401,7 +420,7 @@ int64_t TransportFeedback::GetBaseTimeUs() const {
 std::vector<int64_t> TransportFeedback::GetReceiveDeltasUs() const {
   std::vector<int64_t> us_deltas;
   for (const auto& packet : packets_)
-    us_deltas.push_back(packet.delta_ticks * kDeltaScaleFactor);
+    us_deltas.push_back(packet.delta_ticks() * kDeltaScaleFactor);
   return us_deltas;
 }
 
@@ -434,9 +453,11 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     return false;
   }
 
-  std::vector<uint8_t> delta_sizes;
-  delta_sizes.reserve(status_count);
-  while (delta_sizes.size() < status_count) {
+  // The receive deltas follow the packet chunks, so find where the chunks end
+  // before decoding them again along with the deltas. This avoids expanding
+  // the chunks into a vector of delta sizes.
+  size_t num_decoded = 0;
+  while (num_decoded < status_count) {
     if (index + kChunkSizeBytes > end_index) {
       LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
       Clear();
@@ -446,48 +467,54 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
     index += kChunkSizeBytes;
     encoded_chunks_.push_back(chunk);
-    last_chunk_->Decode(chunk, status_count - delta_sizes.size());
-    last_chunk_->AppendTo(&delta_sizes);
+    last_chunk_->Decode(chunk, status_count - num_decoded);
+    num_decoded += last_chunk_->Size();
   }
-  // Last chunk is stored in the |last_chunk_|.
-  encoded_chunks_.pop_back();
-  RTC_DCHECK_EQ(delta_sizes.size(), status_count);
+  RTC_DCHECK_EQ(num_decoded, status_count);
   num_seq_no_ = status_count;
 
   uint16_t seq_no = base_seq_no_;
-  for (size_t delta_size : delta_sizes) {
-    if (index + delta_size > end_index) {
-      LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
-      Clear();
-      return false;
-    }
-    switch (delta_size) {
-      case 0:
-        break;
-      case 1: {
-        int16_t delta = payload[index];
-        packets_.emplace_back(seq_no, delta);
-        last_timestamp_us_ += delta * kDeltaScaleFactor;
-        index += delta_size;
-        break;
-      }
-      case 2: {
-        int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
-        packets_.emplace_back(seq_no, delta);
-        last_timestamp_us_ += delta * kDeltaScaleFactor;
-        index += delta_size;
-        break;
-      }
-      case 3:
+  num_decoded = 0;
+  for (uint16_t chunk : encoded_chunks_) {
+    last_chunk_->Decode(chunk, status_count - num_decoded);
+    num_decoded += last_chunk_->Size();
+    for (size_t i = 0; i < last_chunk_->Size(); ++i) {
+      const DeltaSize delta_size = last_chunk_->Get(i);
+      if (index + delta_size > end_index) {
+        LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
         Clear();
-        LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
         return false;
-      default:
-        RTC_NOTREACHED();
-        break;
+      }
+      switch (delta_size) {
+        case 0:
+          break;
+        case 1: {
+          int16_t delta = payload[index];
+          packets_.emplace_back(seq_no, delta);
+          last_timestamp_us_ += delta * kDeltaScaleFactor;
+          index += delta_size;
+          break;
+        }
+        case 2: {
+          int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
+          packets_.emplace_back(seq_no, delta);
+          last_timestamp_us_ += delta * kDeltaScaleFactor;
+          index += delta_size;
+          break;
+        }
+        case 3:
+          Clear();
+          LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
+          return false;
+        default:
+          RTC_NOTREACHED();
+          break;
+      }
+      ++seq_no;
     }
-    ++seq_no;
   }
+  // Last chunk is stored in the |last_chunk_|.
+  encoded_chunks_.pop_back();
   size_bytes_ = RtcpPacket::kHeaderLength + index;
   RTC_DCHECK_LE(index, end_index);
   return true;
@@ -534,18 +561,18 @@ bool TransportFeedback::IsConsistent() const {
         LOG(LS_ERROR) << "Failed to find delta for seq_no " << seq_no;
         return false;
       }
-      if (packet_it->sequence_number != seq_no) {
+      if (packet_it->sequence_number() != seq_no) {
         LOG(LS_ERROR) << "Expected to find delta for seq_no " << seq_no
-                      << ". Next delta is for " << packet_it->sequence_number;
+                      << ". Next delta is for " << packet_it->sequence_number();
         return false;
       }
       if (delta_size == 1 &&
-          (packet_it->delta_ticks < 0 || packet_it->delta_ticks > 0xff)) {
-        LOG(LS_ERROR) << "Delta " << packet_it->delta_ticks << " for seq_no "
+          (packet_it->delta_ticks() < 0 || packet_it->delta_ticks() > 0xff)) {
+        LOG(LS_ERROR) << "Delta " << packet_it->delta_ticks() << " for seq_no "
                       << seq_no << " doesn't fit into one byte";
         return false;
       }
-      timestamp_us += packet_it->delta_ticks * kDeltaScaleFactor;
+      timestamp_us += packet_it->delta_ticks() * kDeltaScaleFactor;
       ++packet_it;
     }
     packet_size += delta_size;
@@ -553,7 +580,7 @@ bool TransportFeedback::IsConsistent() const {
   }
   if (packet_it != packets_.end()) {
     LOG(LS_ERROR) << "Unencoded delta for seq_no "
-                  << packet_it->sequence_number;
+                  << packet_it->sequence_number();
     return false;
   }
   if (timestamp_us != last_timestamp_us_) {
@@ -610,7 +637,7 @@ bool TransportFeedback::Create(uint8_t* packet,
   }
 
   for (const auto& received_packet : packets_) {
-    int16_t delta = received_packet.delta_ticks;
+    int16_t delta = received_packet.delta_ticks();
     if (delta >= 0 && delta <= 0xFF) {
       packet[(*position)++] = delta;
     } else {
@@ -45,7 +45,26 @@ class TransportFeedback : public Rtpfb {
     kReceivedLargeDelta,
   };
 
+  class ReceivedPacket {
+   public:
+    ReceivedPacket(uint16_t sequence_number, int16_t delta_ticks)
+        : sequence_number_(sequence_number), delta_ticks_(delta_ticks) {}
+    ReceivedPacket(const ReceivedPacket&) = default;
+    ReceivedPacket& operator=(const ReceivedPacket&) = default;
+
+    uint16_t sequence_number() const { return sequence_number_; }
+    int16_t delta_ticks() const { return delta_ticks_; }
+    int32_t delta_us() const { return delta_ticks_ * kDeltaScaleFactor; }
+
+   private:
+    uint16_t sequence_number_;
+    int16_t delta_ticks_;
+  };
+
   uint16_t GetBaseSequence() const;
+  // The received packets in sequence number order, with their receive deltas.
+  // Walking these needs no copies, unlike the vectors returned below.
+  const std::vector<ReceivedPacket>& GetReceivedPackets() const;
   std::vector<TransportFeedback::StatusSymbol> GetStatusVector() const;
   std::vector<int16_t> GetReceiveDeltas() const;
 
@@ -76,12 +95,6 @@ class TransportFeedback : public Rtpfb {
   using DeltaSize = uint8_t;
   // Keeps DeltaSizes that can be encoded into single chunk if it is last chunk.
   class LastChunk;
-  struct ReceivedPacket {
-    ReceivedPacket(uint16_t sequence_number, int16_t delta_ticks)
-        : sequence_number(sequence_number), delta_ticks(delta_ticks) {}
-    uint16_t sequence_number;
-    int16_t delta_ticks;
-  };
 
   // Reset packet to consistent empty state.
   void Clear();
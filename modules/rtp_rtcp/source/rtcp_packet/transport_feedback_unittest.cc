@@ -119,6 +119,15 @@ class FeedbackTester {
     ASSERT_EQ(expected_deltas_.size(), deltas.size());
     for (size_t i = 0; i < expected_deltas_.size(); ++i)
       EXPECT_EQ(expected_deltas_[i], deltas[i]) << "Delta mismatch @ " << i;
+
+    const std::vector<TransportFeedback::ReceivedPacket>& packets =
+        feedback_->GetReceivedPackets();
+    ASSERT_EQ(expected_seq_.size(), packets.size());
+    for (size_t i = 0; i < packets.size(); ++i) {
+      EXPECT_EQ(expected_seq_[i], packets[i].sequence_number());
+      EXPECT_EQ(expected_deltas_[i], packets[i].delta_us())
+          << "Delta mismatch @ " << i;
+    }
   }
 
   void GenerateDeltas(const uint16_t seq[],
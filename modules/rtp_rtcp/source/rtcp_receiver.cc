@@ -12,6 +12,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <memory>
@@ -169,7 +170,7 @@ void RTCPReceiver::SetSsrcs(uint32_t main_ssrc,
                             const std::set<uint32_t>& registered_ssrcs) {
   rtc::CritScope lock(&rtcp_receiver_lock_);
   main_ssrc_ = main_ssrc;
-  registered_ssrcs_ = registered_ssrcs;
+  registered_ssrcs_.assign(registered_ssrcs.begin(), registered_ssrcs.end());
 }
 
 int32_t RTCPReceiver::RTT(uint32_t remote_ssrc,
@@ -179,15 +180,12 @@ int32_t RTCPReceiver::RTT(uint32_t remote_ssrc,
                           int64_t* max_rtt_ms) const {
   rtc::CritScope lock(&rtcp_receiver_lock_);
 
-  auto it = received_report_blocks_.find(main_ssrc_);
+  auto it = received_report_blocks_.find(std::make_pair(main_ssrc_,
+                                                        remote_ssrc));
   if (it == received_report_blocks_.end())
     return -1;
 
-  auto it_info = it->second.find(remote_ssrc);
-  if (it_info == it->second.end())
-    return -1;
-
-  const ReportBlockWithRtt* report_block = &it_info->second;
+  const ReportBlockWithRtt* report_block = &it->second;
 
   if (report_block->num_rtts == 0)
     return -1;
@@ -284,9 +282,8 @@ int32_t RTCPReceiver::StatisticsReceived(
     std::vector<RTCPReportBlock>* receive_blocks) const {
   RTC_DCHECK(receive_blocks);
   rtc::CritScope lock(&rtcp_receiver_lock_);
-  for (const auto& reports_per_receiver : received_report_blocks_)
-    for (const auto& report : reports_per_receiver.second)
-      receive_blocks->push_back(report.second.report_block);
+  for (const auto& report : received_report_blocks_)
+    receive_blocks->push_back(report.second.report_block);
   return 0;
 }
 
@@ -473,11 +470,11 @@ void RTCPReceiver::HandleReportBlock(const ReportBlock& report_block,
   // which the information in this reception report block pertains.
 
   // Filter out all report blocks that are not for us.
-  if (registered_ssrcs_.count(report_block.source_ssrc()) == 0)
+  if (!IsRegisteredSsrc(report_block.source_ssrc()))
     return;
 
-  ReportBlockWithRtt* report_block_info =
-      &received_report_blocks_[report_block.source_ssrc()][remote_ssrc];
+  ReportBlockWithRtt* report_block_info = &received_report_blocks_[
+      std::make_pair(report_block.source_ssrc(), remote_ssrc)];
 
   last_received_rr_ms_ = clock_->TimeInMilliseconds();
   report_block_info->report_block.remoteSSRC = remote_ssrc;
@@ -547,6 +544,11 @@ RTCPReceiver::ReceiveInformation* RTCPReceiver::GetReceiveInformation(
   return &it->second;
 }
 
+bool RTCPReceiver::IsRegisteredSsrc(uint32_t ssrc) const {
+  return std::binary_search(registered_ssrcs_.begin(), registered_ssrcs_.end(),
+                            ssrc);
+}
+
 bool RTCPReceiver::RtcpRrTimeout(int64_t rtcp_interval_ms) {
   rtc::CritScope lock(&rtcp_receiver_lock_);
   if (last_received_rr_ms_ == 0)
@@ -670,8 +672,13 @@ void RTCPReceiver::HandleBye(const CommonHeader& rtcp_block) {
   }
 
   // Clear our lists.
-  for (auto& reports_per_receiver : received_report_blocks_)
-    reports_per_receiver.second.erase(bye.sender_ssrc());
+  for (auto it = received_report_blocks_.begin();
+       it != received_report_blocks_.end();) {
+    if (it->first.second == bye.sender_ssrc())
+      it = received_report_blocks_.erase(it);
+    else
+      ++it;
+  }
 
   // We can't delete it due to TMMBR.
   ReceiveInformation* receive_info = GetReceiveInformation(bye.sender_ssrc());
@@ -708,7 +715,7 @@ void RTCPReceiver::HandleXrReceiveReferenceTime(uint32_t sender_ssrc,
 }
 
 void RTCPReceiver::HandleXrDlrrReportBlock(const rtcp::ReceiveTimeInfo& rti) {
-  if (registered_ssrcs_.count(rti.ssrc) == 0)  // Not to us.
+  if (!IsRegisteredSsrc(rti.ssrc))  // Not to us.
     return;
 
   // Caller should explicitly enable rtt calculation using extended reports.
@@ -912,6 +919,10 @@ void RTCPReceiver::HandleTransportFeedback(
     return;
   }
 
+  const uint32_t media_source_ssrc = transport_feedback->media_ssrc();
+  if (media_source_ssrc != main_ssrc_ && !IsRegisteredSsrc(media_source_ssrc))
+    return;  // Not to us.
+
   packet_information->packet_type_flags |= kRtcpTransportFeedback;
   packet_information->transport_feedback = std::move(transport_feedback);
 }
@@ -953,12 +964,10 @@ void RTCPReceiver::TriggerCallbacksFromRtcpPacket(
     UpdateTmmbr();
   }
   uint32_t local_ssrc;
-  std::set<uint32_t> registered_ssrcs;
   {
     // We don't want to hold this critsect when triggering the callbacks below.
     rtc::CritScope lock(&rtcp_receiver_lock_);
     local_ssrc = main_ssrc_;
-    registered_ssrcs = registered_ssrcs_;
   }
   if (!receiver_only_ && (packet_information.packet_type_flags & kRtcpSrReq)) {
     rtp_rtcp_->OnRequestSendReport();
@@ -1019,13 +1028,8 @@ void RTCPReceiver::TriggerCallbacksFromRtcpPacket(
 
   if (transport_feedback_observer_ &&
       (packet_information.packet_type_flags & kRtcpTransportFeedback)) {
-    uint32_t media_source_ssrc =
-        packet_information.transport_feedback->media_ssrc();
-    if (media_source_ssrc == local_ssrc ||
-        registered_ssrcs.find(media_source_ssrc) != registered_ssrcs.end()) {
-      transport_feedback_observer_->OnTransportFeedback(
-          *packet_information.transport_feedback);
-    }
+    transport_feedback_observer_->OnTransportFeedback(
+        *packet_information.transport_feedback);
   }
 
   if (bitrate_allocation_observer_ &&
@@ -11,14 +11,15 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_RECEIVER_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_RECEIVER_H_
 
-#include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/flat_map.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/system_wrappers/include/ntp_time.h"
@@ -120,11 +121,10 @@ class RTCPReceiver {
   struct ReceiveInformation;
   struct ReportBlockWithRtt;
   // Mapped by remote ssrc.
-  using ReceivedInfoMap = std::map<uint32_t, ReceiveInformation>;
-  // RTCP report blocks mapped by remote SSRC.
-  using ReportBlockInfoMap = std::map<uint32_t, ReportBlockWithRtt>;
-  // RTCP report blocks map mapped by source SSRC.
-  using ReportBlockMap = std::map<uint32_t, ReportBlockInfoMap>;
+  using ReceivedInfoMap = FlatMap<uint32_t, ReceiveInformation>;
+  // RTCP report blocks mapped by source SSRC, then remote SSRC.
+  using ReportBlockMap =
+      FlatMap<std::pair<uint32_t, uint32_t>, ReportBlockWithRtt>;
 
   bool ParseCompoundPacket(const uint8_t* packet_begin,
                            const uint8_t* packet_end,
@@ -138,6 +138,9 @@ class RTCPReceiver {
   ReceiveInformation* GetReceiveInformation(uint32_t remote_ssrc)
       EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
+  bool IsRegisteredSsrc(uint32_t ssrc) const
+      EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
+
   void HandleSenderReport(const rtcp::CommonHeader& rtcp_block,
                           PacketInformation* packet_information)
       EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
@@ -226,7 +229,8 @@ class RTCPReceiver {
   rtc::CriticalSection rtcp_receiver_lock_;
   uint32_t main_ssrc_ GUARDED_BY(rtcp_receiver_lock_);
   uint32_t remote_ssrc_ GUARDED_BY(rtcp_receiver_lock_);
-  std::set<uint32_t> registered_ssrcs_ GUARDED_BY(rtcp_receiver_lock_);
+  // Sorted.
+  std::vector<uint32_t> registered_ssrcs_ GUARDED_BY(rtcp_receiver_lock_);
 
   // Received sender report.
   RTCPSenderInfo remote_sender_info_;
@@ -244,7 +248,7 @@ class RTCPReceiver {
   // Received report blocks.
   ReportBlockMap received_report_blocks_ GUARDED_BY(rtcp_receiver_lock_);
   ReceivedInfoMap received_infos_ GUARDED_BY(rtcp_receiver_lock_);
-  std::map<uint32_t, std::string> received_cnames_
+  FlatMap<uint32_t, std::string> received_cnames_
       GUARDED_BY(rtcp_receiver_lock_);
 
   // The last time we received an RTCP RR.
@@ -38,8 +38,8 @@ constexpr const char* AbsoluteSendTime::kUri;
 bool AbsoluteSendTime::Parse(const uint8_t* data, 
                              uint8_t length,
                              uint32_t* time_24bits) {
-  RTC_DCHECK(length);
-  RTC_DCHECK_LE(length,kMaxValueSizeBytes);
+  if (length != kMaxValueSizeBytes)
+    return false;
   *time_24bits = ByteReader<uint32_t, 3>::ReadBigEndian(data);
   return true;
 }
@@ -69,8 +69,8 @@ bool AudioLevel::Parse(const uint8_t* data,
                        uint8_t length,
                        bool* voice_activity,
                        uint8_t* audio_level) {
-  RTC_DCHECK(length);
-  RTC_DCHECK_LE(length,kMaxValueSizeBytes);
+  if (length != kMaxValueSizeBytes)
+    return false;
   *voice_activity = (data[0] & 0x80) != 0;
   *audio_level = data[0] & 0x7F;
   return true;
@@ -107,8 +107,8 @@ constexpr const char* TransmissionOffset::kUri;
 bool TransmissionOffset::Parse(const uint8_t* data,
                                uint8_t length, 
                                int32_t* rtp_time) {
-  RTC_DCHECK(length);
-  RTC_DCHECK_LE(length,kMaxValueSizeBytes);
+  if (length != kMaxValueSizeBytes)
+    return false;
   *rtp_time = ByteReader<int32_t, 3>::ReadBigEndian(data);
   return true;
 }
@@ -131,8 +131,8 @@ constexpr const char* TransportSequenceNumber::kUri;
 bool TransportSequenceNumber::Parse(const uint8_t* data,
                                     uint8_t length, 
                                     uint16_t* value) {
-  RTC_DCHECK(length);
-  RTC_DCHECK_LE(length,kMaxValueSizeBytes);
+  if (length != kMaxValueSizeBytes)
+    return false;
   *value = ByteReader<uint16_t>::ReadBigEndian(data);
   return true;
 }
@@ -160,8 +160,8 @@ constexpr const char* VideoOrientation::kUri;
 bool VideoOrientation::Parse(const uint8_t* data,
                              uint8_t length, 
                              VideoRotation* rotation) {
-  RTC_DCHECK(length);
-  RTC_DCHECK_LE(length,kMaxValueSizeBytes);
+  if (length != kMaxValueSizeBytes)
+    return false;
   *rotation = ConvertCVOByteToVideoRotation(data[0]);
   return true;
 }
@@ -174,8 +174,8 @@ bool VideoOrientation::Write(uint8_t* data, VideoRotation rotation) {
 bool VideoOrientation::Parse(const uint8_t* data,
                              uint8_t length, 
                              uint8_t* value) {
-  RTC_DCHECK(length);
-  RTC_DCHECK_LE(length,kMaxValueSizeBytes);
+  if (length != kMaxValueSizeBytes)
+    return false;
   *value = data[0];
   return true;
 }
@@ -197,9 +197,9 @@ constexpr const char* PlayoutDelayLimits::kUri;
 bool PlayoutDelayLimits::Parse(const uint8_t* data,
                                uint8_t length,
                                PlayoutDelay* playout_delay) {
-  RTC_DCHECK(length);
-  RTC_DCHECK_LE(length,kMaxValueSizeBytes);
   RTC_DCHECK(playout_delay);
+  if (length != kMaxValueSizeBytes)
+    return false;
   uint32_t raw = ByteReader<uint32_t, 3>::ReadBigEndian(data);
   uint16_t min_raw = (raw >> 12);
   uint16_t max_raw = (raw & 0xfff);
@@ -254,8 +254,8 @@ bool FrameMarking::Parse(const uint8_t* data,
                          uint8_t length,
                          FrameMarks* frame_marks) {
   RTC_DCHECK(frame_marks);
-  RTC_DCHECK(length);
-  RTC_DCHECK_LE(length,kMaxValueSizeBytes);
+  if (length != 1 && length != 3)
+    return false;
   // Set frame marking data
   frame_marks->startOfFrame = data[0] & 0x80;
   frame_marks->endOfFrame = data[0] & 0x40;
@@ -269,16 +269,13 @@ bool FrameMarking::Parse(const uint8_t* data,
     frame_marks->temporalLayerId = 0;
     frame_marks->spatialLayerId = 0;
     frame_marks->tl0PicIdx = 0;
-  } else if (length==3) {
+  } else {
     // Set scalable parts
     frame_marks->baseLayerSync = data[0] & 0x08;
     frame_marks->temporalLayerId = data[0] & 0x07;
     frame_marks->spatialLayerId = data[1];
     frame_marks->tl0PicIdx = data[2]; 
-  } else {
-    // Incorrect length
-    return false;
-  } 
+  }
   return true;
 }
 
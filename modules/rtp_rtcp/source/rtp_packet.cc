@@ -19,6 +19,7 @@
 #include "webrtc/common_types.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extension.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_parser.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 
 namespace webrtc {
@@ -29,6 +30,8 @@ constexpr uint8_t kRtpVersion = 2;
 constexpr uint16_t kOneByteExtensionId = 0xBEDE;
 constexpr size_t kOneByteHeaderSize = 1;
 constexpr size_t kDefaultPacketSize = 1500;
+static_assert(Packet::kMaxExtensionHeaders == HeaderLayout::kMaxExtensionHeaders,
+              "Packet and HeaderLayout must agree on the extension count.");
 }  // namespace
 //  0                   1                   2                   3
 //  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
@@ -101,6 +104,19 @@ bool Packet::Parse(rtc::CopyOnWriteBuffer buffer) {
   return true;
 }
 
+bool Packet::Parse(rtc::CopyOnWriteBuffer buffer, const HeaderLayout& layout) {
+  if (!layout.valid) {
+    Clear();
+    return false;
+  }
+  RTC_DCHECK_EQ(layout.payload_offset + layout.payload_size +
+                    layout.padding_size,
+                buffer.size());
+  ApplyLayout(layout);
+  buffer_ = std::move(buffer);
+  return true;
+}
+
 bool Packet::Marker() const {
   RTC_DCHECK_EQ(marker_, (data()[1] & 0x80) != 0);
   return marker_;
@@ -164,6 +180,11 @@ void Packet::GetHeader(RTPHeader* header) const {
       &header->extension.voiceActivity, &header->extension.audioLevel);
   header->extension.hasVideoRotation =
       GetExtension<VideoOrientation>(&header->extension.videoRotation);
+  header->extension.playout_delay.min_ms = -1;
+  header->extension.playout_delay.max_ms = -1;
+  GetExtension<PlayoutDelayLimits>(&header->extension.playout_delay);
+  header->extension.hasFrameMarks =
+      GetExtension<FrameMarking>(&header->extension.frameMarks);
 }
 
 size_t Packet::headers_size() const {
@@ -339,105 +360,29 @@ void Packet::Clear() {
 }
 
 bool Packet::ParseBuffer(const uint8_t* buffer, size_t size) {
-  if (size < kFixedHeaderSize) {
-    return false;
-  }
-  const uint8_t version = buffer[0] >> 6;
-  if (version != kRtpVersion) {
+  HeaderLayout layout;
+  if (!ParseHeaderLayout(buffer, size, &layout)) {
     return false;
   }
-  const bool has_padding = (buffer[0] & 0x20) != 0;
-  const bool has_extension = (buffer[0] & 0x10) != 0;
-  const uint8_t number_of_crcs = buffer[0] & 0x0f;
-  marker_ = (buffer[1] & 0x80) != 0;
-  payload_type_ = buffer[1] & 0x7f;
-
-  sequence_number_ = ByteReader<uint16_t>::ReadBigEndian(&buffer[2]);
-  timestamp_ = ByteReader<uint32_t>::ReadBigEndian(&buffer[4]);
-  ssrc_ = ByteReader<uint32_t>::ReadBigEndian(&buffer[8]);
-  if (size < kFixedHeaderSize + number_of_crcs * 4) {
-    return false;
-  }
-  payload_offset_ = kFixedHeaderSize + number_of_crcs * 4;
-
-  if (has_padding) {
-    padding_size_ = buffer[size - 1];
-    if (padding_size_ == 0) {
-      LOG(LS_WARNING) << "Padding was set, but padding size is zero";
-      return false;
-    }
-  } else {
-    padding_size_ = 0;
-  }
-
-  extensions_size_ = 0;
-  for (ExtensionInfo& location : extension_entries_) {
-    location.offset = 0;
-    location.length = 0;
-  }
-  if (has_extension) {
-    /* RTP header extension, RFC 3550.
-     0                   1                   2                   3
-     0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
-    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    |      defined by profile       |           length              |
-    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    |                        header extension                       |
-    |                             ....                              |
-    */
-    size_t extension_offset = payload_offset_ + 4;
-    if (extension_offset > size) {
-      return false;
-    }
-    uint16_t profile =
-        ByteReader<uint16_t>::ReadBigEndian(&buffer[payload_offset_]);
-    size_t extensions_capacity =
-        ByteReader<uint16_t>::ReadBigEndian(&buffer[payload_offset_ + 2]);
-    extensions_capacity *= 4;
-    if (extension_offset + extensions_capacity > size) {
-      return false;
-    }
-    if (profile != kOneByteExtensionId) {
-      LOG(LS_WARNING) << "Unsupported rtp extension " << profile;
-    } else {
-      constexpr uint8_t kPaddingId = 0;
-      constexpr uint8_t kReservedId = 15;
-      while (extensions_size_ + kOneByteHeaderSize < extensions_capacity) {
-        int id = buffer[extension_offset + extensions_size_] >> 4;
-        if (id == kReservedId) {
-          break;
-        } else if (id == kPaddingId) {
-          extensions_size_++;
-          continue;
-        }
-        uint8_t length =
-            1 + (buffer[extension_offset + extensions_size_] & 0xf);
-        if (extensions_size_ + kOneByteHeaderSize + length >
-            extensions_capacity) {
-          LOG(LS_WARNING) << "Oversized rtp header extension.";
-          break;
-        }
-
-        size_t idx = id - 1;
-        if (extension_entries_[idx].length != 0) {
-          LOG(LS_VERBOSE) << "Duplicate rtp header extension id " << id
-                          << ". Overwriting.";
-        }
-
-        extensions_size_ += kOneByteHeaderSize;
-        extension_entries_[idx].offset = extension_offset + extensions_size_;
-        extension_entries_[idx].length = length;
-        extensions_size_ += length;
-      }
-    }
-    payload_offset_ = extension_offset + extensions_capacity;
-  }
+  ApplyLayout(layout);
+  return true;
+}
 
-  if (payload_offset_ + padding_size_ > size) {
-    return false;
+void Packet::ApplyLayout(const HeaderLayout& layout) {
+  RTC_DCHECK(layout.valid);
+  marker_ = layout.marker;
+  payload_type_ = layout.payload_type;
+  padding_size_ = layout.padding_size;
+  sequence_number_ = layout.sequence_number;
+  timestamp_ = layout.timestamp;
+  ssrc_ = layout.ssrc;
+  payload_offset_ = layout.payload_offset;
+  payload_size_ = layout.payload_size;
+  extensions_size_ = layout.extensions_size;
+  for (size_t i = 0; i < kMaxExtensionHeaders; ++i) {
+    extension_entries_[i].offset = layout.extension_offset[i];
+    extension_entries_[i].length = layout.extension_length[i];
   }
-  payload_size_ = size - payload_offset_ - padding_size_;
-  return true;
 }
 
 bool Packet::FindExtension(ExtensionType type,
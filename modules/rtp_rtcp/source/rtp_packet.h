@@ -23,6 +23,8 @@ class RtpHeaderExtensionMap;
 class Random;
 
 namespace rtp {
+struct HeaderLayout;
+
 class Packet {
  public:
   using ExtensionType = RTPExtensionType;
@@ -36,6 +38,11 @@ class Packet {
   // Parse and move given buffer into Packet.
   bool Parse(rtc::CopyOnWriteBuffer packet);
 
+  // Move given buffer into Packet, taking the header fields from |layout|
+  // instead of parsing them. |layout| must have been produced by
+  // ParseHeaderLayout(s) for the same bytes.
+  bool Parse(rtc::CopyOnWriteBuffer packet, const HeaderLayout& layout);
+
   // Maps extensions id to their types.
   void IdentifyExtensions(const ExtensionManager& extensions);
 
@@ -124,6 +131,9 @@ class Packet {
   // but does not touch packet own buffer, leaving packet in invalid state.
   bool ParseBuffer(const uint8_t* buffer, size_t size);
 
+  // Fill header fields from an already parsed |layout|.
+  void ApplyLayout(const HeaderLayout& layout);
+
   // Find an extension based on the type field of the parameter.
   // If found, length and the offset field will be set and true returned,
   // otherwise the parameter will be unchanged and false is returned.
@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_parser.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace rtp {
+namespace {
+constexpr size_t kFixedHeaderSize = 12;
+constexpr uint8_t kRtpVersion = 2;
+constexpr uint16_t kOneByteExtensionId = 0xBEDE;
+constexpr size_t kOneByteHeaderSize = 1;
+// Number of packets whose fixed headers are validated per kernel call.
+constexpr size_t kBatchSize = 64;
+
+typedef void (*ValidateFixedHeadersFunction)(const uint8_t* first_bytes,
+                                             const uint16_t* sizes,
+                                             size_t count,
+                                             uint16_t* min_sizes);
+
+ValidateFixedHeadersFunction SelectValidateFixedHeaders() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2))
+    return &ValidateFixedHeaders_AVX2;
+  if (WebRtc_GetCPUInfo(kSSE2))
+    return &ValidateFixedHeaders_SSE2;
+  return &ValidateFixedHeaders_C;
+#elif defined(WEBRTC_HAS_NEON)
+  return &ValidateFixedHeaders_NEON;
+#else
+  return &ValidateFixedHeaders_C;
+#endif
+}
+
+uint16_t SaturatedSize(size_t size) {
+  return static_cast<uint16_t>(std::min<size_t>(size, 0xffff));
+}
+
+// Parses the rest of a packet whose fixed header already passed
+// ValidateFixedHeaders, i.e. the version is correct and |size| covers the
+// fixed header, the CSRCs and, if present, the extension header word.
+bool ParseValidatedHeader(const uint8_t* buffer,
+                          size_t size,
+                          HeaderLayout* layout) {
+  const bool has_padding = (buffer[0] & 0x20) != 0;
+  const bool has_extension = (buffer[0] & 0x10) != 0;
+  const uint8_t number_of_crcs = buffer[0] & 0x0f;
+  layout->marker = (buffer[1] & 0x80) != 0;
+  layout->payload_type = buffer[1] & 0x7f;
+  layout->sequence_number = ByteReader<uint16_t>::ReadBigEndian(&buffer[2]);
+  layout->timestamp = ByteReader<uint32_t>::ReadBigEndian(&buffer[4]);
+  layout->ssrc = ByteReader<uint32_t>::ReadBigEndian(&buffer[8]);
+  layout->payload_offset = kFixedHeaderSize + number_of_crcs * 4;
+
+  if (has_padding) {
+    layout->padding_size = buffer[size - 1];
+    if (layout->padding_size == 0) {
+      LOG(LS_WARNING) << "Padding was set, but padding size is zero";
+      return false;
+    }
+  } else {
+    layout->padding_size = 0;
+  }
+
+  layout->extensions_size = 0;
+  std::fill(layout->extension_offset,
+            layout->extension_offset + HeaderLayout::kMaxExtensionHeaders, 0);
+  std::fill(layout->extension_length,
+            layout->extension_length + HeaderLayout::kMaxExtensionHeaders, 0);
+  if (has_extension) {
+    size_t extension_offset = layout->payload_offset + 4;
+    RTC_DCHECK_LE(extension_offset, size);
+    uint16_t profile =
+        ByteReader<uint16_t>::ReadBigEndian(&buffer[layout->payload_offset]);
+    size_t extensions_capacity =
+        ByteReader<uint16_t>::ReadBigEndian(&buffer[layout->payload_offset + 2]);
+    extensions_capacity *= 4;
+    if (extension_offset + extensions_capacity > size) {
+      return false;
+    }
+    if (profile != kOneByteExtensionId) {
+      LOG(LS_WARNING) << "Unsupported rtp extension " << profile;
+    } else {
+      constexpr uint8_t kPaddingId = 0;
+      constexpr uint8_t kReservedId = 15;
+      const uint8_t* extensions = buffer + extension_offset;
+      size_t extensions_size = 0;
+      while (extensions_size + kOneByteHeaderSize < extensions_capacity) {
+        int id = extensions[extensions_size] >> 4;
+        if (id == kReservedId) {
+          break;
+        } else if (id == kPaddingId) {
+          extensions_size++;
+          continue;
+        }
+        uint8_t length = 1 + (extensions[extensions_size] & 0xf);
+        if (extensions_size + kOneByteHeaderSize + length >
+            extensions_capacity) {
+          LOG(LS_WARNING) << "Oversized rtp header extension.";
+          break;
+        }
+
+        size_t idx = id - 1;
+        if (layout->extension_length[idx] != 0) {
+          LOG(LS_VERBOSE) << "Duplicate rtp header extension id " << id
+                          << ". Overwriting.";
+        }
+
+        extensions_size += kOneByteHeaderSize;
+        layout->extension_offset[idx] = extension_offset + extensions_size;
+        layout->extension_length[idx] = length;
+        extensions_size += length;
+      }
+      layout->extensions_size = extensions_size;
+    }
+    layout->payload_offset = extension_offset + extensions_capacity;
+  }
+
+  if (layout->payload_offset + layout->padding_size > size) {
+    return false;
+  }
+  layout->payload_size =
+      size - layout->payload_offset - layout->padding_size;
+  return true;
+}
+
+}  // namespace
+
+void ValidateFixedHeaders_C(const uint8_t* first_bytes,
+                            const uint16_t* sizes,
+                            size_t count,
+                            uint16_t* min_sizes) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint8_t first_byte = first_bytes[i];
+    const uint16_t min_size = kFixedHeaderSize + (first_byte & 0x0f) * 4 +
+                              ((first_byte & 0x10) ? 4 : 0);
+    const bool valid =
+        (first_byte >> 6) == kRtpVersion && sizes[i] >= min_size;
+    min_sizes[i] = valid ? min_size : 0;
+  }
+}
+
+bool ParseHeaderLayout(const uint8_t* buffer,
+                       size_t size,
+                       HeaderLayout* layout) {
+  RTC_DCHECK(layout);
+  layout->valid = false;
+  if (size < kFixedHeaderSize)
+    return false;
+  const uint16_t saturated_size = SaturatedSize(size);
+  uint16_t min_size;
+  ValidateFixedHeaders_C(buffer, &saturated_size, 1, &min_size);
+  if (min_size == 0)
+    return false;
+  layout->valid = ParseValidatedHeader(buffer, size, layout);
+  return layout->valid;
+}
+
+size_t ParseHeaderLayouts(
+    rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+    HeaderLayout* layouts) {
+  static const ValidateFixedHeadersFunction validate_fixed_headers =
+      SelectValidateFixedHeaders();
+  RTC_DCHECK(layouts || packets.empty());
+
+  uint8_t first_bytes[kBatchSize];
+  uint16_t sizes[kBatchSize];
+  uint16_t min_sizes[kBatchSize];
+  size_t num_valid = 0;
+  for (size_t begin = 0; begin < packets.size(); begin += kBatchSize) {
+    const size_t count = std::min(kBatchSize, packets.size() - begin);
+    for (size_t i = 0; i < count; ++i) {
+      const rtc::ArrayView<const uint8_t>& packet = packets[begin + i];
+      // A packet too short to hold the first byte fails on its size alone.
+      first_bytes[i] = packet.empty() ? 0 : packet[0];
+      sizes[i] = SaturatedSize(packet.size());
+    }
+    validate_fixed_headers(first_bytes, sizes, count, min_sizes);
+    for (size_t i = 0; i < count; ++i) {
+      const rtc::ArrayView<const uint8_t>& packet = packets[begin + i];
+      HeaderLayout* layout = &layouts[begin + i];
+      layout->valid = min_sizes[i] != 0 &&
+                      ParseValidatedHeader(packet.data(), packet.size(),
+                                           layout);
+      if (layout->valid)
+        ++num_valid;
+    }
+  }
+  return num_valid;
+}
+
+}  // namespace rtp
+}  // namespace webrtc
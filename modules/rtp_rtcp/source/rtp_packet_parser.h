@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_PARSER_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_PARSER_H_
+
+#include <stddef.h>
+
+#include "webrtc/base/array_view.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace rtp {
+
+// Location of the header fields and one-byte header extensions of an RTP
+// packet inside its buffer, found by a single pass over the header.
+// rtp::Packet adopts a layout without walking the header again, so a packet
+// parsed as part of a batch is never re-parsed further down the pipeline.
+struct HeaderLayout {
+  static constexpr size_t kMaxExtensionHeaders = 14;
+
+  bool valid = false;
+  bool marker = false;
+  uint8_t payload_type = 0;
+  uint8_t padding_size = 0;
+  uint16_t sequence_number = 0;
+  uint32_t timestamp = 0;
+  uint32_t ssrc = 0;
+  size_t payload_offset = 0;
+  size_t payload_size = 0;
+  uint16_t extensions_size = 0;
+  // Indexed by one-byte extension id - 1. Zero length marks an absent id.
+  uint16_t extension_offset[kMaxExtensionHeaders] = {};
+  uint8_t extension_length[kMaxExtensionHeaders] = {};
+};
+
+// Fills |layout| from the |size| bytes at |buffer|. Returns false, with
+// |layout->valid| unset, if the bytes are not a well-formed RTP packet.
+bool ParseHeaderLayout(const uint8_t* buffer, size_t size, HeaderLayout* layout);
+
+// Batch version of ParseHeaderLayout. The fixed headers of all |packets| are
+// first validated together on the widest SIMD path the CPU supports; CSRCs,
+// header extensions and padding are then located for the packets that passed.
+// |layouts| must have room for |packets.size()| entries.
+// Returns the number of valid packets. Call delivers packets one at a time
+// through ParseHeaderLayout(); this is for callers which already hold many
+// packets, such as tools reading RTP dumps.
+size_t ParseHeaderLayouts(
+    rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+    HeaderLayout* layouts);
+
+// Fixed header validation kernels used by ParseHeaderLayouts. For each of the
+// |count| packets, given the first header byte and the packet size (saturated
+// to 0xffff), writes the minimum size implied by the CSRC count and extension
+// bit into |min_sizes|, or 0 if the version is not 2 or the packet is shorter
+// than that minimum.
+void ValidateFixedHeaders_C(const uint8_t* first_bytes,
+                            const uint16_t* sizes,
+                            size_t count,
+                            uint16_t* min_sizes);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void ValidateFixedHeaders_SSE2(const uint8_t* first_bytes,
+                               const uint16_t* sizes,
+                               size_t count,
+                               uint16_t* min_sizes);
+void ValidateFixedHeaders_AVX2(const uint8_t* first_bytes,
+                               const uint16_t* sizes,
+                               size_t count,
+                               uint16_t* min_sizes);
+#endif
+#if defined(WEBRTC_HAS_NEON)
+void ValidateFixedHeaders_NEON(const uint8_t* first_bytes,
+                               const uint16_t* sizes,
+                               size_t count,
+                               uint16_t* min_sizes);
+#endif
+
+}  // namespace rtp
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_PARSER_H_
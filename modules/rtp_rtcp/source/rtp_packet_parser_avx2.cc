@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_parser.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+namespace rtp {
+
+// Same as ValidateFixedHeaders_SSE2, sixteen packets per iteration.
+void ValidateFixedHeaders_AVX2(const uint8_t* first_bytes,
+                               const uint16_t* sizes,
+                               size_t count,
+                               uint16_t* min_sizes) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i version_2 = _mm256_set1_epi16(2);
+  const __m256i csrc_count_mask = _mm256_set1_epi16(0x0f);
+  const __m256i extension_bit = _mm256_set1_epi16(0x10);
+  const __m256i fixed_header_size = _mm256_set1_epi16(12);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i first = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(first_bytes + i)));
+    const __m256i size =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sizes + i));
+    const __m256i csrc_bytes =
+        _mm256_slli_epi16(_mm256_and_si256(first, csrc_count_mask), 2);
+    const __m256i extension_bytes =
+        _mm256_srli_epi16(_mm256_and_si256(first, extension_bit), 2);
+    const __m256i min_size = _mm256_add_epi16(
+        fixed_header_size, _mm256_add_epi16(csrc_bytes, extension_bytes));
+    const __m256i version_ok =
+        _mm256_cmpeq_epi16(_mm256_srli_epi16(first, 6), version_2);
+    const __m256i size_ok =
+        _mm256_cmpeq_epi16(_mm256_subs_epu16(min_size, size), zero);
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(min_sizes + i),
+        _mm256_and_si256(min_size, _mm256_and_si256(version_ok, size_ok)));
+  }
+  ValidateFixedHeaders_C(first_bytes + i, sizes + i, count - i,
+                         min_sizes + i);
+}
+
+}  // namespace rtp
+}  // namespace webrtc
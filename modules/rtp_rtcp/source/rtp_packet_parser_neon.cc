@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_parser.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+namespace rtp {
+
+// Same as ValidateFixedHeaders_SSE2, eight packets per iteration.
+void ValidateFixedHeaders_NEON(const uint8_t* first_bytes,
+                               const uint16_t* sizes,
+                               size_t count,
+                               uint16_t* min_sizes) {
+  const uint16x8_t version_2 = vdupq_n_u16(2);
+  const uint16x8_t csrc_count_mask = vdupq_n_u16(0x0f);
+  const uint16x8_t extension_bit = vdupq_n_u16(0x10);
+  const uint16x8_t fixed_header_size = vdupq_n_u16(12);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const uint16x8_t first = vmovl_u8(vld1_u8(first_bytes + i));
+    const uint16x8_t size = vld1q_u16(sizes + i);
+    const uint16x8_t csrc_bytes =
+        vshlq_n_u16(vandq_u16(first, csrc_count_mask), 2);
+    const uint16x8_t extension_bytes =
+        vshrq_n_u16(vandq_u16(first, extension_bit), 2);
+    const uint16x8_t min_size =
+        vaddq_u16(fixed_header_size, vaddq_u16(csrc_bytes, extension_bytes));
+    const uint16x8_t version_ok = vceqq_u16(vshrq_n_u16(first, 6), version_2);
+    const uint16x8_t size_ok = vcleq_u16(min_size, size);
+    vst1q_u16(min_sizes + i,
+              vandq_u16(min_size, vandq_u16(version_ok, size_ok)));
+  }
+  ValidateFixedHeaders_C(first_bytes + i, sizes + i, count - i,
+                         min_sizes + i);
+}
+
+}  // namespace rtp
+}  // namespace webrtc
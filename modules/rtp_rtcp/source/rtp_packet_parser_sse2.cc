@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_parser.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+namespace rtp {
+
+// Validates eight packets per iteration in 16-bit lanes.
+void ValidateFixedHeaders_SSE2(const uint8_t* first_bytes,
+                               const uint16_t* sizes,
+                               size_t count,
+                               uint16_t* min_sizes) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i version_2 = _mm_set1_epi16(2);
+  const __m128i csrc_count_mask = _mm_set1_epi16(0x0f);
+  const __m128i extension_bit = _mm_set1_epi16(0x10);
+  const __m128i fixed_header_size = _mm_set1_epi16(12);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i first = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(first_bytes + i)),
+        zero);
+    const __m128i size =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(sizes + i));
+    // 12 + 4 * CC, plus 4 for the extension header word if X is set.
+    const __m128i csrc_bytes =
+        _mm_slli_epi16(_mm_and_si128(first, csrc_count_mask), 2);
+    const __m128i extension_bytes =
+        _mm_srli_epi16(_mm_and_si128(first, extension_bit), 2);
+    const __m128i min_size = _mm_add_epi16(
+        fixed_header_size, _mm_add_epi16(csrc_bytes, extension_bytes));
+    const __m128i version_ok =
+        _mm_cmpeq_epi16(_mm_srli_epi16(first, 6), version_2);
+    // Unsigned |min_size| <= |size| iff the saturated difference is zero.
+    const __m128i size_ok =
+        _mm_cmpeq_epi16(_mm_subs_epu16(min_size, size), zero);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(min_sizes + i),
+        _mm_and_si128(min_size, _mm_and_si128(version_ok, size_ok)));
+  }
+  ValidateFixedHeaders_C(first_bytes + i, sizes + i, count - i,
+                         min_sizes + i);
+}
+
+}  // namespace rtp
+}  // namespace webrtc
@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_parser.h"
+
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_header_extension.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/simd_kernels.h"
+
+namespace webrtc {
+namespace rtp {
+namespace {
+constexpr uint8_t kPayloadType = 100;
+constexpr uint16_t kSeqNum = 88;
+constexpr uint8_t kTransmissionOffsetExtensionId = 1;
+constexpr uint8_t kAudioLevelExtensionId = 9;
+// clang-format off
+constexpr uint8_t kPacketWithTOAndAL[] = {
+    0x90, kPayloadType, 0x00, kSeqNum,
+    0x65, 0x43, 0x12, 0x78,
+    0x12, 0x34, 0x56, 0x78,
+    0xbe, 0xde, 0x00, 0x02,
+    0x12, 0x00, 0x56, 0xce,
+    0x90, 0x80 | 0x5a, 0x00, 0x00};
+constexpr uint8_t kPacketWithCsrcsAndPadding[] = {
+    0xa2, kPayloadType, 0x00, kSeqNum,
+    0x65, 0x43, 0x12, 0x78,
+    0x12, 0x34, 0x56, 0x78,
+    0x34, 0x56, 0x78, 0x90,
+    0x32, 0x43, 0x54, 0x65,
+    'p', 'a', 'y', 'l', 'o', 'a', 'd',
+    0x00, 0x00, 0x00, 0x04};
+constexpr uint8_t kPacketWithBadVersion[] = {
+    0x40, kPayloadType, 0x00, kSeqNum,
+    0x65, 0x43, 0x12, 0x78,
+    0x12, 0x34, 0x56, 0x78};
+// clang-format on
+
+void ExpectSameLayout(const HeaderLayout& expected,
+                      const HeaderLayout& actual) {
+  ASSERT_EQ(expected.valid, actual.valid);
+  if (!expected.valid)
+    return;
+  EXPECT_EQ(expected.marker, actual.marker);
+  EXPECT_EQ(expected.payload_type, actual.payload_type);
+  EXPECT_EQ(expected.padding_size, actual.padding_size);
+  EXPECT_EQ(expected.sequence_number, actual.sequence_number);
+  EXPECT_EQ(expected.timestamp, actual.timestamp);
+  EXPECT_EQ(expected.ssrc, actual.ssrc);
+  EXPECT_EQ(expected.payload_offset, actual.payload_offset);
+  EXPECT_EQ(expected.payload_size, actual.payload_size);
+  EXPECT_EQ(expected.extensions_size, actual.extensions_size);
+  for (size_t i = 0; i < HeaderLayout::kMaxExtensionHeaders; ++i) {
+    EXPECT_EQ(expected.extension_offset[i], actual.extension_offset[i]);
+    EXPECT_EQ(expected.extension_length[i], actual.extension_length[i]);
+  }
+}
+
+typedef void (*ValidateFixedHeadersFunction)(const uint8_t*,
+                                             const uint16_t*,
+                                             size_t,
+                                             uint16_t*);
+
+void ExpectKernelMatchesC(ValidateFixedHeadersFunction kernel) {
+  // Every first byte against sizes around all the possible minimum sizes,
+  // with a count that leaves a scalar tail.
+  std::vector<uint8_t> first_bytes;
+  std::vector<uint16_t> sizes;
+  for (int first_byte = 0; first_byte < 256; ++first_byte) {
+    for (uint16_t size : {0, 1, 11, 12, 15, 16, 17, 75, 76, 77, 1500, 0xffff}) {
+      first_bytes.push_back(first_byte);
+      sizes.push_back(size);
+    }
+  }
+  first_bytes.resize(first_bytes.size() - 3);
+  sizes.resize(sizes.size() - 3);
+  std::vector<uint16_t> expected(sizes.size());
+  std::vector<uint16_t> actual(sizes.size());
+  ValidateFixedHeaders_C(first_bytes.data(), sizes.data(), sizes.size(),
+                         expected.data());
+  kernel(first_bytes.data(), sizes.data(), sizes.size(), actual.data());
+  EXPECT_EQ(expected, actual);
+}
+}  // namespace
+
+TEST(RtpPacketParserTest, ParsesExtensionsAndPadding) {
+  HeaderLayout layout;
+  ASSERT_TRUE(ParseHeaderLayout(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL),
+                                &layout));
+  EXPECT_EQ(kSeqNum, layout.sequence_number);
+  EXPECT_EQ(0x65431278u, layout.timestamp);
+  EXPECT_EQ(0x12345678u, layout.ssrc);
+  EXPECT_EQ(sizeof(kPacketWithTOAndAL), layout.payload_offset);
+  EXPECT_EQ(3u, layout.extension_length[kTransmissionOffsetExtensionId - 1]);
+  EXPECT_EQ(17u, layout.extension_offset[kTransmissionOffsetExtensionId - 1]);
+  EXPECT_EQ(1u, layout.extension_length[kAudioLevelExtensionId - 1]);
+  EXPECT_EQ(21u, layout.extension_offset[kAudioLevelExtensionId - 1]);
+
+  ASSERT_TRUE(ParseHeaderLayout(kPacketWithCsrcsAndPadding,
+                                sizeof(kPacketWithCsrcsAndPadding), &layout));
+  EXPECT_EQ(20u, layout.payload_offset);
+  EXPECT_EQ(7u, layout.payload_size);
+  EXPECT_EQ(4u, layout.padding_size);
+
+  EXPECT_FALSE(ParseHeaderLayout(kPacketWithBadVersion,
+                                 sizeof(kPacketWithBadVersion), &layout));
+  EXPECT_FALSE(layout.valid);
+  EXPECT_FALSE(ParseHeaderLayout(kPacketWithTOAndAL, 14, &layout));
+}
+
+TEST(RtpPacketParserTest, BatchMatchesSinglePacketParse) {
+  Random random(0x1234567);
+  std::vector<std::vector<uint8_t>> buffers;
+  for (int i = 0; i < 1000; ++i) {
+    // Start from a valid packet and flip random bits, so that the batch sees a
+    // mix of good packets and packets rejected at every stage.
+    const uint8_t* source = (i % 2) ? kPacketWithTOAndAL
+                                    : kPacketWithCsrcsAndPadding;
+    size_t size = (i % 2) ? sizeof(kPacketWithTOAndAL)
+                          : sizeof(kPacketWithCsrcsAndPadding);
+    std::vector<uint8_t> buffer(source, source + size);
+    if (random.Rand(3) == 0)
+      buffer[random.Rand(size - 1)] ^= 1 << random.Rand(7);
+    if (random.Rand(5) == 0)
+      buffer.resize(random.Rand(size));
+    buffers.push_back(buffer);
+  }
+  std::vector<rtc::ArrayView<const uint8_t>> packets;
+  for (const auto& buffer : buffers)
+    packets.push_back(buffer);
+
+  std::vector<HeaderLayout> layouts(packets.size());
+  size_t num_valid = ParseHeaderLayouts(packets, layouts.data());
+  size_t expected_num_valid = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    HeaderLayout expected;
+    if (ParseHeaderLayout(packets[i].data(), packets[i].size(), &expected))
+      ++expected_num_valid;
+    ExpectSameLayout(expected, layouts[i]);
+  }
+  EXPECT_EQ(expected_num_valid, num_valid);
+  EXPECT_GT(num_valid, 0u);
+  EXPECT_LT(num_valid, packets.size());
+}
+
+TEST(RtpPacketParserTest, PacketAdoptsLayoutWithoutReparsing) {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransmissionOffset>(kTransmissionOffsetExtensionId);
+  extensions.Register<AudioLevel>(kAudioLevelExtensionId);
+
+  HeaderLayout layout;
+  rtc::ArrayView<const uint8_t> packets[] = {kPacketWithTOAndAL};
+  ASSERT_EQ(1u, ParseHeaderLayouts(packets, &layout));
+
+  RtpPacketReceived packet(&extensions);
+  ASSERT_TRUE(packet.Parse(
+      rtc::CopyOnWriteBuffer(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL)),
+      layout));
+  RtpPacketReceived reference(&extensions);
+  ASSERT_TRUE(reference.Parse(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL)));
+
+  EXPECT_EQ(reference.SequenceNumber(), packet.SequenceNumber());
+  EXPECT_EQ(reference.headers_size(), packet.headers_size());
+  int32_t time_offset = 0;
+  EXPECT_TRUE(packet.GetExtension<TransmissionOffset>(&time_offset));
+  EXPECT_EQ(0x56ce, time_offset);
+  bool voice_active = false;
+  uint8_t audio_level = 0;
+  EXPECT_TRUE(packet.GetExtension<AudioLevel>(&voice_active, &audio_level));
+  EXPECT_EQ(0x5a, audio_level);
+
+  layout.valid = false;
+  EXPECT_FALSE(packet.Parse(
+      rtc::CopyOnWriteBuffer(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL)),
+      layout));
+}
+
+TEST(RtpPacketParserTest, SimdKernelsMatchC) {
+  for (const auto& simd :
+       test::SupportedSimdKernels<ValidateFixedHeadersFunction>(
+           WEBRTC_X86_KERNEL(&ValidateFixedHeaders_SSE2),
+           WEBRTC_X86_KERNEL(&ValidateFixedHeaders_AVX2),
+           WEBRTC_NEON_KERNEL(&ValidateFixedHeaders_NEON))) {
+    SCOPED_TRACE(simd.instruction_set);
+    ExpectKernelMatchesC(simd.kernel);
+  }
+}
+
+}  // namespace rtp
+}  // namespace webrtc
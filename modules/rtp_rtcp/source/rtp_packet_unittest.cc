@@ -13,6 +13,7 @@
 #include "webrtc/base/random.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extension.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/test/gmock.h"
 #include "webrtc/test/gtest.h"
 
@@ -75,7 +76,77 @@ constexpr uint8_t kPacketWithInvalidExtension[] = {
      'd',  'a',  't',  'a',                     // expected to be 3-bytes.
      'p',  'a',  'y',  'l',  'o',  'a',  'd'
 };
+
+constexpr uint8_t kPlayoutDelayExtensionId = 2;
+constexpr uint8_t kFrameMarkingExtensionId = 3;
+constexpr uint8_t kPacketWithPlayoutDelayAndFrameMarking[] = {
+    0x90, kPayloadType, 0x00, kSeqNum,
+    0x65, 0x43, 0x12, 0x78,
+    0x12, 0x34, 0x56, 0x78,
+    0xbe, 0xde, 0x00, 0x03,
+    0x22, 0x00, 0xa0, 0xc8,  // Playout delay 100 ms to 2000 ms.
+    0x30, 0xe0,              // Frame marking, non-scalable, S, E and I set.
+    0x12, 0x00, 0x56, 0xce,
+    0x00, 0x00,
+    'p', 'a', 'y', 'l', 'o', 'a', 'd'};
 // clang-format on
+
+RtpHeaderExtensionMap AllTestExtensions() {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register(kRtpExtensionTransmissionTimeOffset,
+                      kTransmissionOffsetExtensionId);
+  extensions.Register(kRtpExtensionAudioLevel, kAudioLevelExtensionId);
+  extensions.Register(kRtpExtensionPlayoutDelay, kPlayoutDelayExtensionId);
+  extensions.Register(kRtpExtensionFrameMarking, kFrameMarkingExtensionId);
+  return extensions;
+}
+
+// Parses |data| with both rtp::Packet and RtpHeaderParser, which the receive
+// streams used before, and expects the same RTPHeader from both.
+void ExpectSameHeaderAsRtpHeaderParser(const uint8_t* data, size_t size) {
+  RtpHeaderExtensionMap extensions = AllTestExtensions();
+  RTPHeader expected;
+  ASSERT_TRUE(RtpUtility::RtpHeaderParser(data, size)
+                  .Parse(&expected, &extensions));
+  RtpPacketReceived packet(&extensions);
+  ASSERT_TRUE(packet.Parse(data, size));
+  RTPHeader header;
+  packet.GetHeader(&header);
+
+  EXPECT_EQ(expected.markerBit, header.markerBit);
+  EXPECT_EQ(expected.payloadType, header.payloadType);
+  EXPECT_EQ(expected.sequenceNumber, header.sequenceNumber);
+  EXPECT_EQ(expected.timestamp, header.timestamp);
+  EXPECT_EQ(expected.ssrc, header.ssrc);
+  ASSERT_EQ(expected.numCSRCs, header.numCSRCs);
+  for (size_t i = 0; i < header.numCSRCs; ++i)
+    EXPECT_EQ(expected.arrOfCSRCs[i], header.arrOfCSRCs[i]);
+  EXPECT_EQ(expected.paddingLength, header.paddingLength);
+  EXPECT_EQ(expected.headerLength, header.headerLength);
+
+  const RTPHeaderExtension& expected_ext = expected.extension;
+  const RTPHeaderExtension& ext = header.extension;
+  EXPECT_EQ(expected_ext.hasTransmissionTimeOffset,
+            ext.hasTransmissionTimeOffset);
+  EXPECT_EQ(expected_ext.transmissionTimeOffset, ext.transmissionTimeOffset);
+  EXPECT_EQ(expected_ext.hasAudioLevel, ext.hasAudioLevel);
+  EXPECT_EQ(expected_ext.voiceActivity, ext.voiceActivity);
+  EXPECT_EQ(expected_ext.audioLevel, ext.audioLevel);
+  EXPECT_EQ(expected_ext.playout_delay.min_ms, ext.playout_delay.min_ms);
+  EXPECT_EQ(expected_ext.playout_delay.max_ms, ext.playout_delay.max_ms);
+  // RtpHeaderParser never sets |hasFrameMarks|, only the marks themselves.
+  EXPECT_EQ(expected_ext.frameMarks.startOfFrame, ext.frameMarks.startOfFrame);
+  EXPECT_EQ(expected_ext.frameMarks.endOfFrame, ext.frameMarks.endOfFrame);
+  EXPECT_EQ(expected_ext.frameMarks.independent, ext.frameMarks.independent);
+  EXPECT_EQ(expected_ext.frameMarks.discardable, ext.frameMarks.discardable);
+  EXPECT_EQ(expected_ext.frameMarks.baseLayerSync,
+            ext.frameMarks.baseLayerSync);
+  EXPECT_EQ(expected_ext.frameMarks.temporalLayerId,
+            ext.frameMarks.temporalLayerId);
+  EXPECT_EQ(expected_ext.frameMarks.spatialLayerId,
+            ext.frameMarks.spatialLayerId);
+  EXPECT_EQ(expected_ext.frameMarks.tl0PicIdx, ext.frameMarks.tl0PicIdx);
+}
 }  // namespace
 
 TEST(RtpPacketTest, CreateMinimum) {
@@ -300,4 +371,141 @@ TEST(RtpPacketTest, ParseWithExtensionDelayed) {
   EXPECT_EQ(0u, packet.padding_size());
 }
 
+TEST(RtpPacketTest, GetHeaderMatchesRtpHeaderParser) {
+  ExpectSameHeaderAsRtpHeaderParser(kMinimumPacket, sizeof(kMinimumPacket));
+  ExpectSameHeaderAsRtpHeaderParser(kPacketWithTOAndAL,
+                                    sizeof(kPacketWithTOAndAL));
+  // CSRCs and padding.
+  ExpectSameHeaderAsRtpHeaderParser(kPacket, sizeof(kPacket));
+  ExpectSameHeaderAsRtpHeaderParser(kPacketWithInvalidExtension,
+                                    sizeof(kPacketWithInvalidExtension));
+}
+
+TEST(RtpPacketTest, GetHeaderMatchesRtpHeaderParserForPlayoutDelay) {
+  ExpectSameHeaderAsRtpHeaderParser(
+      kPacketWithPlayoutDelayAndFrameMarking,
+      sizeof(kPacketWithPlayoutDelayAndFrameMarking));
+
+  RtpHeaderExtensionMap extensions = AllTestExtensions();
+  RtpPacketReceived packet(&extensions);
+  ASSERT_TRUE(packet.Parse(kPacketWithPlayoutDelayAndFrameMarking,
+                           sizeof(kPacketWithPlayoutDelayAndFrameMarking)));
+  RTPHeader header;
+  packet.GetHeader(&header);
+  EXPECT_EQ(100, header.extension.playout_delay.min_ms);
+  EXPECT_EQ(2000, header.extension.playout_delay.max_ms);
+  EXPECT_TRUE(header.extension.hasFrameMarks);
+  EXPECT_TRUE(header.extension.frameMarks.startOfFrame);
+  EXPECT_TRUE(header.extension.frameMarks.endOfFrame);
+  EXPECT_TRUE(header.extension.frameMarks.independent);
+  EXPECT_FALSE(header.extension.frameMarks.discardable);
+
+  // A reused header is reset like RtpHeaderParser does.
+  ASSERT_TRUE(packet.Parse(kMinimumPacket, sizeof(kMinimumPacket)));
+  packet.GetHeader(&header);
+  EXPECT_EQ(-1, header.extension.playout_delay.min_ms);
+  EXPECT_EQ(-1, header.extension.playout_delay.max_ms);
+  EXPECT_FALSE(header.extension.hasFrameMarks);
+}
+
+TEST(RtpPacketTest, GetHeaderMatchesRtpHeaderParserForEdgeCases) {
+  // clang-format off
+  // Two-byte header extension profile, which neither parser reads.
+  const uint8_t two_byte_extensions[] = {
+      0x90, kPayloadType, 0x00, kSeqNum,
+      0x65, 0x43, 0x12, 0x78,
+      0x12, 0x34, 0x56, 0x78,
+      0x10, 0x00, 0x00, 0x01,
+      0x01, 0x01, 0xaa, 0x00,
+      'p'};
+  // Extension id 15 ends the extension block.
+  const uint8_t terminated_extensions[] = {
+      0x90, kPayloadType, 0x00, kSeqNum,
+      0x65, 0x43, 0x12, 0x78,
+      0x12, 0x34, 0x56, 0x78,
+      0xbe, 0xde, 0x00, 0x02,
+      0xf0, 0x12, 0x00, 0x56,
+      0xce, 0x00, 0x00, 0x00};
+  // Padding bytes between extensions.
+  const uint8_t padded_extensions[] = {
+      0x90, kPayloadType, 0x00, kSeqNum,
+      0x65, 0x43, 0x12, 0x78,
+      0x12, 0x34, 0x56, 0x78,
+      0xbe, 0xde, 0x00, 0x02,
+      0x00, 0x00, 0x30, 0x80,
+      0x12, 0x00, 0x56, 0xce};
+  // Only padding after the header.
+  const uint8_t pure_padding[] = {
+      0xa0, kPayloadType, 0x00, kSeqNum,
+      0x65, 0x43, 0x12, 0x78,
+      0x12, 0x34, 0x56, 0x78,
+      0x00, 0x00, 0x00, 0x04};
+  // clang-format on
+  ExpectSameHeaderAsRtpHeaderParser(two_byte_extensions,
+                                    sizeof(two_byte_extensions));
+  ExpectSameHeaderAsRtpHeaderParser(terminated_extensions,
+                                    sizeof(terminated_extensions));
+  ExpectSameHeaderAsRtpHeaderParser(padded_extensions,
+                                    sizeof(padded_extensions));
+  ExpectSameHeaderAsRtpHeaderParser(pure_padding, sizeof(pure_padding));
+}
+
+// Where the parsers differ, on packets which are not valid. Call hands packets
+// rtp::Packet rejects to the receive stream's own parser.
+TEST(RtpPacketTest, DiffersFromRtpHeaderParserOnInvalidPackets) {
+  RtpHeaderExtensionMap extensions = AllTestExtensions();
+  // clang-format off
+  // Padding bit set, but a padding size of zero.
+  const uint8_t zero_padding[] = {
+      0xa0, kPayloadType, 0x00, kSeqNum,
+      0x65, 0x43, 0x12, 0x78,
+      0x12, 0x34, 0x56, 0x78,
+      'p', 0x00};
+  // Minimum playout delay above the maximum.
+  const uint8_t inverted_playout_delay[] = {
+      0x90, kPayloadType, 0x00, kSeqNum,
+      0x65, 0x43, 0x12, 0x78,
+      0x12, 0x34, 0x56, 0x78,
+      0xbe, 0xde, 0x00, 0x01,
+      0x22, 0x00, 0xc0, 0x0a};
+  // Frame marking of the wrong size, before a transmission offset.
+  const uint8_t wrong_size_frame_marking[] = {
+      0x90, kPayloadType, 0x00, kSeqNum,
+      0x65, 0x43, 0x12, 0x78,
+      0x12, 0x34, 0x56, 0x78,
+      0xbe, 0xde, 0x00, 0x02,
+      0x31, 0x80, 0x00, 0x12,
+      0x00, 0x56, 0xce, 0x00};
+  // clang-format on
+  RTPHeader header;
+  EXPECT_TRUE(RtpUtility::RtpHeaderParser(zero_padding, sizeof(zero_padding))
+                  .Parse(&header, &extensions));
+  RtpPacketReceived packet(&extensions);
+  EXPECT_FALSE(packet.Parse(zero_padding, sizeof(zero_padding)));
+
+  EXPECT_TRUE(RtpUtility::RtpHeaderParser(inverted_playout_delay,
+                                          sizeof(inverted_playout_delay))
+                  .Parse(&header, &extensions));
+  EXPECT_EQ(120, header.extension.playout_delay.min_ms);
+  EXPECT_EQ(100, header.extension.playout_delay.max_ms);
+  ASSERT_TRUE(packet.Parse(inverted_playout_delay,
+                           sizeof(inverted_playout_delay)));
+  packet.GetHeader(&header);
+  EXPECT_EQ(-1, header.extension.playout_delay.min_ms);
+  EXPECT_EQ(-1, header.extension.playout_delay.max_ms);
+
+  // RtpHeaderParser stops at the first extension of the wrong size, while
+  // rtp::Packet skips only that extension.
+  EXPECT_TRUE(RtpUtility::RtpHeaderParser(wrong_size_frame_marking,
+                                          sizeof(wrong_size_frame_marking))
+                  .Parse(&header, &extensions));
+  EXPECT_FALSE(header.extension.hasTransmissionTimeOffset);
+  ASSERT_TRUE(packet.Parse(wrong_size_frame_marking,
+                           sizeof(wrong_size_frame_marking)));
+  packet.GetHeader(&header);
+  EXPECT_FALSE(header.extension.hasFrameMarks);
+  EXPECT_TRUE(header.extension.hasTransmissionTimeOffset);
+  EXPECT_EQ(kTimeOffset, header.extension.transmissionTimeOffset);
+}
+
 }  // namespace webrtc
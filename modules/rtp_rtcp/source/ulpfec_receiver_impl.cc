@@ -85,7 +85,7 @@ int32_t UlpfecReceiverImpl::AddReceivedRedPacket(
   // Remove RED header of incoming packet and store as a virtual RTP packet.
   std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> received_packet(
       new ForwardErrorCorrection::ReceivedPacket());
-  received_packet->pkt = new ForwardErrorCorrection::Packet();
+  received_packet->pkt = fec_->AllocatePacket();
 
   // Get payload type from RED header and sequence number from RTP header.
   uint8_t payload_type = incoming_rtp_packet[header.headerLength] & 0x7f;
@@ -152,7 +152,7 @@ int32_t UlpfecReceiverImpl::AddReceivedRedPacket(
     received_packet->pkt->length = block_length;
 
     second_received_packet.reset(new ForwardErrorCorrection::ReceivedPacket);
-    second_received_packet->pkt = new ForwardErrorCorrection::Packet;
+    second_received_packet->pkt = fec_->AllocatePacket();
 
     second_received_packet->is_fec = true;
     second_received_packet->seq_num = header.sequenceNumber;
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/rtp_rtcp/include/flexfec_receiver.h"
+#include "webrtc/modules/rtp_rtcp/include/ulpfec_receiver.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+using Packet = ForwardErrorCorrection::Packet;
+
+constexpr int kNumStreams = 30;
+constexpr int kNumFrames = 60;
+constexpr int kMediaPacketsPerFrame = 10;
+constexpr size_t kMediaPacketSize = 1000;
+// About 30% protection, 3 FEC packets per frame.
+constexpr uint8_t kProtectionFactor = 77;
+constexpr int kLossPercent = 10;
+constexpr uint8_t kMediaPayloadType = 96;
+constexpr uint8_t kRedPayloadType = 127;
+constexpr uint8_t kUlpfecPayloadType = 117;
+constexpr uint8_t kFlexfecPayloadType = 118;
+constexpr uint32_t kFirstMediaSsrc = 1000;
+constexpr uint32_t kFirstFlexfecSsrc = 2000;
+
+class RecoveredPacketCounter : public RtpData, public RecoveredPacketReceiver {
+ public:
+  int32_t OnReceivedPayloadData(const uint8_t* payload_data,
+                                size_t payload_size,
+                                const WebRtcRTPHeader* rtp_header) override {
+    return 0;
+  }
+  bool OnRecoveredPacket(const uint8_t* packet, size_t length) override {
+    ++num_packets_;
+    return true;
+  }
+  int num_packets() const { return num_packets_; }
+
+ private:
+  int num_packets_ = 0;
+};
+
+void WriteRtpHeader(uint8_t payload_type,
+                    uint16_t seq_num,
+                    uint32_t timestamp,
+                    uint32_t ssrc,
+                    uint8_t* data) {
+  data[0] = 0x80;
+  data[1] = payload_type;
+  ByteWriter<uint16_t>::WriteBigEndian(&data[2], seq_num);
+  ByteWriter<uint32_t>::WriteBigEndian(&data[4], timestamp);
+  ByteWriter<uint32_t>::WriteBigEndian(&data[8], ssrc);
+}
+
+// One received RTP packet of one of the streams.
+struct ReceivedRtpPacket {
+  int stream;
+  std::vector<uint8_t> data;
+};
+
+// Builds the media and FEC packets of all streams, interleaved frame by frame
+// the way a bundled transport receives them, and drops |kLossPercent| of
+// them. With |use_red|, the media and ULPFEC packets share the RED stream;
+// otherwise the FEC packets are sent as a separate FlexFEC stream.
+std::vector<ReceivedRtpPacket> BuildReceivedPackets(bool use_red,
+                                                    Random* random) {
+  std::vector<std::unique_ptr<ForwardErrorCorrection>> encoders;
+  std::vector<uint16_t> media_seq_nums(kNumStreams, 0);
+  std::vector<uint16_t> fec_seq_nums(kNumStreams, 0);
+  for (int stream = 0; stream < kNumStreams; ++stream) {
+    encoders.push_back(use_red ? ForwardErrorCorrection::CreateUlpfec()
+                               : ForwardErrorCorrection::CreateFlexfec());
+  }
+
+  std::vector<ReceivedRtpPacket> received;
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    for (int stream = 0; stream < kNumStreams; ++stream) {
+      const uint32_t ssrc = kFirstMediaSsrc + stream;
+      const uint32_t timestamp = frame * 3000;
+      ForwardErrorCorrection::PacketList media_packets;
+      for (int i = 0; i < kMediaPacketsPerFrame; ++i) {
+        std::unique_ptr<Packet> packet(new Packet());
+        packet->length = kMediaPacketSize;
+        for (size_t j = kRtpHeaderSize; j < packet->length; ++j)
+          packet->data[j] = random->Rand<uint8_t>();
+        WriteRtpHeader(kMediaPayloadType, media_seq_nums[stream]++, timestamp,
+                       ssrc, packet->data);
+        media_packets.push_back(std::move(packet));
+      }
+      std::list<Packet*> fec_packets;
+      encoders[stream]->EncodeFec(media_packets, kProtectionFactor, 0, false,
+                                  kFecMaskRandom, &fec_packets);
+
+      std::vector<ReceivedRtpPacket> frame_packets;
+      for (const auto& media_packet : media_packets) {
+        ReceivedRtpPacket packet{stream, {}};
+        if (use_red) {
+          // RED header with the media payload type in front of the payload.
+          packet.data.assign(media_packet->data,
+                             media_packet->data + kRtpHeaderSize);
+          packet.data[1] = kRedPayloadType;
+          packet.data.push_back(kMediaPayloadType);
+          packet.data.insert(packet.data.end(),
+                             media_packet->data + kRtpHeaderSize,
+                             media_packet->data + media_packet->length);
+        } else {
+          packet.data.assign(media_packet->data,
+                             media_packet->data + media_packet->length);
+        }
+        frame_packets.push_back(std::move(packet));
+      }
+      for (const Packet* fec_packet : fec_packets) {
+        ReceivedRtpPacket packet{stream,
+                                 std::vector<uint8_t>(kRtpHeaderSize)};
+        if (use_red) {
+          WriteRtpHeader(kRedPayloadType, media_seq_nums[stream]++, timestamp,
+                         ssrc, packet.data.data());
+          packet.data.push_back(kUlpfecPayloadType);
+        } else {
+          WriteRtpHeader(kFlexfecPayloadType, fec_seq_nums[stream]++,
+                         timestamp, kFirstFlexfecSsrc + stream,
+                         packet.data.data());
+        }
+        packet.data.insert(packet.data.end(), fec_packet->data,
+                           fec_packet->data + fec_packet->length);
+        frame_packets.push_back(std::move(packet));
+      }
+
+      for (auto& packet : frame_packets) {
+        if (random->Rand(1, 100) > kLossPercent)
+          received.push_back(std::move(packet));
+      }
+    }
+  }
+  return received;
+}
+
+void ReportPacketRate(const std::string& trace,
+                      size_t num_packets,
+                      int64_t elapsed_ns) {
+  webrtc::test::PrintResult("fec_receiver", "_30_streams_10_percent_loss",
+                            trace,
+                            num_packets * rtc::kNumNanosecsPerSec /
+                                std::max<int64_t>(elapsed_ns, 1),
+                            "packets/s", true);
+}
+}  // namespace
+
+TEST(FecReceiverPerformanceTest, Ulpfec) {
+  Random random(0x10550);
+  const std::vector<ReceivedRtpPacket> packets =
+      BuildReceivedPackets(true, &random);
+  std::vector<RtpPacketReceived> parsed_packets(packets.size());
+  std::vector<RTPHeader> headers(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    ASSERT_TRUE(parsed_packets[i].Parse(packets[i].data.data(),
+                                        packets[i].data.size()));
+    parsed_packets[i].GetHeader(&headers[i]);
+  }
+
+  RecoveredPacketCounter counter;
+  std::vector<std::unique_ptr<UlpfecReceiver>> receivers;
+  for (int stream = 0; stream < kNumStreams; ++stream)
+    receivers.emplace_back(UlpfecReceiver::Create(&counter));
+
+  const int64_t start_ns = rtc::TimeNanos();
+  for (size_t i = 0; i < packets.size(); ++i) {
+    UlpfecReceiver* receiver = receivers[packets[i].stream].get();
+    receiver->AddReceivedRedPacket(headers[i], packets[i].data.data(),
+                                   packets[i].data.size(), kUlpfecPayloadType);
+    receiver->ProcessReceivedFec();
+  }
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+  // Received media packets are passed on too, on top of the recovered ones.
+  EXPECT_GT(counter.num_packets(), 0);
+  ReportPacketRate("ulpfec", packets.size(), elapsed_ns);
+}
+
+TEST(FecReceiverPerformanceTest, Flexfec) {
+  Random random(0xf1e8);
+  const std::vector<ReceivedRtpPacket> packets =
+      BuildReceivedPackets(false, &random);
+  std::vector<RtpPacketReceived> parsed_packets(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    ASSERT_TRUE(parsed_packets[i].Parse(packets[i].data.data(),
+                                        packets[i].data.size()));
+  }
+
+  RecoveredPacketCounter counter;
+  std::vector<std::unique_ptr<FlexfecReceiver>> receivers;
+  for (int stream = 0; stream < kNumStreams; ++stream) {
+    receivers.emplace_back(new FlexfecReceiver(
+        kFirstFlexfecSsrc + stream, kFirstMediaSsrc + stream, &counter));
+  }
+
+  const int64_t start_ns = rtc::TimeNanos();
+  for (size_t i = 0; i < packets.size(); ++i) {
+    receivers[packets[i].stream]->AddAndProcessReceivedPacket(
+        parsed_packets[i]);
+  }
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+  EXPECT_GT(counter.num_packets(), 0);
+  ReportPacketRate("flexfec", packets.size(), elapsed_ns);
+}
+
+}  // namespace webrtc
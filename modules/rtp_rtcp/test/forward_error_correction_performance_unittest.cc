@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr uint32_t kMediaSsrc = 0x12345678;
+constexpr size_t kPacketSize = 1200;
+constexpr uint8_t kProtectionFactor = 255;
+constexpr int kNumFrames = 2000;
+// The recovery loop builds its received packet lists up front, so that only
+// DecodeFec is timed.
+constexpr int kNumFramesPerBatch = 100;
+const int kNumMediaPackets[] = {1, 2, 4, 8, 12, 16, 24, 32, 48};
+
+ForwardErrorCorrection::PacketList BuildMediaPackets(int num_media_packets,
+                                                     Random* random) {
+  ForwardErrorCorrection::PacketList media_packets;
+  for (int i = 0; i < num_media_packets; ++i) {
+    std::unique_ptr<ForwardErrorCorrection::Packet> packet(
+        new ForwardErrorCorrection::Packet());
+    packet->length = kPacketSize;
+    for (size_t j = 0; j < packet->length; ++j)
+      packet->data[j] = random->Rand<uint8_t>();
+    packet->data[0] = 0x80;
+    packet->data[1] = 96;
+    ByteWriter<uint16_t>::WriteBigEndian(&packet->data[2], i);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet->data[4], 90000);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet->data[8], kMediaSsrc);
+    media_packets.push_back(std::move(packet));
+  }
+  return media_packets;
+}
+
+rtc::scoped_refptr<ForwardErrorCorrection::Packet> CopyPacket(
+    const ForwardErrorCorrection::Packet& packet) {
+  rtc::scoped_refptr<ForwardErrorCorrection::Packet> copy(
+      new ForwardErrorCorrection::Packet());
+  copy->length = packet.length;
+  memcpy(copy->data, packet.data, packet.length);
+  return copy;
+}
+
+void RunFecBenchmark(const std::string& scheme,
+                     std::unique_ptr<ForwardErrorCorrection> fec) {
+  Random random(0xfec);
+  for (int num_media_packets : kNumMediaPackets) {
+    const ForwardErrorCorrection::PacketList media_packets =
+        BuildMediaPackets(num_media_packets, &random);
+
+    std::list<ForwardErrorCorrection::Packet*> fec_packets;
+    int64_t start_ns = rtc::TimeNanos();
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+      fec_packets.clear();
+      fec->EncodeFec(media_packets, kProtectionFactor, 0, false,
+                     kFecMaskRandom, &fec_packets);
+    }
+    const int64_t generate_ns = rtc::TimeNanos() - start_ns;
+    ASSERT_FALSE(fec_packets.empty());
+
+    // Every frame loses its first media packet, which the first FEC packet
+    // covering it recovers.
+    std::vector<rtc::scoped_refptr<ForwardErrorCorrection::Packet>> received;
+    for (const auto& media_packet : media_packets) {
+      if (media_packet != media_packets.front())
+        received.push_back(CopyPacket(*media_packet));
+    }
+    const size_t num_received_media_packets = received.size();
+    for (const ForwardErrorCorrection::Packet* fec_packet : fec_packets)
+      received.push_back(CopyPacket(*fec_packet));
+
+    int64_t recover_ns = 0;
+    int num_recovered = 0;
+    ForwardErrorCorrection::RecoveredPacketList recovered_packets;
+    for (int batch = 0; batch < kNumFrames; batch += kNumFramesPerBatch) {
+      std::vector<ForwardErrorCorrection::ReceivedPacketList> frames(
+          kNumFramesPerBatch);
+      for (auto& received_packets : frames) {
+        for (size_t i = 0; i < received.size(); ++i) {
+          std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> packet(
+              new ForwardErrorCorrection::ReceivedPacket());
+          packet->pkt = received[i];
+          packet->is_fec = i >= num_received_media_packets;
+          packet->ssrc = kMediaSsrc;
+          packet->seq_num =
+              packet->is_fec
+                  ? static_cast<uint16_t>(num_media_packets + i -
+                                          num_received_media_packets)
+                  : ByteReader<uint16_t>::ReadBigEndian(&received[i]->data[2]);
+          received_packets.push_back(std::move(packet));
+        }
+      }
+      start_ns = rtc::TimeNanos();
+      for (auto& received_packets : frames) {
+        recovered_packets.clear();
+        fec->DecodeFec(&received_packets, &recovered_packets);
+        num_recovered += recovered_packets.front()->was_recovered;
+      }
+      recover_ns += rtc::TimeNanos() - start_ns;
+    }
+    EXPECT_EQ(kNumFrames, num_recovered);
+
+    const std::string trace = std::to_string(num_media_packets) + "_packets";
+    webrtc::test::PrintResult("fec_generate", "_" + scheme, trace,
+                              generate_ns / kNumFrames, "ns/frame", true);
+    webrtc::test::PrintResult("fec_recover", "_" + scheme, trace,
+                              recover_ns / kNumFrames, "ns/frame", true);
+  }
+}
+}  // namespace
+
+TEST(ForwardErrorCorrectionPerformanceTest, Ulpfec) {
+  RunFecBenchmark("ulpfec", ForwardErrorCorrection::CreateUlpfec());
+}
+
+TEST(ForwardErrorCorrectionPerformanceTest, Flexfec) {
+  RunFecBenchmark("flexfec", ForwardErrorCorrection::CreateFlexfec());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/modules/rtp_rtcp/include/receive_statistics.h"
+#include "webrtc/modules/rtp_rtcp/include/rtcp_aggregator.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumStreams = 300;
+constexpr int kDurationMs = 10000;
+constexpr size_t kMaxPacketSize = 1200;
+constexpr int64_t kFlushIntervalMs = 5;
+constexpr uint32_t kFirstLocalSsrc = 1000;
+constexpr uint32_t kFirstRemoteSsrc = 2000;
+
+// Counts the RTCP datagrams passed to it, and hands them on to |next|, if set.
+class CountingTransport : public Transport {
+ public:
+  explicit CountingTransport(Transport* next) : next_(next) {}
+
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override {
+    return true;
+  }
+  bool SendRtcp(const uint8_t* packet, size_t length) override {
+    ++num_packets_;
+    num_bytes_ += length;
+    return next_ ? next_->SendRtcp(packet, length) : true;
+  }
+
+  int num_packets() const { return num_packets_; }
+  size_t num_bytes() const { return num_bytes_; }
+
+ private:
+  Transport* const next_;
+  int num_packets_ = 0;
+  size_t num_bytes_ = 0;
+};
+
+// Runs receive streams on one bundled transport, each sending its periodic
+// receiver reports and |nacks_per_second| NACKs.
+void RunBundledReceiveStreams(int nacks_per_second, const std::string& trace) {
+  SimulatedClock clock(1000);
+  Random random(0x4ccc);
+  CountingTransport network(nullptr);
+  RtcpAggregator aggregator(&clock, &network, kMaxPacketSize,
+                            kFlushIntervalMs);
+  CountingTransport module_output(&aggregator);
+
+  std::vector<std::unique_ptr<ReceiveStatistics>> receive_statistics;
+  std::vector<std::unique_ptr<RtpRtcp>> modules;
+  for (int i = 0; i < kNumStreams; ++i) {
+    receive_statistics.emplace_back(ReceiveStatistics::Create(&clock));
+    RtpRtcp::Configuration config;
+    config.clock = &clock;
+    config.receiver_only = true;
+    config.receive_statistics = receive_statistics.back().get();
+    config.outgoing_transport = &module_output;
+    modules.emplace_back(RtpRtcp::CreateRtpRtcp(config));
+    modules.back()->SetSSRC(kFirstLocalSsrc + i);
+    modules.back()->SetRemoteSSRC(kFirstRemoteSsrc + i);
+    modules.back()->SetRTCPStatus(RtcpMode::kCompound);
+  }
+
+  std::vector<uint16_t> nack_list(1);
+  for (int ms = 0; ms < kDurationMs; ++ms) {
+    clock.AdvanceTimeMilliseconds(1);
+    for (auto& module : modules) {
+      if (module->TimeUntilNextProcess() <= 0)
+        module->Process();
+      if (random.Rand(1, 1000) <= nacks_per_second) {
+        ++nack_list[0];
+        module->SendNack(nack_list);
+      }
+    }
+    if (aggregator.TimeUntilNextProcess() <= 0)
+      aggregator.Process();
+  }
+  aggregator.Flush();
+
+  ASSERT_GT(module_output.num_packets(), 0);
+  EXPECT_EQ(module_output.num_bytes(), network.num_bytes());
+  // Totals over the run, since datagrams can be rare without loss.
+  webrtc::test::PrintResult("rtcp_aggregator", trace, "rtcp_packets",
+                            module_output.num_packets(), "packets", false);
+  webrtc::test::PrintResult("rtcp_aggregator", trace, "datagrams",
+                            network.num_packets(), "packets", true);
+  webrtc::test::PrintResult("rtcp_aggregator", trace, "mean_datagram_size",
+                            network.num_bytes() / network.num_packets(),
+                            "bytes", false);
+}
+
+}  // namespace
+
+// Only the periodic reports wait for the next flush.
+TEST(RtcpAggregatorPerformanceTest, BundledReceiveStreamsWithoutLoss) {
+  RunBundledReceiveStreams(0, "_300_streams_no_loss");
+}
+
+// NACKs are sent right away, with the reports pending at the time. Models a
+// 2% loss of a 300 packets per second video stream, each lost packet NACKed
+// on its own.
+TEST(RtcpAggregatorPerformanceTest, BundledReceiveStreamsWithLoss) {
+  RunBundledReceiveStreams(6, "_300_streams");
+}
+
+}  // namespace webrtc
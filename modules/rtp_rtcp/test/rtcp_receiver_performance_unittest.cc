@@ -0,0 +1,210 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/remb.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_receiver.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumStreams = 300;
+// The participants receiving each stream, each reporting on it.
+constexpr int kNumRemoteSsrcs = 10;
+constexpr int kDurationSeconds = 5;
+// Per remote SSRC and second, on top of one receiver report.
+constexpr int kNacksPerSecond = 6;
+// Sent by the first remote SSRC only.
+constexpr int kTransportFeedbacksPerSecond = 10;
+constexpr uint32_t kFirstMediaSsrc = 0x10000;
+constexpr uint32_t kFirstRemoteSsrc = 0x20000;
+
+class NullModuleRtpRtcp : public RTCPReceiver::ModuleRtpRtcp {
+ public:
+  void SetTmmbn(std::vector<rtcp::TmmbItem> bounding_set) override {}
+  void OnRequestSendReport() override {}
+  void OnReceivedNack(
+      const std::vector<uint16_t>& nack_sequence_numbers) override {
+    num_nacked_packets_ += nack_sequence_numbers.size();
+  }
+  void OnReceivedRtcpReportBlocks(
+      const ReportBlockList& report_blocks) override {
+    num_report_blocks_ += report_blocks.size();
+  }
+
+  size_t num_nacked_packets() const { return num_nacked_packets_; }
+  size_t num_report_blocks() const { return num_report_blocks_; }
+
+ private:
+  size_t num_nacked_packets_ = 0;
+  size_t num_report_blocks_ = 0;
+};
+
+class NullTransportFeedbackObserver : public TransportFeedbackObserver {
+ public:
+  void AddPacket(uint16_t sequence_number,
+                 size_t length,
+                 int probe_cluster_id) override {}
+  void OnTransportFeedback(const rtcp::TransportFeedback& feedback) override {
+    ++num_feedbacks_;
+  }
+  std::vector<PacketInfo> GetTransportFeedbackVector() const override {
+    return std::vector<PacketInfo>();
+  }
+
+  int num_feedbacks() const { return num_feedbacks_; }
+
+ private:
+  int num_feedbacks_ = 0;
+};
+
+// The compound packets one remote participant sends about |media_ssrc|: a
+// receiver report, NACKs sent as compound packets the way RTCPSender builds
+// them, and for the first participant also REMB and transport feedback.
+void AddPacketsFromRemote(uint32_t media_ssrc,
+                          int remote_index,
+                          Random* random,
+                          std::vector<rtc::Buffer>* packets) {
+  const uint32_t remote_ssrc = kFirstRemoteSsrc + remote_index;
+  rtcp::ReportBlock report_block;
+  report_block.SetMediaSsrc(media_ssrc);
+  report_block.SetExtHighestSeqNum(random->Rand<uint16_t>());
+  report_block.SetFractionLost(5);
+  report_block.SetJitter(random->Rand(0, 1000));
+  rtcp::ReceiverReport rr;
+  rr.SetSenderSsrc(remote_ssrc);
+  rr.AddReportBlock(report_block);
+  rtcp::Sdes sdes;
+  sdes.AddCName(remote_ssrc, "participant" + std::to_string(remote_index));
+
+  rtcp::CompoundPacket report;
+  report.Append(&rr);
+  report.Append(&sdes);
+  rtcp::Remb remb;
+  if (remote_index == 0) {
+    remb.SetSenderSsrc(remote_ssrc);
+    remb.SetBitrateBps(1000000);
+    remb.SetSsrcs({media_ssrc});
+    report.Append(&remb);
+  }
+  packets->push_back(report.Build());
+
+  for (int i = 0; i < kNacksPerSecond; ++i) {
+    rtcp::Nack nack;
+    nack.SetSenderSsrc(remote_ssrc);
+    nack.SetMediaSsrc(media_ssrc);
+    const uint16_t packet_id = random->Rand<uint16_t>();
+    nack.SetPacketIds(&packet_id, 1);
+    rtcp::CompoundPacket compound;
+    compound.Append(&rr);
+    compound.Append(&sdes);
+    compound.Append(&nack);
+    packets->push_back(compound.Build());
+  }
+
+  if (remote_index == 0) {
+    for (int i = 0; i < kTransportFeedbacksPerSecond; ++i) {
+      rtcp::TransportFeedback feedback;
+      feedback.SetSenderSsrc(remote_ssrc);
+      feedback.SetMediaSsrc(media_ssrc);
+      const uint16_t base_sequence_number = i * 50;
+      feedback.SetBase(base_sequence_number, 0);
+      for (int j = 0; j < 50; ++j) {
+        feedback.AddReceivedPacket(base_sequence_number + j,
+                                   j * 2000 + random->Rand(0, 250));
+      }
+      packets->push_back(feedback.Build());
+    }
+  }
+}
+}  // namespace
+
+// The RTCP a bridge receives for the streams it forwards, every stream
+// reported on by several participants.
+TEST(RtcpReceiverPerformanceTest, BridgeStreams) {
+  SimulatedClock clock(1000000);
+  Random random(0x7c9);
+  NullModuleRtpRtcp owner;
+  NullTransportFeedbackObserver transport_feedback_observer;
+  std::vector<std::unique_ptr<RTCPReceiver>> receivers;
+  std::vector<std::vector<rtc::Buffer>> packets(kNumStreams);
+  size_t num_packets_per_second = 0;
+  for (int i = 0; i < kNumStreams; ++i) {
+    const uint32_t media_ssrc = kFirstMediaSsrc + i;
+    receivers.emplace_back(new RTCPReceiver(
+        &clock, false, nullptr, nullptr, nullptr, &transport_feedback_observer,
+        nullptr, &owner));
+    // The media and RTX SSRC.
+    receivers.back()->SetSsrcs(media_ssrc, {media_ssrc, media_ssrc + 1});
+    receivers.back()->SetRemoteSSRC(kFirstRemoteSsrc);
+    for (int j = 0; j < kNumRemoteSsrcs; ++j)
+      AddPacketsFromRemote(media_ssrc, j, &random, &packets[i]);
+    num_packets_per_second += packets[i].size();
+  }
+
+  // Interleave the packets of all streams the way they arrive on one
+  // transport, each second in a different order.
+  struct PacketRef {
+    int stream;
+    size_t index;
+  };
+  std::vector<PacketRef> order;
+  for (int i = 0; i < kNumStreams; ++i) {
+    for (size_t j = 0; j < packets[i].size(); ++j)
+      order.push_back({i, j});
+  }
+
+  int64_t elapsed_ns = 0;
+  size_t num_bytes = 0;
+  for (int second = 0; second < kDurationSeconds; ++second) {
+    for (size_t i = order.size() - 1; i > 0; --i)
+      std::swap(order[i], order[random.Rand<uint32_t>() % (i + 1)]);
+    const int64_t start_ns = rtc::TimeNanos();
+    for (const PacketRef& ref : order) {
+      const rtc::Buffer& packet = packets[ref.stream][ref.index];
+      receivers[ref.stream]->IncomingPacket(packet.data(), packet.size());
+      num_bytes += packet.size();
+    }
+    elapsed_ns += rtc::TimeNanos() - start_ns;
+    clock.AdvanceTimeMilliseconds(1000);
+  }
+
+  const size_t num_packets = num_packets_per_second * kDurationSeconds;
+  EXPECT_GT(owner.num_nacked_packets(), 0u);
+  EXPECT_GT(owner.num_report_blocks(), 0u);
+  EXPECT_EQ(kNumStreams * kDurationSeconds * kTransportFeedbacksPerSecond,
+            transport_feedback_observer.num_feedbacks());
+
+  webrtc::test::PrintResult("rtcp_receiver", "_300_streams", "incoming_packet",
+                            elapsed_ns / static_cast<int64_t>(num_packets),
+                            "ns/packet", true);
+  webrtc::test::PrintResult("rtcp_receiver", "_300_streams", "packet_rate",
+                            num_packets_per_second, "packets/s", false);
+  webrtc::test::PrintResult("rtcp_receiver", "_300_streams", "mean_size",
+                            num_bytes / num_packets, "bytes", false);
+}
+
+}  // namespace webrtc
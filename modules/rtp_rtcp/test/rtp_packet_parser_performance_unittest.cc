@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/rtp_file_reader.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+// Packets are parsed in batches of this size, roughly what one recvmmsg() on
+// a busy bundled transport returns.
+constexpr size_t kBatchSize = 32;
+constexpr int kNumPasses = 2000;
+
+std::vector<std::vector<uint8_t>> ReadRtpDump(const std::string& name) {
+  std::unique_ptr<test::RtpFileReader> reader(test::RtpFileReader::Create(
+      test::RtpFileReader::kRtpDump, test::ResourcePath(name, "rtp")));
+  std::vector<std::vector<uint8_t>> packets;
+  if (!reader)
+    return packets;
+  test::RtpPacket packet;
+  while (reader->NextPacket(&packet)) {
+    if (!RtpHeaderParser::IsRtcp(packet.data, packet.length))
+      packets.emplace_back(packet.data, packet.data + packet.length);
+  }
+  return packets;
+}
+
+void RunParseBenchmark(const std::string& name) {
+  std::vector<std::vector<uint8_t>> dump = ReadRtpDump(name);
+  ASSERT_FALSE(dump.empty());
+  std::vector<rtc::ArrayView<const uint8_t>> views(dump.begin(), dump.end());
+  std::vector<rtc::CopyOnWriteBuffer> buffers;
+  for (const auto& packet : dump)
+    buffers.emplace_back(packet.data(), packet.size());
+  const size_t num_packets = kNumPasses * dump.size();
+
+  // Legacy RTPHeader parser, as used by the receive streams.
+  std::unique_ptr<RtpHeaderParser> header_parser(RtpHeaderParser::Create());
+  RTPHeader header;
+  int64_t start_ns = rtc::TimeNanos();
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    for (const auto& packet : dump)
+      header_parser->Parse(packet.data(), packet.size(), &header);
+  }
+  const int64_t legacy_ns = rtc::TimeNanos() - start_ns;
+
+  // One rtp::Packet::Parse per packet.
+  RtpPacketReceived parsed;
+  start_ns = rtc::TimeNanos();
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    for (const auto& buffer : buffers)
+      parsed.Parse(buffer);
+  }
+  const int64_t single_ns = rtc::TimeNanos() - start_ns;
+
+  // Batched layout parse, adopted by the packets without re-parsing.
+  std::vector<rtp::HeaderLayout> layouts(kBatchSize);
+  std::vector<RtpPacketReceived> batch(kBatchSize);
+  start_ns = rtc::TimeNanos();
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    for (size_t begin = 0; begin < views.size(); begin += kBatchSize) {
+      const size_t count = std::min(kBatchSize, views.size() - begin);
+      rtp::ParseHeaderLayouts(
+          rtc::ArrayView<const rtc::ArrayView<const uint8_t>>(
+              views.data() + begin, count),
+          layouts.data());
+      for (size_t i = 0; i < count; ++i)
+        batch[i].Parse(buffers[begin + i], layouts[i]);
+    }
+  }
+  const int64_t batch_ns = rtc::TimeNanos() - start_ns;
+
+  webrtc::test::PrintResult("rtp_parse", "_legacy_header_parser", name,
+                            legacy_ns / num_packets, "ns/packet", false);
+  webrtc::test::PrintResult("rtp_parse", "_single", name,
+                            single_ns / num_packets, "ns/packet", false);
+  webrtc::test::PrintResult("rtp_parse", "_batch", name,
+                            batch_ns / num_packets, "ns/packet", true);
+}
+}  // namespace
+
+TEST(RtpPacketParserPerformanceTest, VideoDump) {
+  RunParseBenchmark("video_coding/pltype103");
+}
+
+TEST(RtpPacketParserPerformanceTest, AudioDump) {
+  RunParseBenchmark("audio_coding/neteq_universal_new");
+}
+
+}  // namespace webrtc
@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/utility/source/process_thread_impl.h"
 
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
 #include "webrtc/base/task_queue.h"
 #include "webrtc/base/timeutils.h"
@@ -36,6 +38,8 @@ int64_t GetNextCallbackTime(Module* module, int64_t time_now) {
 
 ProcessThread::~ProcessThread() {}
 
+constexpr size_t ProcessThreadImpl::kNotScheduled;
+
 // static
 std::unique_ptr<ProcessThread> ProcessThread::Create(
     const char* thread_name) {
@@ -113,8 +117,11 @@ void ProcessThreadImpl::WakeUp(Module* module) {
   {
     rtc::CritScope lock(&lock_);
     for (ModuleCallback& m : modules_) {
-      if (m.module == module)
+      if (m.module == module) {
         m.next_callback = kCallProcessImmediately;
+        if (m.heap_index != kNotScheduled)
+          SiftUp(m.heap_index);
+      }
     }
   }
   wake_up_->Set();
@@ -151,6 +158,7 @@ void ProcessThreadImpl::RegisterModule(Module* module) {
   {
     rtc::CritScope lock(&lock_);
     modules_.push_back(ModuleCallback(module));
+    Schedule(&modules_.back());
   }
 
   // Wake the thread calling ProcessThreadImpl::Process() to update the
@@ -166,9 +174,19 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
 
   {
     rtc::CritScope lock(&lock_);
-    modules_.remove_if([&module](const ModuleCallback& m) {
-        return m.module == module;
-      });
+    for (auto it = modules_.begin(); it != modules_.end(); ++it) {
+      if (it->module != module)
+        continue;
+      if (it->heap_index != kNotScheduled) {
+        Unschedule(&*it);
+      } else {
+        // Deregistered while the modules due are being processed.
+        std::replace(due_modules_.begin(), due_modules_.end(), &*it,
+                     static_cast<ModuleCallback*>(nullptr));
+      }
+      modules_.erase(it);
+      break;
+    }
 
     // TODO(tommi): we currently need to hold the lock while calling out to
     // ProcessThreadAttached.  This is to make sure that the thread hasn't been
@@ -196,27 +214,47 @@ bool ProcessThreadImpl::Process() {
     rtc::CritScope lock(&lock_);
     if (stop_)
       return false;
-    for (ModuleCallback& m : modules_) {
+    // Only the modules that are due are taken out of the schedule, and each
+    // of them is processed at most once per wakeup, even if it asks to be
+    // called back right away.
+    while (!schedule_.empty() && schedule_.front()->next_callback <= now) {
+      due_modules_.push_back(schedule_.front());
+      Unschedule(schedule_.front());
+    }
+
+    for (size_t i = 0; i < due_modules_.size(); ++i) {
+      ModuleCallback* m = due_modules_[i];
+      if (!m)
+        continue;
       // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
       // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
       // operation should not require taking a lock, so querying all modules
       // should run in a matter of nanoseconds.
-      if (m.next_callback == 0)
-        m.next_callback = GetNextCallbackTime(m.module, now);
-
-      if (m.next_callback <= now ||
-          m.next_callback == kCallProcessImmediately) {
-        m.module->Process();
+      if (m->next_callback == 0)
+        m->next_callback = GetNextCallbackTime(m->module, now);
+
+      if (m->next_callback <= now ||
+          m->next_callback == kCallProcessImmediately) {
+        m->module->Process();
+        // The module may have deregistered itself.
+        if (!due_modules_[i])
+          continue;
         // Use a new 'now' reference to calculate when the next callback
         // should occur.  We'll continue to use 'now' above for the baseline
         // of calculating how long we should wait, to reduce variance.
         int64_t new_now = rtc::TimeMillis();
-        m.next_callback = GetNextCallbackTime(m.module, new_now);
+        m->next_callback = GetNextCallbackTime(m->module, new_now);
       }
-
-      if (m.next_callback < next_checkpoint)
-        next_checkpoint = m.next_callback;
     }
+    for (ModuleCallback* m : due_modules_) {
+      if (m)
+        Schedule(m);
+    }
+    due_modules_.clear();
+
+    if (!schedule_.empty())
+      next_checkpoint =
+          std::min(next_checkpoint, schedule_.front()->next_callback);
 
     while (!queue_.empty()) {
       rtc::QueuedTask* task = queue_.front();
@@ -234,4 +272,59 @@ bool ProcessThreadImpl::Process() {
 
   return true;
 }
+
+void ProcessThreadImpl::Schedule(ModuleCallback* module) {
+  RTC_DCHECK_EQ(kNotScheduled, module->heap_index);
+  schedule_.push_back(module);
+  SiftUp(schedule_.size() - 1);
+}
+
+void ProcessThreadImpl::Unschedule(ModuleCallback* module) {
+  const size_t index = module->heap_index;
+  RTC_DCHECK_LT(index, schedule_.size());
+  RTC_DCHECK_EQ(module, schedule_[index]);
+  ModuleCallback* last = schedule_.back();
+  schedule_.pop_back();
+  module->heap_index = kNotScheduled;
+  if (last != module) {
+    MoveInSchedule(last, index);
+    SiftUp(index);
+    SiftDown(last->heap_index);
+  }
+}
+
+void ProcessThreadImpl::SiftUp(size_t index) {
+  ModuleCallback* module = schedule_[index];
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (schedule_[parent]->next_callback <= module->next_callback)
+      break;
+    MoveInSchedule(schedule_[parent], index);
+    index = parent;
+  }
+  MoveInSchedule(module, index);
+}
+
+void ProcessThreadImpl::SiftDown(size_t index) {
+  ModuleCallback* module = schedule_[index];
+  while (true) {
+    size_t child = 2 * index + 1;
+    if (child >= schedule_.size())
+      break;
+    if (child + 1 < schedule_.size() &&
+        schedule_[child + 1]->next_callback < schedule_[child]->next_callback) {
+      ++child;
+    }
+    if (module->next_callback <= schedule_[child]->next_callback)
+      break;
+    MoveInSchedule(schedule_[child], index);
+    index = child;
+  }
+  MoveInSchedule(module, index);
+}
+
+void ProcessThreadImpl::MoveInSchedule(ModuleCallback* module, size_t index) {
+  schedule_[index] = module;
+  module->heap_index = index;
+}
 }  // namespace webrtc
@@ -14,6 +14,7 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/platform_thread.h"
@@ -43,17 +44,26 @@ class ProcessThreadImpl : public ProcessThread {
   bool Process();
 
  private:
+  static constexpr size_t kNotScheduled = static_cast<size_t>(-1);
+
   struct ModuleCallback {
-    ModuleCallback() : module(nullptr), next_callback(0) {}
+    ModuleCallback()
+        : module(nullptr), next_callback(0), heap_index(kNotScheduled) {}
     ModuleCallback(const ModuleCallback& cb)
-        : module(cb.module), next_callback(cb.next_callback) {}
-    ModuleCallback(Module* module) : module(module), next_callback(0) {}
+        : module(cb.module),
+          next_callback(cb.next_callback),
+          heap_index(cb.heap_index) {}
+    ModuleCallback(Module* module)
+        : module(module), next_callback(0), heap_index(kNotScheduled) {}
     bool operator==(const ModuleCallback& cb) const {
       return cb.module == module;
     }
 
     Module* const module;
     int64_t next_callback;  // Absolute timestamp.
+    // Position in |schedule_|, or kNotScheduled while the module is being
+    // processed.
+    size_t heap_index;
 
    private:
     ModuleCallback& operator=(ModuleCallback&);
@@ -61,13 +71,20 @@ class ProcessThreadImpl : public ProcessThread {
 
   typedef std::list<ModuleCallback> ModuleList;
 
+  // Maintains |schedule_| as a binary min-heap on next_callback.
+  void Schedule(ModuleCallback* module);
+  void Unschedule(ModuleCallback* module);
+  void SiftUp(size_t index);
+  void SiftDown(size_t index);
+  void MoveInSchedule(ModuleCallback* module, size_t index);
+
   // Warning: For some reason, if |lock_| comes immediately before |modules_|
   // with the current class layout, we will  start to have mysterious crashes
   // on Mac 10.9 debug.  I (Tommi) suspect we're hitting some obscure alignemnt
   // issues, but I haven't figured out what they are, if there are alignment
   // requirements for mutexes on Mac or if there's something else to it.
   // So be careful with changing the layout.
-  rtc::CriticalSection lock_;  // Used to guard modules_, tasks_ and stop_.
+  rtc::CriticalSection lock_;  // Guards modules_, schedule_, tasks_ and stop_.
 
   rtc::ThreadChecker thread_checker_;
   const std::unique_ptr<EventWrapper> wake_up_;
@@ -75,6 +92,11 @@ class ProcessThreadImpl : public ProcessThread {
   std::unique_ptr<rtc::PlatformThread> thread_;
 
   ModuleList modules_;
+  // The modules in |modules_| ordered by when they are due to be processed,
+  // so that a wakeup only touches the modules that are due.
+  std::vector<ModuleCallback*> schedule_;
+  // The modules taken out of |schedule_| while being processed.
+  std::vector<ModuleCallback*> due_modules_;
   std::queue<rtc::QueuedTask*> queue_;
   bool stop_;
   const char* thread_name_;
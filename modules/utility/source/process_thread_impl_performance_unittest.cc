@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <time.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/include/module.h"
+#include "webrtc/modules/utility/source/process_thread_impl.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+constexpr int kNumModules = 1000;
+constexpr int kDurationMs = 3000;
+
+// Asks to be processed every |interval_ms| and measures how late the process
+// thread is, taking a lock in TimeUntilNextProcess() the way the RTP modules
+// do.
+class PeriodicModule : public Module {
+ public:
+  PeriodicModule(int64_t interval_ms, int64_t first_process_ms)
+      : interval_ms_(interval_ms), next_process_ms_(first_process_ms) {}
+
+  int64_t TimeUntilNextProcess() override {
+    rtc::CritScope lock(&lock_);
+    return next_process_ms_ - rtc::TimeMillis();
+  }
+
+  void Process() override {
+    rtc::CritScope lock(&lock_);
+    const int64_t now_us = rtc::TimeMicros();
+    const int64_t delay_us =
+        std::max<int64_t>(0, now_us - next_process_ms_ * 1000);
+    total_delay_us_ += delay_us;
+    max_delay_us_ = std::max(max_delay_us_, delay_us);
+    ++num_processed_;
+    next_process_ms_ = now_us / 1000 + interval_ms_;
+  }
+
+  int num_processed() const { return num_processed_; }
+  int64_t total_delay_us() const { return total_delay_us_; }
+  int64_t max_delay_us() const { return max_delay_us_; }
+
+ private:
+  rtc::CriticalSection lock_;
+  const int64_t interval_ms_;
+  int64_t next_process_ms_;
+  int num_processed_ = 0;
+  int64_t total_delay_us_ = 0;
+  int64_t max_delay_us_ = 0;
+};
+
+// Runs |kNumModules| modules with processing intervals picked in turn from
+// |intervals_ms| and staggered start times, and reports the process CPU time
+// and how late the modules are processed.
+void RunProcessThread(const std::string& modifier,
+                      const std::vector<int64_t>& intervals_ms) {
+  ProcessThreadImpl thread("ProcessThread");
+  std::vector<std::unique_ptr<PeriodicModule>> modules;
+  const int64_t start_ms = rtc::TimeMillis();
+  for (int i = 0; i < kNumModules; ++i) {
+    const int64_t interval_ms = intervals_ms[i % intervals_ms.size()];
+    modules.emplace_back(
+        new PeriodicModule(interval_ms, start_ms + i % interval_ms));
+    thread.RegisterModule(modules.back().get());
+  }
+
+  // The test thread sleeps while the process thread runs, so the CPU time of
+  // the process is that of the process thread.
+  const clock_t start_cpu = clock();
+  thread.Start();
+  SleepMs(kDurationMs);
+  thread.Stop();
+  const int64_t cpu_us =
+      (clock() - start_cpu) * rtc::kNumMicrosecsPerSec / CLOCKS_PER_SEC;
+
+  int num_processed = 0;
+  int64_t total_delay_us = 0;
+  int64_t max_delay_us = 0;
+  for (auto& module : modules) {
+    num_processed += module->num_processed();
+    total_delay_us += module->total_delay_us();
+    max_delay_us = std::max(max_delay_us, module->max_delay_us());
+    thread.DeRegisterModule(module.get());
+  }
+  ASSERT_GT(num_processed, 0);
+
+  webrtc::test::PrintResult("process_thread", modifier, "cpu_time",
+                            cpu_us / (kDurationMs / 1000), "us/s", true);
+  webrtc::test::PrintResult("process_thread", modifier, "mean_delay",
+                            total_delay_us / num_processed, "us", true);
+  webrtc::test::PrintResult("process_thread", modifier, "max_delay",
+                            max_delay_us, "us", false);
+}
+}  // namespace
+
+// Modules that rarely have anything to do, like idle streams.
+TEST(ProcessThreadPerformanceTest, IdleModules) {
+  RunProcessThread("_1000_idle_modules", {100, 500, 1000});
+}
+
+// A mix of intervals like that of the RTP/RTCP and pacing modules of active
+// streams.
+TEST(ProcessThreadPerformanceTest, ActiveModules) {
+  RunProcessThread("_1000_active_modules", {5, 10, 20, 100});
+}
+
+}  // namespace webrtc
@@ -154,6 +154,60 @@ TEST(ProcessThreadImpl, Deregister) {
   thread.Stop();
 }
 
+// Tests that a module can deregister itself from within its Process() call,
+// and that the other modules due at the same time are still processed.
+TEST(ProcessThreadImpl, DeregisterFromProcess) {
+  ProcessThreadImpl thread("ProcessThread");
+  std::unique_ptr<EventWrapper> event(EventWrapper::Create());
+
+  MockModule module1;
+  MockModule module2;
+  EXPECT_CALL(module1, TimeUntilNextProcess()).WillRepeatedly(Return(0));
+  EXPECT_CALL(module1, Process())
+      .WillOnce(Invoke([&thread, &module1] {
+        thread.DeRegisterModule(&module1);
+      }));
+  EXPECT_CALL(module1, ProcessThreadAttached(&thread)).Times(1);
+  EXPECT_CALL(module1, ProcessThreadAttached(nullptr)).Times(1);
+  EXPECT_CALL(module2, TimeUntilNextProcess()).WillRepeatedly(Return(0));
+  EXPECT_CALL(module2, Process())
+      .WillOnce(DoAll(SetEvent(event.get()), Return()))
+      .WillRepeatedly(Return());
+  EXPECT_CALL(module2, ProcessThreadAttached(&thread)).Times(1);
+
+  thread.RegisterModule(&module1);
+  thread.RegisterModule(&module2);
+  thread.Start();
+  EXPECT_EQ(kEventSignaled, event->Wait(kEventWaitTimeout));
+
+  EXPECT_CALL(module2, ProcessThreadAttached(nullptr)).Times(1);
+  thread.Stop();
+}
+
+// Tests that a module that keeps asking to be called back right away doesn't
+// keep the thread from processing the other modules.
+TEST(ProcessThreadImpl, BusyModuleDoesNotStarveOthers) {
+  ProcessThreadImpl thread("ProcessThread");
+  std::unique_ptr<EventWrapper> event(EventWrapper::Create());
+
+  MockModule busy_module;
+  MockModule module;
+  EXPECT_CALL(busy_module, TimeUntilNextProcess()).WillRepeatedly(Return(0));
+  EXPECT_CALL(busy_module, Process()).WillRepeatedly(Return());
+  EXPECT_CALL(busy_module, ProcessThreadAttached(_)).Times(2);
+  EXPECT_CALL(module, TimeUntilNextProcess()).WillRepeatedly(Return(5));
+  EXPECT_CALL(module, Process())
+      .WillOnce(DoAll(SetEvent(event.get()), Return()))
+      .WillRepeatedly(Return());
+  EXPECT_CALL(module, ProcessThreadAttached(_)).Times(2);
+
+  thread.RegisterModule(&busy_module);
+  thread.RegisterModule(&module);
+  thread.Start();
+  EXPECT_EQ(kEventSignaled, event->Wait(kEventWaitTimeout));
+  thread.Stop();
+}
+
 // Helper function for testing receiving a callback after a certain amount of
 // time.  There's some variance of timing built into it to reduce chance of
 // flakiness on bots.
@@ -234,6 +234,14 @@ void RtpFrameReferenceFinder::ManageFrameVp8(
   // Find if there has been a gap in fully received frames and save the picture
   // id of those frames in |not_yet_received_frames_|.
   if (AheadOf<uint16_t, kPicIdLength>(frame->picture_id, last_picture_id_)) {
+    // Only the newest |kNotYetReceivedCapacity| picture ids of a large gap
+    // would be kept anyway.
+    if (ForwardDiff<uint16_t, kPicIdLength>(last_picture_id_,
+                                            frame->picture_id) >
+        kNotYetReceivedCapacity) {
+      last_picture_id_ = Subtract<kPicIdLength>(frame->picture_id,
+                                                kNotYetReceivedCapacity + 1);
+    }
     last_picture_id_ = Add<kPicIdLength>(last_picture_id_, 1);
     while (last_picture_id_ != frame->picture_id) {
       not_yet_received_frames_.insert(last_picture_id_);
@@ -470,25 +478,28 @@ void RtpFrameReferenceFinder::ManageFrameVp9(
   // If this is a base layer frame that contains a scalability structure
   // then gof info has already been inserted earlier, so we only want to
   // insert if we haven't done so already.
+  // |info| points into |gof_info_| and does not survive the insertion below.
+  const GofInfoVP9* gof = info->gof;
   if (codec_header.temporal_idx == 0 && !codec_header.ss_data_available) {
     GofInfo new_info(info->gof, frame->picture_id);
     gof_info_.insert(std::make_pair(codec_header.tl0_pic_idx, new_info));
   }
 
   // Clean out old info about up switch frames.
-  uint16_t old_picture_id = Subtract<kPicIdLength>(frame->picture_id, 50);
+  uint16_t old_picture_id =
+      Subtract<kPicIdLength>(frame->picture_id, kMaxUpSwitchAge);
   auto up_switch_erase_to = up_switch_.lower_bound(old_picture_id);
   up_switch_.erase(up_switch_.begin(), up_switch_erase_to);
 
-  size_t diff = ForwardDiff<uint16_t, kPicIdLength>(info->gof->pid_start,
-                                                    frame->picture_id);
-  size_t gof_idx = diff % info->gof->num_frames_in_gof;
+  size_t diff =
+      ForwardDiff<uint16_t, kPicIdLength>(gof->pid_start, frame->picture_id);
+  size_t gof_idx = diff % gof->num_frames_in_gof;
 
   // Populate references according to the scalability structure.
-  frame->num_references = info->gof->num_ref_pics[gof_idx];
+  frame->num_references = gof->num_ref_pics[gof_idx];
   for (size_t i = 0; i < frame->num_references; ++i) {
-    frame->references[i] = Subtract<kPicIdLength>(
-        frame->picture_id, info->gof->pid_diff[gof_idx][i]);
+    frame->references[i] =
+        Subtract<kPicIdLength>(frame->picture_id, gof->pid_diff[gof_idx][i]);
 
     // If this is a reference to a frame earlier than the last up switch point,
     // then ignore this reference.
@@ -538,6 +549,15 @@ void RtpFrameReferenceFinder::FrameReceivedVp9(uint16_t picture_id,
                                                       last_picture_id);
     size_t gof_idx = diff % info->gof->num_frames_in_gof;
 
+    // Only the newest |kMissingFramesCapacity| picture ids of a large gap
+    // would be kept anyway.
+    size_t gap = ForwardDiff<uint16_t, kPicIdLength>(last_picture_id,
+                                                     picture_id);
+    if (gap > kMissingFramesCapacity) {
+      gof_idx += gap - kMissingFramesCapacity - 1;
+      last_picture_id =
+          Subtract<kPicIdLength>(picture_id, kMissingFramesCapacity + 1);
+    }
     last_picture_id = Add<kPicIdLength>(last_picture_id, 1);
     while (last_picture_id != picture_id) {
       ++gof_idx;
@@ -12,15 +12,14 @@
 #define WEBRTC_MODULES_VIDEO_CODING_RTP_FRAME_REFERENCE_FINDER_H_
 
 #include <array>
-#include <map>
 #include <memory>
 #include <deque>
-#include <set>
 #include <utility>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/video_coding/seq_num_ring.h"
 #include "webrtc/modules/video_coding/sequence_number_util.h"
 
 namespace webrtc {
@@ -64,9 +63,23 @@ class RtpFrameReferenceFinder {
   static const int kMaxNotYetReceivedFrames = 100;
   static const int kMaxGofSaved = 50;
   static const int kMaxPaddingAge = 100;
-
+  static const int kMaxUpSwitchAge = 50;
+
+  // Capacities of the ring buffers holding the state above. Each covers the
+  // window that is cleaned up to plus some slack for reordering, so that
+  // eviction of the oldest entry only happens on streams that are already
+  // broken. Missing frames are never cleaned up by age, only evicted; 256
+  // covers the largest reference distance a scalability structure can give.
+  static const size_t kGopInfoCapacity = 128;
+  static const size_t kStashedPaddingCapacity = 128;
+  static const size_t kNotYetReceivedCapacity = 128;
+  static const size_t kLayerInfoCapacity = 64;
+  static const size_t kGofInfoCapacity = 64;
+  static const size_t kUpSwitchCapacity = 64;
+  static const size_t kMissingFramesCapacity = 256;
 
   struct GofInfo {
+    GofInfo() : gof(nullptr), last_picture_id(0) {}
     GofInfo(GofInfoVP9* gof, uint16_t last_picture_id)
         : gof(gof), last_picture_id(last_picture_id) {}
     GofInfoVP9* gof;
@@ -152,9 +165,7 @@ class RtpFrameReferenceFinder {
   // the sequence number of the last packet of the last completed frame, and
   // the second being the sequence number of the last packet of the last
   // completed frame advanced by any potential continuous packets of padding.
-  std::map<uint16_t,
-           std::pair<uint16_t, uint16_t>,
-           DescendingSeqNumComp<uint16_t>>
+  SeqNumRingMap<uint16_t, std::pair<uint16_t, uint16_t>, kGopInfoCapacity>
       last_seq_num_gop_ GUARDED_BY(crit_);
 
   // Save the last picture id in order to detect when there is a gap in frames
@@ -163,7 +174,7 @@ class RtpFrameReferenceFinder {
 
   // Padding packets that have been received but that are not yet continuous
   // with any group of pictures.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> stashed_padding_
+  SeqNumRingSet<uint16_t, kStashedPaddingCapacity> stashed_padding_
       GUARDED_BY(crit_);
 
   // The last unwrapped picture id. Used to unwrap the picture id from a length
@@ -172,7 +183,7 @@ class RtpFrameReferenceFinder {
 
   // Frames earlier than the last received frame that have not yet been
   // fully received.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
+  SeqNumRingSet<uint16_t, kNotYetReceivedCapacity, kPicIdLength>
       not_yet_received_frames_ GUARDED_BY(crit_);
 
   // Frames that have been fully received but didn't have all the information
@@ -181,9 +192,9 @@ class RtpFrameReferenceFinder {
 
   // Holds the information about the last completed frame for a given temporal
   // layer given a Tl0 picture index.
-  std::map<uint8_t,
-           std::array<int16_t, kMaxTemporalLayers>,
-           DescendingSeqNumComp<uint8_t>>
+  SeqNumRingMap<uint8_t,
+                std::array<int16_t, kMaxTemporalLayers>,
+                kLayerInfoCapacity>
       layer_info_ GUARDED_BY(crit_);
 
   // Where the current scalability structure is in the
@@ -195,16 +206,16 @@ class RtpFrameReferenceFinder {
       GUARDED_BY(crit_);
 
   // Holds the the Gof information for a given TL0 picture index.
-  std::map<uint8_t, GofInfo, DescendingSeqNumComp<uint8_t>> gof_info_
+  SeqNumRingMap<uint8_t, GofInfo, kGofInfoCapacity> gof_info_
       GUARDED_BY(crit_);
 
   // Keep track of which picture id and which temporal layer that had the
   // up switch flag set.
-  std::map<uint16_t, uint8_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
-      up_switch_ GUARDED_BY(crit_);
+  SeqNumRingMap<uint16_t, uint8_t, kUpSwitchCapacity, kPicIdLength> up_switch_
+      GUARDED_BY(crit_);
 
   // For every temporal layer, keep a set of which frames that are missing.
-  std::array<std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>,
+  std::array<SeqNumRingSet<uint16_t, kMissingFramesCapacity, kPicIdLength>,
              kMaxTemporalLayers>
       missing_frames_for_layer_ GUARDED_BY(crit_);
 
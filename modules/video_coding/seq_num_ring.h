@@ -0,0 +1,325 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_SEQ_NUM_RING_H_
+#define WEBRTC_MODULES_VIDEO_CODING_SEQ_NUM_RING_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/video_coding/sequence_number_util.h"
+
+namespace webrtc {
+namespace video_coding {
+namespace internal {
+
+template <typename T, typename M>
+struct SeqNumDistance;
+
+template <typename T, T M>
+struct SeqNumDistance<T, std::integral_constant<T, M>> {
+  static T Get(T a, T b) { return ForwardDiff<T, M>(a, b); }
+};
+
+template <typename T>
+struct SeqNumDistance<T, std::integral_constant<T, T(0)>> {
+  static T Get(T a, T b) { return ForwardDiff<T>(a, b); }
+};
+
+template <typename Key>
+struct SetKeyOf {
+  static const Key& Get(const Key& element) { return element; }
+};
+
+template <typename Key, typename Value>
+struct MapKeyOf {
+  static const Key& Get(const std::pair<Key, Value>& element) {
+    return element.first;
+  }
+};
+
+// Sorted, fixed-capacity storage for elements keyed by sequence numbers of
+// length |M|. The elements live in a circular array ordered from the oldest to
+// the newest key, so erasing the oldest elements only moves the head and
+// inserting the newest key, by far the most common case, is an append. Keys
+// are usually consecutive picture ids or tl0 indices, in which case the
+// position of a key is its distance from the oldest key and lookups are
+// constant time; otherwise they fall back to a binary search.
+//
+// When full, inserting a key evicts the oldest element. Iterators are
+// invalidated by any insertion or erasure.
+template <typename Key,
+          Key M,
+          typename Element,
+          typename KeyOf,
+          size_t kCapacity>
+class SeqNumRing {
+ private:
+  template <typename Ring, typename Ref, typename Ptr>
+  class Iterator : public std::iterator<std::bidirectional_iterator_tag,
+                                        Element,
+                                        ptrdiff_t,
+                                        Ptr,
+                                        Ref> {
+   public:
+    Iterator() : ring_(nullptr), index_(0) {}
+    Iterator(Ring* ring, size_t index) : ring_(ring), index_(index) {}
+    // Allows conversion from iterator to const_iterator.
+    template <typename OtherRing, typename OtherRef, typename OtherPtr>
+    Iterator(const Iterator<OtherRing, OtherRef, OtherPtr>& other)
+        : ring_(other.ring_), index_(other.index_) {}
+
+    Ref operator*() const { return ring_->at(index_); }
+    Ptr operator->() const { return &ring_->at(index_); }
+
+    Iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator it = *this;
+      ++index_;
+      return it;
+    }
+    Iterator& operator--() {
+      --index_;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator it = *this;
+      --index_;
+      return it;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return ring_ == other.ring_ && index_ == other.index_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class SeqNumRing;
+    template <typename, typename, typename>
+    friend class Iterator;
+
+    Ring* ring_;
+    size_t index_;
+  };
+
+ public:
+  typedef Key key_type;
+  typedef Element value_type;
+  typedef Iterator<SeqNumRing, Element&, Element*> iterator;
+  typedef Iterator<const SeqNumRing, const Element&, const Element*>
+      const_iterator;
+
+  static constexpr size_t kMaxSize = kCapacity;
+
+  SeqNumRing() : head_(0), size_(0) {}
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, size_); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size_); }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  // Returns the first element whose key is not older than |key|.
+  iterator lower_bound(const Key& key) {
+    return iterator(this, LowerBound(key));
+  }
+  const_iterator lower_bound(const Key& key) const {
+    return const_iterator(this, LowerBound(key));
+  }
+
+  // Returns the first element whose key is newer than |key|.
+  iterator upper_bound(const Key& key) {
+    return iterator(this, UpperBound(key));
+  }
+  const_iterator upper_bound(const Key& key) const {
+    return const_iterator(this, UpperBound(key));
+  }
+
+  iterator find(const Key& key) { return iterator(this, Find(key)); }
+  const_iterator find(const Key& key) const {
+    return const_iterator(this, Find(key));
+  }
+
+  // Inserts |element| unless an element with the same key already exists.
+  // Returns the position of the element with that key and whether |element|
+  // was inserted.
+  std::pair<iterator, bool> insert(const Element& element) {
+    const Key& key = KeyOf::Get(element);
+    size_t index = LowerBound(key);
+    if (index != size_ && !comp_(key, KeyOf::Get(at(index))))
+      return std::make_pair(iterator(this, index), false);
+
+    if (size_ == kCapacity) {
+      PopFront();
+      if (index > 0)
+        --index;
+    }
+    ++size_;
+    for (size_t i = size_ - 1; i > index; --i)
+      at(i) = std::move(at(i - 1));
+    at(index) = element;
+    return std::make_pair(iterator(this, index), true);
+  }
+
+  iterator erase(const_iterator position) {
+    RTC_DCHECK(position.ring_ == this);
+    RTC_DCHECK_LT(position.index_, size_);
+    const_iterator next = position;
+    return erase(position, ++next);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    RTC_DCHECK(first.ring_ == this && last.ring_ == this);
+    RTC_DCHECK_LE(first.index_, last.index_);
+    RTC_DCHECK_LE(last.index_, size_);
+    const size_t count = last.index_ - first.index_;
+    if (first.index_ == 0) {
+      // Erasing the oldest elements, the common case of cleaning out old
+      // state, is only a matter of moving the head.
+      head_ = (head_ + count) % kCapacity;
+    } else {
+      for (size_t i = last.index_; i < size_; ++i)
+        at(i - count) = std::move(at(i));
+    }
+    size_ -= count;
+    return iterator(this, first.index_);
+  }
+
+  size_t erase(const Key& key) {
+    size_t index = Find(key);
+    if (index == size_)
+      return 0;
+    erase(const_iterator(this, index));
+    return 1;
+  }
+
+ protected:
+  Element& at(size_t index) {
+    RTC_DCHECK_LT(index, size_);
+    return elements_[(head_ + index) % kCapacity];
+  }
+  const Element& at(size_t index) const {
+    RTC_DCHECK_LT(index, size_);
+    return elements_[(head_ + index) % kCapacity];
+  }
+
+ private:
+  void PopFront() {
+    head_ = (head_ + 1) % kCapacity;
+    --size_;
+  }
+
+  // Returns the index |key| would have if there were no gaps between the
+  // oldest key and |key|. |key| must not be older than the oldest key.
+  size_t DenseIndex(const Key& key) const {
+    return Distance::Get(KeyOf::Get(at(0)), key);
+  }
+
+  size_t LowerBound(const Key& key) const {
+    if (size_ == 0 || comp_(KeyOf::Get(at(size_ - 1)), key))
+      return size_;
+    if (comp_(key, KeyOf::Get(at(0))))
+      return 0;
+    size_t index = DenseIndex(key);
+    if (index < size_ && KeyOf::Get(at(index)) == key)
+      return index;
+    size_t low = 0;
+    size_t high = size_ - 1;
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (comp_(KeyOf::Get(at(mid)), key))
+        low = mid + 1;
+      else
+        high = mid;
+    }
+    return low;
+  }
+
+  size_t UpperBound(const Key& key) const {
+    if (size_ == 0 || !comp_(key, KeyOf::Get(at(size_ - 1))))
+      return size_;
+    if (comp_(key, KeyOf::Get(at(0))))
+      return 0;
+    size_t index = DenseIndex(key);
+    if (index < size_ && KeyOf::Get(at(index)) == key)
+      return index + 1;
+    size_t low = 0;
+    size_t high = size_ - 1;
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (comp_(key, KeyOf::Get(at(mid))))
+        high = mid;
+      else
+        low = mid + 1;
+    }
+    return low;
+  }
+
+  size_t Find(const Key& key) const {
+    size_t index = LowerBound(key);
+    if (index != size_ && comp_(key, KeyOf::Get(at(index))))
+      return size_;
+    return index;
+  }
+
+  typedef SeqNumDistance<Key, std::integral_constant<Key, M>> Distance;
+
+  template <typename, typename, typename>
+  friend class Iterator;
+
+  DescendingSeqNumComp<Key, M> comp_;
+  std::array<Element, kCapacity> elements_;
+  size_t head_;
+  size_t size_;
+};
+
+}  // namespace internal
+
+// Drop-in replacements for std::set<T, DescendingSeqNumComp<T, M>> and
+// std::map<T, V, DescendingSeqNumComp<T, M>> holding at most |kCapacity|
+// elements. Since the order is only well defined for keys within half the
+// sequence number space of each other, the capacity should cover the window
+// the owner keeps, not more. |Value| must be default constructible.
+template <typename T, size_t kCapacity, T M = 0>
+class SeqNumRingSet
+    : public internal::SeqNumRing<T, M, T, internal::SetKeyOf<T>, kCapacity> {
+};
+
+template <typename T, typename Value, size_t kCapacity, T M = 0>
+class SeqNumRingMap : public internal::SeqNumRing<T,
+                                                  M,
+                                                  std::pair<T, Value>,
+                                                  internal::MapKeyOf<T, Value>,
+                                                  kCapacity> {
+ public:
+  Value& operator[](const T& key) {
+    return this->insert(std::make_pair(key, Value())).first->second;
+  }
+};
+
+}  // namespace video_coding
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_SEQ_NUM_RING_H_
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "webrtc/base/random.h"
+#include "webrtc/modules/video_coding/seq_num_ring.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace video_coding {
+
+TEST(SeqNumRing, KeepsSequenceNumberOrderOverWrap) {
+  SeqNumRingSet<uint16_t, 8> ring;
+  ring.insert(0xfffe);
+  ring.insert(2);
+  ring.insert(0);
+  ring.insert(0xffff);
+  ring.insert(1);
+  EXPECT_FALSE(ring.insert(1).second);
+
+  std::vector<uint16_t> keys(ring.begin(), ring.end());
+  EXPECT_EQ(std::vector<uint16_t>({0xfffe, 0xffff, 0, 1, 2}), keys);
+  EXPECT_EQ(0, *ring.lower_bound(0));
+  EXPECT_EQ(1, *ring.upper_bound(0));
+  EXPECT_EQ(ring.begin(), ring.lower_bound(0xfff0));
+  EXPECT_EQ(ring.end(), ring.upper_bound(2));
+}
+
+TEST(SeqNumRing, EvictsOldestWhenFull) {
+  SeqNumRingMap<uint8_t, int, 4> ring;
+  for (int i = 0; i < 6; ++i)
+    ring[250 + i] = i;
+  ASSERT_EQ(4u, ring.size());
+  EXPECT_EQ(252, ring.begin()->first);
+  EXPECT_TRUE(ring.find(251) == ring.end());
+  EXPECT_EQ(5, ring.find(255)->second);
+
+  // An insertion older than everything in a full ring evicts the previous
+  // oldest element and becomes the oldest itself.
+  ring.insert(std::make_pair(248, 10));
+  ASSERT_EQ(4u, ring.size());
+  EXPECT_EQ(248, ring.begin()->first);
+  EXPECT_TRUE(ring.find(252) == ring.end());
+}
+
+TEST(SeqNumRing, MatchesStdMap) {
+  constexpr uint16_t kPicIdLength = 1 << 15;
+  Random random(0x5eed);
+  SeqNumRingMap<uint16_t, int, 64, kPicIdLength> ring;
+  std::map<uint16_t, int, DescendingSeqNumComp<uint16_t, kPicIdLength>> map;
+
+  uint16_t newest = kPicIdLength - 500;
+  for (int i = 0; i < 20000; ++i) {
+    // Mostly consecutive keys with occasional gaps and reordering, cleaned
+    // up to a window well within the capacity, like the reference finder.
+    newest = Add<kPicIdLength>(newest, random.Rand(0, 3));
+    uint16_t key = Subtract<kPicIdLength>(newest, random.Rand(0, 8));
+    switch (random.Rand(0, 3)) {
+      case 0:
+        EXPECT_EQ(map.insert(std::make_pair(key, i)).second,
+                  ring.insert(std::make_pair(key, i)).second);
+        break;
+      case 1:
+        EXPECT_EQ(map.erase(key), ring.erase(key));
+        break;
+      case 2: {
+        auto map_it = map.upper_bound(key);
+        auto ring_it = ring.upper_bound(key);
+        ASSERT_EQ(map_it == map.end(), ring_it == ring.end());
+        if (map_it != map.end()) {
+          EXPECT_EQ(map_it->first, ring_it->first);
+        }
+        break;
+      }
+      case 3: {
+        uint16_t old_key = Subtract<kPicIdLength>(newest, 40);
+        map.erase(map.begin(), map.lower_bound(old_key));
+        ring.erase(ring.begin(), ring.lower_bound(old_key));
+        break;
+      }
+    }
+    ASSERT_EQ(map.size(), ring.size());
+    auto ring_it = ring.begin();
+    for (const auto& element : map) {
+      EXPECT_EQ(element.first, ring_it->first);
+      EXPECT_EQ(element.second, ring_it->second);
+      ++ring_it;
+    }
+  }
+}
+
+}  // namespace video_coding
+}  // namespace webrtc
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/video_coding/frame_object.h"
+#include "webrtc/modules/video_coding/packet_buffer.h"
+#include "webrtc/modules/video_coding/rtp_frame_reference_finder.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace video_coding {
+namespace {
+constexpr int kNumSpatialLayers = 3;
+constexpr int kNumPictures = 60000;
+// Frames are created in chunks, outside of the timed region, so that only the
+// reference finder is measured. A chunk must fit in the packet slots.
+constexpr int kPicturesPerChunk = 500;
+constexpr size_t kPacketSlots = 1 << 11;
+static_assert(kPicturesPerChunk * kNumSpatialLayers <= kPacketSlots,
+              "A chunk of frames must fit in the packet slots.");
+
+// Holds one packet per frame in a fixed array, so that looking up packets
+// does not add to the measured time.
+class FakePacketBuffer : public PacketBuffer {
+ public:
+  FakePacketBuffer()
+      : PacketBuffer(nullptr, 0, 0, nullptr), packets_(kPacketSlots) {}
+
+  VCMPacket* GetPacket(uint16_t seq_num) override {
+    return &packets_[seq_num % kPacketSlots];
+  }
+
+  bool InsertPacket(VCMPacket* packet) override {
+    packets_[packet->seqNum % kPacketSlots] = *packet;
+    return true;
+  }
+
+  bool GetBitstream(const RtpFrameObject& frame,
+                    uint8_t* destination) override {
+    return true;
+  }
+
+  void ReturnFrame(RtpFrameObject* frame) override {}
+
+ private:
+  std::vector<VCMPacket> packets_;
+};
+
+// Keeps the completed frames so that they are destroyed outside of the timed
+// region.
+class FrameCollector : public OnCompleteFrameCallback {
+ public:
+  void OnCompleteFrame(std::unique_ptr<FrameObject> frame) override {
+    frames_.push_back(std::move(frame));
+    ++num_frames_;
+  }
+
+  void Clear() { frames_.clear(); }
+  int num_frames() const { return num_frames_; }
+
+ private:
+  std::vector<std::unique_ptr<FrameObject>> frames_;
+  int num_frames_ = 0;
+};
+
+// Feeds a VP9 stream with 3 temporal layers (0212...) and 3 spatial layers in
+// non-flexible mode to a reference finder. If |reorder_interval| is non-zero,
+// every |reorder_interval|th picture is delivered after the following one,
+// which makes the reference finder stash frames.
+void RunVp9SvcBenchmark(const std::string& trace, int reorder_interval) {
+  rtc::scoped_refptr<FakePacketBuffer> packet_buffer(new FakePacketBuffer());
+  FrameCollector frame_collector;
+  RtpFrameReferenceFinder reference_finder(&frame_collector);
+
+  GofInfoVP9 gof;
+  gof.SetGofInfoVP9(kTemporalStructureMode3);
+
+  std::vector<int> picture_order;
+  for (int pid = 0; pid < kNumPictures; ++pid)
+    picture_order.push_back(pid);
+  if (reorder_interval > 0) {
+    for (int pid = reorder_interval; pid + 1 < kNumPictures;
+         pid += reorder_interval) {
+      std::swap(picture_order[pid], picture_order[pid + 1]);
+    }
+  }
+
+  int64_t elapsed_ns = 0;
+  std::vector<std::unique_ptr<RtpFrameObject>> frames;
+  for (int chunk = 0; chunk < kNumPictures; chunk += kPicturesPerChunk) {
+    for (int i = chunk; i < chunk + kPicturesPerChunk; ++i) {
+      const int pid = picture_order[i];
+      const size_t gof_idx = pid % gof.num_frames_in_gof;
+      for (int sid = 0; sid < kNumSpatialLayers; ++sid) {
+        VCMPacket packet;
+        packet.codec = kVideoCodecVP9;
+        packet.timestamp = pid * 3000;
+        packet.seqNum = static_cast<uint16_t>(pid * kNumSpatialLayers + sid);
+        packet.markerBit = true;
+        packet.frameType = pid == 0 ? kVideoFrameKey : kVideoFrameDelta;
+        RTPVideoHeaderVP9& vp9 = packet.video_header.codecHeader.VP9;
+        vp9.flexible_mode = false;
+        vp9.picture_id = pid % (1 << 15);
+        vp9.spatial_idx = sid;
+        vp9.temporal_idx = gof.temporal_idx[gof_idx];
+        vp9.tl0_pic_idx = (pid / gof.num_frames_in_gof) % 256;
+        vp9.temporal_up_switch = gof.temporal_up_switch[gof_idx];
+        if (pid == 0) {
+          vp9.ss_data_available = true;
+          vp9.gof = gof;
+        }
+        packet_buffer->InsertPacket(&packet);
+        frames.emplace_back(new RtpFrameObject(packet_buffer, packet.seqNum,
+                                               packet.seqNum, 0, 0, 0));
+      }
+    }
+
+    int64_t start_ns = rtc::TimeNanos();
+    for (auto& frame : frames)
+      reference_finder.ManageFrame(std::move(frame));
+    elapsed_ns += rtc::TimeNanos() - start_ns;
+    frames.clear();
+    frame_collector.Clear();
+  }
+
+  EXPECT_EQ(kNumPictures * kNumSpatialLayers, frame_collector.num_frames());
+  webrtc::test::PrintResult(
+      "rtp_frame_reference_finder", "_vp9_3tl_3sl", trace,
+      frame_collector.num_frames() * rtc::kNumNanosecsPerSec /
+          std::max<int64_t>(elapsed_ns, 1),
+      "frames/s", true);
+}
+}  // namespace
+
+TEST(RtpFrameReferenceFinderPerformanceTest, Vp9SvcInOrder) {
+  RunVp9SvcBenchmark("in_order", 0);
+}
+
+TEST(RtpFrameReferenceFinderPerformanceTest, Vp9SvcReordered) {
+  RunVp9SvcBenchmark("reordered", 7);
+}
+
+}  // namespace video_coding
+}  // namespace webrtc
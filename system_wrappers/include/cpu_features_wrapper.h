@@ -20,7 +20,8 @@ extern "C" {
 // List of features in x86.
 typedef enum {
   kSSE2,
-  kSSE3
+  kSSE3,
+  kAVX2
 } CPUFeature;
 
 // List of features in ARM.
@@ -44,6 +44,28 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
     : "a"(info_type));
 }
 #endif
+
+// Intrinsic for "cpuid" with a sub-leaf, needed for the extended feature flags.
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_leaf) {
+  __asm__ volatile(
+#if defined(__pic__) && defined(__i386__)
+    "mov %%ebx, %%edi\n"
+    "cpuid\n"
+    "xchg %%edi, %%ebx\n"
+    : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+#else
+    "cpuid\n"
+    : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+#endif
+    : "a"(info_type), "c"(sub_leaf));
+}
+
+// Intrinsic for "xgetbv", reading the OS-enabled register state.
+static inline uint64_t _xgetbv(uint32_t xcr) {
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
 #endif  // _MSC_VER
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
@@ -58,6 +80,17 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  if (feature == kAVX2) {
+    // AVX2 also requires the OS to save the YMM registers on context switch,
+    // signalled by OSXSAVE + AVX in CPUID and the XMM/YMM bits in XCR0.
+    if ((cpu_info[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6)
+      return 0;
+    __cpuid(cpu_info, 0);
+    if (cpu_info[0] < 7)
+      return 0;
+    __cpuidex(cpu_info, 7, 0);
+    return 0 != (cpu_info[1] & 0x00000020);
+  }
   return 0;
 }
 #else
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/test/parallel_runner.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/format_macros.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
+DEFINE_int32(threads, 0, "Worker threads, or 0 for one per core.");
+DEFINE_string(output, "", "CSV output file, or empty for stdout.");
+
+namespace webrtc {
+namespace test {
+
+ParallelRunner::ParallelRunner(size_t num_jobs,
+                               const char* thread_name,
+                               std::function<void(size_t)> job)
+    : num_jobs_(num_jobs),
+      thread_name_(thread_name),
+      job_(std::move(job)),
+      next_job_(0),
+      output_(nullptr) {}
+
+ParallelRunner::~ParallelRunner() {
+  if (output_ && output_ != stdout)
+    fclose(output_);
+}
+
+bool ParallelRunner::OpenOutput() {
+  if (FLAGS_output.empty()) {
+    output_ = stdout;
+    return true;
+  }
+  output_ = fopen(FLAGS_output.c_str(), "w");
+  if (!output_) {
+    fprintf(stderr, "Cannot open output file %s\n", FLAGS_output.c_str());
+    return false;
+  }
+  return true;
+}
+
+int64_t ParallelRunner::Run(const char* jobs_name) {
+  size_t num_threads = FLAGS_threads > 0 ? static_cast<size_t>(FLAGS_threads)
+                                         : CpuInfo::DetectNumberOfCores();
+  num_threads = std::max<size_t>(1, std::min(num_threads, num_jobs_));
+  fprintf(stderr, "Running %" PRIuS " %s on %" PRIuS " threads.\n", num_jobs_,
+          jobs_name, num_threads);
+  const int64_t start_ms = rtc::TimeMillis();
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&RunWorker, this, thread_name_));
+    threads.back()->Start();
+  }
+  for (const auto& thread : threads)
+    thread->Stop();
+  const int64_t wall_time_ms = rtc::TimeMillis() - start_ms;
+  fprintf(stderr, "Done in %lld ms.\n", static_cast<long long>(wall_time_ms));
+  return wall_time_ms;
+}
+
+bool ParallelRunner::RunWorker(void* obj) {
+  ParallelRunner* runner = static_cast<ParallelRunner*>(obj);
+  while (runner->RunNextJob()) {
+  }
+  return false;
+}
+
+bool ParallelRunner::RunNextJob() {
+  const size_t index =
+      static_cast<size_t>(rtc::AtomicOps::Increment(&next_job_) - 1);
+  if (index >= num_jobs_)
+    return false;
+  job_(index);
+  return true;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_TEST_PARALLEL_RUNNER_H_
+#define WEBRTC_TEST_PARALLEL_RUNNER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <functional>
+
+#include "webrtc/base/constructormagic.h"
+
+namespace webrtc {
+namespace test {
+
+// Runs the independent jobs of an offline benchmark tool, such as the traces
+// to replay or the scenarios to simulate, on a pool of worker threads, each
+// taking the next job not yet taken until all are done. Defines the --threads
+// flag, for the number of worker threads, and the --output flag, for the file
+// to write the results to, of such tools.
+class ParallelRunner {
+ public:
+  // |job| is called once with each index in [0, |num_jobs|), from any of the
+  // worker threads, so it must only touch the state of that job.
+  ParallelRunner(size_t num_jobs,
+                 const char* thread_name,
+                 std::function<void(size_t)> job);
+  // Closes the output file.
+  ~ParallelRunner();
+
+  // Opens the file given by --output, or stdout if none. Returns false, after
+  // printing why, if it can't be opened.
+  bool OpenOutput();
+  FILE* output() const { return output_; }
+
+  // Runs all jobs, and prints the number of threads used and the time taken
+  // to stderr, naming the jobs by the plural |jobs_name|. Returns the wall
+  // time taken in milliseconds.
+  int64_t Run(const char* jobs_name);
+
+ private:
+  // Runs all jobs at once, since PlatformThread::Stop() ends the loop calling
+  // it.
+  static bool RunWorker(void* obj);
+  bool RunNextJob();
+
+  const size_t num_jobs_;
+  const char* const thread_name_;
+  const std::function<void(size_t)> job_;
+  volatile int next_job_;
+  FILE* output_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ParallelRunner);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_TEST_PARALLEL_RUNNER_H_
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_TEST_TESTSUPPORT_SIMD_KERNELS_H_
+#define WEBRTC_TEST_TESTSUPPORT_SIMD_KERNELS_H_
+
+#include <vector>
+
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/typedefs.h"
+
+// Wrap the x86 and NEON versions of a kernel passed to SupportedSimdKernels()
+// in these, which give nullptr when building for other architectures.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#define WEBRTC_X86_KERNEL(kernel) (kernel)
+#else
+#define WEBRTC_X86_KERNEL(kernel) nullptr
+#endif
+#if defined(WEBRTC_HAS_NEON)
+#define WEBRTC_NEON_KERNEL(kernel) (kernel)
+#else
+#define WEBRTC_NEON_KERNEL(kernel) nullptr
+#endif
+
+namespace webrtc {
+namespace test {
+
+// One SIMD version of a kernel. |Kernel| is usually a function pointer, or a
+// pointer to a table of them for kernels which come in groups.
+template <typename Kernel>
+struct SimdKernel {
+  const char* instruction_set;
+  Kernel kernel;
+};
+
+// Returns the SSE2, AVX2 and NEON versions of a kernel which the CPU running
+// the test supports, so that a test can check each of them against the C
+// version:
+//
+//   for (const auto& simd : test::SupportedSimdKernels<Function>(
+//            WEBRTC_X86_KERNEL(&Foo_SSE2), WEBRTC_X86_KERNEL(&Foo_AVX2),
+//            WEBRTC_NEON_KERNEL(&Foo_NEON))) {
+//     SCOPED_TRACE(simd.instruction_set);
+//     ExpectMatchesC(simd.kernel);
+//   }
+//
+// Pass nullptr for the versions a kernel doesn't have.
+template <typename Kernel>
+std::vector<SimdKernel<Kernel>> SupportedSimdKernels(Kernel sse2,
+                                                     Kernel avx2,
+                                                     Kernel neon) {
+  std::vector<SimdKernel<Kernel>> kernels;
+  if (sse2 && WebRtc_GetCPUInfo(kSSE2))
+    kernels.push_back({"SSE2", sse2});
+  if (avx2 && WebRtc_GetCPUInfo(kAVX2))
+    kernels.push_back({"AVX2", avx2});
+  // NEON is required by the builds which have the NEON versions.
+  if (neon)
+    kernels.push_back({"NEON", neon});
+  return kernels;
+}
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_TEST_TESTSUPPORT_SIMD_KERNELS_H_
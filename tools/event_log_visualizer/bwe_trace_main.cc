@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/modules/remote_bitrate_estimator/include/bwe_trace.h"
+#include "webrtc/tools/event_log_visualizer/plot_base.h"
+#include "webrtc/tools/event_log_visualizer/plot_python.h"
+
+DEFINE_bool(plot_all, true, "Plot all different data types.");
+DEFINE_bool(plot_bitrate,
+            false,
+            "Plot the delay-based and AIMD estimates, the probes and the "
+            "acked bitrate.");
+DEFINE_bool(plot_detector,
+            false,
+            "Plot the delay trend when the overuse detector changed state, "
+            "against its threshold.");
+DEFINE_bool(plot_pacer, false, "Plot the size of the pacer queue.");
+
+namespace webrtc {
+namespace plotting {
+namespace {
+
+constexpr float kLeftMargin = 0.01f;
+constexpr float kRightMargin = 0.02f;
+constexpr float kBottomMargin = 0.02f;
+constexpr float kTopMargin = 0.05f;
+
+// Plots the records of a BWE trace against the time since the first one.
+class BweTraceAnalyzer {
+ public:
+  explicit BweTraceAnalyzer(const std::vector<BweTraceRecord>& records)
+      : records_(records), begin_time_ms_(0), duration_s_(0) {
+    if (!records_.empty()) {
+      begin_time_ms_ = records_.front().time_ms;
+      duration_s_ = ToSeconds(records_.back().time_ms);
+    }
+  }
+
+  void CreateBitrateGraph(Plot* plot) {
+    TimeSeries estimate = NewSeries("Delay-based estimate", LINE_DOT_GRAPH);
+    TimeSeries acked = NewSeries("Acked bitrate", LINE_DOT_GRAPH);
+    TimeSeries aimd = NewSeries("AIMD bitrate", LINE_GRAPH);
+    TimeSeries incoming = NewSeries("AIMD incoming bitrate", LINE_GRAPH);
+    TimeSeries clusters = NewSeries("Probe clusters", BAR_GRAPH);
+    TimeSeries probes = NewSeries("Probe results", BAR_GRAPH);
+    for (const BweTraceRecord& record : records_) {
+      const float x = ToSeconds(record.time_ms);
+      switch (record.type) {
+        case BweTraceRecord::kDelayBasedEstimate:
+          estimate.points.emplace_back(x, ToKbps(record.values[0]));
+          if (record.values[1] >= 0)
+            acked.points.emplace_back(x, ToKbps(record.values[1]));
+          break;
+        case BweTraceRecord::kRateControl:
+          aimd.points.emplace_back(x, ToKbps(record.values[0]));
+          incoming.points.emplace_back(x, ToKbps(record.values[1]));
+          break;
+        case BweTraceRecord::kProbeCluster:
+          clusters.points.emplace_back(x, ToKbps(record.values[0]));
+          break;
+        case BweTraceRecord::kProbeResult:
+          probes.points.emplace_back(x, ToKbps(record.values[0]));
+          break;
+      }
+    }
+    AddSeries(plot, &estimate);
+    AddSeries(plot, &acked);
+    AddSeries(plot, &aimd);
+    AddSeries(plot, &incoming);
+    AddSeries(plot, &clusters);
+    AddSeries(plot, &probes);
+
+    plot->SetXAxis(0, duration_s_, "Time (s)", kLeftMargin, kRightMargin);
+    plot->SetSuggestedYAxis(0, 10, "Bitrate (kbps)", kBottomMargin,
+                            kTopMargin);
+    plot->SetTitle("Congestion controller bitrates");
+  }
+
+  void CreateDetectorGraph(Plot* plot) {
+    static const char* const kStateNames[] = {"Normal", "Underusing",
+                                              "Overusing"};
+    std::map<int32_t, TimeSeries> trends;
+    TimeSeries threshold = NewSeries("Threshold", LINE_DOT_GRAPH);
+    for (const BweTraceRecord& record : records_) {
+      if (record.type != BweTraceRecord::kDelayBasedDetection)
+        continue;
+      const float x = ToSeconds(record.time_ms);
+      auto it = trends.find(record.state);
+      if (it == trends.end()) {
+        const std::string state =
+            record.state >= 0 && record.state < 3
+                ? kStateNames[record.state]
+                : std::to_string(record.state);
+        it = trends.insert(std::make_pair(
+                 record.state, NewSeries("Trend at change to " + state,
+                                         BAR_GRAPH))).first;
+      }
+      it->second.points.emplace_back(x, record.values[0]);
+      threshold.points.emplace_back(x, record.values[1]);
+    }
+    for (auto& trend : trends)
+      AddSeries(plot, &trend.second);
+    AddSeries(plot, &threshold);
+
+    plot->SetXAxis(0, duration_s_, "Time (s)", kLeftMargin, kRightMargin);
+    plot->SetSuggestedYAxis(0, 1, "Delay trend", kBottomMargin, kTopMargin);
+    plot->SetTitle("Overuse detector state changes");
+  }
+
+  void CreatePacerGraph(Plot* plot) {
+    TimeSeries bytes = NewSeries("Queued bytes", LINE_GRAPH);
+    TimeSeries packets = NewSeries("Queued packets", LINE_GRAPH);
+    TimeSeries queue_time = NewSeries("Average queue time (ms)", LINE_GRAPH);
+    for (const BweTraceRecord& record : records_) {
+      if (record.type != BweTraceRecord::kPacerQueue)
+        continue;
+      const float x = ToSeconds(record.time_ms);
+      bytes.points.emplace_back(x, record.values[0]);
+      packets.points.emplace_back(x, record.state);
+      queue_time.points.emplace_back(x, record.values[1]);
+    }
+    AddSeries(plot, &bytes);
+    AddSeries(plot, &packets);
+    AddSeries(plot, &queue_time);
+
+    plot->SetXAxis(0, duration_s_, "Time (s)", kLeftMargin, kRightMargin);
+    plot->SetSuggestedYAxis(0, 1, "Queue", kBottomMargin, kTopMargin);
+    plot->SetTitle("Pacer queue");
+  }
+
+ private:
+  static TimeSeries NewSeries(const std::string& label, PlotStyle style) {
+    TimeSeries series;
+    series.label = label;
+    series.style = style;
+    return series;
+  }
+
+  // Leaves out the series without points, so the legend shows what happened.
+  static void AddSeries(Plot* plot, TimeSeries* series) {
+    if (!series->points.empty())
+      plot->series_list_.push_back(std::move(*series));
+  }
+
+  static float ToKbps(double bps) { return static_cast<float>(bps / 1000); }
+
+  float ToSeconds(int64_t time_ms) const {
+    return static_cast<float>(time_ms - begin_time_ms_) / 1000;
+  }
+
+  const std::vector<BweTraceRecord>& records_;
+  int64_t begin_time_ms_;
+  float duration_s_;
+};
+
+}  // namespace
+}  // namespace plotting
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "A tool for visualizing BWE traces written by "
+      "webrtc::bwe_trace::Dump().\n"
+      "Example usage:\n" +
+      program_name + " <tracefile> | python\n" + "Run " + program_name +
+      " --help for a list of command line options\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (argc != 2) {
+    // Print usage information.
+    std::cout << google::ProgramUsage();
+    return 0;
+  }
+
+  FILE* file = fopen(argv[1], "rb");
+  if (!file) {
+    std::cerr << "Could not open " << argv[1] << std::endl;
+    return 1;
+  }
+  std::vector<webrtc::BweTraceRecord> records;
+  const bool success = webrtc::bwe_trace::Read(file, &records);
+  fclose(file);
+  if (!success) {
+    std::cerr << "Could not read the entire trace file." << std::endl;
+    std::cerr << "Proceeding to plot the first " << records.size()
+              << " records in the file." << std::endl;
+  }
+
+  webrtc::plotting::BweTraceAnalyzer analyzer(records);
+  std::unique_ptr<webrtc::plotting::PlotCollection> collection(
+      new webrtc::plotting::PythonPlotCollection());
+
+  if (FLAGS_plot_all || FLAGS_plot_bitrate) {
+    analyzer.CreateBitrateGraph(collection->AppendNewPlot());
+  }
+
+  if (FLAGS_plot_all || FLAGS_plot_detector) {
+    analyzer.CreateDetectorGraph(collection->AppendNewPlot());
+  }
+
+  if (FLAGS_plot_all || FLAGS_plot_pacer) {
+    analyzer.CreatePacerGraph(collection->AppendNewPlot());
+  }
+
+  collection->Draw();
+
+  return 0;
+}
@@ -27,6 +27,7 @@
 #include "webrtc/modules/rtp_rtcp/include/rtp_receiver.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp.h"
 #include "webrtc/modules/rtp_rtcp/include/ulpfec_receiver.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "webrtc/modules/video_coding/frame_object.h"
 #include "webrtc/modules/video_coding/h264_sprop_parameter_sets.h"
 #include "webrtc/modules/video_coding/h264_sps_pps_tracker.h"
@@ -336,57 +337,73 @@ void RtpStreamReceiver::OnIncomingSSRCChanged(const uint32_t ssrc) {
 bool RtpStreamReceiver::DeliverRtp(const uint8_t* rtp_packet,
                                    size_t rtp_packet_length,
                                    const PacketTime& packet_time) {
-  RTC_DCHECK(remote_bitrate_estimator_);
-  {
-    rtc::CritScope lock(&receive_cs_);
-    if (!receiving_) {
-      return false;
-    }
-  }
-
   RTPHeader header;
   if (!rtp_header_parser_->Parse(rtp_packet, rtp_packet_length,
                                  &header)) {
     return false;
   }
-  size_t payload_length = rtp_packet_length - header.headerLength;
   int64_t arrival_time_ms;
-  int64_t now_ms = clock_->TimeInMilliseconds();
   if (packet_time.timestamp != -1)
     arrival_time_ms = (packet_time.timestamp + 500) / 1000;
   else
-    arrival_time_ms = now_ms;
+    arrival_time_ms = clock_->TimeInMilliseconds();
+  return DeliverParsedRtp(rtp_packet, rtp_packet_length, &header,
+                          arrival_time_ms);
+}
+
+bool RtpStreamReceiver::OnRtpPacket(const RtpPacketReceived& packet) {
+  RTPHeader header;
+  packet.GetHeader(&header);
+  return DeliverParsedRtp(packet.data(), packet.size(), &header,
+                          packet.arrival_time_ms());
+}
+
+bool RtpStreamReceiver::DeliverParsedRtp(const uint8_t* rtp_packet,
+                                         size_t rtp_packet_length,
+                                         RTPHeader* header,
+                                         int64_t arrival_time_ms) {
+  RTC_DCHECK(remote_bitrate_estimator_);
+  {
+    rtc::CritScope lock(&receive_cs_);
+    if (!receiving_) {
+      return false;
+    }
+  }
+
+  size_t payload_length = rtp_packet_length - header->headerLength;
+  int64_t now_ms = clock_->TimeInMilliseconds();
 
   {
     // Periodically log the RTP header of incoming packets.
     rtc::CritScope lock(&receive_cs_);
     if (now_ms - last_packet_log_ms_ > kPacketLogIntervalMs) {
       std::stringstream ss;
-      ss << "Packet received on SSRC: " << header.ssrc << " with payload type: "
-         << static_cast<int>(header.payloadType) << ", timestamp: "
-         << header.timestamp << ", sequence number: " << header.sequenceNumber
+      ss << "Packet received on SSRC: " << header->ssrc
+         << " with payload type: " << static_cast<int>(header->payloadType)
+         << ", timestamp: " << header->timestamp
+         << ", sequence number: " << header->sequenceNumber
          << ", arrival time: " << arrival_time_ms;
-      if (header.extension.hasTransmissionTimeOffset)
-        ss << ", toffset: " << header.extension.transmissionTimeOffset;
-      if (header.extension.hasAbsoluteSendTime)
-        ss << ", abs send time: " << header.extension.absoluteSendTime;
+      if (header->extension.hasTransmissionTimeOffset)
+        ss << ", toffset: " << header->extension.transmissionTimeOffset;
+      if (header->extension.hasAbsoluteSendTime)
+        ss << ", abs send time: " << header->extension.absoluteSendTime;
       LOG(LS_INFO) << ss.str();
       last_packet_log_ms_ = now_ms;
     }
   }
 
   remote_bitrate_estimator_->IncomingPacket(arrival_time_ms, payload_length,
-                                            header);
-  header.payload_type_frequency = kVideoPayloadTypeFrequency;
+                                            *header);
+  header->payload_type_frequency = kVideoPayloadTypeFrequency;
 
-  bool in_order = IsPacketInOrder(header);
-  rtp_payload_registry_.SetIncomingPayloadType(header);
-  bool ret = ReceivePacket(rtp_packet, rtp_packet_length, header, in_order);
+  bool in_order = IsPacketInOrder(*header);
+  rtp_payload_registry_.SetIncomingPayloadType(*header);
+  bool ret = ReceivePacket(rtp_packet, rtp_packet_length, *header, in_order);
   // Update receive statistics after ReceivePacket.
   // Receive statistics will be reset if the payload type changes (make sure
   // that the first packet is included in the stats).
   rtp_receive_statistics_->IncomingPacket(
-      header, rtp_packet_length, IsPacketRetransmitted(header, in_order));
+      *header, rtp_packet_length, IsPacketRetransmitted(*header, in_order));
   return ret;
 }
 
@@ -46,6 +46,7 @@ class RemoteNtpTimeEstimator;
 class RtcpRttStats;
 class RtpHeaderParser;
 class RTPPayloadRegistry;
+class RtpPacketReceived;
 class RtpReceiver;
 class Transport;
 class UlpfecReceiver;
@@ -99,6 +100,9 @@ class RtpStreamReceiver : public RtpData,
   bool DeliverRtp(const uint8_t* rtp_packet,
                   size_t rtp_packet_length,
                   const PacketTime& packet_time);
+  // Same as DeliverRtp, for a packet that has already been parsed with this
+  // stream's header extensions identified.
+  bool OnRtpPacket(const RtpPacketReceived& packet);
   bool DeliverRtcp(const uint8_t* rtcp_packet, size_t rtcp_packet_length);
 
   void FrameContinuous(uint16_t seq_num);
@@ -146,6 +150,10 @@ class RtpStreamReceiver : public RtpData,
   void OnRttUpdate(int64_t avg_rtt_ms, int64_t max_rtt_ms) override;
 
  private:
+  bool DeliverParsedRtp(const uint8_t* rtp_packet,
+                        size_t rtp_packet_length,
+                        RTPHeader* header,
+                        int64_t arrival_time_ms);
   bool ReceivePacket(const uint8_t* packet,
                      size_t packet_length,
                      const RTPHeader& header,
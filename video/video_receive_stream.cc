@@ -282,6 +282,10 @@ bool VideoReceiveStream::DeliverRtp(const uint8_t* packet,
   return rtp_stream_receiver_.DeliverRtp(packet, length, packet_time);
 }
 
+bool VideoReceiveStream::OnRtpPacket(const RtpPacketReceived& packet) {
+  return rtp_stream_receiver_.OnRtpPacket(packet);
+}
+
 bool VideoReceiveStream::OnRecoveredPacket(const uint8_t* packet,
                                            size_t length) {
   return rtp_stream_receiver_.OnRecoveredPacket(packet, length);
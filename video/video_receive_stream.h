@@ -34,6 +34,7 @@ class CongestionController;
 class IvfFileWriter;
 class ProcessThread;
 class RTPFragmentationHeader;
+class RtpPacketReceived;
 class VoiceEngine;
 class VieRemb;
 class VCMTiming;
@@ -63,6 +64,7 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   bool DeliverRtp(const uint8_t* packet,
                   size_t length,
                   const PacketTime& packet_time);
+  bool OnRtpPacket(const RtpPacketReceived& packet);
 
   bool OnRecoveredPacket(const uint8_t* packet, size_t length);
 
@@ -15,6 +15,7 @@
 
 #include "webrtc/audio/utility/audio_frame_operations.h"
 #include "webrtc/base/array_view.h"
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/format_macros.h"
@@ -28,6 +29,7 @@
 #include "webrtc/modules/audio_coding/codecs/audio_format_conversion.h"
 #include "webrtc/modules/audio_device/include/audio_device.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/modules/include/module.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/pacing/packet_router.h"
 #include "webrtc/modules/rtp_rtcp/include/receive_statistics.h"
@@ -50,6 +52,11 @@ namespace {
 
 constexpr int64_t kMaxRetransmissionWindowMs = 1000;
 constexpr int64_t kMinRetransmissionWindowMs = 30;
+// More packets than NetEq buffers, so that only a stalled audio thread makes
+// the queue drop packets.
+constexpr size_t kReceivedPacketQueueCapacity = 64;
+// As often as the RTP/RTCP module is processed.
+constexpr int64_t kNackSenderProcessIntervalMs = 5;
 
 }  // namespace
 
@@ -379,6 +386,44 @@ class VoERtcpObserver : public RtcpBandwidthObserver {
   std::map<uint32_t, uint32_t> extended_max_sequence_number_;
 };
 
+// Sends the NACK lists computed on the audio thread, for channels which queue
+// their received packets, from the process thread. Building and sending the
+// RTCP packet would otherwise add to the time the audio thread needs for a
+// frame.
+class NackSender : public Module {
+ public:
+  explicit NackSender(RtpRtcp* rtp_rtcp) : rtp_rtcp_(rtp_rtcp) {}
+  ~NackSender() override {}
+
+  // Replaces the list not yet sent, if any, since |nack_list| is newer.
+  void SetNackList(std::vector<uint16_t>* nack_list) {
+    rtc::CritScope lock(&crit_);
+    pending_nack_list_.swap(*nack_list);
+  }
+
+  int64_t TimeUntilNextProcess() override {
+    return kNackSenderProcessIntervalMs;
+  }
+
+  void Process() override {
+    {
+      rtc::CritScope lock(&crit_);
+      if (pending_nack_list_.empty())
+        return;
+      nack_list_.swap(pending_nack_list_);
+      pending_nack_list_.clear();
+    }
+    rtp_rtcp_->SendNACK(&nack_list_[0], static_cast<int>(nack_list_.size()));
+  }
+
+ private:
+  RtpRtcp* const rtp_rtcp_;
+  rtc::CriticalSection crit_;
+  std::vector<uint16_t> pending_nack_list_ GUARDED_BY(crit_);
+  // Only used on the process thread.
+  std::vector<uint16_t> nack_list_;
+};
+
 int32_t Channel::SendData(FrameType frameType,
                           uint8_t payloadType,
                           uint32_t timeStamp,
@@ -550,7 +595,20 @@ int32_t Channel::OnReceivedPayloadData(const uint8_t* payloadData,
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, _channelId),
                  "received packet is discarded since playing is not"
                  " activated");
-    _numberOfDiscardedPackets++;
+    rtc::AtomicOps::Increment(&_numberOfDiscardedPackets);
+    return 0;
+  }
+
+  if (received_packet_queue_) {
+    // The audio thread inserts the packet, and updates the NACK list, before
+    // it decodes. See InsertReceivedPackets().
+    if (!received_packet_queue_->Push(
+            *rtpHeader, payloadData, payloadSize,
+            rtc::AtomicOps::AcquireLoad(&received_packet_generation_))) {
+      WEBRTC_TRACE(kTraceWarning, kTraceVoice, VoEId(_instanceId, _channelId),
+                   "received packet is discarded since the queue is full");
+      rtc::AtomicOps::Increment(&_numberOfDiscardedPackets);
+    }
     return 0;
   }
 
@@ -563,16 +621,7 @@ int32_t Channel::OnReceivedPayloadData(const uint8_t* payloadData,
     return -1;
   }
 
-  int64_t round_trip_time = 0;
-  _rtpRtcpModule->RTT(rtp_receiver_->SSRC(), &round_trip_time, NULL, NULL,
-                      NULL);
-
-  std::vector<uint16_t> nack_list = audio_coding_->GetNackList(round_trip_time);
-  if (!nack_list.empty()) {
-    // Can't use nack_list.data() since it's not supported by all
-    // compilers.
-    ResendPackets(&(nack_list[0]), static_cast<int>(nack_list.size()));
-  }
+  ResendNackedPackets();
   return 0;
 }
 
@@ -597,6 +646,8 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
   unsigned int ssrc;
   RTC_CHECK_EQ(GetLocalSSRC(ssrc), 0);
   event_log_proxy_->LogAudioPlayout(ssrc);
+  if (received_packet_queue_)
+    InsertReceivedPackets();
   // Get 10ms raw PCM data from the ACM (mixer limits output frequency)
   bool muted;
   if (audio_coding_->PlayoutData10Ms(audioFrame->sample_rate_hz_, audioFrame,
@@ -610,12 +661,16 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
     return MixerParticipant::AudioFrameInfo::kError;
   }
 
-  if (muted) {
-    // TODO(henrik.lundin): We should be able to do better than this. But we
-    // will have to go through all the cases below where the audio samples may
-    // be used, and handle the muted case in some way.
-    AudioFrameOperations::Mute(audioFrame);
-  }
+  // The samples of a muted frame are not valid, and callers treat them as
+  // zeros without reading them. They are only zeroed for the consumers below
+  // which do read them.
+  bool samples_zeroed = !muted;
+  auto zero_muted_samples = [audioFrame, &samples_zeroed]() {
+    if (!samples_zeroed) {
+      AudioFrameOperations::Mute(audioFrame);
+      samples_zeroed = true;
+    }
+  };
 
   // Convert module ID to internal VoE channel ID
   audioFrame->id_ = VoEChannelId(audioFrame->id_);
@@ -631,6 +686,7 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
     // own mixing/dynamic processing.
     rtc::CritScope cs(&_callbackCritSect);
     if (audio_sink_) {
+      zero_muted_samples();
       AudioSinkInterface::Data data(
           &audioFrame->data_[0], audioFrame->samples_per_channel_,
           audioFrame->sample_rate_hz_, audioFrame->num_channels_,
@@ -650,7 +706,7 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
   }
 
   // Output volume scaling
-  if (output_gain < 0.99f || output_gain > 1.01f) {
+  if (!muted && (output_gain < 0.99f || output_gain > 1.01f)) {
     AudioFrameOperations::ScaleWithSat(output_gain, *audioFrame);
   }
 
@@ -658,6 +714,7 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
   // active
 
   if (left_pan != 1.0f || right_pan != 1.0f) {
+    zero_muted_samples();
     if (audioFrame->num_channels_ == 1) {
       // Emulate stereo mode since panning is active.
       // The mono signal is copied to both left and right channels here.
@@ -673,6 +730,7 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
 
   // Mix decoded PCM output with file if file mixing is enabled
   if (state.output_file_playing) {
+    zero_muted_samples();
     MixAudioWithFile(*audioFrame, audioFrame->sample_rate_hz_);
     muted = false;  // We may have added non-zero samples.
   }
@@ -682,6 +740,7 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
     rtc::CritScope cs(&_callbackCritSect);
     const bool isStereo = (audioFrame->num_channels_ == 2);
     if (_outputExternalMediaCallbackPtr) {
+      zero_muted_samples();
       _outputExternalMediaCallbackPtr->Process(
           _channelId, kPlaybackPerChannel, (int16_t*)audioFrame->data_,
           audioFrame->samples_per_channel_, audioFrame->sample_rate_hz_,
@@ -694,13 +753,16 @@ MixerParticipant::AudioFrameInfo Channel::GetAudioFrameWithMuted(
     rtc::CritScope cs(&_fileCritSect);
 
     if (_outputFileRecording && output_file_recorder_) {
+      zero_muted_samples();
       output_file_recorder_->RecordAudioToFile(*audioFrame);
     }
   }
 
   // Measure audio level (0-9)
-  // TODO(henrik.lundin) Use the |muted| information here too.
-  _outputAudioLevel.ComputeLevel(*audioFrame);
+  if (muted)
+    _outputAudioLevel.ComputeMutedLevel();
+  else
+    _outputAudioLevel.ComputeLevel(*audioFrame);
 
   if (capture_start_rtp_time_stamp_ < 0 && audioFrame->timestamp_ != 0) {
     // The first frame with a valid rtp timestamp.
@@ -892,6 +954,7 @@ Channel::Channel(int32_t channelId,
       playout_timestamp_rtcp_(0),
       playout_delay_ms_(0),
       _numberOfDiscardedPackets(0),
+      received_packet_generation_(0),
       send_sequence_number_(0),
       rtp_ts_wraparound_handler_(new rtc::TimestampWrapAroundHandler()),
       capture_start_rtp_time_stamp_(-1),
@@ -934,6 +997,10 @@ Channel::Channel(int32_t channelId,
   acm_config.id = VoEModuleId(instanceId, channelId);
   acm_config.neteq_config.enable_muted_state = true;
   audio_coding_.reset(AudioCodingModule::Create(acm_config));
+  if (config.queue_received_packets) {
+    received_packet_queue_.reset(
+        new ReceivedPacketQueue(kReceivedPacketQueueCapacity));
+  }
 
   _outputAudioLevel.Clear();
 
@@ -958,6 +1025,9 @@ Channel::Channel(int32_t channelId,
   _rtpRtcpModule.reset(RtpRtcp::CreateRtpRtcp(configuration));
   _rtpRtcpModule->SetSendingMediaStatus(false);
 
+  if (received_packet_queue_)
+    nack_sender_.reset(new NackSender(_rtpRtcpModule.get()));
+
   statistics_proxy_.reset(new StatisticsProxy(_rtpRtcpModule->SSRC()));
   rtp_receive_statistics_->RegisterRtcpStatisticsCallback(
       statistics_proxy_.get());
@@ -1012,6 +1082,8 @@ Channel::~Channel() {
   }
   // De-register modules in process thread
   _moduleProcessThreadPtr->DeRegisterModule(_rtpRtcpModule.get());
+  if (nack_sender_)
+    _moduleProcessThreadPtr->DeRegisterModule(nack_sender_.get());
 
   // End of modules shutdown
 }
@@ -1033,6 +1105,8 @@ int32_t Channel::Init() {
   // --- Add modules to process thread (for periodic schedulation)
 
   _moduleProcessThreadPtr->RegisterModule(_rtpRtcpModule.get());
+  if (nack_sender_)
+    _moduleProcessThreadPtr->RegisterModule(nack_sender_.get());
 
   // --- ACM initialization
 
@@ -1199,6 +1273,8 @@ int32_t Channel::StopPlayout() {
 
   channel_state_.SetPlaying(false);
   _outputAudioLevel.Clear();
+  // Don't play out the packets still queued when playout restarts.
+  rtc::AtomicOps::Increment(&received_packet_generation_);
 
   return 0;
 }
@@ -1261,7 +1337,7 @@ int32_t Channel::StopSend() {
 void Channel::ResetDiscardedPacketCount() {
   WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId, _channelId),
                "Channel::ResetDiscardedPacketCount()");
-  _numberOfDiscardedPackets = 0;
+  rtc::AtomicOps::ReleaseStore(&_numberOfDiscardedPackets, 0);
 }
 
 int32_t Channel::RegisterVoiceEngineObserver(VoiceEngineObserver& observer) {
@@ -1386,6 +1462,8 @@ int32_t Channel::SetRecPayloadType(const CodecInst& codec) {
         "SetRecPayloadType() unable to set PT while playing");
     return -1;
   }
+  // Packets queued for the old payload types aren't inserted.
+  rtc::AtomicOps::Increment(&received_packet_generation_);
 
   if (codec.pltype == -1) {
     // De-register the selected codec (RTP/RTCP module and ACM)
@@ -1601,8 +1679,10 @@ int32_t Channel::ReceivedRTPPacket(const uint8_t* received_packet,
   WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, _channelId),
                "Channel::ReceivedRTPPacket()");
 
-  // Store playout timestamp for the received RTP packet
-  UpdatePlayoutTimestamp(false);
+  // Store playout timestamp for the received RTP packet. Queued packets do
+  // it when they are inserted.
+  if (!received_packet_queue_)
+    UpdatePlayoutTimestamp(false);
 
   RTPHeader header;
   if (!rtp_header_parser_->Parse(received_packet, length, &header)) {
@@ -2615,7 +2695,8 @@ int Channel::GetRTPStatistics(unsigned int& averageJitterMs,
     averageJitterMs = stats.rtcp.jitter / (playoutFrequency / 1000);
   }
 
-  discardedPackets = _numberOfDiscardedPackets;
+  discardedPackets = static_cast<unsigned int>(
+      rtc::AtomicOps::AcquireLoad(&_numberOfDiscardedPackets));
 
   return 0;
 }
@@ -2742,6 +2823,49 @@ int Channel::ResendPackets(const uint16_t* sequence_numbers, int length) {
   return _rtpRtcpModule->SendNACK(sequence_numbers, length);
 }
 
+void Channel::ResendNackedPackets() {
+  int64_t round_trip_time = 0;
+  _rtpRtcpModule->RTT(rtp_receiver_->SSRC(), &round_trip_time, NULL, NULL,
+                      NULL);
+
+  std::vector<uint16_t> nack_list = audio_coding_->GetNackList(round_trip_time);
+  if (nack_list.empty())
+    return;
+  if (nack_sender_) {
+    // On the audio thread; the process thread sends the list.
+    nack_sender_->SetNackList(&nack_list);
+    return;
+  }
+  // Can't use nack_list.data() since it's not supported by all
+  // compilers.
+  ResendPackets(&(nack_list[0]), static_cast<int>(nack_list.size()));
+}
+
+void Channel::InsertReceivedPackets() {
+  const ReceivedPacketQueue::Packet* packet = received_packet_queue_->Front();
+  if (!packet)
+    return;
+  // Once for all the packets which arrived since the last frame, instead of
+  // once per packet on the network thread.
+  UpdatePlayoutTimestamp(false);
+  const int generation =
+      rtc::AtomicOps::AcquireLoad(&received_packet_generation_);
+  for (; packet; packet = received_packet_queue_->Front()) {
+    if (packet->generation != generation) {
+      // Received before playout stopped or the receive codecs changed.
+      rtc::AtomicOps::Increment(&_numberOfDiscardedPackets);
+    } else if (audio_coding_->IncomingPacket(packet->payload.data(),
+                                             packet->payload.size(),
+                                             packet->header) != 0) {
+      _engineStatisticsPtr->SetLastError(
+          VE_AUDIO_CODING_MODULE_ERROR, kTraceWarning,
+          "Channel::InsertReceivedPackets() unable to push data to the ACM");
+    }
+    received_packet_queue_->Pop();
+  }
+  ResendNackedPackets();
+}
+
 uint32_t Channel::Demultiplex(const AudioFrame& audioFrame) {
   WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, _channelId),
                "Channel::Demultiplex()");
@@ -3146,9 +3270,11 @@ int32_t Channel::MixAudioWithFile(AudioFrame& audioFrame, int mixingFrequency) {
 }
 
 void Channel::UpdatePlayoutTimestamp(bool rtcp) {
-  jitter_buffer_playout_timestamp_ = audio_coding_->PlayoutTimestamp();
+  // Timestamp of the audio pulled from NetEq.
+  const rtc::Optional<uint32_t> jitter_buffer_playout_timestamp =
+      audio_coding_->PlayoutTimestamp();
 
-  if (!jitter_buffer_playout_timestamp_) {
+  if (!jitter_buffer_playout_timestamp) {
     // This can happen if this channel has not received any RTP packets. In
     // this case, NetEq is not capable of computing a playout timestamp.
     return;
@@ -3165,8 +3291,7 @@ void Channel::UpdatePlayoutTimestamp(bool rtcp) {
     return;
   }
 
-  RTC_DCHECK(jitter_buffer_playout_timestamp_);
-  uint32_t playout_timestamp = *jitter_buffer_playout_timestamp_;
+  uint32_t playout_timestamp = *jitter_buffer_playout_timestamp;
 
   // Remove the playout delay.
   playout_timestamp -= (delay_ms * (GetRtpTimestampRateHz() / 1000));
@@ -33,6 +33,7 @@
 #include "webrtc/voice_engine/include/voe_base.h"
 #include "webrtc/voice_engine/include/voe_network.h"
 #include "webrtc/voice_engine/level_indicator.h"
+#include "webrtc/voice_engine/received_packet_queue.h"
 #include "webrtc/voice_engine/shared_data.h"
 #include "webrtc/voice_engine/voice_engine_defines.h"
 
@@ -65,6 +66,7 @@ struct SenderInfo;
 
 namespace voe {
 
+class NackSender;
 class OutputMixer;
 class RtcEventLogProxy;
 class RtcpRttStatsProxy;
@@ -433,6 +435,9 @@ protected:
   bool IsPacketInOrder(const RTPHeader& header) const;
   bool IsPacketRetransmitted(const RTPHeader& header, bool in_order) const;
   int ResendPackets(const uint16_t* sequence_numbers, int length);
+  void ResendNackedPackets();
+  // Inserts the packets of |received_packet_queue_| into the ACM.
+  void InsertReceivedPackets();
   int32_t MixOrReplaceAudioWithFile(int mixingFrequency);
   int32_t MixAudioWithFile(AudioFrame& audioFrame, int mixingFrequency);
   void UpdatePlayoutTimestamp(bool rtcp);
@@ -488,12 +493,19 @@ protected:
 
   RemoteNtpTimeEstimator ntp_estimator_ GUARDED_BY(ts_stats_lock_);
 
-  // Timestamp of the audio pulled from NetEq.
-  rtc::Optional<uint32_t> jitter_buffer_playout_timestamp_;
   uint32_t playout_timestamp_rtp_ GUARDED_BY(video_sync_lock_);
   uint32_t playout_timestamp_rtcp_;
   uint32_t playout_delay_ms_ GUARDED_BY(video_sync_lock_);
-  uint32_t _numberOfDiscardedPackets;
+  // Updated with rtc::AtomicOps, from the network and the audio thread.
+  volatile int _numberOfDiscardedPackets;
+  // Only set with ChannelConfig::queue_received_packets. Filled by
+  // OnReceivedPayloadData() and emptied by GetAudioFrameWithMuted().
+  std::unique_ptr<ReceivedPacketQueue> received_packet_queue_;
+  // Incremented, with rtc::AtomicOps, when the queued packets are to be
+  // discarded instead of inserted. Queued packets are tagged with it.
+  volatile int received_packet_generation_;
+  // Only set along with |received_packet_queue_|.
+  std::unique_ptr<NackSender> nack_sender_;
   uint16_t send_sequence_number_;
   uint8_t restored_packet_[kVoiceEngineMaxIpPacketSizeBytes];
 
@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/audio_device/include/fake_audio_device.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/voice_engine/channel_proxy.h"
+#include "webrtc/voice_engine/include/voe_base.h"
+#include "webrtc/voice_engine/voice_engine_impl.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kPacketDurationMs = 20;
+constexpr int kFramesPerPacket = kPacketDurationMs / 10;
+// PCMU, one byte per sample at 8 kHz.
+constexpr uint8_t kPayloadType = 0;
+constexpr size_t kPayloadSize = 8 * kPacketDurationMs;
+constexpr size_t kRtpHeaderSize = 12;
+// 2 s of audio.
+constexpr int kPacketsPerChannel = 100;
+// How far the network thread may run ahead of the audio thread, as packets
+// sitting in a jitter buffer.
+constexpr int kMaxPacketsAhead = 4;
+constexpr int kOutputRateHz = 48000;
+
+// Delivers the packets of a number of receive channels on one thread, while
+// another pulls their audio, as the network and audio threads of a client
+// with many remote participants. Each side only runs ahead of the other by
+// a few packets, so that both are busy at the same time and NetEq neither
+// runs dry nor overflows. Measures the time each side spends in the channels.
+class ReceiveBenchmark {
+ public:
+  ReceiveBenchmark(int num_channels, bool queue_received_packets)
+      : voe_(VoiceEngine::Create()),
+        base_(VoEBase::GetInterface(voe_)),
+        packets_sent_(0),
+        frames_pulled_(0),
+        network_ns_(0),
+        audio_ns_(0) {
+    EXPECT_EQ(0, base_->Init(&adm_, nullptr));
+    VoEBase::ChannelConfig config;
+    config.queue_received_packets = queue_received_packets;
+    VoiceEngineImpl* voe_impl = static_cast<VoiceEngineImpl*>(voe_);
+    for (int i = 0; i < num_channels; ++i) {
+      const int channel = base_->CreateChannel(config);
+      EXPECT_NE(-1, channel);
+      EXPECT_EQ(0, base_->StartPlayout(channel));
+      channels_.push_back(channel);
+      channel_proxies_.push_back(voe_impl->GetChannelProxy(channel));
+    }
+
+    Random random(0x5eed);
+    payload_.resize(kPayloadSize);
+    for (uint8_t& sample : payload_)
+      sample = static_cast<uint8_t>(random.Rand(0, 255));
+  }
+
+  ~ReceiveBenchmark() {
+    channel_proxies_.clear();
+    for (int channel : channels_) {
+      EXPECT_EQ(0, base_->StopPlayout(channel));
+      EXPECT_EQ(0, base_->DeleteChannel(channel));
+    }
+    EXPECT_EQ(0, base_->Terminate());
+    base_->Release();
+    EXPECT_TRUE(VoiceEngine::Delete(voe_));
+  }
+
+  void Run() {
+    rtc::PlatformThread network_thread(&ReceiveBenchmark::NetworkThread, this,
+                                       "BenchmarkNetwork");
+    network_thread.Start();
+    PullAudio();
+    network_thread.Stop();
+  }
+
+  size_t network_ns_per_packet() const {
+    return static_cast<size_t>(network_ns_) /
+           (kPacketsPerChannel * channels_.size());
+  }
+  size_t audio_ns_per_frame() const {
+    return static_cast<size_t>(audio_ns_) /
+           (kPacketsPerChannel * kFramesPerPacket * channels_.size());
+  }
+
+ private:
+  static bool NetworkThread(void* obj) {
+    static_cast<ReceiveBenchmark*>(obj)->DeliverPackets();
+    return false;
+  }
+
+  void DeliverPackets() {
+    uint8_t packet[kRtpHeaderSize + kPayloadSize];
+    for (int i = 0; i < kPacketsPerChannel; ++i) {
+      while (i > rtc::AtomicOps::AcquireLoad(&frames_pulled_) /
+                         kFramesPerPacket +
+                     kMaxPacketsAhead) {
+        SleepMs(0);
+      }
+      const int64_t start_ns = rtc::TimeNanos();
+      for (size_t channel = 0; channel < channel_proxies_.size(); ++channel) {
+        WriteRtpPacket(i, static_cast<uint32_t>(channel + 1), packet);
+        EXPECT_TRUE(channel_proxies_[channel]->ReceivedRTPPacket(
+            packet, sizeof(packet), PacketTime()));
+      }
+      network_ns_ += rtc::TimeNanos() - start_ns;
+      rtc::AtomicOps::ReleaseStore(&packets_sent_, i + 1);
+    }
+  }
+
+  void PullAudio() {
+    AudioFrame frame;
+    for (int i = 0; i < kPacketsPerChannel * kFramesPerPacket; ++i) {
+      // Waits for the packet of the frame.
+      while (i / kFramesPerPacket >=
+             rtc::AtomicOps::AcquireLoad(&packets_sent_)) {
+        SleepMs(0);
+      }
+      const int64_t start_ns = rtc::TimeNanos();
+      for (const auto& channel_proxy : channel_proxies_)
+        channel_proxy->GetAudioFrameWithInfo(kOutputRateHz, &frame);
+      audio_ns_ += rtc::TimeNanos() - start_ns;
+      rtc::AtomicOps::ReleaseStore(&frames_pulled_, i + 1);
+    }
+  }
+
+  void WriteRtpPacket(int index, uint32_t ssrc, uint8_t* packet) const {
+    const uint16_t sequence_number = static_cast<uint16_t>(index);
+    const uint32_t timestamp = static_cast<uint32_t>(index * kPayloadSize);
+    packet[0] = 0x80;
+    packet[1] = kPayloadType;
+    packet[2] = sequence_number >> 8;
+    packet[3] = sequence_number & 0xff;
+    for (int i = 0; i < 4; ++i) {
+      packet[4 + i] = static_cast<uint8_t>(timestamp >> (24 - 8 * i));
+      packet[8 + i] = static_cast<uint8_t>(ssrc >> (24 - 8 * i));
+    }
+    memcpy(packet + kRtpHeaderSize, payload_.data(), kPayloadSize);
+  }
+
+  FakeAudioDeviceModule adm_;
+  VoiceEngine* voe_;
+  VoEBase* const base_;
+  std::vector<int> channels_;
+  std::vector<std::unique_ptr<voe::ChannelProxy>> channel_proxies_;
+  std::vector<uint8_t> payload_;
+
+  // Written by the network thread.
+  volatile int packets_sent_;
+  // Written by the audio thread.
+  volatile int frames_pulled_;
+  int64_t network_ns_;
+  int64_t audio_ns_;
+};
+
+}  // namespace
+
+// Compares inserting the packets into NetEq as they arrive with handing them
+// to the audio thread through the queue of each channel.
+TEST(ChannelReceivePerformanceTest, InsertionOnNetworkAndAudioThread) {
+  for (int num_channels : {10, 100}) {
+    for (bool queue_received_packets : {false, true}) {
+      ReceiveBenchmark benchmark(num_channels, queue_received_packets);
+      benchmark.Run();
+
+      const std::string trace = "_" + std::to_string(num_channels);
+      const std::string mode = queue_received_packets ? "queued" : "direct";
+      webrtc::test::PrintResult("voe_receive", trace, mode + "_network_packet",
+                                benchmark.network_ns_per_packet(), "ns", true);
+      webrtc::test::PrintResult("voe_receive", trace, mode + "_audio_frame",
+                                benchmark.audio_ns_per_frame(), "ns", true);
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -8,8 +8,224 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "webrtc/api/call/transport.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/modules/audio_device/include/fake_audio_device.h"
 #include "webrtc/test/gtest.h"
+#include "webrtc/test/rtcp_packet_parser.h"
 #include "webrtc/voice_engine/channel.h"
+#include "webrtc/voice_engine/channel_proxy.h"
+#include "webrtc/voice_engine/include/voe_base.h"
+#include "webrtc/voice_engine/include/voe_rtp_rtcp.h"
+#include "webrtc/voice_engine/voice_engine_impl.h"
+
+namespace webrtc {
+namespace voe {
+namespace {
+
+// 20 ms PCMU packets.
+constexpr uint8_t kPayloadType = 0;
+constexpr size_t kPayloadSize = 160;
+constexpr int kFramesPerPacket = 2;
+constexpr size_t kRtpHeaderSize = 12;
+constexpr uint32_t kRemoteSsrc = 0x1234;
+constexpr int kOutputRateHz = 48000;
+constexpr int kNackWaitMs = 1000;
+
+// Records the sequence numbers of the last NACK the channel sends, and the
+// thread sending it.
+class NackRecordingTransport : public Transport {
+ public:
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override {
+    return true;
+  }
+
+  bool SendRtcp(const uint8_t* packet, size_t length) override {
+    test::RtcpPacketParser parser;
+    EXPECT_TRUE(parser.Parse(packet, length));
+    if (parser.nack()->num_packets() > 0) {
+      rtc::CritScope lock(&crit_);
+      nacked_ = parser.nack()->packet_ids();
+      nack_thread_ = rtc::CurrentThreadRef();
+      nack_sent_.Set();
+    }
+    return true;
+  }
+
+  bool WaitForNack() { return nack_sent_.Wait(kNackWaitMs); }
+
+  std::vector<uint16_t> nacked() const {
+    rtc::CritScope lock(&crit_);
+    return nacked_;
+  }
+  rtc::PlatformThreadRef nack_thread() const {
+    rtc::CritScope lock(&crit_);
+    return nack_thread_;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  rtc::Event nack_sent_{false, false};
+  std::vector<uint16_t> nacked_ GUARDED_BY(crit_);
+  rtc::PlatformThreadRef nack_thread_ GUARDED_BY(crit_);
+};
+
+// A receive channel which queues its received packets. The test thread acts
+// as both the network and the audio thread.
+class QueuedReceiveChannelTest : public ::testing::Test {
+ protected:
+  QueuedReceiveChannelTest()
+      : voe_(VoiceEngine::Create()),
+        base_(VoEBase::GetInterface(voe_)),
+        rtp_rtcp_(VoERTP_RTCP::GetInterface(voe_)) {
+    EXPECT_EQ(0, base_->Init(&adm_, nullptr));
+    VoEBase::ChannelConfig config;
+    config.queue_received_packets = true;
+    channel_ = base_->CreateChannel(config);
+    EXPECT_NE(-1, channel_);
+    channel_proxy_ =
+        static_cast<VoiceEngineImpl*>(voe_)->GetChannelProxy(channel_);
+    channel_proxy_->RegisterExternalTransport(&transport_);
+    EXPECT_EQ(0, base_->StartPlayout(channel_));
+    for (size_t i = 0; i < kPayloadSize; ++i)
+      payload_[i] = static_cast<uint8_t>(i);
+  }
+
+  ~QueuedReceiveChannelTest() {
+    EXPECT_EQ(0, base_->StopPlayout(channel_));
+    channel_proxy_->DeRegisterExternalTransport();
+    channel_proxy_.reset();
+    EXPECT_EQ(0, base_->DeleteChannel(channel_));
+    EXPECT_EQ(0, base_->Terminate());
+    rtp_rtcp_->Release();
+    base_->Release();
+    EXPECT_TRUE(VoiceEngine::Delete(voe_));
+  }
+
+  void ReceivePacket(uint16_t sequence_number) {
+    uint8_t packet[kRtpHeaderSize + kPayloadSize];
+    const uint32_t timestamp = sequence_number * kPayloadSize;
+    packet[0] = 0x80;
+    packet[1] = kPayloadType;
+    packet[2] = sequence_number >> 8;
+    packet[3] = sequence_number & 0xff;
+    for (int i = 0; i < 4; ++i) {
+      packet[4 + i] = static_cast<uint8_t>(timestamp >> (24 - 8 * i));
+      packet[8 + i] = static_cast<uint8_t>(kRemoteSsrc >> (24 - 8 * i));
+    }
+    memcpy(packet + kRtpHeaderSize, payload_, kPayloadSize);
+    EXPECT_TRUE(channel_proxy_->ReceivedRTPPacket(packet, sizeof(packet),
+                                                  PacketTime()));
+  }
+
+  // Returns whether the frame has any non-zero sample.
+  bool PullFrame() {
+    AudioFrame frame;
+    channel_proxy_->GetAudioFrameWithInfo(kOutputRateHz, &frame);
+    const int16_t* data = frame.data_;
+    const size_t size = frame.samples_per_channel_ * frame.num_channels_;
+    return std::any_of(data, data + size,
+                       [](int16_t sample) { return sample != 0; });
+  }
+
+  unsigned int DiscardedPackets() {
+    unsigned int average_jitter_ms;
+    unsigned int max_jitter_ms;
+    unsigned int discarded_packets;
+    EXPECT_EQ(0, rtp_rtcp_->GetRTPStatistics(channel_, average_jitter_ms,
+                                             max_jitter_ms, discarded_packets));
+    return discarded_packets;
+  }
+
+  FakeAudioDeviceModule adm_;
+  VoiceEngine* voe_;
+  VoEBase* const base_;
+  VoERTP_RTCP* const rtp_rtcp_;
+  int channel_;
+  std::unique_ptr<ChannelProxy> channel_proxy_;
+  NackRecordingTransport transport_;
+  uint8_t payload_[kPayloadSize];
+};
+
+}  // namespace
 
 // Empty test just to get coverage metrics.
 TEST(ChannelTest, EmptyTestToGetCodeCoverage) {}
+
+TEST_F(QueuedReceiveChannelTest, DecodesQueuedPackets) {
+  for (uint16_t sequence_number = 0; sequence_number < 4; ++sequence_number)
+    ReceivePacket(sequence_number);
+  // Queued packets aren't in NetEq until the audio is pulled.
+  EXPECT_EQ(0, channel_proxy_->GetNetworkStatistics().currentBufferSize);
+
+  bool audible = false;
+  for (int i = 0; i < 4 * kFramesPerPacket; ++i)
+    audible |= PullFrame();
+  EXPECT_TRUE(audible);
+  EXPECT_GT(channel_proxy_->GetDecodingCallStatistics().decoded_normal, 0);
+  EXPECT_EQ(0u, DiscardedPackets());
+}
+
+TEST_F(QueuedReceiveChannelTest, SendsNackOffTheAudioThread) {
+  channel_proxy_->SetNACKStatus(true, 50);
+  ReceivePacket(0);
+  PullFrame();
+  // A packet is only NACKed after a few later ones arrive, so they arrive
+  // well before it would be played out.
+  const uint16_t kLostSequenceNumber = 2;
+  for (uint16_t sequence_number = 1; sequence_number < 10; ++sequence_number) {
+    if (sequence_number != kLostSequenceNumber)
+      ReceivePacket(sequence_number);
+  }
+  PullFrame();
+
+  ASSERT_TRUE(transport_.WaitForNack());
+  const std::vector<uint16_t> nacked = transport_.nacked();
+  EXPECT_NE(nacked.end(),
+            std::find(nacked.begin(), nacked.end(), kLostSequenceNumber));
+  // Sent by the process thread, not by the thread which pulled the audio.
+  EXPECT_FALSE(
+      rtc::IsThreadRefEqual(rtc::CurrentThreadRef(), transport_.nack_thread()));
+}
+
+TEST_F(QueuedReceiveChannelTest, CountsDiscardedPackets) {
+  // Not playing: discarded as they arrive.
+  EXPECT_EQ(0, base_->StopPlayout(channel_));
+  ReceivePacket(0);
+  ReceivePacket(1);
+  EXPECT_EQ(2u, DiscardedPackets());
+
+  // Queued before playout stops: discarded instead of inserted once the audio
+  // is pulled again.
+  EXPECT_EQ(0, base_->StartPlayout(channel_));
+  ReceivePacket(2);
+  ReceivePacket(3);
+  ReceivePacket(4);
+  EXPECT_EQ(0, base_->StopPlayout(channel_));
+  EXPECT_EQ(0, base_->StartPlayout(channel_));
+  EXPECT_FALSE(PullFrame());
+  EXPECT_EQ(5u, DiscardedPackets());
+  EXPECT_EQ(0, channel_proxy_->GetDecodingCallStatistics().decoded_normal);
+
+  // Packets received after the restart are played out.
+  ReceivePacket(5);
+  ReceivePacket(6);
+  bool audible = false;
+  for (int i = 0; i < 2 * kFramesPerPacket; ++i)
+    audible |= PullFrame();
+  EXPECT_TRUE(audible);
+  EXPECT_EQ(5u, DiscardedPackets());
+}
+
+}  // namespace voe
+}  // namespace webrtc
@@ -101,6 +101,10 @@ class WEBRTC_DLLEXPORT VoEBase {
   struct ChannelConfig {
     AudioCodingModule::Config acm_config;
     bool enable_voice_pacing = false;
+    // Queue the received audio packets on the network thread, and insert
+    // them into the jitter buffer on the audio thread before it decodes,
+    // instead of inserting each packet as it arrives.
+    bool queue_received_packets = false;
     bool media_crypto_enabled = false;
     MediaCryptoKey media_crypto_key;
   };
@@ -52,6 +52,16 @@ void AudioLevel::ComputeLevel(const AudioFrame& audioFrame)
         audioFrame.data_,
         audioFrame.samples_per_channel_*audioFrame.num_channels_);
 
+    UpdateLevel(absValue);
+}
+
+void AudioLevel::ComputeMutedLevel()
+{
+    UpdateLevel(0);
+}
+
+void AudioLevel::UpdateLevel(int16_t absValue)
+{
     // Protect member access using a lock since this method is called on a
     // dedicated audio thread in the RecordedDataIsAvailable() callback.
     rtc::CritScope cs(&_critSect);
@@ -35,10 +35,14 @@ public:
     // AudioTransport::RecordedDataIsAvailable() callback.
     // In Chrome, this method is called on the AudioInputDevice thread.
     void ComputeLevel(const AudioFrame& audioFrame);
+    // Same as ComputeLevel() for a frame of zeros, without reading it.
+    void ComputeMutedLevel();
 
 private:
     enum { kUpdateFrequency = 10};
 
+    void UpdateLevel(int16_t absValue);
+
     rtc::CriticalSection _critSect;
 
     int16_t _absMax;
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/voice_engine/received_packet_queue.h"
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+namespace voe {
+
+ReceivedPacketQueue::ReceivedPacketQueue(size_t capacity)
+    : slots_(capacity + 1), read_index_(0), write_index_(0) {
+  RTC_DCHECK_GT(capacity, 0);
+}
+
+ReceivedPacketQueue::~ReceivedPacketQueue() {}
+
+bool ReceivedPacketQueue::Push(const WebRtcRTPHeader& header,
+                               const uint8_t* payload,
+                               size_t payload_size,
+                               int generation) {
+  // Only the producer writes |write_index_|.
+  const int write_index = write_index_;
+  const size_t next = Next(write_index);
+  if (next == static_cast<size_t>(rtc::AtomicOps::AcquireLoad(&read_index_)))
+    return false;
+  Packet& packet = slots_[write_index];
+  packet.header = header;
+  packet.payload.SetData(payload, payload_size);
+  packet.generation = generation;
+  rtc::AtomicOps::ReleaseStore(&write_index_, static_cast<int>(next));
+  return true;
+}
+
+const ReceivedPacketQueue::Packet* ReceivedPacketQueue::Front() const {
+  const int read_index = read_index_;
+  if (read_index == rtc::AtomicOps::AcquireLoad(&write_index_))
+    return nullptr;
+  return &slots_[read_index];
+}
+
+void ReceivedPacketQueue::Pop() {
+  const int read_index = read_index_;
+  RTC_DCHECK_NE(read_index, rtc::AtomicOps::AcquireLoad(&write_index_));
+  rtc::AtomicOps::ReleaseStore(&read_index_,
+                               static_cast<int>(Next(read_index)));
+}
+
+}  // namespace voe
+}  // namespace webrtc
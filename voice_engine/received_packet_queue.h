@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VOICE_ENGINE_RECEIVED_PACKET_QUEUE_H_
+#define WEBRTC_VOICE_ENGINE_RECEIVED_PACKET_QUEUE_H_
+
+#include <vector>
+
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+namespace voe {
+
+// Hands the parsed audio payloads of one channel from the thread that
+// receives them to the thread that decodes them. The queue is wait-free for
+// one producer and one consumer: each of the two indices is only written by
+// one side, and is published with release and read with acquire semantics.
+// The payload buffers stay in their slots, so once they have grown to the
+// largest payload no packet allocates.
+class ReceivedPacketQueue {
+ public:
+  struct Packet {
+    WebRtcRTPHeader header;
+    rtc::Buffer payload;
+    // Given by the producer, so that the consumer can tell packets pushed
+    // before a reset, which it discards.
+    int generation;
+  };
+
+  // Holds up to |capacity| packets.
+  explicit ReceivedPacketQueue(size_t capacity);
+  ~ReceivedPacketQueue();
+
+  // Producer side. Copies the packet into the queue, or returns false if the
+  // queue is full.
+  bool Push(const WebRtcRTPHeader& header,
+            const uint8_t* payload,
+            size_t payload_size,
+            int generation);
+
+  // Consumer side. Returns the oldest packet, or null if the queue is empty.
+  // The packet stays valid, and in the queue, until the next call to Pop().
+  const Packet* Front() const;
+  // Removes the packet returned by Front(), which must not be null.
+  void Pop();
+
+ private:
+  size_t Next(int index) const {
+    return (static_cast<size_t>(index) + 1) % slots_.size();
+  }
+
+  // One slot more than the capacity, which is never used, tells a full queue
+  // from an empty one.
+  std::vector<Packet> slots_;
+  // The next slot to read; written by the consumer.
+  volatile int read_index_;
+  // The next slot to write; written by the producer.
+  volatile int write_index_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ReceivedPacketQueue);
+};
+
+}  // namespace voe
+}  // namespace webrtc
+
+#endif  // WEBRTC_VOICE_ENGINE_RECEIVED_PACKET_QUEUE_H_
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/voice_engine/received_packet_queue.h"
+
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/test/gtest.h"
+
+namespace webrtc {
+namespace voe {
+namespace {
+
+WebRtcRTPHeader CreateHeader(uint16_t sequence_number) {
+  WebRtcRTPHeader header = {};
+  header.header.sequenceNumber = sequence_number;
+  header.header.timestamp = sequence_number * 960u;
+  return header;
+}
+
+// The payload of packet |sequence_number| has |sequence_number| % 100 + 1
+// bytes, all equal to the low byte of the sequence number.
+size_t CreatePayload(uint16_t sequence_number, uint8_t* payload) {
+  const size_t size = sequence_number % 100 + 1;
+  for (size_t i = 0; i < size; ++i)
+    payload[i] = static_cast<uint8_t>(sequence_number);
+  return size;
+}
+
+bool PushPacket(ReceivedPacketQueue* queue, uint16_t sequence_number) {
+  uint8_t payload[100];
+  const size_t size = CreatePayload(sequence_number, payload);
+  // The generation just has to come back out with the packet.
+  return queue->Push(CreateHeader(sequence_number), payload, size,
+                     sequence_number);
+}
+
+void ExpectPacket(const ReceivedPacketQueue::Packet* packet,
+                  uint16_t sequence_number) {
+  ASSERT_TRUE(packet);
+  EXPECT_EQ(sequence_number, packet->header.header.sequenceNumber);
+  EXPECT_EQ(sequence_number * 960u, packet->header.header.timestamp);
+  uint8_t payload[100];
+  const size_t size = CreatePayload(sequence_number, payload);
+  EXPECT_EQ(rtc::Buffer(payload, size), packet->payload);
+  EXPECT_EQ(sequence_number, packet->generation);
+}
+
+const uint16_t kNumThreadedPackets = 20000;
+
+struct ProducerState {
+  ReceivedPacketQueue* queue;
+  uint16_t next_sequence_number;
+};
+
+bool ProduceAll(void* obj) {
+  ProducerState* state = static_cast<ProducerState*>(obj);
+  while (state->next_sequence_number < kNumThreadedPackets) {
+    if (PushPacket(state->queue, state->next_sequence_number))
+      ++state->next_sequence_number;
+    else
+      SleepMs(0);
+  }
+  return false;
+}
+
+}  // namespace
+
+TEST(ReceivedPacketQueueTest, StartsEmpty) {
+  ReceivedPacketQueue queue(4);
+  EXPECT_FALSE(queue.Front());
+}
+
+TEST(ReceivedPacketQueueTest, PopsInPushOrder) {
+  ReceivedPacketQueue queue(4);
+  for (uint16_t round = 0; round < 10; ++round) {
+    // Wraps around the slots a few times.
+    EXPECT_TRUE(PushPacket(&queue, 3 * round));
+    EXPECT_TRUE(PushPacket(&queue, 3 * round + 1));
+    EXPECT_TRUE(PushPacket(&queue, 3 * round + 2));
+    for (uint16_t i = 0; i < 3; ++i) {
+      ExpectPacket(queue.Front(), 3 * round + i);
+      queue.Pop();
+    }
+    EXPECT_FALSE(queue.Front());
+  }
+}
+
+TEST(ReceivedPacketQueueTest, RejectsPacketsWhenFull) {
+  ReceivedPacketQueue queue(2);
+  EXPECT_TRUE(PushPacket(&queue, 1));
+  EXPECT_TRUE(PushPacket(&queue, 2));
+  EXPECT_FALSE(PushPacket(&queue, 3));
+
+  ExpectPacket(queue.Front(), 1);
+  queue.Pop();
+  EXPECT_TRUE(PushPacket(&queue, 4));
+  ExpectPacket(queue.Front(), 2);
+  queue.Pop();
+  ExpectPacket(queue.Front(), 4);
+  queue.Pop();
+  EXPECT_FALSE(queue.Front());
+}
+
+TEST(ReceivedPacketQueueTest, HandsPacketsToAnotherThread) {
+  ReceivedPacketQueue queue(16);
+  ProducerState state = {&queue, 0};
+  rtc::PlatformThread producer(&ProduceAll, &state, "ReceivedPacketProducer");
+  producer.Start();
+
+  for (uint16_t sequence_number = 0; sequence_number < kNumThreadedPackets;
+       ++sequence_number) {
+    const ReceivedPacketQueue::Packet* packet;
+    while (!(packet = queue.Front()))
+      SleepMs(0);
+    ExpectPacket(packet, sequence_number);
+    queue.Pop();
+  }
+
+  producer.Stop();
+  EXPECT_FALSE(queue.Front());
+}
+
+}  // namespace voe
+}  // namespace webrtc
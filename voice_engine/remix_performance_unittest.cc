@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "webrtc/audio/utility/audio_frame_operations.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
+#include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/test/gtest.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/voice_engine/utility.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kSamplesPerChannel = kSampleRateHz / 100;
+constexpr int kNumFrames = 100000;
+
+struct Remix {
+  const char* name;
+  size_t src_channels;
+  size_t dst_channels;
+};
+
+// Prints the time per 10 ms frame, and the rate at which the samples of the
+// source and the destination of each frame are read and written.
+void PrintFrameResults(const std::string& trace,
+                       size_t bytes_per_frame,
+                       int64_t elapsed_ns) {
+  webrtc::test::PrintResult("remix", trace, "time_per_frame",
+                            static_cast<size_t>(elapsed_ns / kNumFrames), "ns",
+                            true);
+  webrtc::test::PrintResult(
+      "remix", trace, "sample_bandwidth",
+      static_cast<size_t>(bytes_per_frame * kNumFrames * 1000 / elapsed_ns),
+      "MB/s", true);
+}
+
+}  // namespace
+
+// The capture conversion of TransmitMixer, the device conversion of
+// OutputMixer and the conversion of the input of each send stream in
+// voe::Channel all go through RemixAndResample(), mostly without changing the
+// sample rate.
+TEST(RemixPerformanceTest, RemixAndResampleWithoutResampling) {
+  Random random(0x5eed);
+  for (const Remix& remix : {Remix{"mono_to_stereo", 1, 2},
+                             Remix{"stereo_to_mono", 2, 1},
+                             Remix{"stereo", 2, 2}}) {
+    std::vector<int16_t> src(kSamplesPerChannel * remix.src_channels);
+    for (int16_t& sample : src)
+      sample = static_cast<int16_t>(random.Rand(-32768, 32767));
+    AudioFrame dst_frame;
+    dst_frame.sample_rate_hz_ = kSampleRateHz;
+    PushResampler<int16_t> resampler;
+
+    const int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumFrames; ++i) {
+      dst_frame.num_channels_ = remix.dst_channels;
+      voe::RemixAndResample(src.data(), kSamplesPerChannel, remix.src_channels,
+                            kSampleRateHz, &resampler, &dst_frame);
+    }
+    const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+    EXPECT_EQ(kSamplesPerChannel, dst_frame.samples_per_channel_);
+    EXPECT_EQ(remix.dst_channels, dst_frame.num_channels_);
+
+    PrintFrameResults(std::string("_") + remix.name,
+                      sizeof(int16_t) * kSamplesPerChannel *
+                          (remix.src_channels + remix.dst_channels),
+                      elapsed_ns);
+  }
+}
+
+// The audio conference mixer upmixes each mono source of a stereo mix, and
+// OutputMixer and voe::Channel upmix mono audio for panning.
+TEST(RemixPerformanceTest, UpmixFrameInPlace) {
+  AudioFrame frame;
+  frame.samples_per_channel_ = kSamplesPerChannel;
+
+  int errors = 0;
+  const int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumFrames; ++i) {
+    frame.num_channels_ = 1;
+    errors += AudioFrameOperations::MonoToStereo(&frame);
+  }
+  const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  EXPECT_EQ(0, errors);
+
+  PrintFrameResults("_mono_source_to_stereo",
+                    sizeof(int16_t) * kSamplesPerChannel * 3, elapsed_ns);
+}
+
+}  // namespace webrtc
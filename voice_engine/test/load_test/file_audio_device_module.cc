@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/voice_engine/test/load_test/file_audio_device_module.h"
+
+namespace webrtc {
+namespace test {
+
+FileAudioDeviceModule::FileAudioDeviceModule(
+    const std::string& input_filename,
+    const std::string& output_filename)
+    : file_audio_device_(0, input_filename.c_str(), output_filename.c_str()),
+      initialized_(false),
+      playout_initialized_(false),
+      recording_initialized_(false),
+      playing_(false),
+      recording_(false) {}
+
+FileAudioDeviceModule::~FileAudioDeviceModule() {
+  StopPlayout();
+  StopRecording();
+}
+
+int32_t FileAudioDeviceModule::RegisterAudioCallback(
+    AudioTransport* audio_callback) {
+  return audio_device_buffer_.RegisterAudioCallback(audio_callback);
+}
+
+int32_t FileAudioDeviceModule::Init() {
+  if (initialized_)
+    return 0;
+  file_audio_device_.AttachAudioBuffer(&audio_device_buffer_);
+  if (file_audio_device_.Init() != AudioDeviceGeneric::InitStatus::OK)
+    return -1;
+  initialized_ = true;
+  return 0;
+}
+
+int32_t FileAudioDeviceModule::Terminate() {
+  StopPlayout();
+  StopRecording();
+  initialized_ = false;
+  return file_audio_device_.Terminate();
+}
+
+int32_t FileAudioDeviceModule::InitPlayout() {
+  if (!initialized_)
+    return -1;
+  if (file_audio_device_.InitPlayout() != 0)
+    return -1;
+  playout_initialized_ = true;
+  return 0;
+}
+
+bool FileAudioDeviceModule::PlayoutIsInitialized() const {
+  return playout_initialized_;
+}
+
+int32_t FileAudioDeviceModule::StartPlayout() {
+  if (!playout_initialized_)
+    return -1;
+  if (playing_)
+    return 0;
+  audio_device_buffer_.StartPlayout();
+  if (file_audio_device_.StartPlayout() != 0) {
+    audio_device_buffer_.StopPlayout();
+    return -1;
+  }
+  playing_ = true;
+  return 0;
+}
+
+int32_t FileAudioDeviceModule::StopPlayout() {
+  if (!playing_)
+    return 0;
+  const int32_t result = file_audio_device_.StopPlayout();
+  audio_device_buffer_.StopPlayout();
+  playing_ = false;
+  playout_initialized_ = false;
+  return result;
+}
+
+bool FileAudioDeviceModule::Playing() const {
+  return playing_;
+}
+
+int32_t FileAudioDeviceModule::InitRecording() {
+  if (!initialized_)
+    return -1;
+  if (file_audio_device_.InitRecording() != 0)
+    return -1;
+  recording_initialized_ = true;
+  return 0;
+}
+
+bool FileAudioDeviceModule::RecordingIsInitialized() const {
+  return recording_initialized_;
+}
+
+int32_t FileAudioDeviceModule::StartRecording() {
+  if (!recording_initialized_)
+    return -1;
+  if (recording_)
+    return 0;
+  audio_device_buffer_.StartRecording();
+  if (file_audio_device_.StartRecording() != 0) {
+    audio_device_buffer_.StopRecording();
+    return -1;
+  }
+  recording_ = true;
+  return 0;
+}
+
+int32_t FileAudioDeviceModule::StopRecording() {
+  if (!recording_)
+    return 0;
+  const int32_t result = file_audio_device_.StopRecording();
+  audio_device_buffer_.StopRecording();
+  recording_ = false;
+  recording_initialized_ = false;
+  return result;
+}
+
+bool FileAudioDeviceModule::Recording() const {
+  return recording_;
+}
+
+int32_t FileAudioDeviceModule::StereoPlayoutIsAvailable(
+    bool* available) const {
+  *available = true;
+  return 0;
+}
+
+int32_t FileAudioDeviceModule::StereoRecordingIsAvailable(
+    bool* available) const {
+  *available = true;
+  return 0;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VOICE_ENGINE_TEST_LOAD_TEST_FILE_AUDIO_DEVICE_MODULE_H_
+#define WEBRTC_VOICE_ENGINE_TEST_LOAD_TEST_FILE_AUDIO_DEVICE_MODULE_H_
+
+#include <string>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/audio_device/audio_device_buffer.h"
+#include "webrtc/modules/audio_device/dummy/file_audio_device.h"
+#include "webrtc/modules/audio_device/include/fake_audio_device.h"
+
+namespace webrtc {
+namespace test {
+
+// An AudioDeviceModule which plays a 48 kHz stereo raw file as microphone and
+// writes the playout to another, in real time, with the threads of a
+// FileAudioDevice. AudioDeviceModuleImpl only creates a FileAudioDevice in
+// builds with rtc_use_dummy_audio_file_devices, and the file names are then
+// global, so test tools that run on any build use this module instead. An
+// empty |output_filename| discards the playout.
+class FileAudioDeviceModule : public FakeAudioDeviceModule {
+ public:
+  FileAudioDeviceModule(const std::string& input_filename,
+                        const std::string& output_filename);
+  ~FileAudioDeviceModule() override;
+
+  int32_t RegisterAudioCallback(AudioTransport* audio_callback) override;
+  int32_t Init() override;
+  int32_t Terminate() override;
+
+  int32_t InitPlayout() override;
+  bool PlayoutIsInitialized() const override;
+  int32_t StartPlayout() override;
+  int32_t StopPlayout() override;
+  bool Playing() const override;
+
+  int32_t InitRecording() override;
+  bool RecordingIsInitialized() const override;
+  int32_t StartRecording() override;
+  int32_t StopRecording() override;
+  bool Recording() const override;
+
+  int32_t StereoPlayoutIsAvailable(bool* available) const override;
+  int32_t StereoRecordingIsAvailable(bool* available) const override;
+
+ private:
+  AudioDeviceBuffer audio_device_buffer_;
+  FileAudioDevice file_audio_device_;
+  bool initialized_;
+  bool playout_initialized_;
+  bool recording_initialized_;
+  // FileAudioDevice::Playing() is always true, which would keep VoiceEngine
+  // from ever starting the playout.
+  bool playing_;
+  bool recording_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FileAudioDeviceModule);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_VOICE_ENGINE_TEST_LOAD_TEST_FILE_AUDIO_DEVICE_MODULE_H_
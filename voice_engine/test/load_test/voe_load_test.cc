@@ -0,0 +1,611 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Runs a VoiceEngine with N send and M receive channels on a FileAudioDevice,
+// without audio hardware or network. The send channels encode the speech of
+// the file device, and their packets are looped back to the receive channels,
+// whose mix is played out to the file device. The tool reports the wall time
+// the audio threads spend per 10 ms in each stage of the pipeline, per
+// channel, and how often a 10 ms tick takes longer than 10 ms, so that audio
+// servers can be sized and regressions caught. The stage times include any
+// time the thread was preempted; the thread CPU time is only reported per
+// audio thread.
+//
+// The stages are delimited with the VoEExternalMedia callbacks, which
+// VoiceEngine calls after the near-end processing and after the decoding of
+// each receive channel:
+// - apm: conversion of the captured audio and the near-end processing.
+// - encode: remixing, resampling, encoding and packetization per send channel.
+// - rtp_receive: RTP parsing and NetEq insertion of the looped back packets.
+// - neteq: decoding of every receive channel by the output mixer.
+// - mix: mixing, far-end processing and conversion to the device format.
+// The per receive channel callback isn't free: VoiceEngine zeroes the samples
+// of muted frames before it, which it otherwise skips, and takes a lock. Run
+// with --split_decode_and_mix=false to leave it out, and measure the decoding
+// and the mixing as one neteq_mix stage.
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "webrtc/api/call/transport.h"
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/common_audio/resampler/include/push_resampler.h"
+#include "webrtc/common_types.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+#include "webrtc/test/null_transport.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+#include "webrtc/voice_engine/include/voe_audio_processing.h"
+#include "webrtc/voice_engine/include/voe_base.h"
+#include "webrtc/voice_engine/include/voe_codec.h"
+#include "webrtc/voice_engine/include/voe_external_media.h"
+#include "webrtc/voice_engine/include/voe_network.h"
+#include "webrtc/voice_engine/test/load_test/file_audio_device_module.h"
+
+namespace flags {
+
+DEFINE_int32(send_channels, 10, "Number of send channels.");
+DEFINE_int32(receive_channels, 10,
+             "Number of receive channels. Receive channel j gets the packets "
+             "of send channel j modulo --send_channels.");
+DEFINE_string(codec, "opus", "Payload name of the send codec.");
+DEFINE_int32(duration_s, 20, "Measured duration in seconds.");
+DEFINE_int32(warmup_s, 2, "Seconds to run before measuring.");
+DEFINE_bool(apm, true, "Enable echo cancellation, AGC and noise suppression.");
+DEFINE_bool(split_decode_and_mix,
+            true,
+            "Time the decoding and the mixing separately, with a callback "
+            "per receive channel which makes VoiceEngine zero muted frames.");
+DEFINE_string(input_file,
+              "",
+              "48 kHz stereo raw PCM file played as microphone, or empty for "
+              "the speech of resources/voice_engine/audio_long16.pcm.");
+DEFINE_string(output_file,
+              "",
+              "File to write the 48 kHz stereo playout to, or empty.");
+
+}  // namespace flags
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const int64_t kTickUs = 10 * rtc::kNumMicrosecsPerMillisec;
+
+enum Stage { kApm, kEncode, kRtpReceive, kNetEq, kMix, kNumStages };
+const char* const kStageNames[kNumStages] = {"apm", "encode", "rtp_receive",
+                                             "neteq", "mix"};
+// The name of the mix stage when it includes the decoding.
+const char kNetEqMixStageName[] = "neteq_mix";
+
+// Preemption makes the wall time of a tick longer than the CPU time of its
+// thread, so both are kept.
+int64_t ThreadCpuTimeUs() {
+#if defined(WEBRTC_WIN)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time,
+                      &kernel_time, &user_time)) {
+    return 0;
+  }
+  const uint64_t total_100ns =
+      ((static_cast<uint64_t>(kernel_time.dwHighDateTime) << 32) |
+       kernel_time.dwLowDateTime) +
+      ((static_cast<uint64_t>(user_time.dwHighDateTime) << 32) |
+       user_time.dwLowDateTime);
+  return static_cast<int64_t>(total_100ns / 10);
+#else
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * rtc::kNumMicrosecsPerSec +
+         ts.tv_nsec / rtc::kNumNanosecsPerMicrosec;
+#endif
+}
+
+// The 10 ms ticks of one audio thread.
+struct TickStats {
+  void Add(int64_t start_us, int64_t end_us, int64_t cpu_us) {
+    const int64_t busy_us = end_us - start_us;
+    ++ticks;
+    if (busy_us > kTickUs)
+      ++missed_deadlines;
+    total_busy_us += busy_us;
+    total_cpu_us += cpu_us;
+    max_busy_us = std::max(max_busy_us, busy_us);
+    if (last_start_us > 0)
+      max_interval_us = std::max(max_interval_us, start_us - last_start_us);
+    last_start_us = start_us;
+  }
+
+  int64_t ticks = 0;
+  // Ticks that took longer than 10 ms, which a real device would have heard
+  // as a glitch.
+  int64_t missed_deadlines = 0;
+  int64_t total_busy_us = 0;
+  int64_t total_cpu_us = 0;
+  int64_t max_busy_us = 0;
+  // The longest time between the start of two ticks.
+  int64_t max_interval_us = 0;
+  int64_t last_start_us = 0;
+};
+
+// Carries the RTP packets of each send channel to the receive channels that
+// listen to it. The packets are queued on the capture thread and delivered at
+// the start of the next playout tick, so that the receive processing shows up
+// as a stage of its own instead of inside the encoding.
+class LoopbackNetwork {
+ public:
+  explicit LoopbackNetwork(VoENetwork* network) : network_(network) {}
+
+  // Returns the transport of a send channel, to be registered with
+  // VoENetwork::RegisterExternalTransport().
+  Transport* AddSender(const std::vector<int>& receive_channels) {
+    senders_.emplace_back(new SenderTransport(this, receive_channels));
+    return senders_.back().get();
+  }
+
+  // Called on the playout thread.
+  void DeliverPackets() {
+    {
+      rtc::CritScope lock(&crit_);
+      queued_.swap(delivering_);
+    }
+    for (const Packet& packet : delivering_) {
+      for (int channel : *packet.receive_channels) {
+        network_->ReceivedRTPPacket(channel, packet.data.data(),
+                                    packet.data.size());
+      }
+    }
+    delivering_.clear();
+  }
+
+ private:
+  struct Packet {
+    const std::vector<int>* receive_channels;
+    rtc::Buffer data;
+  };
+
+  class SenderTransport : public Transport {
+   public:
+    SenderTransport(LoopbackNetwork* network,
+                    const std::vector<int>& receive_channels)
+        : network_(network), receive_channels_(receive_channels) {}
+
+    bool SendRtp(const uint8_t* packet,
+                 size_t length,
+                 const PacketOptions& options) override {
+      if (!receive_channels_.empty()) {
+        rtc::CritScope lock(&network_->crit_);
+        network_->queued_.push_back(
+            Packet{&receive_channels_, rtc::Buffer(packet, length)});
+      }
+      return true;
+    }
+
+    // RTCP isn't part of the load being measured.
+    bool SendRtcp(const uint8_t* packet, size_t length) override {
+      return true;
+    }
+
+   private:
+    LoopbackNetwork* const network_;
+    const std::vector<int> receive_channels_;
+  };
+
+  VoENetwork* const network_;
+  std::vector<std::unique_ptr<SenderTransport>> senders_;
+  rtc::CriticalSection crit_;
+  std::vector<Packet> queued_ GUARDED_BY(crit_);
+  // Only used on the playout thread.
+  std::vector<Packet> delivering_;
+};
+
+// Sits between the FileAudioDevice and VoiceEngine, and times each capture
+// and playout tick and its stages. The stage boundaries inside VoiceEngine
+// come from the VoEMediaProcess callbacks. The stats of the capture and the
+// playout thread are each only touched by that thread until the audio device
+// is stopped.
+class StageMeter : public AudioTransport, public VoEMediaProcess {
+ public:
+  explicit StageMeter(LoopbackNetwork* network) : network_(network) {}
+
+  void set_audio_transport(AudioTransport* audio_transport) {
+    audio_transport_ = audio_transport;
+  }
+
+  // Ticks that start before |start_us| aren't measured. Must be called before
+  // the audio device starts.
+  void set_measurement_start(int64_t start_us) { start_us_ = start_us; }
+
+  int32_t RecordedDataIsAvailable(const void* audio_samples,
+                                  const size_t num_samples,
+                                  const size_t bytes_per_sample,
+                                  const size_t num_channels,
+                                  const uint32_t sample_rate,
+                                  const uint32_t total_delay_ms,
+                                  const int32_t clock_drift,
+                                  const uint32_t current_mic_level,
+                                  const bool key_pressed,
+                                  uint32_t& new_mic_level) override {
+    const int64_t cpu_start_us = ThreadCpuTimeUs();
+    const int64_t start_us = rtc::TimeMicros();
+    apm_end_us_ = start_us;
+    const int32_t result = audio_transport_->RecordedDataIsAvailable(
+        audio_samples, num_samples, bytes_per_sample, num_channels,
+        sample_rate, total_delay_ms, clock_drift, current_mic_level,
+        key_pressed, new_mic_level);
+    const int64_t end_us = rtc::TimeMicros();
+    if (start_us >= start_us_) {
+      capture_stage_us_[kApm] += apm_end_us_ - start_us;
+      capture_stage_us_[kEncode] += end_us - apm_end_us_;
+      capture_.Add(start_us, end_us, ThreadCpuTimeUs() - cpu_start_us);
+    }
+    return result;
+  }
+
+  int32_t NeedMorePlayData(const size_t num_samples,
+                           const size_t bytes_per_sample,
+                           const size_t num_channels,
+                           const uint32_t sample_rate,
+                           void* audio_samples,
+                           size_t& num_samples_out,
+                           int64_t* elapsed_time_ms,
+                           int64_t* ntp_time_ms) override {
+    const int64_t cpu_start_us = ThreadCpuTimeUs();
+    const int64_t start_us = rtc::TimeMicros();
+    network_->DeliverPackets();
+    const int64_t receive_end_us = rtc::TimeMicros();
+    last_decode_end_us_ = receive_end_us;
+    const int32_t result = audio_transport_->NeedMorePlayData(
+        num_samples, bytes_per_sample, num_channels, sample_rate,
+        audio_samples, num_samples_out, elapsed_time_ms, ntp_time_ms);
+    const int64_t end_us = rtc::TimeMicros();
+    if (start_us >= start_us_) {
+      playout_stage_us_[kRtpReceive] += receive_end_us - start_us;
+      playout_stage_us_[kNetEq] += last_decode_end_us_ - receive_end_us;
+      playout_stage_us_[kMix] += end_us - last_decode_end_us_;
+      playout_.Add(start_us, end_us, ThreadCpuTimeUs() - cpu_start_us);
+    }
+    return result;
+  }
+
+  void PushCaptureData(int voe_channel,
+                       const void* audio_data,
+                       int bits_per_sample,
+                       int sample_rate,
+                       size_t number_of_channels,
+                       size_t number_of_frames) override {
+    audio_transport_->PushCaptureData(voe_channel, audio_data,
+                                      bits_per_sample, sample_rate,
+                                      number_of_channels, number_of_frames);
+  }
+
+  void PullRenderData(int bits_per_sample,
+                      int sample_rate,
+                      size_t number_of_channels,
+                      size_t number_of_frames,
+                      void* audio_data,
+                      int64_t* elapsed_time_ms,
+                      int64_t* ntp_time_ms) override {
+    audio_transport_->PullRenderData(bits_per_sample, sample_rate,
+                                     number_of_channels, number_of_frames,
+                                     audio_data, elapsed_time_ms, ntp_time_ms);
+  }
+
+  // Called after the near-end processing on the capture thread, and after the
+  // decoding of each receive channel on the playout thread. The output mixer
+  // decodes all channels before it mixes, so the last call ends the decoding.
+  void Process(int channel,
+               ProcessingTypes type,
+               int16_t audio10ms[],
+               size_t length,
+               int samplingFreq,
+               bool isStereo) override {
+    if (type == kRecordingAllChannelsMixed)
+      apm_end_us_ = rtc::TimeMicros();
+    else if (type == kPlaybackPerChannel)
+      last_decode_end_us_ = rtc::TimeMicros();
+  }
+
+  int64_t stage_us(Stage stage) const {
+    return stage == kApm || stage == kEncode ? capture_stage_us_[stage]
+                                             : playout_stage_us_[stage];
+  }
+  const TickStats& capture() const { return capture_; }
+  const TickStats& playout() const { return playout_; }
+
+ private:
+  LoopbackNetwork* const network_;
+  AudioTransport* audio_transport_ = nullptr;
+  int64_t start_us_ = 0;
+
+  // Capture thread.
+  int64_t apm_end_us_ = 0;
+  int64_t capture_stage_us_[kNumStages] = {0};
+  TickStats capture_;
+
+  // Playout thread.
+  int64_t last_decode_end_us_ = 0;
+  int64_t playout_stage_us_[kNumStages] = {0};
+  TickStats playout_;
+};
+
+class MeteredAudioDeviceModule : public FileAudioDeviceModule {
+ public:
+  MeteredAudioDeviceModule(const std::string& input_filename,
+                           const std::string& output_filename,
+                           StageMeter* meter)
+      : FileAudioDeviceModule(input_filename, output_filename),
+        meter_(meter) {}
+
+  int32_t RegisterAudioCallback(AudioTransport* audio_callback) override {
+    meter_->set_audio_transport(audio_callback);
+    return FileAudioDeviceModule::RegisterAudioCallback(
+        audio_callback ? meter_ : nullptr);
+  }
+
+ private:
+  StageMeter* const meter_;
+};
+
+// Converts the 16 kHz mono speech of the VoiceEngine tests to the 48 kHz
+// stereo that FileAudioDevice reads. Returns the name of the new file, or an
+// empty string on failure.
+std::string CreateSpeechFile() {
+  const size_t kInputSamples = 160;
+  const size_t kOutputSamples = 480;
+  const std::string source_name =
+      ResourcePath("voice_engine/audio_long16", "pcm");
+  FILE* source = fopen(source_name.c_str(), "rb");
+  if (!source) {
+    fprintf(stderr, "Cannot open %s\n", source_name.c_str());
+    return "";
+  }
+  const std::string name = TempFilename(OutputPath(), "voe_load_test");
+  FILE* destination = fopen(name.c_str(), "wb");
+  if (!destination) {
+    fprintf(stderr, "Cannot create %s\n", name.c_str());
+    fclose(source);
+    return "";
+  }
+  PushResampler<int16_t> resampler;
+  resampler.InitializeIfNeeded(16000, 48000, 1);
+  int16_t input[kInputSamples];
+  int16_t output[kOutputSamples];
+  int16_t stereo[2 * kOutputSamples];
+  while (fread(input, sizeof(input[0]), kInputSamples, source) ==
+         kInputSamples) {
+    resampler.Resample(input, kInputSamples, output, kOutputSamples);
+    for (size_t i = 0; i < kOutputSamples; ++i)
+      stereo[2 * i] = stereo[2 * i + 1] = output[i];
+    fwrite(stereo, sizeof(stereo[0]), 2 * kOutputSamples, destination);
+  }
+  fclose(source);
+  fclose(destination);
+  return name;
+}
+
+bool FindCodec(VoECodec* codec, const std::string& name, CodecInst* inst) {
+  for (int i = 0; i < codec->NumOfCodecs(); ++i) {
+    RTC_CHECK_EQ(0, codec->GetCodec(i, *inst));
+    if (STR_CASE_CMP(inst->plname, name.c_str()) == 0)
+      return true;
+  }
+  return false;
+}
+
+std::string Format(double value) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.2f", value);
+  return buffer;
+}
+
+void PrintTicks(const char* thread, const TickStats& stats) {
+  if (stats.ticks == 0)
+    return;
+  printf(
+      "%s: %lld ticks, %.3f%% missed the 10 ms deadline, busy %.1f%%, "
+      "CPU %.1f%%, longest tick %.2f ms, longest interval %.2f ms\n",
+      thread, static_cast<long long>(stats.ticks),
+      100.0 * stats.missed_deadlines / stats.ticks,
+      100.0 * stats.total_busy_us / (stats.ticks * kTickUs),
+      100.0 * stats.total_cpu_us / (stats.ticks * kTickUs),
+      stats.max_busy_us / 1000.0, stats.max_interval_us / 1000.0);
+}
+
+int RunLoadTest() {
+  const int num_send = flags::FLAGS_send_channels;
+  const int num_receive = flags::FLAGS_receive_channels;
+  if (num_send < 0 || num_receive < 0 || num_send + num_receive == 0 ||
+      (num_receive > 0 && num_send == 0)) {
+    fprintf(stderr, "Receive channels need at least one send channel.\n");
+    return 1;
+  }
+
+  VoiceEngine* voe = VoiceEngine::Create();
+  VoEBase* base = VoEBase::GetInterface(voe);
+  VoECodec* codec = VoECodec::GetInterface(voe);
+  VoENetwork* network = VoENetwork::GetInterface(voe);
+  VoEExternalMedia* external_media = VoEExternalMedia::GetInterface(voe);
+  VoEAudioProcessing* apm = VoEAudioProcessing::GetInterface(voe);
+
+  CodecInst send_codec;
+  std::string input_file = flags::FLAGS_input_file;
+  const bool temporary_input = input_file.empty();
+  if (!FindCodec(codec, flags::FLAGS_codec, &send_codec)) {
+    fprintf(stderr, "Unknown codec %s\n", flags::FLAGS_codec.c_str());
+    input_file.clear();
+  } else if (temporary_input) {
+    input_file = CreateSpeechFile();
+  }
+  if (input_file.empty()) {
+    apm->Release();
+    external_media->Release();
+    network->Release();
+    codec->Release();
+    base->Release();
+    VoiceEngine::Delete(voe);
+    return 1;
+  }
+
+  LoopbackNetwork loopback(network);
+  StageMeter meter(&loopback);
+  MeteredAudioDeviceModule adm(input_file, flags::FLAGS_output_file, &meter);
+  RTC_CHECK_EQ(0, base->Init(&adm));
+
+  NullTransport receiver_transport;
+  std::vector<int> receive_channels;
+  std::vector<std::vector<int>> receivers(num_send);
+  for (int i = 0; i < num_receive; ++i) {
+    const int channel = base->CreateChannel();
+    RTC_CHECK_GE(channel, 0);
+    RTC_CHECK_EQ(0, codec->SetRecPayloadType(channel, send_codec));
+    RTC_CHECK_EQ(0,
+                 network->RegisterExternalTransport(channel,
+                                                    receiver_transport));
+    if (flags::FLAGS_split_decode_and_mix) {
+      RTC_CHECK_EQ(0, external_media->RegisterExternalMediaProcessing(
+                          channel, kPlaybackPerChannel, meter));
+    }
+    receive_channels.push_back(channel);
+    receivers[i % num_send].push_back(channel);
+  }
+  std::vector<int> send_channels;
+  for (int i = 0; i < num_send; ++i) {
+    const int channel = base->CreateChannel();
+    RTC_CHECK_GE(channel, 0);
+    RTC_CHECK_EQ(0, codec->SetSendCodec(channel, send_codec));
+    RTC_CHECK_EQ(0, network->RegisterExternalTransport(
+                        channel, *loopback.AddSender(receivers[i])));
+    send_channels.push_back(channel);
+  }
+  RTC_CHECK_EQ(0, external_media->RegisterExternalMediaProcessing(
+                      -1, kRecordingAllChannelsMixed, meter));
+  if (flags::FLAGS_apm) {
+    RTC_CHECK_EQ(0, apm->SetEcStatus(true, kEcAec));
+    RTC_CHECK_EQ(0, apm->SetAgcStatus(true, kAgcAdaptiveDigital));
+    RTC_CHECK_EQ(0, apm->SetNsStatus(true, kNsModerateSuppression));
+  }
+
+  printf("Running %d send and %d receive channels with %s/%d for %d s, "
+         "after %d s of warm-up.\n",
+         num_send, num_receive, send_codec.plname, send_codec.plfreq,
+         flags::FLAGS_duration_s, flags::FLAGS_warmup_s);
+  meter.set_measurement_start(rtc::TimeMicros() +
+                              flags::FLAGS_warmup_s * rtc::kNumMicrosecsPerSec);
+  for (int channel : receive_channels)
+    RTC_CHECK_EQ(0, base->StartPlayout(channel));
+  for (int channel : send_channels)
+    RTC_CHECK_EQ(0, base->StartSend(channel));
+
+  SleepMs((flags::FLAGS_warmup_s + flags::FLAGS_duration_s) * 1000);
+
+  for (int channel : send_channels)
+    base->StopSend(channel);
+  for (int channel : receive_channels)
+    base->StopPlayout(channel);
+  external_media->DeRegisterExternalMediaProcessing(-1,
+                                                    kRecordingAllChannelsMixed);
+  if (flags::FLAGS_split_decode_and_mix) {
+    for (int channel : receive_channels)
+      external_media->DeRegisterExternalMediaProcessing(channel,
+                                                        kPlaybackPerChannel);
+  }
+  for (int channel : send_channels) {
+    network->DeRegisterExternalTransport(channel);
+    base->DeleteChannel(channel);
+  }
+  for (int channel : receive_channels) {
+    network->DeRegisterExternalTransport(channel);
+    base->DeleteChannel(channel);
+  }
+  // Stops the audio device threads, after which the stats can be read.
+  base->Terminate();
+  apm->Release();
+  external_media->Release();
+  network->Release();
+  codec->Release();
+  base->Release();
+  VoiceEngine::Delete(voe);
+  if (temporary_input)
+    remove(input_file.c_str());
+
+  // Wall time per 10 ms of audio. The apm stage is shared by all send
+  // channels. Without the per channel callbacks the neteq stage is empty, and
+  // the decoding is part of the mix stage.
+  const std::string trace = "send" + std::to_string(num_send) + "_receive" +
+                            std::to_string(num_receive);
+  printf("%-12s %17s %23s\n", "stage", "wall us/10ms",
+         "wall us/10ms/channel");
+  for (int i = 0; i < kNumStages; ++i) {
+    const Stage stage = static_cast<Stage>(i);
+    if (stage == kNetEq && !flags::FLAGS_split_decode_and_mix)
+      continue;
+    const std::string name =
+        stage == kMix && !flags::FLAGS_split_decode_and_mix
+            ? kNetEqMixStageName
+            : kStageNames[stage];
+    const TickStats& ticks =
+        stage == kApm || stage == kEncode ? meter.capture() : meter.playout();
+    if (ticks.ticks == 0)
+      continue;
+    const double us_per_tick =
+        static_cast<double>(meter.stage_us(stage)) / ticks.ticks;
+    const int num_channels =
+        stage == kApm ? 1 : stage == kEncode ? num_send : num_receive;
+    printf("%-12s %17.1f %23.2f\n", name.c_str(), us_per_tick,
+           us_per_tick / num_channels);
+    PrintResult("voe_load_wall_time", "_" + name, trace, Format(us_per_tick),
+                "us/10ms", false);
+    PrintResult("voe_load_wall_time_per_channel", "_" + name, trace,
+                Format(us_per_tick / num_channels), "us/10ms", false);
+  }
+  PrintTicks("capture", meter.capture());
+  PrintTicks("playout", meter.playout());
+  for (const TickStats* stats : {&meter.capture(), &meter.playout()}) {
+    if (stats->ticks == 0)
+      continue;
+    PrintResult("voe_load_missed_deadlines",
+                stats == &meter.capture() ? "_capture" : "_playout", trace,
+                Format(100.0 * stats->missed_deadlines / stats->ticks), "%",
+                true);
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  google::SetUsageMessage(
+      "Runs VoiceEngine with many send and receive channels on a file audio "
+      "device and a loopback network, and reports the time spent per 10 ms "
+      "in each stage and the rate of missed 10 ms deadlines.\n"
+      "Example usage:\n" +
+      std::string(argv[0]) +
+      " --send_channels=50 --receive_channels=200 --codec=opus");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  return webrtc::test::RunLoadTest();
+}
@@ -10,6 +10,8 @@
 
 #include "webrtc/voice_engine/utility.h"
 
+#include <string.h>
+
 #include "webrtc/audio/utility/audio_frame_operations.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
@@ -42,14 +44,10 @@ void RemixAndResample(const int16_t* src_data,
   const int16_t* audio_ptr = src_data;
   size_t audio_ptr_num_channels = num_channels;
   int16_t mono_audio[AudioFrame::kMaxDataSizeSamples];
-
-  // Downmix before resampling.
-  if (num_channels == 2 && dst_frame->num_channels_ == 1) {
-    AudioFrameOperations::StereoToMono(src_data, samples_per_channel,
-                                       mono_audio);
-    audio_ptr = mono_audio;
+  const bool downmix = num_channels == 2 && dst_frame->num_channels_ == 1;
+  const bool upmix = num_channels == 1 && dst_frame->num_channels_ == 2;
+  if (downmix)
     audio_ptr_num_channels = 1;
-  }
 
   if (resampler->InitializeIfNeeded(sample_rate_hz, dst_frame->sample_rate_hz_,
                                     audio_ptr_num_channels) == -1) {
@@ -58,6 +56,34 @@ void RemixAndResample(const int16_t* src_data,
             << ", audio_ptr_num_channels = " << audio_ptr_num_channels;
   }
 
+  // The resampler would only copy the samples, so remix them straight into
+  // |dst_frame| instead of through |mono_audio| and that copy. Only for the
+  // remixing done here, which writes |dst_frame->num_channels_| channels.
+  if (sample_rate_hz == dst_frame->sample_rate_hz_ &&
+      (downmix || upmix || num_channels == dst_frame->num_channels_)) {
+    RTC_CHECK_LE(samples_per_channel * dst_frame->num_channels_,
+                 AudioFrame::kMaxDataSizeSamples);
+    if (downmix) {
+      AudioFrameOperations::StereoToMono(src_data, samples_per_channel,
+                                         dst_frame->data_);
+    } else if (upmix) {
+      AudioFrameOperations::MonoToStereo(src_data, samples_per_channel,
+                                         dst_frame->data_);
+    } else {
+      memcpy(dst_frame->data_, src_data,
+             sizeof(int16_t) * samples_per_channel * num_channels);
+    }
+    dst_frame->samples_per_channel_ = samples_per_channel;
+    return;
+  }
+
+  // Downmix before resampling.
+  if (downmix) {
+    AudioFrameOperations::StereoToMono(src_data, samples_per_channel,
+                                       mono_audio);
+    audio_ptr = mono_audio;
+  }
+
   const size_t src_length = samples_per_channel * audio_ptr_num_channels;
   int out_length = resampler->Resample(audio_ptr, src_length, dst_frame->data_,
                                        AudioFrame::kMaxDataSizeSamples);
@@ -69,7 +95,7 @@ void RemixAndResample(const int16_t* src_data,
   dst_frame->samples_per_channel_ = out_length / audio_ptr_num_channels;
 
   // Upmix after resampling.
-  if (num_channels == 1 && dst_frame->num_channels_ == 2) {
+  if (upmix) {
     // The audio in dst_frame really is mono at this point; MonoToStereo will
     // set this back to stereo.
     dst_frame->num_channels_ = 1;
@@ -10,6 +10,9 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "webrtc/base/format_macros.h"
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/modules/include/module_common_types.h"
@@ -204,6 +207,38 @@ TEST_F(UtilityTest, RemixAndResampleMixingOnlySucceeds) {
   VerifyFramesAreEqual(golden_frame_, dst_frame_);
 }
 
+TEST_F(UtilityTest, RemixAndResampleKeepsUnsupportedRemixInSourceChannels) {
+  // Stereo -> a frame with four channels, at the same rate. Only 1 <-> 2
+  // channels are remixed, so the stereo samples are copied as they are.
+  SetStereoFrame(&src_frame_, 10, 20);
+  dst_frame_.CopyFrom(src_frame_);
+  const size_t kSrcSamples =
+      src_frame_.samples_per_channel_ * src_frame_.num_channels_;
+  std::fill(dst_frame_.data_,
+            dst_frame_.data_ + AudioFrame::kMaxDataSizeSamples, -1);
+  dst_frame_.num_channels_ = 4;
+  RemixAndResample(src_frame_, &resampler_, &dst_frame_);
+  EXPECT_EQ(src_frame_.samples_per_channel_, dst_frame_.samples_per_channel_);
+  for (size_t i = 0; i < kSrcSamples; ++i)
+    EXPECT_EQ(src_frame_.data_[i], dst_frame_.data_[i]);
+  for (size_t i = kSrcSamples; i < AudioFrame::kMaxDataSizeSamples; ++i)
+    EXPECT_EQ(-1, dst_frame_.data_[i]);
+}
+
+#if GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
+TEST_F(UtilityTest, RemixAndResampleFromMoreThanStereoDies) {
+  // Four channels at the same rate, which would fit in the frame as stereo
+  // but not as they are.
+  const size_t kSamplesPerChannel = AudioFrame::kMaxDataSizeSamples / 2;
+  std::vector<int16_t> src(4 * kSamplesPerChannel);
+  dst_frame_.sample_rate_hz_ = 48000;
+  dst_frame_.num_channels_ = 2;
+  EXPECT_DEATH(RemixAndResample(src.data(), kSamplesPerChannel, 4, 48000,
+                                &resampler_, &dst_frame_),
+               "");
+}
+#endif
+
 TEST_F(UtilityTest, RemixAndResampleSucceeds) {
   const int kSampleRates[] = {8000, 16000, 32000, 44100, 48000, 96000};
   const int kSampleRatesSize = sizeof(kSampleRates) / sizeof(*kSampleRates);